@@ -10,3 +10,8 @@
 
 #define CUSTOM_MILLIS esphome::millis()
 #define CUSTOM_DELAY(x) esphome::delay(x)
+
+namespace esphome {
+    void log_info_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix = "");
+    void log_debug_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix = "");
+}
@@ -0,0 +1,75 @@
+/// adaptive_polling.h — Per-request poll periods that follow what the unit is doing.
+/// Deps: cn105_types.h (INFO_EXCHANGE_WIRE_MS)
+///
+/// Policy (applied by RequestScheduler when AdaptivePollingConfig::enabled):
+///   - FAST_WHEN_ACTIVE requests (0x03 room temp, 0x06 status/power) are polled every
+///     `fast_interval_ms` while the unit is active (compressor running or room temperature moving);
+///   - STRETCH_WHEN_STABLE requests (0x02, 0x09, 0x04, 0x42) back off exponentially, up to
+///     `max_stretch` × update_interval, once their payload has been identical `stable_cycles` times;
+///   - the resulting polling load (wire time / period, summed over requests) never exceeds
+///     `bus_budget_pct` of the link: fast polling is slowed down first.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "cn105_types.h"
+
+namespace esphome {
+
+    enum class PollClass : uint8_t {
+        FIXED,                  // every cycle, or every interval_ms when set (historical behaviour)
+        FAST_WHEN_ACTIVE,       // shortened period while the unit is active
+        STRETCH_WHEN_STABLE,    // lengthened period while the payload does not change
+    };
+
+    struct AdaptivePollingConfig {
+        bool enabled = false;
+        uint32_t fast_interval_ms = 1000;   // FAST_WHEN_ACTIVE period while active
+        uint8_t stable_cycles = 3;          // identical payloads before stretching starts
+        uint8_t max_stretch = 8;            // longest STRETCH_WHEN_STABLE period, in update intervals
+        uint8_t bus_budget_pct = 50;        // max share of the link spent polling
+    };
+
+    namespace adaptive_polling {
+
+        /// FNV-1a over the payload: cheap "did it change" fingerprint for STRETCH_WHEN_STABLE requests.
+        inline uint32_t payload_hash(const uint8_t* payload, size_t len) {
+            uint32_t h = 2166136261u;
+            for (size_t i = 0; i < len; i++) {
+                h = (h ^ payload[i]) * 16777619u;
+            }
+            return h;
+        }
+
+        /// Period multiplier after `stable_count` identical payloads: 1 until `stable_cycles`,
+        /// then 2, 4, 8... capped at `max_stretch`.
+        inline uint32_t stretch_factor(uint8_t stable_count, const AdaptivePollingConfig& cfg) {
+            if (stable_count < cfg.stable_cycles) return 1;
+            const uint32_t doublings = static_cast<uint32_t>(stable_count - cfg.stable_cycles) + 1;
+            const uint32_t cap = cfg.max_stretch < 1 ? 1 : cfg.max_stretch;
+            if (doublings >= 31) return cap;
+            const uint32_t factor = 1u << doublings;
+            return factor < cap ? factor : cap;
+        }
+
+        /// Fastest period the FAST_WHEN_ACTIVE requests may use, given the load already taken by the
+        /// others (`slow_load_permille`, wire time per period in ‰). Returns `base_interval_ms` when
+        /// the budget leaves no room to poll faster.
+        inline uint32_t budgeted_fast_interval(uint32_t base_interval_ms, uint8_t fast_count,
+            uint32_t slow_load_permille, const AdaptivePollingConfig& cfg) {
+            if (fast_count == 0) return base_interval_ms;
+            const uint32_t budget_permille = uint32_t(cfg.bus_budget_pct) * 10;
+            if (slow_load_permille >= budget_permille) return base_interval_ms;
+            const uint32_t min_period = uint32_t(fast_count) * INFO_EXCHANGE_WIRE_MS * 1000 / (budget_permille - slow_load_permille);
+            uint32_t period = cfg.fast_interval_ms > min_period ? cfg.fast_interval_ms : min_period;
+            return period < base_interval_ms ? period : base_interval_ms;
+        }
+
+        /// Share of the link (‰) used by one request polled every `period_ms`.
+        inline uint32_t load_permille(uint32_t period_ms) {
+            return period_ms == 0 ? 1000 : INFO_EXCHANGE_WIRE_MS * 1000 / period_ms;
+        }
+
+    }
+
+}
@@ -0,0 +1,142 @@
+/// byte_maps.h — Direct-indexed decode (byte → entry) and encode (entry → byte) tables for the CN105 byte maps.
+/// Role: Replaces the linear scans of lookup_value_opt() / lookup_index() on the decode and SET paths.
+/// Deps: <cstdint>, <cstring>, <optional>, <type_traits> (no ESPHome dependency)
+///
+/// Each table is generated at compile time from the protocol byte array of cn105_types.h (MODE, FAN, ...),
+/// which stays the single definition: the decode index and the encode bytes both come from it, and the
+/// entry enum must have exactly one value per byte (static_assert), so neither direction can drift.
+/// The decode index only spans 0 … largest byte of the map (a few bytes each, AUTO_SUB_MODE 68):
+/// on ESP8266 const data lives in RAM, so a full 256-entry index per map would cost ~2.5 KB.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+namespace cn105_protocol {
+
+// ════════════════════════════════════════════════════════════════
+// Entries (same order as the byte arrays and their *_MAP labels)
+// UNSET: no value yet / not requested (was nullptr with the label pointers)
+// ════════════════════════════════════════════════════════════════
+
+enum class Power : uint8_t { OFF, ON, COUNT, UNSET = 0xFF };
+enum class Mode : uint8_t { HEAT, DRY, COOL, FAN, AUTO, COUNT, UNSET = 0xFF };
+enum class Fan : uint8_t { AUTO, QUIET, SPEED_1, SPEED_2, SPEED_3, SPEED_4, COUNT, UNSET = 0xFF };
+enum class Vane : uint8_t { AUTO, POS_1, POS_2, POS_3, POS_4, POS_5, SWING, COUNT, UNSET = 0xFF };
+enum class WideVane : uint8_t { FAR_LEFT, LEFT, CENTER, RIGHT, FAR_RIGHT, SPLIT, SWING, AIRFLOW_CONTROL, COUNT, UNSET = 0xFF };
+enum class AirflowControl : uint8_t { EVEN, INDIRECT, DIRECT, COUNT, UNSET = 0xFF };
+// Prefixed: LOW / HIGH are Arduino macros
+enum class Stage : uint8_t { STAGE_IDLE, STAGE_LOW, STAGE_GENTLE, STAGE_MEDIUM, STAGE_MODERATE, STAGE_HIGH, STAGE_DIFFUSE, COUNT, UNSET = 0xFF };
+enum class SubMode : uint8_t { NORMAL, WARMUP, DEFROST, PREHEAT, STANDBY, OFF, COUNT, UNSET = 0xFF };
+enum class AutoSubMode : uint8_t { AUTO_OFF, AUTO_COOL, AUTO_HEAT, AUTO_LEADER, AUTO_INACTIVE, AUTO_IDLE, AUTO_ACTIVE, COUNT, UNSET = 0xFF };
+
+// ════════════════════════════════════════════════════════════════
+// ByteMap
+// ════════════════════════════════════════════════════════════════
+
+/// Decode index value of a byte that is not in the map.
+static constexpr uint8_t NO_ENTRY = 0xFF;
+
+/// Size of the decode index of a byte array: its largest byte + 1.
+template <size_t N>
+constexpr size_t byte_span(const uint8_t (&bytes)[N]) {
+    size_t span = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (bytes[i] + size_t(1) > span) span = bytes[i] + size_t(1);
+    }
+    return span;
+}
+
+/// Number of entries an entry type declares (Enum::COUNT), or `n` for a plain index type (TEMP, ROOM_TEMP).
+template <typename Entry>
+constexpr size_t entry_count(size_t n) {
+    if constexpr (std::is_enum<Entry>::value) {
+        return static_cast<size_t>(Entry::COUNT);
+    } else {
+        return n;
+    }
+}
+
+/// Both directions of one protocol byte map.
+///
+/// @tparam Entry  Entry enum (or uint8_t for maps without named entries).
+/// @tparam N      Number of entries (length of the byte array and of its value map).
+/// @tparam SPAN   Size of the decode index (see byte_span()).
+template <typename Entry, size_t N, size_t SPAN>
+class ByteMap {
+    static_assert(entry_count<Entry>(N) == N, "entry enum and byte array lengths differ");
+    static_assert(N < NO_ENTRY, "too many entries for a uint8_t index");
+    static_assert(SPAN <= 256, "span exceeds the byte range");
+
+public:
+    constexpr explicit ByteMap(const uint8_t (&bytes)[N]) : bytes_{}, index_{} {
+        for (size_t b = 0; b < SPAN; b++) index_[b] = NO_ENTRY;
+        // Backwards, so a byte listed twice decodes to its first entry like the linear scan did
+        for (size_t i = N; i-- > 0;) {
+            bytes_[i] = bytes[i];
+            index_[bytes[i]] = static_cast<uint8_t>(i);
+        }
+    }
+
+    /// Entry of a protocol byte, or std::nullopt if the byte is not in the map.
+    constexpr std::optional<Entry> decode(uint8_t byte) const {
+        if (byte >= SPAN || index_[byte] == NO_ENTRY) return std::nullopt;
+        return static_cast<Entry>(index_[byte]);
+    }
+
+    /// Protocol byte of an entry (has() must be true).
+    constexpr uint8_t encode(Entry entry) const { return bytes_[static_cast<size_t>(entry)]; }
+
+    /// True for an entry of the map (false for UNSET).
+    static constexpr bool has(Entry entry) { return static_cast<size_t>(entry) < N; }
+
+    /// Value of a protocol byte in a parallel value map (drop-in for lookup_value_opt()).
+    template <typename T>
+    std::optional<T> lookup(const T (&values)[N], uint8_t byte) const {
+        if (byte >= SPAN || index_[byte] == NO_ENTRY) return std::nullopt;
+        return values[index_[byte]];
+    }
+
+    /// Entry of a label (drop-in for lookup_index(), case-insensitive). Settings hold pointers into
+    /// the label map, so a pointer match is tried before falling back to strcasecmp().
+    std::optional<Entry> find(const char* const (&labels)[N], const char* label) const {
+        if (label == nullptr) return std::nullopt;
+        for (size_t i = 0; i < N; i++) {
+            if (labels[i] == label) return static_cast<Entry>(i);
+        }
+        for (size_t i = 0; i < N; i++) {
+            if (strcasecmp(labels[i], label) == 0) return static_cast<Entry>(i);
+        }
+        return std::nullopt;
+    }
+
+    /// Label of an entry, or nullptr for UNSET (or any value outside the map).
+    const char* label(const char* const (&labels)[N], Entry entry) const {
+        const size_t i = static_cast<size_t>(entry);
+        return i < N ? labels[i] : nullptr;
+    }
+
+    /// Entry of an integer value (TEMP_MAP).
+    std::optional<Entry> find(const int (&values)[N], int value) const {
+        for (size_t i = 0; i < N; i++) {
+            if (values[i] == value) return static_cast<Entry>(i);
+        }
+        return std::nullopt;
+    }
+
+    static constexpr size_t size() { return N; }
+    static constexpr size_t span() { return SPAN; }
+
+private:
+    uint8_t bytes_[N];
+    uint8_t index_[SPAN];
+};
+
+}  // namespace cn105_protocol
+
+/// ByteMap of a byte array of cn105_types.h, e.g. CN105_BYTE_MAP(cn105_protocol::Mode, MODE).
+#define CN105_BYTE_MAP(Entry, bytes) \
+    cn105_protocol::ByteMap<Entry, sizeof(bytes), cn105_protocol::byte_span(bytes)>(bytes)
@@ -138,7 +138,30 @@ CONF_REMOTE_TEMP_TIMEOUT = "remote_temperature_timeout"
 CONF_REMOTE_TEMP_KEEPALIVE_INTERVAL = "remote_temperature_keepalive_interval"
 CONF_DEBOUNCE_DELAY = "debounce_delay"
 CONF_CONNECTION_BOOTSTRAP_DELAY = "connection_bootstrap_delay"
+CONF_WARM_RECONNECT_WINDOW = "warm_reconnect_window"
 CONF_INSTALLER_MODE = "installer_mode"
+CONF_INFO_PIPELINE_WINDOW = "info_pipeline_window"
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_FAST_INTERVAL = "fast_interval"
+CONF_STABLE_CYCLES = "stable_cycles"
+CONF_MAX_STRETCH = "max_stretch"
+CONF_BUS_BUDGET = "bus_budget"
+CONF_COMMAND_LATENCY = "command_latency"
+CONF_PERCENTILE = "percentile"
+CONF_TO_ACK = "to_ack"
+CONF_TO_CONFIRM = "to_confirm"
+CONF_BUS = "bus"
+CONF_LOOP_PROFILER = "loop_profiler"
+CONF_PACKET_DEBUG = "packet_debug"
+CONF_FRAME_CAPTURE = "frame_capture"
+CONF_FRAMES = "frames"
+CONF_DUMP_BUTTON = "dump_button"
+CONF_PUBLISH_DEADBAND = "publish_deadband"
+CONF_ABSOLUTE = "absolute"
+CONF_RELATIVE = "relative"
+CONF_WINDOW = "window"
+CONF_REPORT = "report"
+CONF_LOOP_MAX = "loop_max"
 
 # DÃÂÃÂ©finitions des classes C++ (identiques ÃÂÃÂ  votre version)
 VaneOrientationSelect = cg.global_ns.class_(
@@ -176,6 +199,7 @@ RemoteTempSourceInfo = cg.global_ns.class_(
     "RemoteTempSourceInfo", text_sensor.TextSensor, cg.Component
 )
 cn105_ns = cg.esphome_ns.namespace("cn105")
+PublishField = cg.esphome_ns.enum("PublishField", is_class=True)
 HpUpTimeConnectionSensor = cn105_ns.class_(
     "HpUpTimeConnectionSensor", sensor.Sensor, cg.PollingComponent
 )
@@ -236,41 +260,74 @@ def get_uart_port_index(core_config, target_uart_id_str):
 SELECT_SCHEMA = select.select_schema(VaneOrientationSelect).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(VaneOrientationSelect)}
 )
+# Republish a numeric sensor only when it moves by more than max(absolute, relative x last value)
+PUBLISH_DEADBAND_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ABSOLUTE, default=0.0): cv.positive_float,
+        cv.Optional(CONF_RELATIVE, default="0%"): cv.percentage,
+    }
+)
+
 COMPRESSOR_FREQUENCY_SENSOR_SCHEMA = sensor.sensor_schema(
     CompressorFrequencySensor,
     unit_of_measurement=UNIT_HERTZ,
     device_class=DEVICE_CLASS_FREQUENCY,
     state_class=STATE_CLASS_MEASUREMENT,
     accuracy_decimals=1,
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(CompressorFrequencySensor)})
+).extend(
+    {
+        cv.GenerateID(CONF_ID): cv.declare_id(CompressorFrequencySensor),
+        cv.Optional(CONF_PUBLISH_DEADBAND): PUBLISH_DEADBAND_SCHEMA,
+    }
+)
 INPUT_POWER_SENSOR_SCHEMA = sensor.sensor_schema(
     InputPowerSensor,
     unit_of_measurement=UNIT_WATT,
     device_class=DEVICE_CLASS_POWER,
     state_class=STATE_CLASS_MEASUREMENT,
     accuracy_decimals=0,
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(InputPowerSensor)})
+).extend(
+    {
+        cv.GenerateID(CONF_ID): cv.declare_id(InputPowerSensor),
+        cv.Optional(CONF_PUBLISH_DEADBAND): PUBLISH_DEADBAND_SCHEMA,
+    }
+)
 KWH_SENSOR_SCHEMA = sensor.sensor_schema(
     kWhSensor,
     unit_of_measurement=UNIT_KILOWATT_HOURS,
     device_class=DEVICE_CLASS_ENERGY,
     state_class=STATE_CLASS_TOTAL_INCREASING,
     accuracy_decimals=1,
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(kWhSensor)})
+).extend(
+    {
+        cv.GenerateID(CONF_ID): cv.declare_id(kWhSensor),
+        cv.Optional(CONF_PUBLISH_DEADBAND): PUBLISH_DEADBAND_SCHEMA,
+    }
+)
 RUNTIME_HOURS_SENSOR_SCHEMA = sensor.sensor_schema(
     RuntimeHoursSensor,
     unit_of_measurement=UNIT_HOUR,
     device_class=DEVICE_CLASS_DURATION,
     state_class=STATE_CLASS_TOTAL_INCREASING,
     accuracy_decimals=2,
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(RuntimeHoursSensor)})
+).extend(
+    {
+        cv.GenerateID(CONF_ID): cv.declare_id(RuntimeHoursSensor),
+        cv.Optional(CONF_PUBLISH_DEADBAND): PUBLISH_DEADBAND_SCHEMA,
+    }
+)
 OUTSIDE_AIR_TEMPERATURE_SENSOR_SCHEMA = sensor.sensor_schema(
     OutsideAirTemperatureSensor,
     unit_of_measurement=UNIT_CELSIUS,
     device_class=DEVICE_CLASS_TEMPERATURE,
     state_class=STATE_CLASS_MEASUREMENT,
     accuracy_decimals=1,
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(OutsideAirTemperatureSensor)})
+).extend(
+    {
+        cv.GenerateID(CONF_ID): cv.declare_id(OutsideAirTemperatureSensor),
+        cv.Optional(CONF_PUBLISH_DEADBAND): PUBLISH_DEADBAND_SCHEMA,
+    }
+)
 ISEE_SENSOR_SCHEMA = binary_sensor.binary_sensor_schema(ISeeSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(ISeeSensor)}
 )
@@ -342,6 +399,55 @@ HP_UP_TIME_CONNECTION_SENSOR_SCHEMA = sensor.sensor_schema(
     entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
 ).extend(cv.polling_component_schema("60s"))
 
+# Latence des commandes (ms, percentile configurable): control() -> ACK 0x61, -> relecture 0x02, ecriture -> ACK
+COMMAND_LATENCY_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement="ms",
+    icon="mdi:timer-outline",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+COMMAND_LATENCY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_PERCENTILE, default=95): cv.int_range(min=1, max=100),
+        cv.Optional(CONF_TO_ACK): COMMAND_LATENCY_SENSOR_SCHEMA,
+        cv.Optional(CONF_TO_CONFIRM): COMMAND_LATENCY_SENSOR_SCHEMA,
+        cv.Optional(CONF_BUS): COMMAND_LATENCY_SENSOR_SCHEMA,
+    }
+)
+
+LOOP_PROFILER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_WINDOW, default="60s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=1)),
+        ),
+        cv.Optional(CONF_REPORT): text_sensor.text_sensor_schema(
+            icon="mdi:chart-timeline-variant",
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_LOOP_MAX): sensor.sensor_schema(
+            unit_of_measurement="us",
+            icon="mdi:timer-alert-outline",
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+FRAME_CAPTURE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_FRAMES, default=64): cv.int_range(min=4, max=1024),
+        cv.Optional(CONF_DUMP_BUTTON): button.button_schema(
+            FunctionsButton,
+            icon="mdi:file-download-outline",
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
 HVAC_OPTION_SWITCH_SCHEMA = switch.switch_schema(HVACOptionSwitch).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(HVACOptionSwitch)}
 )
@@ -420,7 +526,24 @@ CONFIG_SCHEMA = (
             cv.Optional(CONF_CONNECTION_BOOTSTRAP_DELAY, default="10s"): cv.All(
                 cv.update_interval
             ),
+            # Keep the last unit state across a link loss shorter than this; 0s = full resync
+            cv.Optional(CONF_WARM_RECONNECT_WINDOW, default="5min"): cv.All(
+                cv.positive_time_period_milliseconds
+            ),
             cv.Optional(CONF_INSTALLER_MODE, default=False): cv.boolean,
+            cv.Optional(CONF_INFO_PIPELINE_WINDOW, default=1): cv.int_range(min=1, max=4),
+            cv.Optional(CONF_ADAPTIVE_POLLING): cv.Schema(
+                {
+                    cv.Optional(CONF_FAST_INTERVAL, default="1s"): cv.positive_time_period_milliseconds,
+                    cv.Optional(CONF_STABLE_CYCLES, default=3): cv.int_range(min=1, max=50),
+                    cv.Optional(CONF_MAX_STRETCH, default=8): cv.int_range(min=1, max=64),
+                    cv.Optional(CONF_BUS_BUDGET, default="50%"): cv.percentage,
+                }
+            ),
+            cv.Optional(CONF_COMMAND_LATENCY): COMMAND_LATENCY_SCHEMA,
+            cv.Optional(CONF_LOOP_PROFILER): LOOP_PROFILER_SCHEMA,
+            cv.Optional(CONF_PACKET_DEBUG, default=True): cv.boolean,
+            cv.Optional(CONF_FRAME_CAPTURE): FRAME_CAPTURE_SCHEMA,
             cv.Optional(
                 CONF_HP_UP_TIME_CONNECTION_SENSOR
             ): HP_UP_TIME_CONNECTION_SENSOR_SCHEMA,
@@ -463,6 +586,16 @@ CONFIG_SCHEMA = (
 )
 
 
+def publish_deadband_to_code(var, field, conf_item):
+    if CONF_PUBLISH_DEADBAND in conf_item:
+        deadband = conf_item[CONF_PUBLISH_DEADBAND]
+        cg.add(
+            var.set_publish_deadband(
+                field, deadband[CONF_ABSOLUTE], deadband[CONF_RELATIVE]
+            )
+        )
+
+
 @coroutine
 def to_code(config):
     uart_id_object = config[CONF_UART_ID]
@@ -470,7 +603,53 @@ def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID], uart_var)
 
     cg.add(var.set_installer_mode(config[CONF_INSTALLER_MODE]))
+    cg.add(var.set_info_pipeline_window(config[CONF_INFO_PIPELINE_WINDOW]))
+    if CONF_ADAPTIVE_POLLING in config:
+        adaptive = config[CONF_ADAPTIVE_POLLING]
+        cg.add(
+            var.set_adaptive_polling(
+                adaptive[CONF_FAST_INTERVAL].total_milliseconds,
+                adaptive[CONF_STABLE_CYCLES],
+                adaptive[CONF_MAX_STRETCH],
+                int(round(adaptive[CONF_BUS_BUDGET] * 100)),
+            )
+        )
     cg.add(var.set_power_unit_is_btu(config[CONF_POWER_UNIT_IS_BTU]))
+    if CONF_COMMAND_LATENCY in config:
+        latency = config[CONF_COMMAND_LATENCY]
+        cg.add(var.set_command_latency_percentile(latency[CONF_PERCENTILE]))
+        if CONF_TO_ACK in latency:
+            sens = yield sensor.new_sensor(latency[CONF_TO_ACK])
+            cg.add(var.set_command_to_ack_sensor(sens))
+        if CONF_TO_CONFIRM in latency:
+            sens = yield sensor.new_sensor(latency[CONF_TO_CONFIRM])
+            cg.add(var.set_command_to_confirm_sensor(sens))
+        if CONF_BUS in latency:
+            sens = yield sensor.new_sensor(latency[CONF_BUS])
+            cg.add(var.set_command_bus_sensor(sens))
+    if CONF_LOOP_PROFILER in config:
+        profiler = config[CONF_LOOP_PROFILER]
+        # Without this define the profiling markers compile to nothing
+        cg.add_define("USE_CN105_LOOP_PROFILER")
+        cg.add(var.set_loop_profiler_window(profiler[CONF_WINDOW].total_milliseconds))
+        if CONF_REPORT in profiler:
+            tsens = yield text_sensor.new_text_sensor(profiler[CONF_REPORT])
+            cg.add(var.set_loop_profiler_report_sensor(tsens))
+        if CONF_LOOP_MAX in profiler:
+            sens = yield sensor.new_sensor(profiler[CONF_LOOP_MAX])
+            cg.add(var.set_loop_profiler_max_sensor(sens))
+
+    if CONF_FRAME_CAPTURE in config:
+        capture = config[CONF_FRAME_CAPTURE]
+        # Without this define the capture markers compile to nothing
+        cg.add_define("USE_CN105_FRAME_CAPTURE")
+        cg.add(var.set_frame_capture_size(capture[CONF_FRAMES]))
+        if CONF_DUMP_BUTTON in capture:
+            button_var = yield button.new_button(capture[CONF_DUMP_BUTTON])
+            cg.add(var.set_frame_capture_dump_button(button_var))
+    if not config[CONF_PACKET_DEBUG]:
+        # hpPacketDebug() / hpFunctionsDebug() compile to empty functions
+        cg.add_define("CN105_DISABLE_PACKET_DEBUG")
 
     cg.add(uart_var.set_data_bits(8))
     cg.add(uart_var.set_parity(UARTParityOptions.UART_CONFIG_PARITY_EVEN))
@@ -557,6 +736,11 @@ def to_code(config):
             int(config[CONF_CONNECTION_BOOTSTRAP_DELAY].total_milliseconds)
         )
     )
+    cg.add(
+        var.set_warm_reconnect_window(
+            int(config[CONF_WARM_RECONNECT_WINDOW].total_milliseconds)
+        )
+    )
 
     # --- Configuration des entitÃÂÃÂ©s optionnelles (style original) ---
     if CONF_HORIZONTAL_SWING_SELECT in config:
@@ -595,6 +779,7 @@ def to_code(config):
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
         cg.add(var.set_compressor_frequency_sensor(sensor_var))
+        publish_deadband_to_code(var, PublishField.COMPRESSOR_FREQUENCY, conf_item)
 
     if CONF_INPUT_POWER_SENSOR in config:
         conf_item = config[CONF_INPUT_POWER_SENSOR]
@@ -602,6 +787,7 @@ def to_code(config):
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
         cg.add(var.set_input_power_sensor(sensor_var))
+        publish_deadband_to_code(var, PublishField.INPUT_POWER, conf_item)
 
     if CONF_KWH_SENSOR in config:
         conf_item = config[CONF_KWH_SENSOR]
@@ -609,6 +795,7 @@ def to_code(config):
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
         cg.add(var.set_kwh_sensor(sensor_var))
+        publish_deadband_to_code(var, PublishField.KWH, conf_item)
 
     if CONF_RUNTIME_HOURS_SENSOR in config:
         conf_item = config[CONF_RUNTIME_HOURS_SENSOR]
@@ -616,6 +803,7 @@ def to_code(config):
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
         cg.add(var.set_runtime_hours_sensor(sensor_var))
+        publish_deadband_to_code(var, PublishField.RUNTIME_HOURS, conf_item)
 
     if CONF_OUTSIDE_AIR_TEMPERATURE_SENSOR in config:
         conf_item = config[CONF_OUTSIDE_AIR_TEMPERATURE_SENSOR]
@@ -623,6 +811,7 @@ def to_code(config):
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
         cg.add(var.set_outside_air_temperature_sensor(sensor_var))
+        publish_deadband_to_code(var, PublishField.OUTSIDE_AIR_TEMPERATURE, conf_item)
 
     if CONF_ISEE_SENSOR in config:
         bsensor_var = yield binary_sensor.new_binary_sensor(config[CONF_ISEE_SENSOR])
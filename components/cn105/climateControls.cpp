@@ -21,13 +21,13 @@ void CN105Climate::checkPendingWantedSettings() {
         return;
     }
 
-    // Don't log if sendWantedSettings() will defer due to write throttle (300ms)
-    if (now - this->lastSend <= 300) {
+    // Already queued: the scheduler sends it as soon as the line is free
+    if (this->scheduler_.is_write_pending(WRITE_SETTINGS)) {
         return;
     }
 
     ESP_LOGI(LOG_ACTION_EVT_TAG, "checkPendingWantedSettings - wanted settings have changed, sending them to the heatpump...");
-    this->sendWantedSettings();
+    this->scheduler_.enqueue_write(WRITE_SETTINGS);
 }
 
 void CN105Climate::checkPendingWantedRunStates() {
@@ -41,13 +41,13 @@ void CN105Climate::checkPendingWantedRunStates() {
         return;
     }
 
-    // Don't log if sendWantedRunStates() will defer due to write throttle (300ms)
-    if (now - this->lastSend <= 300) {
+    // Already queued: the scheduler sends it as soon as the line is free
+    if (this->scheduler_.is_write_pending(WRITE_RUN_STATES)) {
         return;
     }
 
     ESP_LOGI(LOG_ACTION_EVT_TAG, "checkPendingWantedRunStates - wanted run states have changed, sending them to the heatpump...");
-    this->sendWantedRunStates();
+    this->scheduler_.enqueue_write(WRITE_RUN_STATES);
 }
 
 void logCheckWantedSettingsMutex(wantedHeatpumpSettings& settings) {
@@ -258,6 +258,7 @@ void CN105Climate::finalizeControlIfUpdated(bool updated) {
     this->wantedSettings.hasChanged = true;
     this->wantedSettings.hasBeenSent = false;
     this->wantedSettings.lastChange = CUSTOM_MILLIS;
+    this->commandLatency_.control(CommandKind::SETTINGS, CUSTOM_MILLIS);
     this->debugSettings("control (wantedSettings)", this->wantedSettings);
     this->publish_state();
 }
@@ -268,7 +269,7 @@ void CN105Climate::control(const esphome::climate::ClimateCall& call) {
     std::lock_guard<std::mutex> guard(wantedSettingsMutex);
     this->controlDelegate(call);
 #else    
-    this->emulateMutex("CONTROL_WANTED_SETTINGS", std::bind(&CN105Climate::controlDelegate, this, call));
+    this->emulateMutex("CONTROL_WANTED_SETTINGS", [this, call]() { this->controlDelegate(call); });
 #endif    
 
 }
@@ -284,29 +285,29 @@ void CN105Climate::control(const esphome::climate::ClimateCall& call) {
 void CN105Climate::controlSwing() {
     // Check if horizontal vane (wideVane) is supported by this unit at the beginning.
     bool wideVaneSupported = this->traits_.supports_swing_mode(climate::CLIMATE_SWING_HORIZONTAL);
-    bool vane_is_swing = (this->currentSettings.vane != nullptr) && (strcmp(this->currentSettings.vane, "SWING") == 0);
-    bool wide_is_swing = (this->currentSettings.wideVane != nullptr) && (strcmp(this->currentSettings.wideVane, "SWING") == 0);
+    bool vane_is_swing = this->currentSettings.vane == cn105_protocol::Vane::SWING;
+    bool wide_is_swing = this->currentSettings.wideVane == cn105_protocol::WideVane::SWING;
 
     switch (this->swing_mode) {
     case climate::CLIMATE_SWING_OFF:
         // When swing is turned OFF, conditionally set vanes to a default static position.
         // This only sets default position if swing was previously enabled
         if (vane_is_swing) {
-            this->setVaneSetting("AUTO");
+            this->setVaneSetting(cn105_protocol::Vane::AUTO);
         }
         if (wideVaneSupported && wide_is_swing) {
-            this->setWideVaneSetting("|");
+            this->setWideVaneSetting(cn105_protocol::WideVane::CENTER);
         }
         break;
 
     case climate::CLIMATE_SWING_VERTICAL:
         // Turn on vertical swing.
-        this->setVaneSetting("SWING");
+        this->setVaneSetting(cn105_protocol::Vane::SWING);
         // If horizontal swing was also on AND is supported, turn it off to a default static position.
         // This correctly handles switching from BOTH to VERTICAL, while preserving any user's
         // static horizontal setting if it wasn't swinging.
         if (wideVaneSupported && wide_is_swing) {
-            this->setWideVaneSetting("|");
+            this->setWideVaneSetting(cn105_protocol::WideVane::CENTER);
         }
         break;
 
@@ -315,20 +316,20 @@ void CN105Climate::controlSwing() {
         // This correctly handles switching from BOTH to HORIZONTAL, while preserving any user's
         // static vertical setting if it wasn't swinging.
         if (vane_is_swing) {
-            this->setVaneSetting("AUTO");
+            this->setVaneSetting(cn105_protocol::Vane::AUTO);
         }
         // Turn on horizontal swing, but only if the unit supports it.
         if (wideVaneSupported) {
-            this->setWideVaneSetting("SWING");
+            this->setWideVaneSetting(cn105_protocol::WideVane::SWING);
         }
         break;
 
     case climate::CLIMATE_SWING_BOTH:
         // Turn on vertical swing.
-        this->setVaneSetting("SWING");
+        this->setVaneSetting(cn105_protocol::Vane::SWING);
         // Turn on horizontal swing, but only if the unit supports it.
         if (wideVaneSupported) {
-            this->setWideVaneSetting("SWING");
+            this->setWideVaneSetting(cn105_protocol::WideVane::SWING);
         }
         break;
 
@@ -341,30 +342,30 @@ void CN105Climate::controlFan() {
 
     switch (this->fan_mode.value()) {
     case climate::CLIMATE_FAN_OFF:
-        this->setPowerSetting("OFF");
+        this->setPowerSetting(cn105_protocol::Power::OFF);
         break;
     case climate::CLIMATE_FAN_QUIET:
-        this->setFanSpeed("QUIET");
+        this->setFanSpeed(cn105_protocol::Fan::QUIET);
         break;
     case climate::CLIMATE_FAN_DIFFUSE:
-        this->setFanSpeed("QUIET");
+        this->setFanSpeed(cn105_protocol::Fan::QUIET);
         break;
     case climate::CLIMATE_FAN_LOW:
-        this->setFanSpeed("1");
+        this->setFanSpeed(cn105_protocol::Fan::SPEED_1);
         break;
     case climate::CLIMATE_FAN_MEDIUM:
-        this->setFanSpeed("2");
+        this->setFanSpeed(cn105_protocol::Fan::SPEED_2);
         break;
     case climate::CLIMATE_FAN_MIDDLE:
-        this->setFanSpeed("3");
+        this->setFanSpeed(cn105_protocol::Fan::SPEED_3);
         break;
     case climate::CLIMATE_FAN_HIGH:
-        this->setFanSpeed("4");
+        this->setFanSpeed(cn105_protocol::Fan::SPEED_4);
         break;
     case climate::CLIMATE_FAN_ON:
     case climate::CLIMATE_FAN_AUTO:
     default:
-        this->setFanSpeed("AUTO");
+        this->setFanSpeed(cn105_protocol::Fan::AUTO);
         break;
     }
 }
@@ -474,42 +475,42 @@ void CN105Climate::controlMode() {
     switch (this->mode) {
     case climate::CLIMATE_MODE_COOL:
         ESP_LOGI("control", "changing mode to COOL");
-        this->setModeSetting("COOL");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::COOL);
+        this->setPowerSetting(cn105_protocol::Power::ON);
         break;
     case climate::CLIMATE_MODE_HEAT:
         ESP_LOGI("control", "changing mode to HEAT");
-        this->setModeSetting("HEAT");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::HEAT);
+        this->setPowerSetting(cn105_protocol::Power::ON);
 
         break;
     case climate::CLIMATE_MODE_DRY:
         ESP_LOGI("control", "changing mode to DRY");
-        this->setModeSetting("DRY");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::DRY);
+        this->setPowerSetting(cn105_protocol::Power::ON);
 
         break;
 
     case climate::CLIMATE_MODE_HEAT_COOL:
         ESP_LOGI("control", "changing mode to HEAT_COOL (hardware AUTO)");
-        this->setModeSetting("AUTO");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::AUTO);
+        this->setPowerSetting(cn105_protocol::Power::ON);
         break;
 
     case climate::CLIMATE_MODE_AUTO:
         ESP_LOGI("control", "changing mode to AUTO");
-        this->setModeSetting("AUTO");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::AUTO);
+        this->setPowerSetting(cn105_protocol::Power::ON);
 
         break;
     case climate::CLIMATE_MODE_FAN_ONLY:
         ESP_LOGI("control", "changing mode to FAN_ONLY");
-        this->setModeSetting("FAN");
-        this->setPowerSetting("ON");
+        this->setModeSetting(cn105_protocol::Mode::FAN);
+        this->setPowerSetting(cn105_protocol::Power::ON);
         break;
     case climate::CLIMATE_MODE_OFF:
         ESP_LOGI("control", "changing mode to OFF");
-        this->setPowerSetting("OFF");
+        this->setPowerSetting(cn105_protocol::Power::OFF);
         break;
     default:
         ESP_LOGW("control", "unsupported mode");
@@ -521,13 +522,13 @@ void CN105Climate::setActionIfOperatingTo(climate::ClimateAction action_if_opera
 
     // Determine if stage indicates activity (for fallback logic)
     bool stage_is_active = this->use_stage_for_operating_status_ &&
-        this->currentSettings.stage != nullptr &&
-        strcmp(this->currentSettings.stage, STAGE_MAP[0 /*IDLE*/]) != 0;
+        is_set(this->currentSettings.stage) &&
+        this->currentSettings.stage != cn105_protocol::Stage::STAGE_IDLE;
 
     ESP_LOGD(LOG_OPERATING_STATUS_TAG, "Setting action (operating: %s, stage_fallback_enabled: %s, stage: %s, stage_is_active: %s)",
         this->currentStatus.operating ? "true" : "false",
         this->use_stage_for_operating_status_ ? "yes" : "no",
-        getIfNotNull(this->currentSettings.stage, "N/A"),
+        getIfNotNull(to_label(this->currentSettings.stage), "N/A"),
         stage_is_active ? "yes" : "no");
 
     // True fallback logic: operating OR (fallback enabled AND stage is active)
@@ -539,7 +540,7 @@ void CN105Climate::setActionIfOperatingTo(climate::ClimateAction action_if_opera
     } else if (stage_is_active) {
         // Fallback: compressor not running but stage indicates activity (e.g., gas heating)
         this->action = action_if_operating;
-        ESP_LOGD(LOG_OPERATING_STATUS_TAG, "Action set by stage fallback (stage: %s)", this->currentSettings.stage);
+        ESP_LOGD(LOG_OPERATING_STATUS_TAG, "Action set by stage fallback (stage: %s)", to_label(this->currentSettings.stage));
     } else {
         // Neither operating nor stage indicates activity
         this->action = climate::CLIMATE_ACTION_IDLE;
@@ -663,58 +664,64 @@ climate::ClimateTraits& CN105Climate::config_traits() {
 }
 
 
-void CN105Climate::setModeSetting(const char* setting) {
-    int index = lookupByteMapIndex(MODE_MAP, 5, setting);
-    if (index > -1) {
-        wantedSettings.mode = MODE_MAP[index];
-    } else {
-        wantedSettings.mode = MODE_MAP[0];
+namespace {
+    // Label from a select or a YAML lambda -> entry. Unknown labels fall back to the first entry, as before.
+    template <typename Table, size_t N>
+    auto entryOrFirst(const Table& table, const char* (&labels)[N], const char* setting, const char* field) {
+        auto entry = table.find(labels, setting);
+        if (!entry) {
+            ESP_LOGW("lookup", "%s caution value %s not found, using %s", field, setting ? setting : "NULL", labels[0]);
+        }
+        return entry.value_or(static_cast<typename decltype(entry)::value_type>(0));
     }
 }
 
+void CN105Climate::setModeSetting(cn105_protocol::Mode setting) {
+    wantedSettings.mode = MODE_TABLE.has(setting) ? setting : cn105_protocol::Mode::HEAT;
+}
+
+void CN105Climate::setModeSetting(const char* setting) {
+    this->setModeSetting(entryOrFirst(MODE_TABLE, MODE_MAP, setting, "mode"));
+}
+
+void CN105Climate::setPowerSetting(cn105_protocol::Power setting) {
+    wantedSettings.power = POWER_TABLE.has(setting) ? setting : cn105_protocol::Power::OFF;
+}
+
 void CN105Climate::setPowerSetting(const char* setting) {
-    int index = lookupByteMapIndex(POWER_MAP, 2, setting);
-    if (index > -1) {
-        wantedSettings.power = POWER_MAP[index];
-    } else {
-        wantedSettings.power = POWER_MAP[0];
-    }
+    this->setPowerSetting(entryOrFirst(POWER_TABLE, POWER_MAP, setting, "power"));
+}
+
+void CN105Climate::setFanSpeed(cn105_protocol::Fan setting) {
+    wantedSettings.fan = FAN_TABLE.has(setting) ? setting : cn105_protocol::Fan::AUTO;
 }
 
 void CN105Climate::setFanSpeed(const char* setting) {
-    int index = lookupByteMapIndex(FAN_MAP, 6, setting);
-    if (index > -1) {
-        wantedSettings.fan = FAN_MAP[index];
-    } else {
-        wantedSettings.fan = FAN_MAP[0];
-    }
+    this->setFanSpeed(entryOrFirst(FAN_TABLE, FAN_MAP, setting, "fan"));
+}
+
+void CN105Climate::setVaneSetting(cn105_protocol::Vane setting) {
+    wantedSettings.vane = VANE_TABLE.has(setting) ? setting : cn105_protocol::Vane::AUTO;
 }
 
 void CN105Climate::setVaneSetting(const char* setting) {
-    int index = lookupByteMapIndex(VANE_MAP, 7, setting);
-    if (index > -1) {
-        wantedSettings.vane = VANE_MAP[index];
-    } else {
-        wantedSettings.vane = VANE_MAP[0];
-    }
+    this->setVaneSetting(entryOrFirst(VANE_TABLE, VANE_MAP, setting, "vane"));
+}
+
+void CN105Climate::setWideVaneSetting(cn105_protocol::WideVane setting) {
+    wantedSettings.wideVane = WIDEVANE_TABLE.has(setting) ? setting : cn105_protocol::WideVane::FAR_LEFT;
 }
 
 void CN105Climate::setWideVaneSetting(const char* setting) {
-    int index = lookupByteMapIndex(WIDEVANE_MAP, 8, setting);
-    if (index > -1) {
-        wantedSettings.wideVane = WIDEVANE_MAP[index];
-    } else {
-        wantedSettings.wideVane = WIDEVANE_MAP[0];
-    }
+    this->setWideVaneSetting(entryOrFirst(WIDEVANE_TABLE, WIDEVANE_MAP, setting, "wideVane"));
+}
+
+void CN105Climate::setAirflowControlSetting(cn105_protocol::AirflowControl setting) {
+    wantedRunStates.airflow_control = AIRFLOW_CONTROL_TABLE.has(setting) ? setting : cn105_protocol::AirflowControl::EVEN;
 }
 
 void CN105Climate::setAirflowControlSetting(const char* setting) {
-    int index = lookupByteMapIndex(AIRFLOW_CONTROL_MAP, 3, setting);
-    if (index > -1) {
-        wantedRunStates.airflow_control = AIRFLOW_CONTROL_MAP[index];
-    } else {
-        wantedRunStates.airflow_control = AIRFLOW_CONTROL_MAP[0];
-    }
+    this->setAirflowControlSetting(entryOrFirst(AIRFLOW_CONTROL_TABLE, AIRFLOW_CONTROL_MAP, setting, "airflow control"));
 }
 
 void CN105Climate::set_remote_temperature(float setting) {
@@ -726,6 +733,10 @@ void CN105Climate::set_remote_temperature(float setting) {
     // Toujours renvoyer la température distante lorsqu’un nouvel échantillon arrive,
     // même si la valeur n’a pas changé, afin d’éviter que l’unité Mitsubishi
     // ne repasse sur la sonde interne faute de mise à jour régulière (#474).
+    if (setting != this->last_remote_temp_sent_) {
+        // an unchanged value is debounced or only refreshes the keep-alive: not a command to time
+        this->commandLatency_.control(CommandKind::REMOTE_TEMP, CUSTOM_MILLIS);
+    }
     this->remoteTemperature_ = setting;
     this->shouldSendExternalTemperature_ = true;
     ESP_LOGD(LOG_REMOTE_TEMP, "setting remote temperature to %f", this->remoteTemperature_);
@@ -33,10 +33,6 @@ CN105Climate::CN105Climate(uart::UARTComponent* uart) :
     scheduler_(
         // send callback: send a packet via buildAndSendInfoPacket
         [this](uint8_t code) { this->buildAndSendInfoPacket(code); },
-        // timeout_callback: uses set_timeout from component
-        [this](const std::string& name, uint32_t timeout_ms, std::function<void()> callback) {
-            this->set_timeout(name.c_str(), timeout_ms, std::move(callback));
-        },
         // terminate_callback: completes the cycle
         [this]() { this->terminateCycle(); },
         // context_callback: Returns 'this' for the 'canSend' and 'onResponse' callbacks.
@@ -86,6 +82,8 @@ CN105Climate::CN105Climate(uart::UARTComponent* uart) :
     this->remote_temp_timeout_ = 4294967295;    // uint32_t max
     this->generateExtraComponents();
     this->loopCycle.init();
+    // queued SET writes (settings, run states, functions) are performed when they reach the head of the queue
+    this->scheduler_.set_write_callback([this](uint8_t write_id) { return this->performQueuedWrite(write_id); });
     this->wantedSettings.resetSettings();
     this->wantedRunStates.resetSettings();
 #ifndef USE_ESP32
@@ -95,135 +93,170 @@ CN105Climate::CN105Climate(uart::UARTComponent* uart) :
     // Register info requests moved to setup() to ensure hardware_settings_ are populated
 }
 
-void CN105Climate::registerInfoRequests() {
-    scheduler_.clear_requests();
-
+// INFO request catalogue: constexpr descriptors (flash on ESP32), only RequestState lives in RAM.
+// Registration order breaks due-time ties (0x20 before 0x22).
+constexpr RequestDescriptor CN105Climate::INFO_REQUESTS[] = {
     // 0x02 Settings
-    InfoRequest r_settings("settings", "Settings", 0x02, 3, 0);
-    r_settings.onResponse = [this](CN105Climate& self) { (void)self; this->getSettingsFromResponsePacket(); };
-    scheduler_.register_request(r_settings);
+    RequestDescriptor("settings", "Settings", 0x02, 3, 0)
+        .polled(PollClass::STRETCH_WHEN_STABLE)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) { self.getSettingsFromResponsePacket(frame); }),
 
     // 0x03 Room temperature
-    InfoRequest r_room("room_temp", "Room temperature", 0x03, 3, 0);
-    r_room.onResponse = [this](CN105Climate& self) { (void)self; this->getRoomTemperatureFromResponsePacket(); };
-    scheduler_.register_request(r_room);
+    RequestDescriptor("room_temp", "Room temperature", 0x03, 3, 0)
+        .polled(PollClass::FAST_WHEN_ACTIVE)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) {
+            self.getRoomTemperatureFromResponsePacket(frame);
+            self.updatePollingActivity();
+            }),
 
     // 0x06 Status
-    InfoRequest r_status("status", "Status", 0x06, 3, 0);
-    r_status.onResponse = [this](CN105Climate& self) { (void)self; this->getOperatingAndCompressorFreqFromResponsePacket(); };
-    scheduler_.register_request(r_status);
+    RequestDescriptor("status", "Status", 0x06, 3, 0)
+        .polled(PollClass::FAST_WHEN_ACTIVE)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) {
+            self.getOperatingAndCompressorFreqFromResponsePacket(frame);
+            self.updatePollingActivity();
+            }),
 
     // 0x09 Standby/Power
-    InfoRequest r_power("standby", "Power/Standby", 0x09, 3, 500);
-    r_power.onResponse = [this](CN105Climate& self) { (void)self; this->getPowerFromResponsePacket(); };
-    scheduler_.register_request(r_power);
+    RequestDescriptor("standby", "Power/Standby", 0x09, 3, 500)
+        .polled(PollClass::STRETCH_WHEN_STABLE)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) { self.getPowerFromResponsePacket(frame); }),
 
     // 0x42 HVAC options
-    InfoRequest r_hvac_opts("hvac_options", "HVAC options", 0x42, 3, 500);
-    r_hvac_opts.canSend = [this](const CN105Climate& self) {
-        (void)self;
-        return (this->air_purifier_switch_ != nullptr || this->night_mode_switch_ != nullptr || this->circulator_switch_ != nullptr);
-        };
-    r_hvac_opts.onResponse = [this](CN105Climate& self) { (void)self; this->getHVACOptionsFromResponsePacket(); };
-    scheduler_.register_request(r_hvac_opts);
+    RequestDescriptor("hvac_options", "HVAC options", 0x42, 3, 500)
+        .polled(PollClass::STRETCH_WHEN_STABLE)
+        .can_send([](const CN105Climate& self) {
+            return (self.air_purifier_switch_ != nullptr || self.night_mode_switch_ != nullptr || self.circulator_switch_ != nullptr);
+            })
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) { self.getHVACOptionsFromResponsePacket(frame); }),
 
     // Placeholders
-    InfoRequest r_error_info("error_info", "Error Info", 0x04, 3, 0);
-    r_error_info.onResponse = [this](CN105Climate& self) { (void)self; this->getErrorInfoFromResponsePacket(); };
-    scheduler_.register_request(r_error_info);
+    RequestDescriptor("error_info", "Error Info", 0x04, 3, 0)
+        .polled(PollClass::STRETCH_WHEN_STABLE)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) { self.getErrorInfoFromResponsePacket(frame); }),
+
+    RequestDescriptor("timers", "Timers", 0x05, 1, 0)
+        .start_disabled()
+        .on_response([](CN105Climate&, const cn105_protocol::FrameView&) {
+            ESP_LOGW("Decoder", "[0x05 is Timer : not implemented]");
+            }),
+};
+
+// 0x20/0x22: interval and enabled state come from `hardware_settings` (registerHardwareSettingsRequests())
+constexpr RequestDescriptor CN105Climate::FUNCTIONS_REQUESTS[] = {
+    // --- Part 1 (0x20) ---
+    RequestDescriptor("functions1", "Functions Part 1", 0x20, 3, 0, 0, LOG_FUNCTIONS_TAG)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) {
+            // Log the raw packet and decoded pairs even if the unit returns all zeros
+            self.hpPacketDebug(frame.payload, frame.length, "RX 0x20");
+            self.hpFunctionsDebug(frame.payload, frame.length);
+            if (CN105Climate::checkFunctionsResponse(self, frame, 0x20)) {
+                self.functions.setData1(&frame.payload[1]);
+                ESP_LOGD(LOG_FUNCTIONS_TAG, "Got functions packet 1 (via request catalogue)");
+            }
+            }),
 
-    InfoRequest r_timers("timers", "Timers", 0x05, 1, 0);
-    r_timers.disabled = true;
-    scheduler_.register_request(r_timers);
+    // --- Part 2 (0x22) ---
+    RequestDescriptor("functions2", "Functions Part 2", 0x22, 3, 0, 0, LOG_FUNCTIONS_TAG)
+        .on_response([](CN105Climate& self, const cn105_protocol::FrameView& frame) {
+            // Log the raw packet and decoded pairs even if the unit returns all zeros
+            self.hpPacketDebug(frame.payload, frame.length, "RX 0x22");
+            self.hpFunctionsDebug(frame.payload, frame.length);
+            if (CN105Climate::checkFunctionsResponse(self, frame, 0x22)) {
+                self.functions.setData2(&frame.payload[1]);
+                ESP_LOGD(LOG_FUNCTIONS_TAG, "Got functions packet 2 (via request catalogue)");
+                self.functionsArrived();
+            }
+            }),
+};
+
+void CN105Climate::registerInfoRequests() {
+    scheduler_.clear_requests();
+    scheduler_.register_requests(INFO_REQUESTS, sizeof(INFO_REQUESTS) / sizeof(INFO_REQUESTS[0]));
+
+    // Replies answered but never polled
+    scheduler_.register_response_handler(0x10, [](CN105Climate&, const cn105_protocol::FrameView&) {
+        ESP_LOGD("Decoder", "[0x10 is Unknown : not implemented]");
+        });
 
     // Call to the new dedicated method.
     this->registerHardwareSettingsRequests();
-}
 
-void CN105Climate::registerHardwareSettingsRequests() {
-    uint32_t interval = 0;
-    bool is_enabled = false;
+    this->scheduler_.set_adaptive_polling(this->adaptive_polling_, this->get_update_interval());
+}
 
-    if (!this->hardware_settings_.empty()) {
-        ESP_LOGI(LOG_FUNCTIONS_TAG, "Registering function settings requests (0x20/0x22) with interval %u ms", this->hardware_settings_interval_ms_);
-        interval = this->hardware_settings_interval_ms_;
-        is_enabled = true;
-    }
-    else {
-        ESP_LOGI(LOG_FUNCTIONS_TAG, "Registering function settings requests (0x20/0x22), disabled");
+/**
+ * Adaptive polling input: the unit is "active" while the compressor runs or while the
+ * room temperature has changed within the last ADAPTIVE_TEMP_MOVING_MS.
+ */
+void CN105Climate::updatePollingActivity() {
+    const float room = this->currentStatus.roomTemperature;
+    if (!std::isnan(room)) {
+        if (!std::isnan(this->activityRoomTemp_) && room != this->activityRoomTemp_) {
+            this->roomTempChangedMs_ = CUSTOM_MILLIS;
+        }
+        this->activityRoomTemp_ = room;
     }
+    const bool compressor_running = this->currentStatus.compressorFrequency > 0;
+    const bool temp_moving = (this->roomTempChangedMs_ != 0) &&
+        (CUSTOM_MILLIS - this->roomTempChangedMs_ < ADAPTIVE_TEMP_MOVING_MS);
+    this->scheduler_.set_unit_active(compressor_running || temp_moving);
+}
 
-    // Helper Lambda: Checks for incompatibility and disables everything if necessary.
-    auto check_and_disable = [](CN105Climate& self, uint8_t code) -> bool {
-        if (self.data[0] != code) return false;
-
-        bool all_zeros = true;
-        // On some units (e.g. SEZ), codes may be present with a value of zero as long as the session
-        // is not in installer mode. The presence of the byte (code+value) just validate the support.
-        for (int i = 1; i < self.parser_.data_length(); i++) {
-            if (self.data[i] != 0) {
-                all_zeros = false;
-                break;
-            }
+/**
+ * Validates a 0x20/0x22 functions response: an all-zero payload means the unit does not support
+ * the feature, so the request is disabled and the hardware setting selects are marked unavailable.
+ */
+bool CN105Climate::checkFunctionsResponse(CN105Climate& self, const cn105_protocol::FrameView& frame, uint8_t code) {
+    if (frame[0] != code) return false;
+
+    bool all_zeros = true;
+    // On some units (e.g. SEZ), codes may be present with a value of zero as long as the session
+    // is not in installer mode. The presence of the byte (code+value) just validate the support.
+    for (int i = 1; i < frame.length; i++) {
+        if (frame[i] != 0) {
+            all_zeros = false;
+            break;
         }
+    }
 
-        if (all_zeros) {
-            ESP_LOGW(LOG_FUNCTIONS_TAG, "Response 0x%02X contains only zeros. Feature not supported by unit. Disabling.", code);
-
-            // 1. Do activate the request via the scheduler.
-            self.scheduler_.disable_request(code);
+    if (all_zeros) {
+        ESP_LOGW(LOG_FUNCTIONS_TAG, "Response 0x%02X contains only zeros. Feature not supported by unit. Disabling.", code);
 
-            // 2. Mark graphics components as failed (unavailable).
-            ESP_LOGD(LOG_FUNCTIONS_TAG, "Marking Hardware Setting Selects as failed.");
-            for (auto* setting : self.hardware_settings_) {
-                setting->set_enabled(false);
-            }
+        // 1. Do activate the request via the scheduler.
+        self.scheduler_.disable_request(code);
 
-            return false;
+        // 2. Mark graphics components as failed (unavailable).
+        ESP_LOGD(LOG_FUNCTIONS_TAG, "Marking Hardware Setting Selects as failed.");
+        for (auto* setting : self.hardware_settings_) {
+            setting->set_enabled(false);
         }
 
-        // If no hardware settings are defined in YAML this was a manual request
-        // that is expected to run once, disable future requests.
-        if (self.hardware_settings_.empty()) {
-            self.scheduler_.disable_request(code);
-        }
-
-        return true;
-        };
+        return false;
+    }
 
-    // --- Part 1 (0x20) ---
-    InfoRequest r_funcs1("functions1", "Functions Part 1", 0x20, 3, 0, interval, LOG_FUNCTIONS_TAG);
-    r_funcs1.onResponse = [this, check_and_disable](CN105Climate& self) {
-        // Log the raw packet and decoded pairs even if the unit returns all zeros
-        self.hpPacketDebug(self.data, self.parser_.data_length(), "RX 0x20");
-        self.hpFunctionsDebug(self.data, self.parser_.data_length());
-        if (check_and_disable(self, 0x20)) {
-            self.functions.setData1(&self.data[1]);
-            ESP_LOGD(LOG_FUNCTIONS_TAG, "Got functions packet 1 (via InfoRequest)");
-        }
-        };
-    scheduler_.register_request(r_funcs1);
-    if (!is_enabled) {
-        scheduler_.disable_request(0x20);
+    // If no hardware settings are defined in YAML this was a manual request
+    // that is expected to run once, disable future requests.
+    if (self.hardware_settings_.empty()) {
+        self.scheduler_.disable_request(code);
     }
 
-    // --- Part 2 (0x22) ---
-    InfoRequest r_funcs2("functions2", "Functions Part 2", 0x22, 3, 0, interval, LOG_FUNCTIONS_TAG);
-    r_funcs2.onResponse = [this, check_and_disable](CN105Climate& self) {
-        // Log the raw packet and decoded pairs even if the unit returns all zeros
-        self.hpPacketDebug(self.data, self.parser_.data_length(), "RX 0x22");
-        self.hpFunctionsDebug(self.data, self.parser_.data_length());
-        if (check_and_disable(self, 0x22)) {
-            self.functions.setData2(&self.data[1]);
-            ESP_LOGD(LOG_FUNCTIONS_TAG, "Got functions packet 2 (via InfoRequest)");
-            self.functionsArrived();
-        }
-        };
-    scheduler_.register_request(r_funcs2);
-    if (!is_enabled) {
+    return true;
+}
+
+void CN105Climate::registerHardwareSettingsRequests() {
+    scheduler_.register_requests(FUNCTIONS_REQUESTS, sizeof(FUNCTIONS_REQUESTS) / sizeof(FUNCTIONS_REQUESTS[0]));
+
+    if (!this->hardware_settings_.empty()) {
+        ESP_LOGI(LOG_FUNCTIONS_TAG, "Registering function settings requests (0x20/0x22) with interval %u ms", this->hardware_settings_interval_ms_);
+        scheduler_.set_request_interval(0x20, this->hardware_settings_interval_ms_);
+        scheduler_.set_request_interval(0x22, this->hardware_settings_interval_ms_);
+    }
+    else {
+        ESP_LOGI(LOG_FUNCTIONS_TAG, "Registering function settings requests (0x20/0x22), disabled");
+        scheduler_.disable_request(0x20);
         scheduler_.disable_request(0x22);
     }
-
 }
 
 // The sendInfoRequest, markResponseSeenFor, sendNextAfter, and processInfoResponse methods
@@ -369,6 +402,7 @@ void CN105Climate::setupUART() {
         ESP_LOGI(LOG_CONN_TAG, "UART configured as SERIAL_8E1");
         this->transition_to_(DriverState::CONNECTING);
         this->parser_.reset();
+        this->rx_frames_.clear();
     } else {
         ESP_LOGW(LOG_CONN_TAG, "UART is not configured as SERIAL_8E1");
     }
@@ -381,6 +415,10 @@ void CN105Climate::setHeatpumpConnected(bool state) {
     } else if (state_ == DriverState::CONNECTED) {
         this->transition_to_(DriverState::DISCONNECTED);
     }
+    if (!state) {
+        this->commandLatency_.reset_link();   // the ACKs of writes still outstanding will never come
+        this->stateFreshness_.linkLost(CUSTOM_MILLIS);
+    }
     if (this->hp_uptime_connection_sensor_ != nullptr) {
         if (state) {
             this->hp_uptime_connection_sensor_->start();
@@ -403,13 +441,20 @@ void CN105Climate::disconnectUART() {
 
 void CN105Climate::reconnectUART() {
     ESP_LOGD(TAG, "reconnectUART()");
+    if (this->handshake_.in_progress()) {
+        // a CONNECT is already awaited or scheduled by runHandshake_()
+        return;
+    }
     this->lastReconnectTimeMs = CUSTOM_MILLIS;
+    this->reinitUART_();
+    // CONNECT goes out from loop() after the first backoff step, not from here
+    this->handshake_.link_lost(CUSTOM_MILLIS);
+}
+
+void CN105Climate::reinitUART_() {
     this->disconnectUART();
-    // Disabled: Low-level UART fallback (ESP-IDF 5.4.x) can interfere with the
-    // handshake/fallback tests. We let UARTComponent generate the standard reset.
     this->force_low_level_uart_reinit();
     this->setupUART();
-    this->sendFirstConnectionPacket();
 }
 
 
@@ -417,7 +462,7 @@ void CN105Climate::reconnectIfConnectionLost() {
 
     long reconnectTimeMs = CUSTOM_MILLIS - this->lastReconnectTimeMs;
 
-    if (reconnectTimeMs < this->update_interval_) {
+    if (this->handshake_.in_progress() || reconnectTimeMs < this->update_interval_) {
         return;
     }
 
@@ -461,7 +506,6 @@ void CN105Climate::force_low_level_uart_reinit() {
     // We reconfigure in-place and sanitize the GPIOs
     if (this->tx_pin_ >= 0) gpio_reset_pin((gpio_num_t)this->tx_pin_);
     if (this->rx_pin_ >= 0) gpio_reset_pin((gpio_num_t)this->rx_pin_);
-    CUSTOM_DELAY(2);
 
     // Settings SERIAL_8E1 @ 2400 bauds (values ​​from the UARTComponent config)
     uart_config_t cfg = {};
@@ -490,8 +534,10 @@ void CN105Climate::force_low_level_uart_reinit() {
     // Ensure classic UART mode
     uart_set_mode(port, UART_MODE_UART);
 
-    // Wait for any TX in progress to finish (if driver already installed)
-    uart_wait_tx_done(port, pdMS_TO_TICKS(20));
+    // No wait for a TX in progress: this runs from loop(), and a CONNECT is only written after it
+    if (uart_wait_tx_done(port, 0) == ESP_ERR_TIMEOUT) {
+        ESP_LOGD(TAG, "UART TX still busy during reinit, not waiting");
+    }
 
     // Fix UART clock source (lower bits may be sensitive)
 #if defined(UART_SCLK_XTAL)
@@ -511,7 +557,6 @@ void CN105Climate::force_low_level_uart_reinit() {
 
     // Purge buffers to avoid residue
     uart_flush_input(port);
-    CUSTOM_DELAY(2);
 
     // Diagnostics
     uint32_t eff_baud = 0;
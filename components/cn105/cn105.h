@@ -2,6 +2,9 @@
 #include "Globals.h"
 #include "cn105_protocol.h"
 #include "frame_parser.h"
+#include "frame_queue.h"
+#include "response_decoders.h"
+#include "packet_builder.h"
 #include "esphome/components/uart/uart.h"
 #include "heatpumpFunctions.h"
 #include "van_orientation_select.h"
@@ -26,10 +29,17 @@
 #include "localization.h"
 #include "info_request.h"
 #include "request_scheduler.h"
+#include "command_latency.h"
+#include "handshake.h"
+#include "loop_profiler.h"
+#include "publish_coalescer.h"
+#include "state_snapshot.h"
+#include "frame_capture.h"
 #include <esphome/components/sensor/sensor.h>
 #include <esphome/components/button/button.h>
 #include <esphome/components/binary_sensor/binary_sensor.h>
 #include "cycle_management.h"
+#include <cstring>
 #include <vector>
 #include <map>
 
@@ -51,9 +61,6 @@ namespace esphome {
 
     const char* driver_state_to_str(DriverState s);
 
-    void log_info_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix = "");
-    void log_debug_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix = "");
-
     class CN105Climate : public climate::Climate, public Component, public esphome::uart::UARTDevice {
 
         //friend class VaneOrientationSelect;
@@ -112,6 +119,36 @@ namespace esphome {
         void set_remote_temperature_control_sensor(esphome::binary_sensor::BinarySensor* sensor);
         void set_remote_temperature_margin(float margin);
 
+        // command_latency: diagnostic sensors fed by commandLatency_ (percentile of each histogram, ms)
+        void set_command_latency_percentile(uint8_t pct) { this->command_latency_percentile_ = pct; }
+        void set_command_to_ack_sensor(esphome::sensor::Sensor* sensor) { this->command_to_ack_sensor_ = sensor; }
+        void set_command_to_confirm_sensor(esphome::sensor::Sensor* sensor) { this->command_to_confirm_sensor_ = sensor; }
+        void set_command_bus_sensor(esphome::sensor::Sensor* sensor) { this->command_bus_sensor_ = sensor; }
+
+        // deadband of a numeric sensor: republished only when it moves by more than max(absolute, relative × last)
+        void set_publish_deadband(PublishField field, float absolute, float relative) {
+            this->pendingPublish_.set_deadband(field, absolute, relative);
+        }
+        const PublishCoalescer& get_publish_coalescer() const { return this->pendingPublish_; }
+        const VersionedState<SettingsField>& get_settings_state() const { return this->settingsState_; }
+        const VersionedState<StatusField>& get_status_state() const { return this->statusState_; }
+
+#ifdef USE_CN105_LOOP_PROFILER
+        // loop_profiler: per-phase loop() timings, reported once per window
+        void set_loop_profiler_window(uint32_t window_ms) { this->loopProfiler_.set_window_ms(window_ms); }
+        void set_loop_profiler_report_sensor(esphome::text_sensor::TextSensor* sensor) { this->loop_profiler_report_sensor_ = sensor; }
+        void set_loop_profiler_max_sensor(esphome::sensor::Sensor* sensor) { this->loop_profiler_max_sensor_ = sensor; }
+        const LoopProfiler& get_loop_profiler() const { return this->loopProfiler_; }
+#endif
+
+#ifdef USE_CN105_FRAME_CAPTURE
+        // frame_capture: ring of the last raw RX/TX frames, dumped to the log as base64 on demand
+        void set_frame_capture_size(uint16_t frames) { this->frameCapture_.init(frames); }
+        void set_frame_capture_dump_button(FunctionsButton* button);
+        void dump_frame_capture();
+        const FrameCapture& get_frame_capture() const { return this->frameCapture_; }
+#endif
+
         //sensor::Sensor* compressor_frequency_sensor;
         binary_sensor::BinarySensor* iSee_sensor_ = nullptr;
         binary_sensor::BinarySensor* remote_temp_sensor_ = nullptr;
@@ -180,8 +217,20 @@ namespace esphome {
 
         bool hasChanged(const char* before, const char* now, const char* field, bool checkNotNull = false);
 
+        // StringRef variant: compared in place (no std::string copy on every 0x02 reply)
         inline bool hasChanged(esphome::StringRef before, const char* now, const char* field, bool checkNotNull = false) {
-            return hasChanged(std::string(before).c_str(), now, field, checkNotNull);
+            if (now == nullptr || before.empty()) {
+                return hasChanged("", now, field, checkNotNull);
+            }
+            const size_t n = before.size();
+            return strncmp(before.c_str(), now, n) != 0 || now[n] != '\0';
+        }
+
+        // Entry variant: an UNSET `now` counts as no value, like a null label
+        template <typename Entry>
+        bool hasChanged(Entry before, Entry now, const char* field, bool checkNotNull = false) {
+            if (!is_set(now)) return hasChanged(to_label(before), nullptr, field, checkNotNull);
+            return before != now;
         }
 
 
@@ -214,14 +263,14 @@ namespace esphome {
         bool isUARTReady_() const { return state_ >= DriverState::CONNECTING; }
         bool isHeatpumpConnected() const { return state_ == DriverState::CONNECTED; }
 
-        void sendWantedSettings();
-        void sendWantedSettingsDelegate();
+        bool sendWantedSettings();
+        bool sendWantedSettingsDelegate();
         // Use the temperature from an external sensor. Use
         // set_remote_temp(0) to switch back to the internal sensor.
         void set_remote_temperature(float);
         void sendRemoteTemperature();
-        void sendRemoteTemperaturePacket();  // Send packet only, without resetting watchdog
-        void sendWantedRunStates();
+        void sendRemoteTemperaturePacket();  // Queue packet only, without resetting watchdog
+        bool sendWantedRunStates();
         float getDeadbandAdjustedTemperature(float remoteTemperature);
 
         void set_remote_temp_timeout(uint32_t timeout);
@@ -266,17 +315,31 @@ namespace esphome {
         void controlSwing();
         // Bootstrap connexion CN105 en loop() (ÃÂ©vite de perdre les tout premiers logs OTA)
         void maybe_start_connection_();
+        void runHandshake_();         // CONNECT / reply timeout / backoff from loop(), never blocks
+        void reinitUART_();
 
         // DÃÂ©lai de grÃÂ¢ce configurable avant d'envoyer CONNECT (pour laisser le flux OTA s'attacher)
         void set_connection_bootstrap_delay(uint32_t delay_ms) { this->conn_bootstrap_delay_ms_ = delay_ms; }
 
+        // Warm reconnect: keep the last unit state across a link loss shorter than this (0 = always resync)
+        void set_warm_reconnect_window(uint32_t window_ms) { this->warm_reconnect_window_ms_ = window_ms; }
+
         // Mode installateur: utilise un handshake CONNECT ÃÂ©tendu (0x5B) au lieu du standard (0x5A)
         void set_installer_mode(bool mode) {
-            // Mode demandÃÂ© via YAML
-            this->installer_mode_ = mode;
-            // Mode effectivement utilisÃÂ©: peut tomber en fallback vers standard si la PAC ignore 0x5B
-            this->installer_mode_effective_ = mode;
-            this->installer_mode_fallback_done_ = false;
+            // Requested in YAML; the handshake falls back to standard (0x5A) if the unit ignores 0x5B
+            this->handshake_.set_installer_mode(mode);
+        }
+
+        // Number of INFO requests allowed in flight at once (1 = sequential, the historical behaviour)
+        void set_info_pipeline_window(uint8_t window) { this->scheduler_.set_pipeline_window(window); }
+
+        // Adaptive polling: fast 0x03/0x06 while active, stretched 0x02/0x09/0x04/0x42 while stable
+        void set_adaptive_polling(uint32_t fast_interval_ms, uint8_t stable_cycles, uint8_t max_stretch, uint8_t bus_budget_pct) {
+            this->adaptive_polling_.enabled = true;
+            this->adaptive_polling_.fast_interval_ms = fast_interval_ms;
+            this->adaptive_polling_.stable_cycles = stable_cycles;
+            this->adaptive_polling_.max_stretch = max_stretch;
+            this->adaptive_polling_.bus_budget_pct = bus_budget_pct;
         }
 
         // UnitÃÂ© de puissance brute envoyÃÂ©e par la PAC: false = Watts (dÃÂ©faut), true = BTU/s
@@ -297,6 +360,12 @@ namespace esphome {
         unsigned long nbCompleteCycles_ = 0;
         unsigned long nbCycles_ = 0;
         unsigned int nbHeatpumpConnections_ = 0;
+        // FrameParser noise diagnostics: frames recovered from a buffered 0xFC vs discarded
+        uint32_t get_parser_resyncs() const { return this->parser_.resync_count(); }
+        uint32_t get_parser_drops() const { return this->parser_.drop_count(); }
+        uint32_t get_short_responses() const { return this->shortResponses_; }
+        uint32_t get_unknown_responses() const { return this->scheduler_.get_unknown_responses(); }
+        const CommandTracker& get_command_latency() const { return this->commandLatency_; }
 
 
         void sendFirstConnectionPacket();
@@ -339,32 +408,41 @@ namespace esphome {
         }
 
         bool processInput(void);
-        void processDataPacket();
-        void getErrorInfoFromResponsePacket();
-    void getDataFromResponsePacket();
-        void getAutoModeStateFromResponsePacket(); //NET added
-        void getPowerFromResponsePacket(); //NET added
-        void getSettingsFromResponsePacket();
-        void getRoomTemperatureFromResponsePacket();
-        void getOperatingAndCompressorFreqFromResponsePacket();
-        void getHVACOptionsFromResponsePacket();
+        void drainFrames();
+        void processDataPacket(const cn105_protocol::FrameView& frame);
+        void getErrorInfoFromResponsePacket(const cn105_protocol::FrameView& frame);
+    void getDataFromResponsePacket(const cn105_protocol::FrameView& frame);
+        void getAutoModeStateFromResponsePacket(const cn105_protocol::FrameView& frame); //NET added
+        void getPowerFromResponsePacket(const cn105_protocol::FrameView& frame); //NET added
+        void getSettingsFromResponsePacket(const cn105_protocol::FrameView& frame);
+        void getRoomTemperatureFromResponsePacket(const cn105_protocol::FrameView& frame);
+        void getOperatingAndCompressorFreqFromResponsePacket(const cn105_protocol::FrameView& frame);
+        void getHVACOptionsFromResponsePacket(const cn105_protocol::FrameView& frame);
 
         void updateSuccess();
-        void processCommand();
+        void processCommand(const cn105_protocol::FrameView& frame);
 
         uint8_t checkSum(uint8_t bytes[], int len);
 
-        const char* getModeSetting();
-        const char* getPowerSetting();
-        const char* getVaneSetting();
-        const char* getWideVaneSetting();
-        const char* getAirflowControlSetting();
-        const char* getFanSpeedSetting();
+        // Wanted value if any, else the current one (UNSET until the first 0x02 read)
+        cn105_protocol::Mode getModeSetting();
+        cn105_protocol::Power getPowerSetting();
+        cn105_protocol::Vane getVaneSetting();
+        cn105_protocol::WideVane getWideVaneSetting();
+        cn105_protocol::AirflowControl getAirflowControlSetting();
+        cn105_protocol::Fan getFanSpeedSetting();
         float getTemperatureSetting();
         bool getAirPurifierRunState();
         bool getNightModeRunState();
         bool getCirculatorRunState();
 
+        void setModeSetting(cn105_protocol::Mode setting);
+        void setPowerSetting(cn105_protocol::Power setting);
+        void setVaneSetting(cn105_protocol::Vane setting);
+        void setWideVaneSetting(cn105_protocol::WideVane setting);
+        void setAirflowControlSetting(cn105_protocol::AirflowControl setting);
+        void setFanSpeed(cn105_protocol::Fan setting);
+        // Label variants (selects, YAML lambdas): case-insensitive, unknown labels fall back to the first entry
         void setModeSetting(const char* setting);
         void setPowerSetting(const char* setting);
         void setVaneSetting(const char* setting);
@@ -382,11 +460,11 @@ namespace esphome {
         int lookupByteMapIndex(const char* valuesMap[], int len, const char* lookupValue, const char* debugInfo = "");
         int lookupByteMapIndex(const int valuesMap[], int len, int lookupValue, const char* debugInfo = "");
 
-        void writePacket(uint8_t* packet, int length, bool checkIsActive = true);
+        bool writePacket(uint8_t* packet, int length, bool checkIsActive = true);
         void prepareInfoPacket(uint8_t* packet, int length);
         void prepareSetPacket(uint8_t* packet, int length);
 
-        void publishStateToHA(heatpumpSettings& settings);
+        void publishStateToHA(heatpumpSettings& settings, FieldMask changed);
         void publishWantedSettingsStateToHA();
         void publishWantedRunStatesStateToHA();
 
@@ -409,7 +487,7 @@ namespace esphome {
         void setActionIfOperatingTo(climate::ClimateAction action);
         void setActionIfOperatingAndCompressorIsActiveTo(climate::ClimateAction action);
         void hpPacketDebug(const uint8_t* packet, unsigned int length, const char* packetDirection, const char* log_prefix = "");
-        void hpFunctionsDebug(uint8_t* packet, unsigned int length);
+        void hpFunctionsDebug(const uint8_t* packet, unsigned int length);
 
         void debugSettings(const char* settingName, heatpumpSettings& settings);
         void debugSettings(const char* settingName, wantedHeatpumpSettings& settings);
@@ -418,7 +496,19 @@ namespace esphome {
         void debugClimate(const char* settingName);
 
 #ifndef USE_ESP32
-        void emulateMutex(const char* retryName, std::function<void()>&& f);
+        // Runs f under wantedSettingsMutex. Unlocked (the usual case): called inline, nothing allocated;
+        // locked: f is type-erased and retried through set_timeout by emulateMutexDeferred()
+        template <typename F>
+        void emulateMutex(const char* retryName, F&& f) {
+            if (!this->wantedSettingsMutex) {
+                this->wantedSettingsMutex = true;
+                f();
+                this->wantedSettingsMutex = false;
+                return;
+            }
+            this->emulateMutexDeferred(retryName, std::function<void()>(std::forward<F>(f)));
+        }
+        void emulateMutexDeferred(const char* retryName, std::function<void()>&& f);
 #endif
 
 
@@ -447,7 +537,44 @@ namespace esphome {
         // Orchestrateur des requÃÂªtes INFO
         RequestScheduler scheduler_;
         void registerInfoRequests();
+        void updatePollingActivity();
         void registerHardwareSettingsRequests();
+        static const RequestDescriptor INFO_REQUESTS[];         // constexpr catalogues, defined in cn105.cpp
+        static const RequestDescriptor FUNCTIONS_REQUESTS[];
+        static bool checkFunctionsResponse(CN105Climate& self, const cn105_protocol::FrameView& frame, uint8_t code);
+
+        // SET writes queued on scheduler_, performed by performQueuedWrite() when the line is free
+        enum QueuedWrite : uint8_t {
+            WRITE_SETTINGS = 0,         // 0x41/0x01 from wantedSettings (merges every change made before it goes out)
+            WRITE_RUN_STATES = 1,       // 0x41/0x08 from wantedRunStates
+            WRITE_REMOTE_TEMP = 2,      // 0x41/0x07 from remoteTemperature_
+            WRITE_FUNCTIONS_1 = 3,      // 0x41/0x1F
+            WRITE_FUNCTIONS_2 = 4,      // 0x41/0x21, after the ACK of part 1
+        };
+        uint8_t performQueuedWrite(uint8_t write_id);
+        CommandTracker commandLatency_;                 // HA control → write → 0x61 ACK → 0x02 readback
+        heatpumpSettings lastWrittenSettings_{};        // fields of the last SET 0x01, checked against the 0x02 readback
+        uint8_t command_latency_percentile_ = 95;
+        sensor::Sensor* command_to_ack_sensor_ = nullptr;
+        sensor::Sensor* command_to_confirm_sensor_ = nullptr;
+        sensor::Sensor* command_bus_sensor_ = nullptr;
+        void publishCommandLatency();
+        PublishCoalescer pendingPublish_;               // marked by the decoders, flushed once per cycle
+        VersionedState<SettingsField> settingsState_;   // change masks of the 0x02 decodes
+        VersionedState<StatusField> statusState_;       // change masks of the 0x03 / 0x06 decodes
+        void flushPublishes_();
+        void publishNumeric_(PublishField field, sensor::Sensor* sensor, float value);
+#ifdef USE_CN105_LOOP_PROFILER
+        LoopProfiler loopProfiler_;                     // CN105_PROFILE_PHASE() markers feed it
+        text_sensor::TextSensor* loop_profiler_report_sensor_ = nullptr;
+        sensor::Sensor* loop_profiler_max_sensor_ = nullptr;
+        void publishLoopProfile_();
+#endif
+#ifdef USE_CN105_FRAME_CAPTURE
+        FrameCapture frameCapture_;                     // CN105_CAPTURE_FRAME() markers feed it
+#endif
+        bool writeRemoteTemperaturePacket();
+        bool writeFunctionsPacket(uint8_t code);
 
 #ifdef USE_ESP32
         std::mutex wantedSettingsMutex;
@@ -479,7 +606,11 @@ namespace esphome {
         unsigned long lastReconnectTimeMs;
 
         cn105_protocol::FrameParser parser_;     // UART frame assembler (Phase 3A)
-        uint8_t* data;
+        cn105_protocol::FrameQueue<RX_FRAME_QUEUE_SIZE> rx_frames_;   // completed frames awaiting decode
+        uint32_t shortResponses_ = 0;                                // 0x62 replies under RESPONSE_DATA_LEN, not decoded
+        AdaptivePollingConfig adaptive_polling_{};      // disabled unless `adaptive_polling:` is set in YAML
+        float activityRoomTemp_ = NAN;                  // last room temperature seen by updatePollingActivity()
+        uint32_t roomTempChangedMs_ = 0;                // when it last changed (0 = never)
 
         // All fields are default-initialized via heatpumpStatus struct defaults (NAN, false, etc.)
         heatpumpStatus currentStatus{};
@@ -522,9 +653,10 @@ namespace esphome {
         uint32_t boot_ms_ = 0;
         uint32_t conn_bootstrap_delay_ms_{ 10000 };  // par dÃÂ©faut 10s
 
-        bool installer_mode_{ false };
-        bool installer_mode_effective_{ false };
-        bool installer_mode_fallback_done_{ false };
+        uint32_t warm_reconnect_window_ms_{ 300000 };
+        stateFreshness stateFreshness_;   // snapshot kept (stale) across short link losses, see warm_reconnect_window
+        void stateRefreshed_(uint8_t part);
+        HandshakeEngine handshake_;     // CONNECT retries/backoff and installer probe, driven by runHandshake_()
         bool power_unit_is_btu_{ false };  // true = la PAC envoie en BTU/s (nÃÂ©cessite conversion ÃÂ3.412)
         bool supports_dual_setpoint_ = false;
         int horizontal_vanes_{ 1 }; // Kept for legacy logging if needed, or can be removed if unused.
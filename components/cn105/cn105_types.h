@@ -3,9 +3,16 @@
 #include <cmath>
 #include <cstring>
 #include <string>
+#include "byte_maps.h"
 
 #define MAX_DATA_BYTES     64         
 #define MAX_DELAY_RESPONSE_FACTOR 10  
+#define UART_READ_CHUNK_SIZE 128      // stack buffer for one bulk UART read in processInput()
+#define RX_FRAME_QUEUE_SIZE 4         // FrameQueue slots between the parser and the decoders
+#define INFO_EXCHANGE_WIRE_MS 222     // 0x42 request + 0x62 reply at 2400 8E1 (2 × 22 bytes) + ~20 ms unit latency
+#define ADAPTIVE_TEMP_MOVING_MS 300000    // room temperature counts as "moving" this long after it last changed
+#define INFO_REPLY_SLOT_MS 110        // one 22-byte 0x62 reply at 2400 8E1 (~101 ms) + margin, per pipelined request queued ahead
+#define WRITE_ACK_TIMEOUT_MS 500      // wait for the 0x61 ACK of a SET packet before the scheduler moves on
 
 static const char* LOG_ACTION_EVT_TAG = "EVT_SETS";
 static const char* TAG = "CN105";
@@ -19,9 +26,10 @@ static const char* LOG_SET_RUN_STATE = "SET_RUN_STATE";
 static const char* LOG_OPERATING_STATUS_TAG = "OPERATING_STATUS";
 static const char* LOG_TEMP_SENSOR_TAG = "TEMP_SENSOR";
 static const char* LOG_DUAL_SP_TAG = "DUAL_SP";
-static const char* LOG_FUNCTIONS_TAG = "FUNCTIONS";
+static constexpr const char* LOG_FUNCTIONS_TAG = "FUNCTIONS";     // constexpr: used by the request catalogue
 static const char* LOG_HARDWARE_SELECT_TAG = "HardwareSelect";
 static const char* LOG_CONN_TAG = "CN105_CONN";
+static const char* LOG_CAPTURE_TAG = "CN105_CAPTURE";
 
 static const char* SHEDULER_REMOTE_TEMP_TIMEOUT = "->remote_temp_timeout";
 static const char* SCHEDULER_REMOTE_TEMP_KEEPALIVE = "->remote_temp_keepalive";
@@ -34,6 +42,7 @@ static const uint32_t RECEIVED_SETPOINT_GRACE_WINDOW_MS = 3000;
 static const uint32_t UI_SETPOINT_ANTIREBOUND_MS = 600;
 
 static const int PACKET_LEN = 22;
+static const int RESPONSE_DATA_LEN = 16;     // 0x62 replies always carry 16 data bytes; the decoders index up to data[15]
 static const int PACKET_TYPE_DEFAULT = 99;
 
 static const int CONNECT_LEN = 8;
@@ -68,35 +77,35 @@ static const uint8_t CONTROL_PACKET_1[5] = { 0x01,    0x02,  0x04,  0x08, 0x10 }
 static const uint8_t CONTROL_PACKET_2[1] = { 0x01 };
 static const uint8_t RUN_STATE_PACKET_1[5] = { 0x01, 0x04, 0x08, 0x10, 0x20 };
 static const uint8_t RUN_STATE_PACKET_2[5] = { 0x02, 0x04, 0x08, 0x10, 0x20 };
-static const uint8_t POWER[2] = { 0x00, 0x01 };
+inline constexpr uint8_t POWER[2] = { 0x00, 0x01 };
 static const char* POWER_MAP[2] = { "OFF", "ON" };
-static const uint8_t MODE[5] = { 0x01,   0x02,  0x03, 0x07, 0x08 };
+inline constexpr uint8_t MODE[5] = { 0x01,   0x02,  0x03, 0x07, 0x08 };
 static const char* MODE_MAP[5] = { "HEAT", "DRY", "COOL", "FAN", "AUTO" };
-static const uint8_t TEMP[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+inline constexpr uint8_t TEMP[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
 static const int TEMP_MAP[16] = { 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16 };
-static const uint8_t FAN[6] = { 0x00,  0x01,   0x02, 0x03, 0x05, 0x06 };
+inline constexpr uint8_t FAN[6] = { 0x00,  0x01,   0x02, 0x03, 0x05, 0x06 };
 static const char* FAN_MAP[6] = { "AUTO", "QUIET", "1", "2", "3", "4" };
-static const uint8_t VANE[7] = { 0x00,  0x01, 0x02, 0x03, 0x04, 0x05, 0x07 };
+inline constexpr uint8_t VANE[7] = { 0x00,  0x01, 0x02, 0x03, 0x04, 0x05, 0x07 };
 static const char* VANE_MAP[7] = { "AUTO", "↑↑", "↑", "—", "↓", "↓↓", "SWING" };
-static const uint8_t WIDEVANE[8] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x00 };
+inline constexpr uint8_t WIDEVANE[8] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x00 };
 static const char* WIDEVANE_MAP[8] = { "←←", "←", "|", "→", "→→", "←→", "SWING", "AIRFLOW CONTROL" };
-static const uint8_t ROOM_TEMP[32] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+inline constexpr uint8_t ROOM_TEMP[32] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
                                   0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f };
 static const int ROOM_TEMP_MAP[32] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
                                   26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41 };
 static const uint8_t TIMER_MODE[4] = { 0x00,  0x01,  0x02, 0x03 };
 static const char* TIMER_MODE_MAP[4] = { "NONE", "OFF", "ON", "BOTH" };
 
-static const uint8_t AIRFLOW_CONTROL[3] = { 0x00, 0x01, 0x02 };
+inline constexpr uint8_t AIRFLOW_CONTROL[3] = { 0x00, 0x01, 0x02 };
 static const char* AIRFLOW_CONTROL_MAP[3] = { "EVEN", "INDIRECT", "DIRECT" };
 
-static const uint8_t STAGE[7] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+inline constexpr uint8_t STAGE[7] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
 static const char* STAGE_MAP[7] = { "IDLE", "LOW", "GENTLE", "MEDIUM", "MODERATE", "HIGH", "DIFFUSE" };
 
 // 0x10 = OFF state, observed on MFZ-KX09NL / MFZ-KJ18NA when the unit is
 // powered off (data[3] of the 0x09 packet). Confirmed by correlation with
 // 0x02 data[3] (power) = 0x00 across every powered-off cycle.
-static const uint8_t SUB_MODE[6] = { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10 };
+inline constexpr uint8_t SUB_MODE[6] = { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10 };
 static const char* SUB_MODE_MAP[6] = { "NORMAL", "WARMUP", "DEFROST", "PREHEAT", "STANDBY", "OFF" };
 
 // 0x40 / 0x41 / 0x43 added for newer MFZ units, where data[5] of the 0x09
@@ -120,9 +129,23 @@ static const char* SUB_MODE_MAP[6] = { "NORMAL", "WARMUP", "DEFROST", "PREHEAT",
 // These labels are distinct from the older AUTO_COOL/AUTO_HEAT/AUTO_LEADER
 // labels which appear to belong to a different protocol revision (older units
 // where this byte was a 4-state enum rather than a bitfield).
-static const uint8_t AUTO_SUB_MODE[7] = { 0x00, 0x01, 0x02, 0x03, 0x40, 0x41, 0x43 };
+inline constexpr uint8_t AUTO_SUB_MODE[7] = { 0x00, 0x01, 0x02, 0x03, 0x40, 0x41, 0x43 };
 static const char* AUTO_SUB_MODE_MAP[7] = { "AUTO_OFF", "AUTO_COOL", "AUTO_HEAT", "AUTO_LEADER", "AUTO_INACTIVE", "AUTO_IDLE", "AUTO_ACTIVE" };
 
+// Decode / encode tables generated from the byte arrays above (byte_maps.h). Tables and byte arrays are
+// inline, not static: one definition per program instead of a copy in every translation unit (.rodata is RAM on ESP8266)
+inline constexpr auto POWER_TABLE = CN105_BYTE_MAP(cn105_protocol::Power, POWER);
+inline constexpr auto MODE_TABLE = CN105_BYTE_MAP(cn105_protocol::Mode, MODE);
+inline constexpr auto TEMP_TABLE = CN105_BYTE_MAP(uint8_t, TEMP);
+inline constexpr auto FAN_TABLE = CN105_BYTE_MAP(cn105_protocol::Fan, FAN);
+inline constexpr auto VANE_TABLE = CN105_BYTE_MAP(cn105_protocol::Vane, VANE);
+inline constexpr auto WIDEVANE_TABLE = CN105_BYTE_MAP(cn105_protocol::WideVane, WIDEVANE);
+inline constexpr auto ROOM_TEMP_TABLE = CN105_BYTE_MAP(uint8_t, ROOM_TEMP);
+inline constexpr auto AIRFLOW_CONTROL_TABLE = CN105_BYTE_MAP(cn105_protocol::AirflowControl, AIRFLOW_CONTROL);
+inline constexpr auto STAGE_TABLE = CN105_BYTE_MAP(cn105_protocol::Stage, STAGE);
+inline constexpr auto SUB_MODE_TABLE = CN105_BYTE_MAP(cn105_protocol::SubMode, SUB_MODE);
+inline constexpr auto AUTO_SUB_MODE_TABLE = CN105_BYTE_MAP(cn105_protocol::AutoSubMode, AUTO_SUB_MODE);
+
 static const int TIMER_INCREMENT_MINUTES = 10;
 
 static const uint8_t FUNCTIONS_SET_PART1 = 0x1F;
@@ -134,47 +157,75 @@ const uint8_t ESPMHP_MIN_TEMPERATURE = 16;
 const uint8_t ESPMHP_MAX_TEMPERATURE = 26;
 const float ESPMHP_TEMPERATURE_STEP = 0.5;
 
+// Labels of the setting entries, for Home Assistant (selects, text sensors) and logs only.
+// nullptr for UNSET, like the label pointers the settings held before.
+static inline const char* to_label(cn105_protocol::Power v) { return POWER_TABLE.label(POWER_MAP, v); }
+static inline const char* to_label(cn105_protocol::Mode v) { return MODE_TABLE.label(MODE_MAP, v); }
+static inline const char* to_label(cn105_protocol::Fan v) { return FAN_TABLE.label(FAN_MAP, v); }
+static inline const char* to_label(cn105_protocol::Vane v) { return VANE_TABLE.label(VANE_MAP, v); }
+static inline const char* to_label(cn105_protocol::WideVane v) { return WIDEVANE_TABLE.label(WIDEVANE_MAP, v); }
+static inline const char* to_label(cn105_protocol::AirflowControl v) { return AIRFLOW_CONTROL_TABLE.label(AIRFLOW_CONTROL_MAP, v); }
+static inline const char* to_label(cn105_protocol::Stage v) { return STAGE_TABLE.label(STAGE_MAP, v); }
+static inline const char* to_label(cn105_protocol::SubMode v) { return SUB_MODE_TABLE.label(SUB_MODE_MAP, v); }
+static inline const char* to_label(cn105_protocol::AutoSubMode v) { return AUTO_SUB_MODE_TABLE.label(AUTO_SUB_MODE_MAP, v); }
+
+template <typename Entry>
+constexpr bool is_set(Entry v) { return v != Entry::UNSET; }
+
+// Entries first: 10 bytes, then the three floats (24 bytes in all, was 8 label pointers + floats)
 struct heatpumpSettings {
-    const char* power = nullptr;
-    const char* mode = nullptr;
+    cn105_protocol::Power power = cn105_protocol::Power::UNSET;
+    cn105_protocol::Mode mode = cn105_protocol::Mode::UNSET;
+    cn105_protocol::Fan fan = cn105_protocol::Fan::UNSET;
+    cn105_protocol::Vane vane = cn105_protocol::Vane::UNSET;
+    cn105_protocol::WideVane wideVane = cn105_protocol::WideVane::UNSET;
+    cn105_protocol::Stage stage = cn105_protocol::Stage::UNSET;
+    cn105_protocol::SubMode sub_mode = cn105_protocol::SubMode::UNSET;
+    cn105_protocol::AutoSubMode auto_sub_mode = cn105_protocol::AutoSubMode::UNSET;
+    bool iSee = false;
+    bool connected = false;
     float temperature = -1.0f;
     float dual_low_target = -100.0f;
     float dual_high_target = -100.0f;
-    const char* fan = nullptr;
-    const char* vane = nullptr;
-    const char* wideVane = nullptr;
-    bool iSee = false;
-    bool connected = false;
-    const char* stage = nullptr;
-    const char* sub_mode = nullptr;
-    const char* auto_sub_mode = nullptr;
 
     void resetSettings() {
-        power = nullptr;
-        mode = nullptr;
+        power = cn105_protocol::Power::UNSET;
+        mode = cn105_protocol::Mode::UNSET;
         temperature = -1.0f;
         dual_low_target = -100.0f;
         dual_high_target = -100.0f;
-        fan = nullptr;
-        vane = nullptr;
-        wideVane = nullptr;
+        fan = cn105_protocol::Fan::UNSET;
+        vane = cn105_protocol::Vane::UNSET;
+        wideVane = cn105_protocol::WideVane::UNSET;
     }
 
-    // Trivial copy — all members are scalars/pointers
+    // Trivial copy — all members are scalars
     heatpumpSettings& operator=(const heatpumpSettings& other) = default;
 
+    // One byte per entry: compared with & instead of && so the whole check is branch-free
     bool operator==(const heatpumpSettings& other) const {
-        return power == other.power &&
-            mode == other.mode &&
-            temperature == other.temperature &&
-            fan == other.fan &&
-            vane == other.vane &&
-            wideVane == other.wideVane;
+        return (power == other.power) &
+            (mode == other.mode) &
+            (temperature == other.temperature) &
+            (fan == other.fan) &
+            (vane == other.vane) &
+            (wideVane == other.wideVane);
     }
 
     bool operator!=(const heatpumpSettings& other) const {
         return !(this->operator==(other));
     }
+
+    // True when every field set in `written` (not UNSET / temperature > 0) reads back unchanged here:
+    // the 0x02 readback confirms a SET 0x01
+    bool confirms(const heatpumpSettings& written) const {
+        return (!is_set(written.power) || power == written.power) &&
+            (!is_set(written.mode) || mode == written.mode) &&
+            (written.temperature <= 0 || std::fabs(temperature - written.temperature) < ESPMHP_TEMPERATURE_STEP / 2) &&
+            (!is_set(written.fan) || fan == written.fan) &&
+            (!is_set(written.vane) || vane == written.vane) &&
+            (!is_set(written.wideVane) || wideVane == written.wideVane);
+    }
 };
 
 struct wantedHeatpumpSettings : heatpumpSettings {
@@ -252,23 +303,23 @@ struct heatpumpRunStates {
     int8_t air_purifier = -1;
     int8_t night_mode = -1;
     int8_t circulator = -1;
-    const char* airflow_control = nullptr;
+    cn105_protocol::AirflowControl airflow_control = cn105_protocol::AirflowControl::UNSET;
 
     void resetSettings() {
         air_purifier = -1;
         night_mode = -1;
         circulator = -1;
-        airflow_control = nullptr;
+        airflow_control = cn105_protocol::AirflowControl::UNSET;
     }
 
-    // Trivial copy — all members are scalars/pointers
+    // Trivial copy — all members are scalars
     heatpumpRunStates& operator=(const heatpumpRunStates& other) = default;
 
     bool operator==(const heatpumpRunStates& other) const {
-        return air_purifier == other.air_purifier &&
-            night_mode == other.night_mode &&
-            circulator == other.circulator &&
-            airflow_control == other.airflow_control;
+        return (air_purifier == other.air_purifier) &
+            (night_mode == other.night_mode) &
+            (circulator == other.circulator) &
+            (airflow_control == other.airflow_control);
     }
 
     bool operator!=(const heatpumpRunStates& other) const {
@@ -298,3 +349,44 @@ struct wantedHeatpumpRunStates : heatpumpRunStates {
     }
 };
 
+// Freshness of the last known unit state (currentSettings / currentStatus / currentRunStates).
+// Warm reconnect: after a short link loss the snapshot is kept, marked stale, and the first fresh
+// 0x02 / 0x03 / 0x06 replies are diffed against it, so only real changes are published to HA.
+struct stateFreshness {
+    static constexpr uint8_t SETTINGS = 0x01;       // 0x02
+    static constexpr uint8_t ROOM = 0x02;           // 0x03
+    static constexpr uint8_t STATUS = 0x04;         // 0x06
+    static constexpr uint8_t ALL = SETTINGS | ROOM | STATUS;
+
+    bool valid = false;             // a complete snapshot has been received at least once
+    bool stale = false;             // link lost since: the snapshot may be outdated
+    uint32_t staleSinceMs = 0;      // when the link was lost
+    uint8_t pending = 0;            // parts not refreshed yet since the reconnection
+
+    void linkLost(uint32_t now_ms) {
+        if (stale) return;          // keep the first loss time across retries
+        stale = true;
+        staleSinceMs = now_ms;
+    }
+
+    uint32_t staleForMs(uint32_t now_ms) const { return stale ? now_ms - staleSinceMs : 0; }
+
+    // On 0x7A/0x7B: true when the snapshot can be kept (warm), false when a full resync is needed.
+    // max_age_ms = 0 disables warm reconnects.
+    bool warmStart(uint32_t now_ms, uint32_t max_age_ms) {
+        const bool warm = max_age_ms > 0 && valid && staleForMs(now_ms) <= max_age_ms;
+        if (!warm) valid = false;
+        pending = ALL;
+        return warm;
+    }
+
+    // A fresh reply for `part` was decoded. Returns true when it completes the refresh.
+    bool refreshed(uint8_t part) {
+        const bool was_pending = pending != 0;
+        pending &= static_cast<uint8_t>(~part);
+        if (pending != 0 || !was_pending) return false;
+        valid = true;
+        stale = false;
+        return true;
+    }
+};
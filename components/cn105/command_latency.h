@@ -0,0 +1,237 @@
+/// command_latency.h — ACK correlation for SET writes and fixed-bucket command latency histograms.
+/// Deps: none
+///
+/// Every HA command goes through up to four timestamps:
+///   control   — control() / select / switch callback entry (CommandTracker::control)
+///   write     — its SET packet goes on the bus (CommandTracker::written)
+///   ack       — the matching 0x61; ACKs come back in write order, so the oldest outstanding
+///               write is the one acknowledged (CommandTracker::ack)
+///   confirm   — first readback showing the written values, 0x02 for settings (CommandTracker::confirmed)
+///
+/// Usage:
+///   tracker.control(CommandKind::SETTINGS, now);
+///   tracker.written(CommandKind::SETTINGS, now);
+///   CommandKind k; if (tracker.ack(now, &k)) { ... }
+///   if (tracker.awaiting_confirm(CommandKind::SETTINGS) && readback_matches) tracker.confirmed(CommandKind::SETTINGS, now);
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+
+    enum class CommandKind : uint8_t {
+        SETTINGS,       // 0x41/0x01
+        RUN_STATES,     // 0x41/0x08
+        REMOTE_TEMP,    // 0x41/0x07
+        FUNCTIONS,      // 0x41/0x1F + 0x41/0x21
+        COUNT,
+    };
+
+    const char* command_kind_to_str(CommandKind kind);
+
+    /// Latency histogram with fixed bucket bounds (no allocation, constant-time record).
+    class LatencyHistogram {
+    public:
+        static constexpr size_t BUCKETS = 12;
+        /// Upper bounds (ms, inclusive) of all buckets but the last one, which holds everything above.
+        static constexpr uint32_t BOUNDS_MS[BUCKETS - 1] = { 50, 100, 200, 300, 500, 750, 1000, 1500, 2000, 3000, 5000 };
+
+        void record(uint32_t ms) {
+            size_t b = 0;
+            while (b < BUCKETS - 1 && ms > BOUNDS_MS[b]) b++;
+            counts_[b]++;
+            count_++;
+            sum_ms_ += ms;
+            if (ms > max_ms_) max_ms_ = ms;
+        }
+
+        /// Upper bound of the bucket holding the `pct`-th percentile sample (max seen for the last
+        /// bucket, and never more than it). 0 when empty.
+        uint32_t percentile(uint8_t pct) const {
+            if (count_ == 0) return 0;
+            const uint64_t rank = (uint64_t(count_) * pct + 99) / 100;      // 1-based, ceil
+            uint64_t seen = 0;
+            for (size_t b = 0; b < BUCKETS; b++) {
+                seen += counts_[b];
+                if (seen >= rank && seen > 0) {
+                    if (b == BUCKETS - 1) return max_ms_;
+                    return BOUNDS_MS[b] < max_ms_ ? BOUNDS_MS[b] : max_ms_;
+                }
+            }
+            return max_ms_;
+        }
+
+        uint32_t count() const { return count_; }
+        uint32_t mean_ms() const { return count_ ? static_cast<uint32_t>(sum_ms_ / count_) : 0; }
+        uint32_t max_ms() const { return max_ms_; }
+        uint32_t bucket(size_t b) const { return b < BUCKETS ? counts_[b] : 0; }
+
+        void reset() {
+            for (auto& c : counts_) c = 0;
+            count_ = 0;
+            sum_ms_ = 0;
+            max_ms_ = 0;
+        }
+
+    private:
+        uint32_t counts_[BUCKETS] = {};
+        uint32_t count_ = 0;
+        uint64_t sum_ms_ = 0;
+        uint32_t max_ms_ = 0;
+    };
+
+    /// Correlates 0x61 ACKs with the SET writes they acknowledge and feeds the latency histograms.
+    class CommandTracker {
+    public:
+        static constexpr size_t MAX_OUTSTANDING = 4;    // writes on the bus still waiting for their ACK
+        static constexpr uint32_t STALE_MS = 5000;      // an unacknowledged write older than this is dropped
+
+        /// HA asked for a change: starts the clock, unless a command of this kind is already waiting to be written.
+        void control(CommandKind kind, uint32_t now_ms) {
+            auto& s = kinds_[index(kind)];
+            if (!s.pending) {
+                s.pending = true;
+                s.control_ms = now_ms;
+            }
+        }
+
+        /// The SET packet of `kind` went on the bus. `more_packets` keeps the command pending for the
+        /// next packet of the same command (functions part 1 → part 2). A write no control() asked for
+        /// (remote temperature keep-alive) only feeds the bus histogram.
+        void written(CommandKind kind, uint32_t now_ms, bool more_packets = false) {
+            auto& s = kinds_[index(kind)];
+            const bool commanded = s.pending;
+            const uint32_t control_ms = commanded ? s.control_ms : now_ms;
+            const bool first_packet = !s.in_progress;
+            s.in_progress = commanded && more_packets;
+            if (!more_packets) s.pending = false;
+            drop_stale(now_ms);
+            if (outstanding_count_ == MAX_OUTSTANDING) {
+                pop_front();
+                lost_acks_++;
+            }
+            outstanding_[(head_ + outstanding_count_) % MAX_OUTSTANDING] = { kind, control_ms, now_ms, commanded && !more_packets };
+            outstanding_count_++;
+            if (commanded && first_packet) to_write_.record(now_ms - control_ms);
+        }
+
+        /// A 0x61 arrived: it acknowledges the oldest outstanding write. Returns false if none is outstanding.
+        bool ack(uint32_t now_ms, CommandKind* kind = nullptr) {
+            dirty_ = true;
+            drop_stale(now_ms);
+            if (outstanding_count_ == 0) {
+                unmatched_acks_++;
+                return false;
+            }
+            const Outstanding w = outstanding_[head_];
+            pop_front();
+            bus_.record(now_ms - w.write_ms);
+            if (w.closes_command) {
+                to_ack_.record(now_ms - w.control_ms);
+                auto& s = kinds_[index(w.kind)];
+                s.awaiting_confirm = true;
+                s.confirm_from_ms = w.control_ms;
+            }
+            last_ack_kind_ = w.kind;
+            last_ack_ms_ = now_ms - w.write_ms;
+            if (kind) *kind = w.kind;
+            return true;
+        }
+
+        /// True once a command of `kind` has been acknowledged and its readback not seen yet.
+        bool awaiting_confirm(CommandKind kind) const { return kinds_[index(kind)].awaiting_confirm; }
+
+        /// The first readback showing the written values arrived: closes the end-to-end measurement.
+        void confirmed(CommandKind kind, uint32_t now_ms) {
+            auto& s = kinds_[index(kind)];
+            if (!s.awaiting_confirm) return;
+            s.awaiting_confirm = false;
+            dirty_ = true;
+            to_confirm_.record(now_ms - s.confirm_from_ms);
+        }
+
+        /// Forgets outstanding writes and pending commands (link lost: their ACKs will never come).
+        void reset_link() {
+            outstanding_count_ = 0;
+            head_ = 0;
+            for (auto& s : kinds_) s = KindState();
+        }
+
+        const LatencyHistogram& to_write() const { return to_write_; }     // control → bus write
+        const LatencyHistogram& bus() const { return bus_; }               // bus write → ACK
+        const LatencyHistogram& to_ack() const { return to_ack_; }         // control → ACK
+        const LatencyHistogram& to_confirm() const { return to_confirm_; } // control → confirming readback
+
+        /// True when a histogram changed since the last call (publish diagnostics only then).
+        bool take_dirty() {
+            const bool d = dirty_;
+            dirty_ = false;
+            return d;
+        }
+
+        size_t outstanding() const { return outstanding_count_; }
+        uint32_t unmatched_acks() const { return unmatched_acks_; }
+        uint32_t lost_acks() const { return lost_acks_; }
+        CommandKind last_ack_kind() const { return last_ack_kind_; }
+        uint32_t last_ack_ms() const { return last_ack_ms_; }
+
+    private:
+        struct Outstanding {
+            CommandKind kind;
+            uint32_t control_ms;
+            uint32_t write_ms;
+            bool closes_command;    // last packet of a control()-initiated command
+        };
+
+        struct KindState {
+            bool pending = false;           // control() seen, not written yet
+            bool in_progress = false;       // first packet of a multi-packet command written
+            uint32_t control_ms = 0;
+            bool awaiting_confirm = false;  // acknowledged, readback not seen yet
+            uint32_t confirm_from_ms = 0;
+        };
+
+        static size_t index(CommandKind kind) {
+            const size_t i = static_cast<size_t>(kind);
+            return i < static_cast<size_t>(CommandKind::COUNT) ? i : 0;
+        }
+
+        void pop_front() {
+            head_ = (head_ + 1) % MAX_OUTSTANDING;
+            outstanding_count_--;
+        }
+
+        void drop_stale(uint32_t now_ms) {
+            while (outstanding_count_ > 0 && now_ms - outstanding_[head_].write_ms > STALE_MS) {
+                pop_front();
+                lost_acks_++;
+            }
+        }
+
+        Outstanding outstanding_[MAX_OUTSTANDING] = {};
+        size_t head_ = 0;
+        size_t outstanding_count_ = 0;
+        KindState kinds_[static_cast<size_t>(CommandKind::COUNT)];
+        LatencyHistogram to_write_;
+        LatencyHistogram bus_;
+        LatencyHistogram to_ack_;
+        LatencyHistogram to_confirm_;
+        uint32_t unmatched_acks_ = 0;
+        uint32_t lost_acks_ = 0;
+        CommandKind last_ack_kind_ = CommandKind::SETTINGS;
+        uint32_t last_ack_ms_ = 0;
+        bool dirty_ = false;
+    };
+
+    inline const char* command_kind_to_str(CommandKind kind) {
+        switch (kind) {
+        case CommandKind::SETTINGS:    return "settings";
+        case CommandKind::RUN_STATES:  return "run states";
+        case CommandKind::REMOTE_TEMP: return "remote temperature";
+        case CommandKind::FUNCTIONS:   return "functions";
+        default:                       return "unknown";
+        }
+    }
+
+}
@@ -1,4 +1,5 @@
 #include "cn105.h"
+#include "esphome/core/helpers.h"
 #ifdef USE_WIFI
 #include "esphome/components/wifi/wifi_component.h"
 #endif
@@ -22,6 +23,7 @@ void CN105Climate::setup() {
     this->fan_mode = climate::CLIMATE_FAN_OFF;
     this->swing_mode = climate::CLIMATE_SWING_OFF;
     this->parser_.reset();
+    this->rx_frames_.clear();
     this->lastResponseMs = CUSTOM_MILLIS;
 
     // initialize diagnostic stats
@@ -32,6 +34,9 @@ void CN105Climate::setup() {
     // Register info requests here to ensure all dependencies (like hardware_settings) are ready
     this->registerInfoRequests();
 
+    // Per-device jitter seed: units power-cycled together must not retry CONNECT in lockstep
+    this->handshake_.set_seed(random_uint32());
+
     ESP_LOGI(TAG, "tx_pin: %d rx_pin: %d", this->tx_pin_, this->rx_pin_);
     //ESP_LOGI(TAG, "remote_temp_timeout is set to %lu", this->remote_temp_timeout_);
     log_info_uint32(TAG, "remote_temp_timeout is set to ", this->remote_temp_timeout_);
@@ -53,44 +58,66 @@ void CN105Climate::setup() {
  * This function is called repeatedly in the main program loop.
  */
 void CN105Climate::loop() {
+#ifdef USE_CN105_LOOP_PROFILER
+    if (this->loopProfiler_.window_elapsed(CUSTOM_MILLIS)) {
+        this->publishLoopProfile_();            // outside the timed loop: reporting is not profiled
+        this->loopProfiler_.start_window(CUSTOM_MILLIS);
+    }
+    ScopedLoopTotal cn105_loop_total_(this->loopProfiler_, micros);
+#endif
     // Bootstrap connection CN105 (UART + CONNECT) from loop()
-    this->maybe_start_connection_();
+    {
+        CN105_PROFILE_PHASE(CONNECTION);
+        this->maybe_start_connection_();
+    }
 
     // As long as the connection is not successful, we do not launch ANY cycle/write (otherwise it short-circuits the delay).
     // We still continue to read/process the input in order to detect 0x7A/0x7B (connection success).
     const bool can_talk_to_hp = this->isHeatpumpConnected();
 
+    // Expire soft timeouts / ACK waits and send whatever the request queue lets through
+    {
+        CN105_PROFILE_PHASE(SCHEDULER);
+        this->scheduler_.loop();
+    }
+
     if (!this->processInput()) {                                            // if we don't get any input: no read op
         if (!can_talk_to_hp) {
             return;
         }
-        if ((this->wantedSettings.hasChanged) && (!this->loopCycle.isCycleRunning())) {
+        if (!this->loopCycle.isCycleRunning()) {
+            this->flushPublishes_();            // replies decoded outside a cycle (or before a cycle timeout)
+        }
+        CN105_PROFILE_PHASE(SCHEDULER);
+        // Pending writes are queued; the scheduler sends them between INFO exchanges, ahead of the remaining polls
+        if (this->wantedSettings.hasChanged) {
             this->checkPendingWantedSettings();
-        } else if ((this->wantedRunStates.hasChanged) && (!this->loopCycle.isCycleRunning())) {
+        }
+        if (this->wantedRunStates.hasChanged) {
             this->checkPendingWantedRunStates();
-        } else if ((this->isSetFunctions_) && (!this->loopCycle.isCycleRunning())) {
+        }
+        if (this->isSetFunctions_) {
             this->isSetFunctions_ = false;
             this->setFunctions(this->functions);
-            // Also request to get function settings from heat pump to update UI with latest values.
-            this->isGetFunctions_ = true;
-        } else {
-            if (this->loopCycle.isCycleRunning()) {                         // if we are  running an update cycle
-                this->loopCycle.checkTimeout(this->update_interval_);
-            } else { // we are not running a cycle
-                if (this->loopCycle.hasUpdateIntervalPassed(this->get_update_interval())) {
-                    if (this->isGetFunctions_) {
-                        // Reactivate requests 0x20/0x22 and bypass interval timers.
-                        // This must be done before starting a new cycle to prevent a race hazard of
-                        // request 0x22 occurring before request 0x20.
-                        this->scheduler_.enable_request(0x20);
-                        this->scheduler_.timer_bypass(0x20);
-                        this->scheduler_.enable_request(0x22);
-                        this->scheduler_.timer_bypass(0x22);
-                        this->isGetFunctions_ = false;
-                    }
-                    this->buildAndSendRequestsInfoPackets();            // initiate an update cycle with this->cycleStarted();
-                }
+        }
+        if (this->shouldSendExternalTemperature_) {
+            this->sendRemoteTemperature();
+        }
+
+        if (this->loopCycle.isCycleRunning()) {                             // if we are  running an update cycle
+            this->loopCycle.checkTimeout(this->update_interval_);
+        } else if (this->loopCycle.hasUpdateIntervalPassed(this->scheduler_.poll_period_ms(this->get_update_interval()))) {
+            if (this->isGetFunctions_ && !this->scheduler_.is_write_pending(WRITE_FUNCTIONS_2)) {
+                // Reactivate requests 0x20/0x22 and bypass interval timers.
+                // This must be done before starting a new cycle to prevent a race hazard of
+                // request 0x22 occurring before request 0x20.
+                this->scheduler_.enable_request(0x20);
+                this->scheduler_.timer_bypass(0x20);
+                this->scheduler_.enable_request(0x22);
+                this->scheduler_.timer_bypass(0x22);
+                this->isGetFunctions_ = false;
             }
+            this->buildAndSendRequestsInfoPackets();                // initiate an update cycle with this->cycleStarted();
         }
     }
 }
@@ -103,7 +130,7 @@ void CN105Climate::maybe_start_connection_() {
                 if (state_ >= DriverState::CONNECTING) return;
                 ESP_LOGW(LOG_CONN_TAG, "Bootstrap connexion: timeout 120s, démarrage CN105 malgré tout");
                 this->setupUART();
-                this->sendFirstConnectionPacket();
+                this->handshake_.begin(CUSTOM_MILLIS);      // CONNECT envoyé par runHandshake_() au prochain loop()
             });
 
 #ifdef USE_WIFI
@@ -135,21 +162,53 @@ void CN105Climate::maybe_start_connection_() {
             if (elapsed < this->conn_bootstrap_delay_ms_) {
                 return;  // grace delay not elapsed yet
             }
-            ESP_LOGI(LOG_CONN_TAG, "Bootstrap connexion: init UART + envoi CONNECT (loop)");
-            this->setupUART();
-            this->sendFirstConnectionPacket();
-            // setupUART() transitions to CONNECTING if UART config is valid
+            if (!this->handshake_.in_progress()) {
+                ESP_LOGI(LOG_CONN_TAG, "Bootstrap connexion: init UART + envoi CONNECT (loop)");
+                this->setupUART();
+                this->handshake_.begin(CUSTOM_MILLIS);
+            }
+            // setupUART() transitions to CONNECTING if UART config is valid; otherwise CONNECT is retried with backoff
+            this->runHandshake_();
             return;
         }
 
         case DriverState::CONNECTING:
-        case DriverState::CONNECTED:
         case DriverState::DISCONNECTED:
-            // Nothing to do — connection already started or managed elsewhere
+            this->runHandshake_();
+            return;
+
+        case DriverState::CONNECTED:
+            // Nothing to do — a lost link is detected by reconnectIfConnectionLost()
             return;
     }
 }
 
+/**
+ * Drives handshake_ from loop() without ever blocking it: CONNECT is written when due, and a missing
+ * reply reinitialises the UART while handshake_ schedules the next attempt (exponential backoff with
+ * jitter, or an immediate 0x5A retry when the unit ignored the 0x5B installer probe).
+ */
+void CN105Climate::runHandshake_() {
+    const uint32_t now = CUSTOM_MILLIS;
+    switch (this->handshake_.poll(now)) {
+    case HandshakeEngine::Action::SEND_CONNECT:
+        this->sendFirstConnectionPacket();
+        break;
+    case HandshakeEngine::Action::PROBE_FAILED:
+        ESP_LOGW(LOG_CONN_TAG, "No reply to installer handshake (0x5B). Falling back to standard handshake (0x5A).");
+        this->reinitUART_();
+        break;
+    case HandshakeEngine::Action::TIMED_OUT:
+        ESP_LOGE(LOG_CONN_TAG, "--> Heatpump did not reply: NOT CONNECTED <--");
+        ESP_LOGI(LOG_CONN_TAG, "Reinitializing UART, next CONNECT in %u ms (attempt %u)",
+            (unsigned)this->handshake_.next_attempt_in(now), (unsigned)this->handshake_.attempts() + 1);
+        this->reinitUART_();
+        break;
+    default:
+        break;
+    }
+}
+
 uint32_t CN105Climate::get_update_interval() const { return this->update_interval_; }
 void CN105Climate::set_update_interval(uint32_t update_interval) {
     //ESP_LOGD(TAG, "Setting update interval to %lu", update_interval);
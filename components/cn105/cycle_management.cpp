@@ -1,5 +1,4 @@
 #include "cycle_management.h"
-#include "cn105.h"
 #include "Globals.h"
 
 using namespace esphome;
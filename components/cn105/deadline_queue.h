@@ -0,0 +1,119 @@
+/// deadline_queue.h — Fixed-capacity earliest-deadline-first queue (binary min-heap, no allocation).
+/// Deps: none
+///
+/// Items are small ids ordered by a millis() deadline; equal deadlines pop in insertion order.
+/// Deadlines are compared wrap-safe (millis() rolls over every ~49.7 days). An optional priority
+/// class comes first: every item of a higher class pops before any lower-class item, whatever the deadlines.
+///
+/// Usage:
+///   DeadlineQueue<16> q;
+///   q.push(id, due_ms);
+///   while (!q.empty() && q.top_due() <= now) { uint8_t id = q.pop(); ... }
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cn105_protocol {
+
+template <size_t N>
+class DeadlineQueue {
+public:
+    static constexpr size_t capacity() { return N; }
+
+    /// Inserts `id` with deadline `due_ms` in class `priority` (higher first). Returns false when
+    /// full or `id` is already queued.
+    bool push(uint8_t id, uint32_t due_ms, uint8_t priority = 0) {
+        if (size_ == N || contains(id)) return false;
+        size_t i = size_++;
+        heap_[i] = { due_ms, seq_++, id, priority };
+        sift_up(i);
+        return true;
+    }
+
+    /// Removes and returns the id with the earliest deadline. Undefined when empty.
+    uint8_t pop() {
+        const uint8_t id = heap_[0].id;
+        remove_at(0);
+        return id;
+    }
+
+    /// Removes `id` if queued. Returns true if it was.
+    bool remove(uint8_t id) {
+        for (size_t i = 0; i < size_; i++) {
+            if (heap_[i].id == id) {
+                remove_at(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(uint8_t id) const {
+        for (size_t i = 0; i < size_; i++) {
+            if (heap_[i].id == id) return true;
+        }
+        return false;
+    }
+
+    uint8_t top() const { return heap_[0].id; }
+    uint32_t top_due() const { return heap_[0].due_ms; }
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    void clear() { size_ = 0; }
+
+private:
+    struct Entry {
+        uint32_t due_ms;
+        uint32_t seq;       // tie-break: FIFO among equal deadlines
+        uint8_t id;
+        uint8_t priority;
+    };
+
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        const int32_t d = static_cast<int32_t>(a.due_ms - b.due_ms);
+        if (d != 0) return d < 0;
+        return static_cast<int32_t>(a.seq - b.seq) < 0;
+    }
+
+    void sift_up(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(heap_[i], heap_[parent])) break;
+            swap(i, parent);
+            i = parent;
+        }
+    }
+
+    void sift_down(size_t i) {
+        for (;;) {
+            size_t l = 2 * i + 1, r = l + 1, m = i;
+            if (l < size_ && before(heap_[l], heap_[m])) m = l;
+            if (r < size_ && before(heap_[r], heap_[m])) m = r;
+            if (m == i) return;
+            swap(i, m);
+            i = m;
+        }
+    }
+
+    void remove_at(size_t i) {
+        heap_[i] = heap_[--size_];
+        if (i < size_) {
+            sift_down(i);
+            sift_up(i);
+        }
+    }
+
+    void swap(size_t a, size_t b) {
+        Entry t = heap_[a];
+        heap_[a] = heap_[b];
+        heap_[b] = t;
+    }
+
+    Entry heap_[N]{};
+    size_t size_ = 0;
+    uint32_t seq_ = 0;
+};
+
+}  // namespace cn105_protocol
@@ -31,6 +31,7 @@ void CN105Climate::set_vertical_vane_select(
         this->wantedSettings.hasChanged = true;
         this->wantedSettings.hasBeenSent = false;
         this->wantedSettings.lastChange = CUSTOM_MILLIS;
+        this->commandLatency_.control(CommandKind::SETTINGS, CUSTOM_MILLIS);
         });
 
 }
@@ -67,6 +68,7 @@ void CN105Climate::set_horizontal_vane_select(
         this->wantedSettings.hasChanged = true;
         this->wantedSettings.hasBeenSent = false;
         this->wantedSettings.lastChange = CUSTOM_MILLIS;
+        this->commandLatency_.control(CommandKind::SETTINGS, CUSTOM_MILLIS);
         });
 
 }
@@ -80,15 +82,16 @@ void CN105Climate::set_airflow_control_select(
         });
 
     this->airflow_control_select_->setCallbackFunction([this](const char* setting) {
-        if (strcmp(this->currentSettings.wideVane, lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 8, 0x80 & 0x0F)) == 0) {
+        if (this->currentSettings.wideVane == cn105_protocol::WideVane::AIRFLOW_CONTROL) {
             ESP_LOGD("EVT", "airFlow -> Request for change of airflow control setting: %s", setting);
 
             this->setAirflowControlSetting(setting);
             this->wantedRunStates.hasChanged = true;
             this->wantedRunStates.hasBeenSent = false;
             this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+            this->commandLatency_.control(CommandKind::RUN_STATES, CUSTOM_MILLIS);
         } else {
-            this->airflow_control_select_->publish_state(this->currentRunStates.airflow_control);
+            this->airflow_control_select_->publish_state(getIfNotNull(to_label(this->currentRunStates.airflow_control), AIRFLOW_CONTROL_MAP[0]));
         }
         });
 }
@@ -155,6 +158,12 @@ void CN105Climate::set_functions_get_button(FunctionsButton* Button) {
         });
 }
 
+#ifdef USE_CN105_FRAME_CAPTURE
+void CN105Climate::set_frame_capture_dump_button(FunctionsButton* button) {
+    button->setCallbackFunction([this]() { this->dump_frame_capture(); });
+}
+#endif
+
 void CN105Climate::set_functions_set_button(FunctionsButton* Button) {
     this->Functions_set_button_ = Button;
     this->Functions_set_button_->setCallbackFunction([this]() {
@@ -175,6 +184,7 @@ void CN105Climate::set_functions_set_button(FunctionsButton* Button) {
 
         // Now send the codes.
         this->isSetFunctions_ = true;
+        this->commandLatency_.control(CommandKind::FUNCTIONS, CUSTOM_MILLIS);
 
         });
 }
@@ -203,6 +213,7 @@ void CN105Climate::set_air_purifier_switch(HVACOptionSwitch* Switch) {
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->commandLatency_.control(CommandKind::RUN_STATES, CUSTOM_MILLIS);
         });
 }
 
@@ -214,6 +225,7 @@ void CN105Climate::set_night_mode_switch(HVACOptionSwitch* Switch) {
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->commandLatency_.control(CommandKind::RUN_STATES, CUSTOM_MILLIS);
         });
 }
 
@@ -225,6 +237,7 @@ void CN105Climate::set_circulator_switch(HVACOptionSwitch* Switch) { // only in
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->commandLatency_.control(CommandKind::RUN_STATES, CUSTOM_MILLIS);
         });
 }
 
@@ -279,5 +292,6 @@ void CN105Climate::add_hardware_setting(HardwareSettingSelect* setting) {
 
         // Trigger write to device
         this->isSetFunctions_ = true;
+        this->commandLatency_.control(CommandKind::FUNCTIONS, CUSTOM_MILLIS);
         });
 }
@@ -0,0 +1,181 @@
+/// frame_capture.h — RAM ring of the last raw RX/TX frames, dumped on demand as base64 for post-mortem analysis.
+/// Deps: <cstdint>, <cstring>, <memory> (timestamps are passed in; the component macro reads millis())
+///
+/// Enabled by `frame_capture:` in YAML, which defines USE_CN105_FRAME_CAPTURE. Without it the
+/// CN105_CAPTURE_FRAME() markers expand to nothing and no ring exists.
+///
+/// Recording is one memcpy into a fixed slot (allocated once), so it can stay on in production at
+/// WARN level. Dump blob (little-endian), base64-encoded:
+///   header  'C' 'N' 'C' version(1)  count(u16)  dump_ms(u32)  dropped(u32)
+///   record  ms(u32)  flags(u8: bit 7 = TX, bit 6 = truncated)  length(u8)  bytes[length]
+/// `dropped` counts frames overwritten since the last clear; ms are millis() at receive / write time.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace esphome {
+
+    enum class FrameDirection : uint8_t { RX, TX };
+
+    struct CapturedFrame {
+        static constexpr uint8_t MAX_BYTES = 22;        // header + 16 data bytes + checksum
+
+        uint32_t ms = 0;
+        uint8_t flags = 0;
+        uint8_t length = 0;                             // bytes stored (≤ MAX_BYTES)
+        uint8_t bytes[MAX_BYTES] = {};
+
+        static constexpr uint8_t FLAG_TX = 0x80;
+        static constexpr uint8_t FLAG_TRUNCATED = 0x40;
+
+        FrameDirection direction() const { return (flags & FLAG_TX) ? FrameDirection::TX : FrameDirection::RX; }
+        bool truncated() const { return (flags & FLAG_TRUNCATED) != 0; }
+    };
+
+    /// Streaming base64 encoder: hands out lines of at most LINE_CHARS characters to `sink(const char*)`.
+    template <typename Sink>
+    class Base64Lines {
+    public:
+        static constexpr size_t LINE_CHARS = 96;            // multiple of 4: every line decodes on its own
+
+        explicit Base64Lines(Sink& sink) : sink_(sink) {}
+
+        void put(uint8_t byte) {
+            group_[group_len_++] = byte;
+            if (group_len_ == 3) emit_group();
+        }
+
+        void put(const uint8_t* data, size_t n) {
+            for (size_t i = 0; i < n; i++) put(data[i]);
+        }
+
+        void put_u16(uint16_t v) {
+            put(static_cast<uint8_t>(v));
+            put(static_cast<uint8_t>(v >> 8));
+        }
+
+        void put_u32(uint32_t v) {
+            for (int shift = 0; shift < 32; shift += 8) put(static_cast<uint8_t>(v >> shift));
+        }
+
+        /// Pads the last group and sends the last line.
+        void finish() {
+            if (group_len_ > 0) emit_group();
+            if (line_len_ > 0) flush_line();
+        }
+
+    private:
+        void emit_group() {
+            static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            const uint32_t v = (uint32_t(group_[0]) << 16) | (uint32_t(group_len_ > 1 ? group_[1] : 0) << 8) |
+                uint32_t(group_len_ > 2 ? group_[2] : 0);
+            line_[line_len_++] = ALPHABET[(v >> 18) & 0x3F];
+            line_[line_len_++] = ALPHABET[(v >> 12) & 0x3F];
+            line_[line_len_++] = group_len_ > 1 ? ALPHABET[(v >> 6) & 0x3F] : '=';
+            line_[line_len_++] = group_len_ > 2 ? ALPHABET[v & 0x3F] : '=';
+            group_len_ = 0;
+            if (line_len_ == LINE_CHARS) flush_line();
+        }
+
+        void flush_line() {
+            line_[line_len_] = '\0';
+            sink_(static_cast<const char*>(line_));
+            line_len_ = 0;
+        }
+
+        Sink& sink_;
+        uint8_t group_[3] = {};
+        uint8_t group_len_ = 0;
+        char line_[LINE_CHARS + 1] = {};
+        size_t line_len_ = 0;
+    };
+
+    class FrameCapture {
+    public:
+        static constexpr uint8_t FORMAT_VERSION = 1;
+
+        /// Allocates the ring once (config time); 0 leaves capture disabled.
+        void init(uint16_t capacity) {
+            slots_.reset(capacity > 0 ? new CapturedFrame[capacity] : nullptr);
+            capacity_ = slots_ ? capacity : 0;
+            clear();
+        }
+
+        void record(FrameDirection direction, uint32_t ms, const uint8_t* data, size_t length) {
+            if (capacity_ == 0) return;
+            CapturedFrame& slot = slots_[head_];
+            const size_t stored = length < CapturedFrame::MAX_BYTES ? length : CapturedFrame::MAX_BYTES;
+            slot.ms = ms;
+            slot.flags = (direction == FrameDirection::TX ? CapturedFrame::FLAG_TX : 0) |
+                (stored < length ? CapturedFrame::FLAG_TRUNCATED : 0);
+            slot.length = static_cast<uint8_t>(stored);
+            memcpy(slot.bytes, data, stored);
+            head_ = static_cast<uint16_t>(head_ + 1 == capacity_ ? 0 : head_ + 1);
+            if (size_ < capacity_) {
+                size_++;
+            } else {
+                dropped_++;
+            }
+        }
+
+        void clear() {
+            head_ = 0;
+            size_ = 0;
+            dropped_ = 0;
+        }
+
+        uint16_t capacity() const { return capacity_; }
+        uint16_t size() const { return size_; }
+        uint32_t dropped() const { return dropped_; }
+
+        /// i-th frame still in the ring, oldest first (i < size()).
+        const CapturedFrame& at(uint16_t i) const {
+            const uint32_t oldest = size_ < capacity_ ? 0 : head_;
+            return slots_[(oldest + i) % capacity_];
+        }
+
+        /// Bytes of the binary blob (before base64).
+        size_t blob_size() const {
+            size_t n = 14;
+            for (uint16_t i = 0; i < size_; i++) n += 6 + at(i).length;
+            return n;
+        }
+
+        /// Streams the blob as base64 lines to `sink(const char* line)`; nothing is allocated.
+        template <typename Sink>
+        void dump_base64(uint32_t now_ms, Sink&& sink) const {
+            Base64Lines<Sink> out(sink);
+            const uint8_t magic[4] = { 'C', 'N', 'C', FORMAT_VERSION };
+            out.put(magic, sizeof(magic));
+            out.put_u16(size_);
+            out.put_u32(now_ms);
+            out.put_u32(dropped_);
+            for (uint16_t i = 0; i < size_; i++) {
+                const CapturedFrame& f = at(i);
+                out.put_u32(f.ms);
+                out.put(f.flags);
+                out.put(f.length);
+                out.put(f.bytes, f.length);
+            }
+            out.finish();
+        }
+
+    private:
+        std::unique_ptr<CapturedFrame[]> slots_;
+        uint16_t capacity_ = 0;
+        uint16_t head_ = 0;             // next slot written
+        uint16_t size_ = 0;
+        uint32_t dropped_ = 0;
+    };
+
+}
+
+#ifdef USE_CN105_FRAME_CAPTURE
+#define CN105_CAPTURE_FRAME(direction, ms, data, length) \
+    this->frameCapture_.record(::esphome::FrameDirection::direction, (ms), (data), (length))
+#else
+#define CN105_CAPTURE_FRAME(direction, ms, data, length) do {} while (0)
+#endif
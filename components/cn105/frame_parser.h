@@ -4,17 +4,30 @@
 /// Extracts byte-by-byte frame assembly from CN105Climate into a pure,
 /// testable class with no ESPHome dependency.
 ///
-/// Usage:
+/// Resynchronization: the header (FC <cmd> 01 30 <len>) is validated byte by byte. When a
+/// header byte is wrong, the length does not fit, or a frame fails its checksum, the bytes
+/// already buffered after the bad start are rescanned for the next 0xFC instead of being
+/// thrown away, so a frame starting inside a corrupted one is not lost. The rescan reparses
+/// buffer_ in place, the same way for both feed() overloads.
+/// resync_count() counts recoveries from a buffered 0xFC, drop_count() frames discarded outright.
+///
+/// Usage (byte by byte):
 ///   FrameParser parser;
 ///   while (serial.available()) {
 ///       parser.feed(serial.read());
-///       if (parser.frame_complete()) {
+///       while (parser.frame_complete()) {    // a rescan can complete another frame
 ///           process(parser.command(), parser.data(), parser.data_length());
-///           parser.reset();
+///           parser.next();
 ///       }
 ///   }
+///
+/// Usage (bulk, one call per UART read):
+///   uint8_t chunk[128];
+///   size_t n = serial.read_array(chunk, serial.available());
+///   parser.feed(chunk, n, [](const FrameParser& p) { process(p.command(), p.data(), p.data_length()); });
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include "cn105_protocol.h"
@@ -27,60 +40,87 @@ public:
     FrameParser() { reset(); }
 
     /// Feed one byte from the UART stream.
-    /// After each call, check frame_complete() to see if a full frame is ready.
+    /// After each call, check frame_complete() to see if a full frame is ready, then call next().
     void feed(uint8_t byte) {
-        if (!found_start_) {
-            if (byte == 0xFC) {
-                found_start_ = true;
-                bytes_read_ = 0;
-                buffer_[bytes_read_++] = byte;
-            }
-            // Ignore garbage bytes before 0xFC
-            return;
-        }
-
-        // Overflow protection
-        if (bytes_read_ >= MAX_DATA_BYTES) {
-            reset();
-            return;
-        }
+        consume(byte);
+        drain();
+    }
 
-        buffer_[bytes_read_] = byte;
+    /// Feed a chunk of bytes from the UART stream.
+    /// Garbage before a start byte is skipped with memchr(), payload runs are copied in one go,
+    /// and every frame completed inside the chunk is passed to `on_frame(const FrameParser&)`.
+    /// next() is called after each callback; a trailing partial frame is kept for the next call.
+    /// A frame with a bad checksum is still handed to the callback, then its bytes are rescanned
+    /// for an embedded start byte before parsing continues.
+    /// @return Number of completed frames handed to the callback.
+    template <typename OnFrame>
+    size_t feed(const uint8_t* bytes, size_t len, OnFrame&& on_frame) {
+        size_t frames = 0;
+        size_t i = 0;
+        if (frame_complete_) reset();
+
+        while (i < len) {
+            if (!found_start_) {
+                const void* start = std::memchr(bytes + i, 0xFC, len - i);
+                if (start == nullptr) break;
+                i = static_cast<size_t>(static_cast<const uint8_t*>(start) - bytes);
+            }
 
-        // At index 4, we know the data length
-        if (bytes_read_ == 4) {
-            data_length_ = byte;
-            command_ = buffer_[1];
+            if (data_length_ < 0) {
+                // Header: byte by byte so the length checks stay in one place
+                feed(bytes[i++]);
+                continue;
+            }
 
-            // Sanity check: declared length must fit in buffer
-            // Total frame = 5 (header) + data_length + 1 (checksum)
-            if ((data_length_ + 6) > MAX_DATA_BYTES) {
-                reset();
-                return;
+            // Payload + checksum run
+            const size_t frame_len = static_cast<size_t>(data_length_) + 6;
+            size_t n = frame_len - static_cast<size_t>(bytes_read_);
+            if (n > len - i) n = len - i;
+            std::memcpy(&buffer_[bytes_read_], bytes + i, n);
+            bytes_read_ += static_cast<int>(n);
+            i += n;
+
+            if (static_cast<size_t>(bytes_read_) == frame_len) {
+                bytes_read_ = data_length_ + 5;     // same end state as the byte-wise path
+                checksum_byte_ = buffer_[bytes_read_];
+                frame_complete_ = true;
+                // The rescan of a bad frame can complete more frames from the buffered bytes
+                do {
+                    frames++;
+                    on_frame(static_cast<const FrameParser&>(*this));
+                    next();
+                } while (frame_complete_);
             }
         }
+        return frames;
+    }
 
-        // Check if we have a complete frame
-        // Complete when bytes_read_ == 5 (header) + data_length_ (payload) + 1 (checksum) - 1 (0-indexed)
-        if (data_length_ >= 0 && bytes_read_ == data_length_ + 5) {
-            // Frame is complete (checksum byte is at buffer_[bytes_read_])
-            checksum_byte_ = byte;
-            frame_complete_ = true;
+    /// Release the completed frame and go on with the bytes still queued in the buffer.
+    /// A frame with a bad checksum is first rescanned for an embedded start byte, which can
+    /// complete another frame: check frame_complete() again afterwards.
+    void next() {
+        if (!frame_complete_) return;
+        if (checksum_valid()) {
+            restart();
         } else {
-            bytes_read_++;
+            resync(data_length_ + 6);
         }
+        drain();
     }
 
-    /// Reset the parser to accept a new frame.
+    /// Drop everything buffered, including bytes queued for a rescan.
     void reset() {
-        found_start_ = false;
-        frame_complete_ = false;
-        bytes_read_ = 0;
-        data_length_ = -1;
-        command_ = 0;
-        checksum_byte_ = 0;
+        restart();
+        pending_ = 0;
+        pending_end_ = 0;
     }
 
+    /// Number of times a bad header/length/checksum was recovered from a buffered 0xFC.
+    uint32_t resync_count() const { return resyncs_; }
+
+    /// Number of partial or corrupted frames discarded with no start byte to recover from.
+    uint32_t drop_count() const { return drops_; }
+
     /// True when a complete frame (header + payload + checksum) has been received.
     bool frame_complete() const { return frame_complete_; }
 
@@ -112,6 +152,88 @@ public:
     }
 
 private:
+    /// Frame state machine, one byte at a time. A rejected header goes to resync().
+    void consume(uint8_t byte) {
+        if (!found_start_) {
+            if (byte == 0xFC) {
+                found_start_ = true;
+                bytes_read_ = 0;
+                buffer_[bytes_read_++] = byte;
+            }
+            // Ignore garbage bytes before 0xFC
+            return;
+        }
+
+        // Overflow protection
+        if (bytes_read_ >= MAX_DATA_BYTES) {
+            restart();
+            return;
+        }
+
+        buffer_[bytes_read_] = byte;
+
+        // Every CN105 frame carries 0x01 0x30 at offsets 2-3
+        if ((bytes_read_ == 2 && byte != 0x01) || (bytes_read_ == 3 && byte != 0x30)) {
+            resync(bytes_read_ + 1);
+            return;
+        }
+
+        // At index 4, we know the data length
+        if (bytes_read_ == 4) {
+            // Sanity check: declared length must fit in buffer
+            // Total frame = 5 (header) + data_length + 1 (checksum)
+            if ((byte + 6) > MAX_DATA_BYTES) {
+                resync(5);
+                return;
+            }
+            data_length_ = byte;
+            command_ = buffer_[1];
+        }
+
+        // Check if we have a complete frame
+        // Complete when bytes_read_ == 5 (header) + data_length_ (payload) + 1 (checksum) - 1 (0-indexed)
+        if (data_length_ >= 0 && bytes_read_ == data_length_ + 5) {
+            // Frame is complete (checksum byte is at buffer_[bytes_read_])
+            checksum_byte_ = byte;
+            frame_complete_ = true;
+        } else {
+            bytes_read_++;
+        }
+    }
+
+    /// Abandon the frame being assembled (first `count` bytes of buffer_) and queue the bytes from
+    /// the next 0xFC in buffer_[1..count) for reparsing, ahead of any bytes already queued.
+    /// The queue sits in buffer_ past the frame: consume() writes at bytes_read_, below pending_.
+    void resync(int count) {
+        if (pending_ == pending_end_) pending_ = pending_end_ = count;
+        const void* next = std::memchr(&buffer_[1], 0xFC, count - 1);
+        if (next == nullptr) {
+            drops_++;
+            restart();
+            return;
+        }
+        resyncs_++;
+        const int from = static_cast<int>(static_cast<const uint8_t*>(next) - buffer_);
+        pending_ -= count - from;
+        std::memmove(&buffer_[pending_], &buffer_[from], count - from);
+        restart();
+    }
+
+    /// Reparse queued bytes until they run out or complete a frame.
+    void drain() {
+        while (pending_ < pending_end_ && !frame_complete_) consume(buffer_[pending_++]);
+    }
+
+    /// Start a new frame, keeping the queued bytes.
+    void restart() {
+        found_start_ = false;
+        frame_complete_ = false;
+        bytes_read_ = 0;
+        data_length_ = -1;
+        command_ = 0;
+        checksum_byte_ = 0;
+    }
+
     uint8_t buffer_[MAX_DATA_BYTES]{};
     bool found_start_ = false;
     bool frame_complete_ = false;
@@ -119,6 +241,10 @@ private:
     int data_length_ = -1;
     uint8_t command_ = 0;
     uint8_t checksum_byte_ = 0;
+    int pending_ = 0;               // bytes queued for a rescan: buffer_[pending_..pending_end_)
+    int pending_end_ = 0;
+    uint32_t resyncs_ = 0;
+    uint32_t drops_ = 0;
 };
 
 } // namespace cn105_protocol
@@ -0,0 +1,107 @@
+/// frame_queue.h — Fixed-capacity ring of received CN105 frames and the read-only view handed to decoders.
+/// Deps: frame_parser.h (FrameParser), cn105_types.h (MAX_DATA_BYTES)
+///
+/// Byte ingestion (FrameParser) and decoding are decoupled: each completed frame is copied once
+/// into its own slot, then decoders read it through an immutable FrameView that stays valid
+/// until the slot is popped — the parser can keep assembling the next frame meanwhile.
+///
+/// Usage:
+///   FrameQueue<4> frames;
+///   parser.feed(chunk, n, [&](const FrameParser& p) { frames.push(p, millis()); });
+///   while (!frames.empty()) {
+///       decode(frames.front());
+///       frames.pop();
+///   }
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "frame_parser.h"
+#include "cn105_types.h"
+
+namespace cn105_protocol {
+
+/// Read-only view of one received frame. Points into a FrameQueue slot (no copy).
+struct FrameView {
+    uint8_t command = 0;                // offset 1 in the frame header
+    const uint8_t* payload = nullptr;   // data bytes (offset 5), `length` bytes long
+    uint8_t length = 0;                 // declared data length (offset 4)
+    uint32_t timestamp_ms = 0;          // millis() when the frame was completed
+    bool checksum_ok = false;
+    const uint8_t* raw = nullptr;       // full frame: header + payload + checksum
+    uint8_t raw_length = 0;
+
+    /// Payload byte access, same indexing as the legacy `data[]` pointer.
+    uint8_t operator[](size_t i) const { return payload[i]; }
+};
+
+template <size_t N>
+class FrameQueue {
+public:
+    static constexpr size_t capacity() { return N; }
+
+    /// Copy the frame currently completed in `parser` into the next free slot.
+    /// @return false (and counts an overflow) when every slot is in use.
+    bool push(const FrameParser& parser, uint32_t timestamp_ms) {
+        if (count_ == N) {
+            overflows_++;
+            return false;
+        }
+        Slot& slot = slots_[(head_ + count_) % N];
+        slot.size = static_cast<uint8_t>(parser.frame_size());
+        std::memcpy(slot.bytes, parser.raw(), slot.size);
+        slot.timestamp_ms = timestamp_ms;
+        slot.checksum_ok = parser.checksum_valid();
+        count_++;
+        return true;
+    }
+
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+    size_t size() const { return count_; }
+
+    /// View of the oldest frame. Only valid while !empty() and until pop().
+    FrameView front() const {
+        const Slot& slot = slots_[head_];
+        FrameView view;
+        view.command = slot.bytes[1];
+        view.payload = &slot.bytes[5];
+        view.length = slot.bytes[4];
+        view.timestamp_ms = slot.timestamp_ms;
+        view.checksum_ok = slot.checksum_ok;
+        view.raw = slot.bytes;
+        view.raw_length = slot.size;
+        return view;
+    }
+
+    /// Release the oldest slot.
+    void pop() {
+        if (count_ == 0) return;
+        head_ = (head_ + 1) % N;
+        count_--;
+    }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+    /// Frames lost because the queue was full.
+    uint32_t overflow_count() const { return overflows_; }
+
+private:
+    struct Slot {
+        uint8_t bytes[MAX_DATA_BYTES];
+        uint8_t size;
+        bool checksum_ok;
+        uint32_t timestamp_ms;
+    };
+
+    Slot slots_[N]{};
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t overflows_ = 0;
+};
+
+}  // namespace cn105_protocol
@@ -0,0 +1,164 @@
+/// handshake.h — Non-blocking CONNECT handshake engine: reply timeout, exponential backoff with jitter,
+/// and the installer-mode (0x5B) probe with its fallback to the standard handshake (0x5A).
+/// Deps: none
+///
+/// Driven from loop() (CN105Climate::runHandshake_()), never sleeps:
+///   begin(now) / link_lost(now)  → schedules a CONNECT (now, or after the backoff delay)
+///   poll(now) == SEND_CONNECT    → write CONNECT with connect_command(), then sent(now)
+///   poll(now) == TIMED_OUT       → no 0x7A/0x7B within reply_timeout_ms: next attempt after backoff
+///   poll(now) == PROBE_FAILED    → 0x5B ignored within installer_probe_ms: retry at once with 0x5A
+///   connected(now)               → 0x7A/0x7B received, backoff reset
+///
+/// Backoff: attempt n waits d/2 + rand[0, d/2] with d = min(backoff_max_ms, backoff_min_ms << n)
+/// ("equal jitter"), so several controllers restarted together do not retry in lockstep.
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+    struct HandshakeConfig {
+        uint32_t reply_timeout_ms = 2000;       // CONNECT → 0x7A/0x7B (a live unit answers in ~100 ms)
+        uint32_t installer_probe_ms = 1000;     // 0x5B → 0x7B before falling back to 0x5A
+        uint32_t backoff_min_ms = 500;          // delay before the first retry (before jitter)
+        uint32_t backoff_max_ms = 8000;         // cap: retry + reply timeout stays under the former flat 10 s
+    };
+
+    class HandshakeEngine {
+    public:
+        enum class Action : uint8_t {
+            NONE,
+            SEND_CONNECT,       // the caller writes CONNECT now and calls sent()
+            TIMED_OUT,          // no reply: reinitialise the UART, a retry is scheduled
+            PROBE_FAILED,       // installer handshake ignored: switched to standard, retried at once
+        };
+
+        explicit HandshakeEngine(const HandshakeConfig& config = HandshakeConfig(), uint32_t seed = 0x105)
+            : config_(config), rng_(seed ? seed : 1) {}
+
+        void configure(const HandshakeConfig& config) { config_ = config; }
+        void set_seed(uint32_t seed) { rng_ = seed ? seed : 1; }
+
+        /// Installer (0x5B) handshake requested in YAML: probed first, abandoned for good once ignored.
+        void set_installer_mode(bool requested) {
+            installer_requested_ = requested;
+            installer_effective_ = requested;
+            installer_fallback_done_ = false;
+        }
+
+        /// First connection: CONNECT goes out on the next poll().
+        void begin(uint32_t now_ms) {
+            attempts_ = 0;
+            schedule(now_ms, 0);
+        }
+
+        /// The link was lost (no reply for too long): reconnect after the first backoff step.
+        void link_lost(uint32_t now_ms) {
+            if (in_progress()) return;
+            attempts_ = 0;
+            schedule(now_ms, next_delay());
+        }
+
+        /// CONNECT could not be written (UART not ready): try again after the backoff delay.
+        void retry_later(uint32_t now_ms) {
+            attempts_++;
+            schedule(now_ms, next_delay());
+        }
+
+        Action poll(uint32_t now_ms) {
+            switch (phase_) {
+            case Phase::WAIT_RETRY:
+                if (int32_t(now_ms - deadline_ms_) < 0) return Action::NONE;
+                return Action::SEND_CONNECT;
+            case Phase::AWAIT_REPLY:
+                if (int32_t(now_ms - deadline_ms_) < 0) return Action::NONE;
+                if (probing()) {
+                    installer_effective_ = false;
+                    installer_fallback_done_ = true;
+                    schedule(now_ms, 0);
+                    return Action::PROBE_FAILED;
+                }
+                attempts_++;
+                schedule(now_ms, next_delay());
+                return Action::TIMED_OUT;
+            default:
+                return Action::NONE;
+            }
+        }
+
+        /// CONNECT written: the reply (or probe) timer starts.
+        void sent(uint32_t now_ms) {
+            phase_ = Phase::AWAIT_REPLY;
+            sent_ms_ = now_ms;
+            deadline_ms_ = now_ms + (probing() ? config_.installer_probe_ms : config_.reply_timeout_ms);
+            nb_sent_++;
+        }
+
+        /// 0x7A/0x7B received.
+        void connected(uint32_t now_ms) {
+            last_connect_ms_ = (phase_ == Phase::AWAIT_REPLY) ? now_ms - sent_ms_ : 0;
+            phase_ = Phase::IDLE;
+            attempts_ = 0;
+        }
+
+        /// CONNECT command byte for the next attempt (0x5B while the installer probe is on).
+        uint8_t connect_command() const { return installer_effective_ ? 0x5B : 0x5A; }
+        bool installer_effective() const { return installer_effective_; }
+        bool installer_fallback_done() const { return installer_fallback_done_; }
+
+        /// A retry is scheduled or a reply awaited: reconnect requests from elsewhere are ignored.
+        bool in_progress() const { return phase_ != Phase::IDLE; }
+        bool awaiting_reply() const { return phase_ == Phase::AWAIT_REPLY; }
+        uint32_t attempts() const { return attempts_; }
+        uint32_t nb_sent() const { return nb_sent_; }
+        uint32_t last_delay_ms() const { return last_delay_ms_; }
+        uint32_t last_connect_ms() const { return last_connect_ms_; }        // CONNECT → reply of the last success
+
+        /// Milliseconds until the next CONNECT (0 when due or not waiting to retry).
+        uint32_t next_attempt_in(uint32_t now_ms) const {
+            if (phase_ != Phase::WAIT_RETRY || int32_t(now_ms - deadline_ms_) >= 0) return 0;
+            return deadline_ms_ - now_ms;
+        }
+
+        /// Backoff ceiling (before jitter) for a given attempt count.
+        uint32_t backoff_ms(uint32_t attempt) const {
+            uint32_t d = config_.backoff_min_ms;
+            for (uint32_t i = 0; i < attempt && d < config_.backoff_max_ms; i++) d <<= 1;
+            return d < config_.backoff_max_ms ? d : config_.backoff_max_ms;
+        }
+
+    private:
+        enum class Phase : uint8_t { IDLE, WAIT_RETRY, AWAIT_REPLY };
+
+        bool probing() const { return installer_requested_ && installer_effective_ && !installer_fallback_done_; }
+
+        uint32_t next_delay() {
+            const uint32_t d = backoff_ms(attempts_);
+            // xorshift32: cheap, deterministic per seed
+            rng_ ^= rng_ << 13;
+            rng_ ^= rng_ >> 17;
+            rng_ ^= rng_ << 5;
+            return d / 2 + rng_ % (d / 2 + 1);
+        }
+
+        void schedule(uint32_t now_ms, uint32_t delay_ms) {
+            phase_ = Phase::WAIT_RETRY;
+            deadline_ms_ = now_ms + delay_ms;
+            last_delay_ms_ = delay_ms;
+        }
+
+        HandshakeConfig config_;
+        uint32_t rng_;
+        Phase phase_ = Phase::IDLE;
+        uint32_t deadline_ms_ = 0;
+        uint32_t sent_ms_ = 0;
+        uint32_t attempts_ = 0;
+        uint32_t nb_sent_ = 0;
+        uint32_t last_delay_ms_ = 0;
+        uint32_t last_connect_ms_ = 0;
+        bool installer_requested_ = false;
+        bool installer_effective_ = false;
+        bool installer_fallback_done_ = false;
+    };
+
+}
@@ -47,55 +47,44 @@ void CN105Climate::functionsArrived() {
     }
 }
 
+/**
+ * Queues both function SET packets (0x1F then 0x21). Each one is written when it reaches the head of
+ * the TX queue and the second waits for the ACK of the first, instead of going out back to back.
+ */
 bool CN105Climate::setFunctions(heatpumpFunctions const& functions) {
     if (!functions.isValid()) {
         return false;
     }
+    if (&functions != &this->functions) {
+        this->functions = functions;
+    }
+    this->scheduler_.enqueue_write(WRITE_FUNCTIONS_1);
+    this->scheduler_.enqueue_write(WRITE_FUNCTIONS_2);
+    return true;
+}
 
-    uint8_t packet1[PACKET_LEN] = {};
-    uint8_t packet2[PACKET_LEN] = {};
-
-    prepareSetPacket(packet1, PACKET_LEN);
-    packet1[5] = FUNCTIONS_SET_PART1;
-
-    prepareSetPacket(packet2, PACKET_LEN);
-    packet2[5] = FUNCTIONS_SET_PART2;
+bool CN105Climate::writeFunctionsPacket(uint8_t code) {
+    if (!this->functions.isValid()) {
+        return false;
+    }
 
-    functions.getData1(&packet1[6]);
-    functions.getData2(&packet2[6]);
+    uint8_t packet[PACKET_LEN] = {};
+    prepareSetPacket(packet, PACKET_LEN);
+    packet[5] = code;
+    if (code == FUNCTIONS_SET_PART1) {
+        this->functions.getData1(&packet[6]);
+    } else {
+        this->functions.getData2(&packet[6]);
+    }
 
     // sanity check, we expect data byte 15 (index 20) to be 0
     // REMOVED for Bug #485 - newer units use these bytes
-    // if (packet1[20] != 0 || packet2[20] != 0)
+    // if (packet[20] != 0)
     //    return false;
 
-    // make sure all the other data bytes are set
-    // REMOVED for Bug #485
-    /* for (int i = 6; i < 20; ++i) {
-        if (packet1[i] == 0 || packet2[i] == 0)
-            return false;
-    } */
-
-    packet1[21] = checkSum(packet1, 21);
-    packet2[21] = checkSum(packet2, 21);
-    /*
-        while (!canSend(false)) {
-            //esphome::CUSTOM_DELAY(10);
-            CUSTOM_DELAY(10);
-        }*/
-    ESP_LOGD(TAG, "sending a setFunctions packet part 1");
-    writePacket(packet1, PACKET_LEN);
-    //readPacket();
-
-    /*while (!canSend(false)) {
-        //esphome::CUSTOM_DELAY(10);
-        CUSTOM_DELAY(10);
-    }*/
-    ESP_LOGD(TAG, "sending a setFunctions packet part 2");
-    writePacket(packet2, PACKET_LEN);
-    //readPacket();
-
-    return true;
+    packet[21] = checkSum(packet, 21);
+    ESP_LOGD(TAG, "sending a setFunctions packet part %d", code == FUNCTIONS_SET_PART1 ? 1 : 2);
+    return writePacket(packet, PACKET_LEN);
 }
 
 
@@ -107,12 +96,12 @@ bool heatpumpFunctions::isValid() const {
     return _isValid1 && _isValid2;
 }
 
-void heatpumpFunctions::setData1(uint8_t* data) {
+void heatpumpFunctions::setData1(const uint8_t* data) {
     memcpy(raw, data, 15);
     _isValid1 = true;
 }
 
-void heatpumpFunctions::setData2(uint8_t* data) {
+void heatpumpFunctions::setData2(const uint8_t* data) {
     memcpy(raw + 15, data, 15);
     _isValid2 = true;
 }
@@ -4,79 +4,102 @@
 
 using namespace esphome;
 
+/// Decoded entry, or the previous one (with a warning) when the byte was not in its map.
+template <typename Entry>
+static Entry decodedOrPrevious(Entry decoded, Entry previous, const char* field, uint8_t raw) {
+    if (is_set(decoded)) return decoded;
+    ESP_LOGW("Decoder", "Unknown %s byte 0x%02X — keeping previous value", field, raw);
+    return previous;
+}
+
 /**
  * processInput: reads available bytes from UART and feeds them to the FrameParser.
- * When a complete frame is detected, delegates to processDataPacket().
+ * Completed frames are copied into rx_frames_ and decoded from there by drainFrames().
  */
 
 
 bool CN105Climate::processInput(void) {
+    CN105_PROFILE_PHASE(UART_READ);
+    // Drain the UART in chunks: one read_array() per chunk instead of one virtual read_byte() per byte
+    uint8_t chunk[UART_READ_CHUNK_SIZE];
     bool processed = false;
-    while (this->get_hw_serial_()->available()) {
+    int avail;
+    while ((avail = this->get_hw_serial_()->available()) > 0) {
+        size_t n = static_cast<size_t>(avail) < sizeof(chunk) ? static_cast<size_t>(avail) : sizeof(chunk);
+        if (!this->get_hw_serial_()->read_array(chunk, n)) {
+            break;
+        }
         processed = true;
-        uint8_t inputData;
-        if (this->get_hw_serial_()->read_byte(&inputData)) {
-            ESP_LOGV("Decoder", "--> %02X", inputData);
-            this->parser_.feed(inputData);
-            if (this->parser_.frame_complete()) {
-                this->processDataPacket();
-                this->parser_.reset();
+        this->parser_.feed(chunk, n, [this](const cn105_protocol::FrameParser& parser) {
+            if (this->rx_frames_.full()) {
+                // burst larger than the ring: decode what we have to free the slots
+                this->drainFrames();
             }
-        }
+            this->rx_frames_.push(parser, CUSTOM_MILLIS);
+        });
+        this->drainFrames();
     }
     return processed;
 }
 
 /**
- * processDataPacket: called when the FrameParser has assembled a complete frame.
- * Validates checksum, sets the data pointer, and dispatches to processCommand().
+ * drainFrames: decodes every queued frame, oldest first, then releases its slot.
  */
-void CN105Climate::processDataPacket() {
+void CN105Climate::drainFrames() {
+    while (!this->rx_frames_.empty()) {
+        this->processDataPacket(this->rx_frames_.front());
+        this->rx_frames_.pop();
+    }
+}
 
-    ESP_LOGV(TAG, "processing data packet...");
+/**
+ * processDataPacket: called for each frame taken from rx_frames_.
+ * Validates checksum and dispatches to processCommand().
+ */
+void CN105Climate::processDataPacket(const cn105_protocol::FrameView& frame) {
+    CN105_PROFILE_PHASE(DECODE);
 
-    // Point data at the payload section of the parser buffer
-    // Note: cast away const because downstream code uses non-const data pointer
-    this->data = const_cast<uint8_t*>(this->parser_.data());
+    ESP_LOGV(TAG, "processing data packet...");
 
-    this->hpPacketDebug(this->parser_.raw(), this->parser_.frame_size(), "READ");
+    CN105_CAPTURE_FRAME(RX, frame.timestamp_ms, frame.raw, frame.raw_length);
+    this->hpPacketDebug(frame.raw, frame.raw_length, "READ");
 
     // During handshake, log every received frame for diagnostics
     if (!this->isHeatpumpConnected()) {
         ESP_LOGD(LOG_CONN_TAG, "RX during handshake (cmd=0x%02X len=%d)",
-            this->parser_.command(), this->parser_.data_length());
-        this->hpPacketDebug(this->parser_.raw(), this->parser_.frame_size(), LOG_CONN_TAG);
+            frame.command, frame.length);
+        this->hpPacketDebug(frame.raw, frame.raw_length, LOG_CONN_TAG);
     }
 
-    if (this->parser_.checksum_valid()) {
+    if (frame.checksum_ok) {
         ESP_LOGD("chkSum", "OK");
         // checkpoint of a heatpump response
-        this->lastResponseMs = CUSTOM_MILLIS;
+        this->lastResponseMs = frame.timestamp_ms;
 
         // processing the specific command
-        processCommand();
+        processCommand(frame);
     } else {
         ESP_LOGW("chkSum", "KO -> checksum mismatch (cmd=0x%02X len=%d)",
-            this->parser_.command(), this->parser_.data_length());
+            frame.command, frame.length);
         if (!this->isHeatpumpConnected()) {
             ESP_LOGD(LOG_CONN_TAG, "Checksum KO during handshake");
-            this->hpPacketDebug(this->parser_.raw(), this->parser_.frame_size(), LOG_CONN_TAG);
+            this->hpPacketDebug(frame.raw, frame.raw_length, LOG_CONN_TAG);
         }
     }
 }
 
 
 
-void CN105Climate::getAutoModeStateFromResponsePacket() {
+void CN105Climate::getAutoModeStateFromResponsePacket(const cn105_protocol::FrameView& frame) {
     heatpumpSettings receivedSettings{};
 
-    if (data[10] == 0x00) {
+    if (frame[10] == 0x00) {
         ESP_LOGD("Decoder", "[0x10 is 0x00]");
 
-    } else if (data[10] == 0x01) {
+    } else if (frame[10] == 0x01) {
         ESP_LOGD("Decoder", "[0x10 is 0x01]");
 
-    } else if (data[10] == 0x02) {
+    } else if (frame[10] == 0x02) {
         ESP_LOGD("Decoder", "[0x10 is 0x02]");
 
     } else {
@@ -85,140 +108,82 @@ void CN105Climate::getAutoModeStateFromResponsePacket() {
     }
 }
 
-void CN105Climate::getPowerFromResponsePacket() {
+void CN105Climate::getPowerFromResponsePacket(const cn105_protocol::FrameView& frame) {
     ESP_LOGD("Decoder", "[0x09 is sub modes]");
 
+    const cn105_protocol::StageFrame decoded = cn105_protocol::decode_stage(frame.payload);
     heatpumpSettings receivedSettings{};
+    receivedSettings.stage = decodedOrPrevious(decoded.stage, this->currentSettings.stage, "stage", frame[4]);
+    receivedSettings.sub_mode = decodedOrPrevious(decoded.sub_mode, this->currentSettings.sub_mode, "sub_mode", frame[3]);
+    receivedSettings.auto_sub_mode = decodedOrPrevious(decoded.auto_sub_mode, this->currentSettings.auto_sub_mode, "auto_sub_mode", frame[5]);
 
-    // Use std::optional lookups — keep previous value on unknown bytes
-    auto stage_opt = cn105_protocol::lookup_value_opt(STAGE_MAP, STAGE, 7, data[4]);
-    if (stage_opt) {
-        receivedSettings.stage = *stage_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown stage byte 0x%02X — keeping previous value", data[4]);
-        receivedSettings.stage = this->currentSettings.stage;
-    }
-
-    auto sub_mode_opt = cn105_protocol::lookup_value_opt(SUB_MODE_MAP, SUB_MODE, 6, data[3]);
-    if (sub_mode_opt) {
-        receivedSettings.sub_mode = *sub_mode_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown sub_mode byte 0x%02X — keeping previous value", data[3]);
-        receivedSettings.sub_mode = this->currentSettings.sub_mode;
-    }
-
-    auto auto_sub_mode_opt = cn105_protocol::lookup_value_opt(AUTO_SUB_MODE_MAP, AUTO_SUB_MODE, 7, data[5]);
-    if (auto_sub_mode_opt) {
-        receivedSettings.auto_sub_mode = *auto_sub_mode_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown auto_sub_mode byte 0x%02X — keeping previous value", data[5]);
-        receivedSettings.auto_sub_mode = this->currentSettings.auto_sub_mode;
-    }
-
-    ESP_LOGD("Decoder", "[Stage : %s]", receivedSettings.stage);
-    ESP_LOGD("Decoder", "[Sub Mode  : %s]", receivedSettings.sub_mode);
-    ESP_LOGD("Decoder", "[Auto Mode Sub Mode  : %s]", receivedSettings.auto_sub_mode);
+    ESP_LOGD("Decoder", "[Stage : %s]", getIfNotNull(to_label(receivedSettings.stage), "-"));
+    ESP_LOGD("Decoder", "[Sub Mode  : %s]", getIfNotNull(to_label(receivedSettings.sub_mode), "-"));
+    ESP_LOGD("Decoder", "[Auto Mode Sub Mode  : %s]", getIfNotNull(to_label(receivedSettings.auto_sub_mode), "-"));
 
     //this->heatpumpUpdate(receivedSettings);
-    if (this->stage_sensor_ != nullptr) {
-        if (!this->currentSettings.stage || strcmp(receivedSettings.stage, this->currentSettings.stage) != 0) {
+    if (this->stage_sensor_ != nullptr && is_set(receivedSettings.stage)) {
+        if (receivedSettings.stage != this->currentSettings.stage) {
             this->currentSettings.stage = receivedSettings.stage;
-            this->stage_sensor_->publish_state(receivedSettings.stage);
+            this->stage_sensor_->publish_state(to_label(receivedSettings.stage));
 
-            // If using stage as operating fallback, update action immediately when stage changes
-            // and publish to Home Assistant
+            // If using stage as operating fallback, the action changes with the stage:
+            // updated and published to Home Assistant at the end of the cycle
             if (this->use_stage_for_operating_status_) {
-                this->updateAction();
-                this->publish_state();
+                this->pendingPublish_.mark(PublishField::CLIMATE);
             }
         }
     }
-    if (this->Sub_mode_sensor_ != nullptr && (!this->currentSettings.sub_mode || strcmp(receivedSettings.sub_mode, this->currentSettings.sub_mode) != 0)) {
+    if (this->Sub_mode_sensor_ != nullptr && is_set(receivedSettings.sub_mode) && receivedSettings.sub_mode != this->currentSettings.sub_mode) {
         this->currentSettings.sub_mode = receivedSettings.sub_mode;
-        this->Sub_mode_sensor_->publish_state(receivedSettings.sub_mode);
+        this->Sub_mode_sensor_->publish_state(to_label(receivedSettings.sub_mode));
     }
-    if (this->Auto_sub_mode_sensor_ != nullptr && (!this->currentSettings.auto_sub_mode || strcmp(receivedSettings.auto_sub_mode, this->currentSettings.auto_sub_mode) != 0)) {
+    if (this->Auto_sub_mode_sensor_ != nullptr && is_set(receivedSettings.auto_sub_mode) && receivedSettings.auto_sub_mode != this->currentSettings.auto_sub_mode) {
         this->currentSettings.auto_sub_mode = receivedSettings.auto_sub_mode;
-        this->Auto_sub_mode_sensor_->publish_state(receivedSettings.auto_sub_mode);
+        this->Auto_sub_mode_sensor_->publish_state(to_label(receivedSettings.auto_sub_mode));
     }
 }
 
-void CN105Climate::getSettingsFromResponsePacket() {
+void CN105Climate::getSettingsFromResponsePacket(const cn105_protocol::FrameView& frame) {
+    const cn105_protocol::SettingsFrame decoded = cn105_protocol::decode_settings(frame.payload);
     heatpumpSettings receivedSettings{};
     heatpumpRunStates receivedRunStates{};
     ESP_LOGD("Decoder", "[0x02 is settings]");
 
     receivedSettings.connected = true;
+    receivedSettings.power = decodedOrPrevious(decoded.power, this->currentSettings.power, "power", frame[3]);
+    receivedSettings.iSee = decoded.isee;
+    receivedSettings.mode = decodedOrPrevious(decoded.mode, this->currentSettings.mode, "mode",
+        static_cast<uint8_t>(decoded.isee ? frame[4] - 0x08 : frame[4]));
 
-    auto power_opt = cn105_protocol::lookup_value_opt(POWER_MAP, POWER, 2, data[3]);
-    if (power_opt) {
-        receivedSettings.power = *power_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown power byte 0x%02X — keeping previous value", data[3]);
-        receivedSettings.power = this->currentSettings.power;
-    }
-
-    receivedSettings.iSee = data[4] > 0x08 ? true : false;
-    uint8_t modeByte = receivedSettings.iSee ? (data[4] - 0x08) : data[4];
-    auto mode_opt = cn105_protocol::lookup_value_opt(MODE_MAP, MODE, 5, modeByte);
-    if (mode_opt) {
-        receivedSettings.mode = *mode_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown mode byte 0x%02X — keeping previous value", modeByte);
-        receivedSettings.mode = this->currentSettings.mode;
-    }
-
-    ESP_LOGD("Decoder", "[Power : %s]", receivedSettings.power);
+    ESP_LOGD("Decoder", "[Power : %s]", getIfNotNull(to_label(receivedSettings.power), "-"));
     ESP_LOGD("Decoder", "[iSee  : %d]", receivedSettings.iSee);
-    ESP_LOGD("Decoder", "[Mode  : %s]", receivedSettings.mode);
+    ESP_LOGD("Decoder", "[Mode  : %s]", getIfNotNull(to_label(receivedSettings.mode), "-"));
 
-    if (data[11] != 0x00) {
-        int temp = data[11];
-        temp -= 128;
-        receivedSettings.temperature = (float)temp / 2;
+    if (decoded.temperature_encoding_b) {
         this->use_temperature_encoding_b_ = true;
+    }
+    if (std::isnan(decoded.temperature)) {
+        ESP_LOGW("Decoder", "Unknown temperature byte 0x%02X — keeping previous value", frame[5]);
+        receivedSettings.temperature = this->currentSettings.temperature;
     } else {
-        auto temp_opt = cn105_protocol::lookup_value_opt(TEMP_MAP, TEMP, 16, data[5]);
-        if (temp_opt) {
-            receivedSettings.temperature = static_cast<float>(*temp_opt);
-        } else {
-            ESP_LOGW("Decoder", "Unknown temperature byte 0x%02X — keeping previous value", data[5]);
-            receivedSettings.temperature = this->currentSettings.temperature;
-        }
+        receivedSettings.temperature = decoded.temperature;
     }
 
     ESP_LOGD("Decoder", "[Temp °C: %f]", receivedSettings.temperature);
 
-    auto fan_opt = cn105_protocol::lookup_value_opt(FAN_MAP, FAN, 6, data[6]);
-    if (fan_opt) {
-        receivedSettings.fan = *fan_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown fan byte 0x%02X — keeping previous value", data[6]);
-        receivedSettings.fan = this->currentSettings.fan;
-    }
-    ESP_LOGD("Decoder", "[Fan: %s]", receivedSettings.fan);
+    receivedSettings.fan = decodedOrPrevious(decoded.fan, this->currentSettings.fan, "fan", frame[6]);
+    ESP_LOGD("Decoder", "[Fan: %s]", getIfNotNull(to_label(receivedSettings.fan), "-"));
 
-    auto vane_opt = cn105_protocol::lookup_value_opt(VANE_MAP, VANE, 7, data[7]);
-    if (vane_opt) {
-        receivedSettings.vane = *vane_opt;
-    } else {
-        ESP_LOGW("Decoder", "Unknown vane byte 0x%02X — keeping previous value", data[7]);
-        receivedSettings.vane = this->currentSettings.vane;
-    }
-    ESP_LOGD("Decoder", "[Vane: %s]", receivedSettings.vane);
+    receivedSettings.vane = decodedOrPrevious(decoded.vane, this->currentSettings.vane, "vane", frame[7]);
+    ESP_LOGD("Decoder", "[Vane: %s]", getIfNotNull(to_label(receivedSettings.vane), "-"));
 
     // --- START OF MODIFIED SECTION - Reverted widevane section back to more or less original state
-    if ((data[10] != 0) && (this->traits_.supports_swing_mode(climate::CLIMATE_SWING_HORIZONTAL))) {    // wideVane is not always supported
-        uint8_t wideVaneByte = data[10] & 0x0F;
-        auto wideVane_opt = cn105_protocol::lookup_value_opt(WIDEVANE_MAP, WIDEVANE, 8, wideVaneByte);
-        if (wideVane_opt) {
-            receivedSettings.wideVane = *wideVane_opt;
-        } else {
-            ESP_LOGW("Decoder", "Unknown wideVane byte 0x%02X — keeping previous value", wideVaneByte);
-            receivedSettings.wideVane = this->currentSettings.wideVane;
-        }
-        this->wideVaneAdj = (data[10] & 0xF0) == 0x80 ? true : false;
-        ESP_LOGD("Decoder", "[wideVane: %s (adj:%d)]", receivedSettings.wideVane, this->wideVaneAdj);
+    if (decoded.wide_vane_reported && (this->traits_.supports_swing_mode(climate::CLIMATE_SWING_HORIZONTAL))) {    // wideVane is not always supported
+        receivedSettings.wideVane = decodedOrPrevious(decoded.wide_vane, this->currentSettings.wideVane, "wideVane",
+            static_cast<uint8_t>(frame[10] & 0x0F));
+        this->wideVaneAdj = decoded.wide_vane_adjust;
+        ESP_LOGD("Decoder", "[wideVane: %s (adj:%d)]", getIfNotNull(to_label(receivedSettings.wideVane), "-"), this->wideVaneAdj);
     } else {
         ESP_LOGD("Decoder", "widevane is not supported");
     }
@@ -234,7 +199,7 @@ void CN105Climate::getSettingsFromResponsePacket() {
     // via the IR remote (e.g. COOL→70%, DRY→50%, HEAT→40%).
     // Not all models populate this byte — it may read 0x00 on unsupported units.
     if (this->target_humidity_sensor_ != nullptr) {
-        uint8_t raw_humidity = data[12];
+        uint8_t raw_humidity = decoded.target_humidity;
         if (raw_humidity > 0 && raw_humidity <= 100) {
             float humidity_pct = static_cast<float>(raw_humidity);
             if (this->target_humidity_sensor_->get_raw_state() != humidity_pct) {
@@ -248,37 +213,30 @@ void CN105Climate::getSettingsFromResponsePacket() {
 
     // --- AIRFLOW CONTROL START
     if (this->airflow_control_select_ != nullptr) {
-        if (data[10] == 0x80) {
-            if (receivedSettings.iSee) {
-                auto airflow_opt = cn105_protocol::lookup_value_opt(AIRFLOW_CONTROL_MAP, AIRFLOW_CONTROL, 3, data[14]);
-                if (airflow_opt) {
-                    receivedRunStates.airflow_control = *airflow_opt;
-                } else {
-                    ESP_LOGW("Decoder", "Unknown airflow_control byte 0x%02X — keeping previous value", data[14]);
-                    receivedRunStates.airflow_control = this->currentRunStates.airflow_control;
-                }
-            } else {
-                // For some reason data[10] is 0x80, but the i-See sensor is not active. 
-                // Some units let us do this, but the real mode is unknown (might be powersave) and the i-See sensor does not get activated.
-                //receivedRunStates.airflow_control = "N/A";
-                ESP_LOGD("Decoder", "i-See sensor not present/active.");
-                receivedRunStates.airflow_control = AIRFLOW_CONTROL_MAP[0];
-            }
-        } else {
-            receivedRunStates.airflow_control = AIRFLOW_CONTROL_MAP[0];
+        if (frame[10] == 0x80 && !decoded.isee) {
+            // For some reason data[10] is 0x80, but the i-See sensor is not active.
+            // Some units let us do this, but the real mode is unknown (might be powersave) and the i-See sensor does not get activated.
+            ESP_LOGD("Decoder", "i-See sensor not present/active.");
         }
-        if (!this->currentRunStates.airflow_control || strcmp(receivedRunStates.airflow_control, this->currentRunStates.airflow_control) != 0) {
+        receivedRunStates.airflow_control = decodedOrPrevious(decoded.airflow_control, this->currentRunStates.airflow_control,
+            "airflow_control", frame[14]);
+        if (is_set(receivedRunStates.airflow_control) && receivedRunStates.airflow_control != this->currentRunStates.airflow_control) {
             this->currentRunStates.airflow_control = receivedRunStates.airflow_control;
-            this->airflow_control_select_->publish_state(receivedRunStates.airflow_control);
+            this->airflow_control_select_->publish_state(to_label(receivedRunStates.airflow_control));
         }
     }
 
     // --- AIRFLOW CONTROL END
 
+    if (this->commandLatency_.awaiting_confirm(CommandKind::SETTINGS) && receivedSettings.confirms(this->lastWrittenSettings_)) {
+        this->commandLatency_.confirmed(CommandKind::SETTINGS, CUSTOM_MILLIS);
+    }
+
     this->heatpumpUpdate(receivedSettings);
+    this->stateRefreshed_(stateFreshness::SETTINGS);
 }
 
-void CN105Climate::getRoomTemperatureFromResponsePacket() {
+void CN105Climate::getRoomTemperatureFromResponsePacket(const cn105_protocol::FrameView& frame) {
 
     heatpumpStatus receivedStatus{};
 
@@ -292,27 +250,16 @@ void CN105Climate::getRoomTemperatureFromResponsePacket() {
     // SP = room setpoint temperature?
     // RM = indoor unit operating time in minutes
 
-    if (data[5] > 1) {
-        receivedStatus.outsideAirTemperature = (data[5] - 128) / 2.0f;
-    } else {
-        receivedStatus.outsideAirTemperature = NAN;
-    }
-
-    if (data[6] != 0x00) {
-        int temp = data[6];
-        temp -= 128;
-        receivedStatus.roomTemperature = temp / 2.0f;
-        ESP_LOGD(LOG_TEMP_SENSOR_TAG, "data[6]  --> [Room °C: %f]", receivedStatus.roomTemperature);
+    const cn105_protocol::RoomTemperatureFrame decoded = cn105_protocol::decode_room_temperature(frame.payload);
+    receivedStatus.outsideAirTemperature = decoded.outside_air_temperature;
+    if (std::isnan(decoded.room_temperature)) {
+        ESP_LOGW("Decoder", "Unknown room_temp byte 0x%02X — keeping previous value", frame[3]);
+        receivedStatus.roomTemperature = this->currentStatus.roomTemperature;
     } else {
-        auto room_temp_opt = cn105_protocol::lookup_value_opt(ROOM_TEMP_MAP, ROOM_TEMP, 32, data[3]);
-        if (room_temp_opt) {
-            receivedStatus.roomTemperature = static_cast<float>(*room_temp_opt);
-        } else {
-            ESP_LOGW("Decoder", "Unknown room_temp byte 0x%02X — keeping previous value", data[3]);
-            receivedStatus.roomTemperature = this->currentStatus.roomTemperature;
-        }
-        ESP_LOGD(LOG_TEMP_SENSOR_TAG, "data[3] map --> [Room °C : %f]", receivedStatus.roomTemperature);
+        receivedStatus.roomTemperature = decoded.room_temperature;
     }
+    ESP_LOGD(LOG_TEMP_SENSOR_TAG, "%s --> [Room °C: %f]", decoded.room_encoding_b ? "data[6]" : "data[3] map",
+        receivedStatus.roomTemperature);
 
     // Update the remote temperature control sensor (Issue 290)
     if (this->remote_temp_sensor_ != nullptr) {
@@ -326,7 +273,7 @@ void CN105Climate::getRoomTemperatureFromResponsePacket() {
         this->remote_temp_sensor_->publish_state(is_remote);
     }
 
-    receivedStatus.runtimeHours = float((data[11] << 16) | (data[12] << 8) | data[13]) / 60;
+    receivedStatus.runtimeHours = decoded.runtime_hours;
 
     ESP_LOGD("Decoder", "[Room °C: %f]", receivedStatus.roomTemperature);
     ESP_LOGD("Decoder", "[OAT  °C: %f]", receivedStatus.outsideAirTemperature);
@@ -337,9 +284,10 @@ void CN105Climate::getRoomTemperatureFromResponsePacket() {
     receivedStatus.inputPower = currentStatus.inputPower;
     receivedStatus.kWh = currentStatus.kWh;
     this->statusChanged(receivedStatus);
+    this->stateRefreshed_(stateFreshness::ROOM);
 }
 
-void CN105Climate::getOperatingAndCompressorFreqFromResponsePacket() {
+void CN105Climate::getOperatingAndCompressorFreqFromResponsePacket(const cn105_protocol::FrameView& frame) {
     //FC 62 01 30 10 06 00 00 1A 01 00 00 00 00 00 00 00 00 00 00 00 3C
     //MSZ-RW25VGHZ-SC1 / MUZ-RW25VGHZ-SC1
     //FC 62 01 30 10 06 00 00 00 01 00 08 05 50 00 00 42 00 00 00 00 B7
@@ -351,38 +299,41 @@ void CN105Climate::getOperatingAndCompressorFreqFromResponsePacket() {
     //      TODO: Currently the maximum size of the counter is not known and
     //            if the counter extends to other bytes.
     // ?? = unknown bytes that appear to have a fixed/constant value
+    const cn105_protocol::StatusFrame decoded = cn105_protocol::decode_status(frame.payload);
     heatpumpStatus receivedStatus{};
     ESP_LOGD("Decoder", "[0x06 is status]");
     //this->last_received_packet_sensor->publish_state("0x62-> 0x06: Data -> Heatpump Status");
 
     // reset counter (because a reply indicates it is connected)
     this->nonResponseCounter = 0;
-    receivedStatus.operating = data[4];
-    // Some models (e.g. PAA/PUZ combo) seem to have some noise on the compressor frequency sensor, even when not in operation.
-    // To avoid reporting random values, set the compressor frequency to 0 when the heatpump is not operating.
-    receivedStatus.compressorFrequency = (data[4]) ? data[3] : 0;
-    receivedStatus.inputPower = convert_input_power_to_W(float((data[5] << 8) | data[6]));
-    receivedStatus.kWh = convert_energy_usage_to_kWh(float((data[7] << 8) | data[8]));
+    receivedStatus.operating = decoded.operating;
+    // Some models (e.g. PAA/PUZ combo) seem to have some noise on the compressor frequency sensor, even when not in operation:
+    // decode_status() reports 0 Hz when the heatpump is not operating.
+    receivedStatus.compressorFrequency = decoded.compressor_frequency;
+    receivedStatus.inputPower = convert_input_power_to_W(decoded.raw_input_power);
+    receivedStatus.kWh = convert_energy_usage_to_kWh(decoded.raw_energy);
 
     // no change with this packet to roomTemperature
     receivedStatus.roomTemperature = currentStatus.roomTemperature;
     receivedStatus.outsideAirTemperature = currentStatus.outsideAirTemperature;
     receivedStatus.runtimeHours = currentStatus.runtimeHours;
     this->statusChanged(receivedStatus);
+    this->stateRefreshed_(stateFreshness::STATUS);
 }
 
-void CN105Climate::getHVACOptionsFromResponsePacket() {
+void CN105Climate::getHVACOptionsFromResponsePacket(const cn105_protocol::FrameView& frame) {
     //MSZ-LN25VG2W
     //FC 62 01 30 10 42 01 01 01 00 00 00 00 00 00 00 00 00 00 00 00 18
     //                  AP NM CL
     // AP = air purifier (1 = on, 0 = off)
     // NM = night mode (1 = on, 0 = off)
     // CL = circulator (1 = on, 0 = off) ! MIGHT BE SAME BYTE AS ECONOCOOL - NEEDS TESTING !
+    const cn105_protocol::HvacOptionsFrame decoded = cn105_protocol::decode_hvac_options(frame.payload);
     heatpumpRunStates receivedRunStates{};
     ESP_LOGD("Decoder", "[0x42 is HVAC options]");
 
     if (this->air_purifier_switch_ != nullptr) {
-        receivedRunStates.air_purifier = data[1];
+        receivedRunStates.air_purifier = decoded.air_purifier;
         ESP_LOGD("Decoder", "[Air purifier : %s]", receivedRunStates.air_purifier ? "ON" : "OFF");
         if (receivedRunStates.air_purifier != this->currentRunStates.air_purifier || receivedRunStates.air_purifier != this->air_purifier_switch_->state) {
             this->currentRunStates.air_purifier = receivedRunStates.air_purifier;
@@ -390,7 +341,7 @@ void CN105Climate::getHVACOptionsFromResponsePacket() {
         }
     }
     if (this->night_mode_switch_ != nullptr) {
-        receivedRunStates.night_mode = data[2];
+        receivedRunStates.night_mode = decoded.night_mode;
         ESP_LOGD("Decoder", "[Night mode : %s]", receivedRunStates.night_mode ? "ON" : "OFF");
         if (receivedRunStates.night_mode != this->currentRunStates.night_mode || receivedRunStates.night_mode != this->night_mode_switch_->state) {
             this->currentRunStates.night_mode = receivedRunStates.night_mode;
@@ -398,7 +349,7 @@ void CN105Climate::getHVACOptionsFromResponsePacket() {
         }
     }
     if (this->circulator_switch_ != nullptr) {
-        receivedRunStates.circulator = data[3];
+        receivedRunStates.circulator = decoded.circulator;
         ESP_LOGD("Decoder", "[Circulator : %s]", receivedRunStates.circulator ? "ON" : "OFF");
         if (receivedRunStates.circulator != this->currentRunStates.circulator || receivedRunStates.circulator != this->circulator_switch_->state) {
             this->currentRunStates.circulator = receivedRunStates.circulator;
@@ -408,206 +359,277 @@ void CN105Climate::getHVACOptionsFromResponsePacket() {
 }
 
 void CN105Climate::terminateCycle() {
-    if (this->shouldSendExternalTemperature_) {
-        // We will receive ACK packet for this.
-        // Sending WantedSettings must be delayed in this case (lastSend timestamp updated).        
-        ESP_LOGD(LOG_REMOTE_TEMP, "Sending remote temperature...");
-        this->sendRemoteTemperature();
-    }
-
+    CN105_PROFILE_PHASE(PUBLISH);
     this->loopCycle.cycleEnded();
 
+    this->flushPublishes_();
+
     if (this->hp_uptime_connection_sensor_ != nullptr) {
         // if the uptime connection sensor is configured
         // we trigger  manual update at the end of a cycle.
         this->hp_uptime_connection_sensor_->update();
     }
 
+    if (this->commandLatency_.take_dirty()) {
+        this->publishCommandLatency();
+    }
+
     this->nbCompleteCycles_++;
 }
-void CN105Climate::getErrorInfoFromResponsePacket() {
+
+void CN105Climate::publishCommandLatency() {
+    const uint8_t pct = this->command_latency_percentile_;
+    const auto& latency = this->commandLatency_;
+    ESP_LOGD(LOG_ACK, "command latency p%u: write %u ms, bus %u ms, ack %u ms, confirm %u ms (%u acks, %u lost)",
+        pct, (unsigned)latency.to_write().percentile(pct), (unsigned)latency.bus().percentile(pct),
+        (unsigned)latency.to_ack().percentile(pct), (unsigned)latency.to_confirm().percentile(pct),
+        (unsigned)latency.bus().count(), (unsigned)latency.lost_acks());
+    if (this->command_to_ack_sensor_ != nullptr && latency.to_ack().count() > 0) {
+        this->command_to_ack_sensor_->publish_state(latency.to_ack().percentile(pct));
+    }
+    if (this->command_to_confirm_sensor_ != nullptr && latency.to_confirm().count() > 0) {
+        this->command_to_confirm_sensor_->publish_state(latency.to_confirm().percentile(pct));
+    }
+    if (this->command_bus_sensor_ != nullptr && latency.bus().count() > 0) {
+        this->command_bus_sensor_->publish_state(latency.bus().percentile(pct));
+    }
+}
+
+#ifdef USE_CN105_LOOP_PROFILER
+void CN105Climate::publishLoopProfile_() {
+    const LoopProfiler& profiler = this->loopProfiler_;
+    if (profiler.stats(LoopPhase::LOOP).count() == 0) return;
+    char report[256];
+    profiler.format(report, sizeof(report));
+    ESP_LOGD(TAG, "loop profile (us min/avg/max/p99): %s", report);
+    const uint32_t loop_max_us = profiler.stats(LoopPhase::LOOP).max_us();
+    if (loop_max_us >= LoopProfiler::BLOCKING_WARN_US) {
+        const LoopPhase worst = profiler.slowest_phase();
+        ESP_LOGW(TAG, "loop() blocked up to %u us, longest phase: %s (%u us)", (unsigned)loop_max_us,
+            loop_phase_to_str(worst), (unsigned)profiler.stats(worst).max_us());
+    }
+    if (this->loop_profiler_report_sensor_ != nullptr) {
+        this->loop_profiler_report_sensor_->publish_state(report);
+    }
+    if (this->loop_profiler_max_sensor_ != nullptr) {
+        this->loop_profiler_max_sensor_->publish_state(loop_max_us);
+    }
+}
+#endif
+
+void CN105Climate::getErrorInfoFromResponsePacket(const cn105_protocol::FrameView& frame) {
     ESP_LOGD("Decoder", "0x04 error info");
     if (this->error_code_sensor_ != nullptr) {
-        uint8_t error_raw = this->data[4];
-        uint8_t error_sub = this->data[5];
-        // Bit 7 (0x80) is a protocol status flag ("error reporting available"),
-        // not an actual error code. Use lower 7 bits for real error detection.
-        uint8_t error_code = error_raw & 0x7F;
-        if (error_code == 0x00 && error_sub == 0x00) {
+        // Bit 7 of data[4] is a protocol status flag ("error reporting available"), not part of the code
+        const cn105_protocol::ErrorInfoFrame decoded = cn105_protocol::decode_error_info(frame.payload);
+        if (!decoded.has_error()) {
             this->error_code_sensor_->publish_state("No Error");
         } else {
             char buf[32];
-            snprintf(buf, sizeof(buf), "Error 0x%02X sub 0x%02X", error_code, error_sub);
+            snprintf(buf, sizeof(buf), "Error 0x%02X sub 0x%02X", decoded.code, decoded.sub_code);
             this->error_code_sensor_->publish_state(buf);
         }
     }
 }
 
-void CN105Climate::getDataFromResponsePacket() {
-
-    // D'abord, laissons l'orchestrateur traiter les codes connus
-    const uint8_t code = this->data[0];
-    if (this->scheduler_.process_response(code)) {
-        return;
-    }
-    // Sinon, switch pour les cas non gÃÂ©rÃÂ©s par l'orchestrateur
-    switch (code) {
-
-    case 0x04:
-        // Handled by orchestrator (r_error_info onResponse → getErrorInfoFromResponsePacket)
-        // Reaching here means the scheduler did not intercept this response — unexpected
-        ESP_LOGW("Decoder", "[0x04] reached switch fallback — should have been handled by orchestrator");
-        break; // orchestrator
-
-    case 0x05:
-        /* timer packet */
-        ESP_LOGW("Decoder", "[0x05 is Timer : not implemented]");
-        //this->last_received_packet_sensor->publish_state("0x62-> 0x05: Data -> Timer Packet");
-        break;
-
-    case 0x06:
-        break; // orchestrator
-    case 0x09:
-        break; // orchestrator
-
-    case 0x10:
-        ESP_LOGD("Decoder", "[0x10 is Unknown : not implemented]");
-        //this->getAutoModeStateFromResponsePacket();
-        break;
-
-    case 0x20: // fallthrough
-    case 0x22:
-        break; // orchestrator
-
-    case 0x42:
-        break; // orchestrator
-
-    default:
-        ESP_LOGW("Decoder", "packet type [%02X] <-- unknown and unexpected", data[0]);
-        //this->last_received_packet_sensor->publish_state("0x62-> ?? : Data -> Unknown");
-        break;
-    }
-
+void CN105Climate::getDataFromResponsePacket(const cn105_protocol::FrameView& frame) {
+    // One lookup on frame[0]: request bookkeeping, decoder (onResponse) and next request,
+    // or a reply-only handler; unknown codes are counted by the scheduler
+    this->scheduler_.process_response(frame, this);
 }
 
 void CN105Climate::updateSuccess() {
-    ESP_LOGD(LOG_ACK, "Last heatpump data update successful!");
-    // nothing can be done here because we have no mean to know wether it is an external temp ack
-    // or a wantedSettings update ack
+    // 0x61 carries no command code, but the unit answers SET writes in order:
+    // the oldest write still waiting is the one acknowledged
+    CommandKind kind;
+    if (this->commandLatency_.ack(CUSTOM_MILLIS, &kind)) {
+        ESP_LOGD(LOG_ACK, "Last heatpump data update successful! (%s, %u ms)",
+            command_kind_to_str(kind), (unsigned)this->commandLatency_.last_ack_ms());
+    } else {
+        ESP_LOGD(LOG_ACK, "Last heatpump data update successful! (no write outstanding)");
+    }
 }
 
-void CN105Climate::processCommand() {
-    switch (this->parser_.command()) {
+void CN105Climate::processCommand(const cn105_protocol::FrameView& frame) {
+    switch (frame.command) {
     case 0x61:  /* last update was successful */
-        this->hpPacketDebug(this->parser_.raw(), this->parser_.frame_size(), LOG_ACK);
+        this->hpPacketDebug(frame.raw, frame.raw_length, LOG_ACK);
         this->updateSuccess();
+        this->scheduler_.process_ack();
         break;
 
     case 0x62:  /* packet contains data (room °C, settings, timer, status, or functions...)*/
-        this->getDataFromResponsePacket();
+        if (frame.length < RESPONSE_DATA_LEN) {
+            // the decoders read fixed offsets: a short reply would decode stale bytes of the queue slot
+            this->shortResponses_++;
+            ESP_LOGD("Decoder", "0x62 reply with %d data bytes ignored", frame.length);
+            break;
+        }
+        this->getDataFromResponsePacket(frame);
         break;
     case 0x7a:  // Connection success (User / standard)
     case 0x7b:  // Connection success (Installer / extended)
         // Log en INFO sur le tag dÃÂ©diÃÂ©, dÃÂ©tails en DEBUG via hpPacketDebug
         ESP_LOGI(LOG_CONN_TAG, "--> Heatpump did reply: connection success (%s, 0x%02X)! <--",
-            (this->parser_.command() == 0x7b) ? "Installer" : "User",
-            this->parser_.command());
-        this->hpPacketDebug(this->parser_.raw(), this->parser_.frame_size(), LOG_CONN_TAG);
+            (frame.command == 0x7b) ? "Installer" : "User",
+            frame.command);
+        this->hpPacketDebug(frame.raw, frame.raw_length, LOG_CONN_TAG);
         // isHeatpumpConnected_ replaced by FSM transition in setHeatpumpConnected()
+        this->handshake_.connected(CUSTOM_MILLIS);
+        ESP_LOGD(LOG_CONN_TAG, "CONNECT answered in %u ms", (unsigned)this->handshake_.last_connect_ms());
         this->setHeatpumpConnected(true);
         // let's say that the last complete cycle was over now
         this->loopCycle.lastCompleteCycleMs = CUSTOM_MILLIS;
-        this->currentSettings.resetSettings();      // each time we connect, we need to reset current setting to force a complete sync with ha component state and receievdSettings
-        this->currentRunStates.resetSettings();
+        if (this->stateFreshness_.warmStart(CUSTOM_MILLIS, this->warm_reconnect_window_ms_)) {
+            // short link loss: keep the snapshot, the first replies are diffed against it
+            ESP_LOGI(LOG_CONN_TAG, "Warm reconnect: keeping unit state from %u ms ago",
+                (unsigned)this->stateFreshness_.staleForMs(CUSTOM_MILLIS));
+        } else {
+            this->currentSettings.resetSettings();      // each time we connect, we need to reset current setting to force a complete sync with ha component state and receievdSettings
+            this->currentRunStates.resetSettings();
+        }
+        // read settings, room temperature and status in the first cycle
+        this->scheduler_.timer_bypass(0x02);
+        this->scheduler_.timer_bypass(0x03);
+        this->scheduler_.timer_bypass(0x06);
         break;
     default:
         break;
     }
 }
 
+void CN105Climate::stateRefreshed_(uint8_t part) {
+    const uint32_t stale_ms = this->stateFreshness_.staleForMs(CUSTOM_MILLIS);
+    if (this->stateFreshness_.refreshed(part) && stale_ms > 0) {
+        ESP_LOGI(LOG_CONN_TAG, "Unit state refreshed %u ms after the link loss", (unsigned)stale_ms);
+    }
+}
 
 void CN105Climate::statusChanged(heatpumpStatus status) {
+    const FieldMask changed = this->statusState_.commit(diff_status(this->currentStatus, status));
+    if (changed == 0) return;   // no change
 
-    if (status != currentStatus) {
-        this->debugStatus("received", status);
-        this->debugStatus("current", currentStatus);
+    this->debugStatus("received", status);
+    this->debugStatus("current", currentStatus);
 
+    // only the fields that moved are published, once, at the end of the cycle
+    if (has_field(changed, StatusField::OPERATING) || has_field(changed, StatusField::ROOM_TEMPERATURE)) {
+        this->pendingPublish_.mark(PublishField::CLIMATE);
+    }
+    if (has_field(changed, StatusField::COMPRESSOR_FREQUENCY)) {
+        this->pendingPublish_.mark(PublishField::COMPRESSOR_FREQUENCY);
+    }
+    if (has_field(changed, StatusField::INPUT_POWER)) {
+        this->pendingPublish_.mark(PublishField::INPUT_POWER);
+    }
+    if (has_field(changed, StatusField::KWH)) {
+        this->pendingPublish_.mark(PublishField::KWH);
+    }
+    if (has_field(changed, StatusField::RUNTIME_HOURS)) {
+        this->pendingPublish_.mark(PublishField::RUNTIME_HOURS);
+    }
+    if (has_field(changed, StatusField::OUTSIDE_AIR_TEMPERATURE)) {
+        this->pendingPublish_.mark(PublishField::OUTSIDE_AIR_TEMPERATURE);
+    }
 
-        this->currentStatus.operating = status.operating;
-        this->currentStatus.compressorFrequency = status.compressorFrequency;
-        this->currentStatus.inputPower = status.inputPower;
-        this->currentStatus.kWh = status.kWh;
-        this->currentStatus.runtimeHours = status.runtimeHours;
-        this->currentStatus.roomTemperature = status.roomTemperature;
-        this->currentStatus.outsideAirTemperature = status.outsideAirTemperature;
+    this->currentStatus.operating = status.operating;
+    this->currentStatus.compressorFrequency = status.compressorFrequency;
+    this->currentStatus.inputPower = status.inputPower;
+    this->currentStatus.kWh = status.kWh;
+    this->currentStatus.runtimeHours = status.runtimeHours;
+    this->currentStatus.roomTemperature = status.roomTemperature;
+    this->currentStatus.outsideAirTemperature = status.outsideAirTemperature;
+    if (has_field(changed, StatusField::ROOM_TEMPERATURE)) {
         this->setCurrentTemperature(this->currentStatus.roomTemperature);
+    }
+}
 
+/**
+ * flushPublishes_: sends what the decoders marked since the last flush. Called at the end of each
+ * cycle (terminateCycle()) and from loop() when no cycle is running (timed-out cycle, late reply).
+ */
+void CN105Climate::flushPublishes_() {
+    if (!this->pendingPublish_.pending()) return;
+    CN105_PROFILE_PHASE(PUBLISH);
+    const uint16_t dirty = this->pendingPublish_.take();
+    auto is = [dirty](PublishField field) { return (dirty & PublishCoalescer::bit(field)) != 0; };
+
+    if (is(PublishField::CLIMATE)) {
         this->updateAction();       // update action info on HA climate component
         this->publish_state();
+    }
+    if (is(PublishField::COMPRESSOR_FREQUENCY)) {
+        this->publishNumeric_(PublishField::COMPRESSOR_FREQUENCY, this->compressor_frequency_sensor_, this->currentStatus.compressorFrequency);
+    }
+    if (is(PublishField::INPUT_POWER)) {
+        this->publishNumeric_(PublishField::INPUT_POWER, this->input_power_sensor_, this->currentStatus.inputPower);
+    }
+    if (is(PublishField::KWH)) {
+        this->publishNumeric_(PublishField::KWH, this->kwh_sensor_, this->currentStatus.kWh);
+    }
+    if (is(PublishField::RUNTIME_HOURS)) {
+        this->publishNumeric_(PublishField::RUNTIME_HOURS, this->runtime_hours_sensor_, this->currentStatus.runtimeHours);
+    }
+    if (is(PublishField::OUTSIDE_AIR_TEMPERATURE)) {
+        this->publishNumeric_(PublishField::OUTSIDE_AIR_TEMPERATURE, this->outside_air_temperature_sensor_,
+            this->fahrenheitSupport_.normalizeHeatpumpTemperatureToUiTemperature(this->currentStatus.outsideAirTemperature));
+    }
+}
 
-        if (this->compressor_frequency_sensor_ != nullptr) {
-            this->compressor_frequency_sensor_->publish_state(currentStatus.compressorFrequency);
-        }
-
-        if (this->input_power_sensor_ != nullptr) {
-            this->input_power_sensor_->publish_state(currentStatus.inputPower);
-        }
-
-        if (this->kwh_sensor_ != nullptr) {
-            this->kwh_sensor_->publish_state(currentStatus.kWh);
-        }
-
-        if (this->runtime_hours_sensor_ != nullptr) {
-            this->runtime_hours_sensor_->publish_state(currentStatus.runtimeHours);
-        }
-
-        if (this->outside_air_temperature_sensor_ != nullptr) {
-            this->outside_air_temperature_sensor_->publish_state(this->fahrenheitSupport_.normalizeHeatpumpTemperatureToUiTemperature(currentStatus.outsideAirTemperature));
-        }
-    } // else no change
+void CN105Climate::publishNumeric_(PublishField field, sensor::Sensor* sensor, float value) {
+    if (sensor == nullptr || !this->pendingPublish_.should_publish(field, value)) return;
+    sensor->publish_state(value);
+    this->pendingPublish_.published(field, value);
 }
 
 
-void CN105Climate::publishStateToHA(heatpumpSettings& settings) {
+void CN105Climate::publishStateToHA(heatpumpSettings& settings, FieldMask changed) {
+    CN105_PROFILE_PHASE(PUBLISH);
 
-    if ((this->wantedSettings.mode == nullptr) && (this->wantedSettings.power == nullptr)) {        // to prevent overwriting a user demand
+    // only the checks of the fields set in `changed` run
+    const bool powerOrMode = has_field(changed, SettingsField::POWER) || has_field(changed, SettingsField::MODE);
+    if (powerOrMode && !is_set(this->wantedSettings.mode) && !is_set(this->wantedSettings.power)) {        // to prevent overwriting a user demand
         checkPowerAndModeSettings(settings);
     }
 
-    this->updateAction();       // update action info on HA climate component
+    if (powerOrMode) {
+        this->updateAction();       // update action info on HA climate component
+    }
 
-    if (this->wantedSettings.fan == nullptr) {  // to prevent overwriting a user demand
+    if (has_field(changed, SettingsField::FAN) && !is_set(this->wantedSettings.fan)) {  // to prevent overwriting a user demand
         checkFanSettings(settings);
     }
 
-    if (this->wantedSettings.vane == nullptr) { // to prevent overwriting a user demand
+    if (has_field(changed, SettingsField::VANE) && !is_set(this->wantedSettings.vane)) { // to prevent overwriting a user demand
         checkVaneSettings(settings);
     }
 
-    if (this->wantedSettings.wideVane == nullptr) { // to prevent overwriting a user demand
+    if (has_field(changed, SettingsField::WIDE_VANE) && !is_set(this->wantedSettings.wideVane)) { // to prevent overwriting a user demand
         checkWideVaneSettings(settings);
     }
 
     // HA Temp
     // Ignorer temporairement une consigne entrante si une consigne utilisateur est en cours
-    bool hasPendingUserTemp = (this->wantedSettings.temperature != -1.0f) && (this->wantedSettings.hasChanged) && (!this->wantedSettings.hasBeenSent);
-    uint32_t graceWindowMs = this->get_update_interval() + DEFER_SCHEDULE_UPDATE_LOOP_DELAY;
-    bool graceAfterSend = (this->wantedSettings.hasBeenSent) && ((CUSTOM_MILLIS - this->wantedSettings.lastChange) < graceWindowMs);
-    if (!hasPendingUserTemp && !graceAfterSend) {
-        if (this->wantedSettings.temperature == -1) { // to prevent overwriting a user demand
-            this->updateTargetTemperaturesFromSettings(settings.temperature);
-            this->currentSettings.temperature = settings.temperature;
+    if (has_field(changed, SettingsField::TEMPERATURE)) {
+        bool hasPendingUserTemp = (this->wantedSettings.temperature != -1.0f) && (this->wantedSettings.hasChanged) && (!this->wantedSettings.hasBeenSent);
+        uint32_t graceWindowMs = this->get_update_interval() + DEFER_SCHEDULE_UPDATE_LOOP_DELAY;
+        bool graceAfterSend = (this->wantedSettings.hasBeenSent) && ((CUSTOM_MILLIS - this->wantedSettings.lastChange) < graceWindowMs);
+        if (!hasPendingUserTemp && !graceAfterSend) {
+            if (this->wantedSettings.temperature == -1) { // to prevent overwriting a user demand
+                this->updateTargetTemperaturesFromSettings(settings.temperature);
+                this->currentSettings.temperature = settings.temperature;
+            }
+        } else {
+            ESP_LOGD(LOG_SETTINGS_TAG, "Ignoring incoming setpoint due to pending user change or grace window");
         }
-    } else {
-        ESP_LOGD(LOG_SETTINGS_TAG, "Ignoring incoming setpoint due to pending user change or grace window");
     }
 
     this->currentSettings.iSee = settings.iSee;
 
     this->currentSettings.connected = true;
 
-    // publish to HA
-    this->publish_state();
+    // published to HA at the end of the cycle
+    this->pendingPublish_.mark(PublishField::CLIMATE);
 
 }
 
@@ -616,14 +638,16 @@ void CN105Climate::publishStateToHA(heatpumpSettings& settings) {
 void CN105Climate::heatpumpUpdate(heatpumpSettings& settings) {
     // settings correponds to current settings
     ESP_LOGV(LOG_SETTINGS_TAG, "Settings received");
-    // if received settings are different from current settings 
-    if (settings != this->currentSettings) {
-        ESP_LOGI(LOG_SETTINGS_TAG, "Settings changed, updating HA states");
+    // fields of the received settings that differ from the current settings
+    const FieldMask changed = this->settingsState_.commit(diff_settings(this->currentSettings, settings));
+    if (changed != 0) {
+        ESP_LOGI(LOG_SETTINGS_TAG, "Settings changed (fields 0x%02X, v%u), updating HA states", changed,
+            (unsigned)this->settingsState_.version());
         this->debugSettings("current", this->currentSettings);
         this->debugSettings("received", settings);
         this->debugSettings("wanted", this->wantedSettings);
         this->debugClimate("climate");
-        this->publishStateToHA(settings);
+        this->publishStateToHA(settings, changed);
     }
 
 }
@@ -639,14 +663,14 @@ void CN105Climate::checkVaneSettings(heatpumpSettings& settings, bool updateCurr
             currentSettings.vane = settings.vane;
         }
 
-        if (strcmp(settings.vane, "SWING") == 0) {
-            if ((currentSettings.wideVane != nullptr) && (strcmp(currentSettings.wideVane, "SWING") == 0)) {
+        if (settings.vane == cn105_protocol::Vane::SWING) {
+            if (currentSettings.wideVane == cn105_protocol::WideVane::SWING) {
                 this->swing_mode = climate::CLIMATE_SWING_BOTH;
             } else {
                 this->swing_mode = climate::CLIMATE_SWING_VERTICAL;
             }
         } else {
-            if ((currentSettings.wideVane != nullptr) && (strcmp(currentSettings.wideVane, "SWING") == 0)) {
+            if (currentSettings.wideVane == cn105_protocol::WideVane::SWING) {
                 this->swing_mode = climate::CLIMATE_SWING_HORIZONTAL;
             } else {
                 this->swing_mode = climate::CLIMATE_SWING_OFF;
@@ -675,14 +699,14 @@ void CN105Climate::checkWideVaneSettings(heatpumpSettings& settings, bool update
             currentSettings.wideVane = settings.wideVane;
         }
 
-        if (strcmp(settings.wideVane, "SWING") == 0) {
-            if ((currentSettings.vane != nullptr) && (strcmp(currentSettings.vane, "SWING") == 0)) {
+        if (settings.wideVane == cn105_protocol::WideVane::SWING) {
+            if (currentSettings.vane == cn105_protocol::Vane::SWING) {
                 this->swing_mode = climate::CLIMATE_SWING_BOTH;
             } else {
                 this->swing_mode = climate::CLIMATE_SWING_HORIZONTAL;
             }
         } else {
-            if ((currentSettings.vane != nullptr) && (strcmp(currentSettings.vane, "SWING") == 0)) {
+            if (currentSettings.vane == cn105_protocol::Vane::SWING) {
                 this->swing_mode = climate::CLIMATE_SWING_VERTICAL;
             } else {
                 this->swing_mode = climate::CLIMATE_SWING_OFF;
@@ -700,15 +724,15 @@ void CN105Climate::checkWideVaneSettings(heatpumpSettings& settings, bool update
 }
 void CN105Climate::updateExtraSelectComponents(heatpumpSettings& settings) {
     if (this->vertical_vane_select_ != nullptr) {
-        if (this->hasChanged(this->vertical_vane_select_->current_option(), settings.vane, "select vane")) {
+        if (this->hasChanged(this->vertical_vane_select_->current_option(), to_label(settings.vane), "select vane")) {
             ESP_LOGI(TAG, "vane setting (extra select component) changed");
-            this->vertical_vane_select_->publish_state(settings.vane);
+            this->vertical_vane_select_->publish_state(to_label(settings.vane));
         }
     }
     if (this->horizontal_vane_select_ != nullptr) {
-        if (this->hasChanged(this->horizontal_vane_select_->current_option(), settings.wideVane, "select wideVane")) {
+        if (this->hasChanged(this->horizontal_vane_select_->current_option(), to_label(settings.wideVane), "select wideVane")) {
             ESP_LOGI(TAG, "widevane setting (extra select component) changed");
-            this->horizontal_vane_select_->publish_state(settings.wideVane);
+            this->horizontal_vane_select_->publish_state(to_label(settings.wideVane));
         }
     }
 }
@@ -718,7 +742,7 @@ void CN105Climate::checkFanSettings(heatpumpSettings& settings, bool updateCurre
          *
          * const char* FAN_MAP[6]         = {"AUTO", "QUIET", "1", "2", "3", "4"};
          */
-         // currentSettings.fan== NULL is true when it is the first time we get en answer from hp
+         // currentSettings.fan is UNSET the first time we get an answer from hp
 
     if (this->hasChanged(currentSettings.fan, settings.fan, "fan")) { // fan setting change ?
         ESP_LOGI(TAG, "fan setting changed");
@@ -726,18 +750,25 @@ void CN105Climate::checkFanSettings(heatpumpSettings& settings, bool updateCurre
             currentSettings.fan = settings.fan;
         }
 
-        if (strcmp(settings.fan, "QUIET") == 0) {
+        switch (settings.fan) {
+        case cn105_protocol::Fan::QUIET:
             this->fan_mode = climate::CLIMATE_FAN_QUIET;
-        } else if (strcmp(settings.fan, "1") == 0) {
+            break;
+        case cn105_protocol::Fan::SPEED_1:
             this->fan_mode = climate::CLIMATE_FAN_LOW;
-        } else if (strcmp(settings.fan, "2") == 0) {
+            break;
+        case cn105_protocol::Fan::SPEED_2:
             this->fan_mode = climate::CLIMATE_FAN_MEDIUM;
-        } else if (strcmp(settings.fan, "3") == 0) {
+            break;
+        case cn105_protocol::Fan::SPEED_3:
             this->fan_mode = climate::CLIMATE_FAN_MIDDLE;
-        } else if (strcmp(settings.fan, "4") == 0) {
+            break;
+        case cn105_protocol::Fan::SPEED_4:
             this->fan_mode = climate::CLIMATE_FAN_HIGH;
-        } else { //case "AUTO" or default:
+            break;
+        default: //case AUTO
             this->fan_mode = climate::CLIMATE_FAN_AUTO;
+            break;
         }
         if (this->fan_mode.has_value()) {
             ESP_LOGD(TAG, "Fan mode is: %i", static_cast<int>(this->fan_mode.value()));
@@ -749,7 +780,7 @@ void CN105Climate::checkFanSettings(heatpumpSettings& settings, bool updateCurre
 
 
 void CN105Climate::checkPowerAndModeSettings(heatpumpSettings& settings, bool updateCurrentSettings) {
-    // currentSettings.power== NULL is true when it is the first time we get en answer from hp
+    // currentSettings.power is UNSET the first time we get an answer from hp
     if (this->hasChanged(currentSettings.power, settings.power, "power") ||
         this->hasChanged(currentSettings.mode, settings.mode, "mode")) {           // mode or power change ?
 
@@ -758,30 +789,37 @@ void CN105Climate::checkPowerAndModeSettings(heatpumpSettings& settings, bool up
             currentSettings.power = settings.power;
             currentSettings.mode = settings.mode;
         }
-        if (strcmp(settings.power, "ON") == 0) {
-            if (strcmp(settings.mode, "HEAT") == 0) {
+        if (settings.power == cn105_protocol::Power::ON) {
+            switch (settings.mode) {
+            case cn105_protocol::Mode::HEAT:
                 this->mode = climate::CLIMATE_MODE_HEAT;
-            } else if (strcmp(settings.mode, "DRY") == 0) {
+                break;
+            case cn105_protocol::Mode::DRY:
                 this->mode = climate::CLIMATE_MODE_DRY;
-            } else if (strcmp(settings.mode, "COOL") == 0) {
+                break;
+            case cn105_protocol::Mode::COOL:
                 this->mode = climate::CLIMATE_MODE_COOL;
                 /*if (cool_setpoint != currentSettings.temperature) {
                     cool_setpoint = currentSettings.temperature;
                     save(currentSettings.temperature, cool_storage);
                 }*/
-            } else if (strcmp(settings.mode, "FAN") == 0) {
+                break;
+            case cn105_protocol::Mode::FAN:
                 this->mode = climate::CLIMATE_MODE_FAN_ONLY;
-            } else if (strcmp(settings.mode, "AUTO") == 0) {
+                break;
+            case cn105_protocol::Mode::AUTO:
                 // If we were in HEAT_COOL via HA, stay in HEAT_COOL even if HP says AUTO
                 if (this->mode != climate::CLIMATE_MODE_HEAT_COOL) {
                     this->mode = climate::CLIMATE_MODE_AUTO;
                 }
-            } else {
+                break;
+            default:
                 ESP_LOGW(
                     TAG,
-                    "Unknown climate mode value %s received from HeatPump",
-                    settings.mode
+                    "Unknown climate mode value %u received from HeatPump",
+                    static_cast<unsigned>(settings.mode)
                 );
+                break;
             }
         } else {
             this->mode = climate::CLIMATE_MODE_OFF;
@@ -16,11 +16,11 @@ void CN105Climate::sendFirstConnectionPacket() {
         memcpy(packet, CONNECT, CONNECT_LEN);
 
         // Choix du mode de handshake: standard (0x5A) ou installateur (0x5B)
-        packet[1] = this->installer_mode_effective_ ? 0x5B : 0x5A;
+        packet[1] = this->handshake_.connect_command();
         // CONNECT a un checksum pré-calculé dans la constante; si on modifie l'octet commande, on doit le recalculer.
         packet[CONNECT_LEN - 1] = checkSum(packet, CONNECT_LEN - 1);
 
-        ESP_LOGI(LOG_CONN_TAG, "Envoi du paquet de connexion en mode %s (0x%02X)...", this->installer_mode_effective_ ? "Installateur" : "Standard", packet[1]);
+        ESP_LOGI(LOG_CONN_TAG, "Envoi du paquet de connexion en mode %s (0x%02X)...", packet[1] == 0x5B ? "Installateur" : "Standard", packet[1]);
 
         // Détails des octets en DEBUG sur le tag de connexion
         this->hpPacketDebug(packet, CONNECT_LEN, LOG_CONN_TAG);
@@ -31,26 +31,14 @@ void CN105Climate::sendFirstConnectionPacket() {
         this->lastConnectRqTimeMs = CUSTOM_MILLIS;
         this->nbHeatpumpConnections_++;
 
-        // we wait for a 10s timeout to check if the hp has replied to connection packet
-        this->set_timeout("checkFirstConnection", 10000, [this]() {
-            if (!this->isHeatpumpConnected()) {
-                ESP_LOGE(LOG_CONN_TAG, "--> Heatpump did not reply: NOT CONNECTED <--");
-                // Fallback automatique: si le mode installateur est demandé mais que la PAC ignore 0x5B,
-                // on retente une fois en mode standard (0x5A) pour préserver la connectivité.
-                if (this->installer_mode_ && this->installer_mode_effective_ && !this->installer_mode_fallback_done_) {
-                    this->installer_mode_effective_ = false;
-                    this->installer_mode_fallback_done_ = true;
-                    ESP_LOGW(LOG_CONN_TAG, "No reply to installer handshake (0x5B). Falling back to standard handshake (0x5A).");
-                }
-                ESP_LOGI(LOG_CONN_TAG, "Reinitializing UART and trying to connect again...");
-                this->reconnectUART();
-            }});
+        // the reply timeout (or installer probe) runs from loop() in runHandshake_()
+        this->handshake_.sent(CUSTOM_MILLIS);
 
     } else {
         ESP_LOGE(LOG_CONN_TAG, "UART doesn't seem to be connected...");
         this->setupUART();
-        // this delay to prevent a logging flood should never happen
-        CUSTOM_DELAY(750);
+        // retried by runHandshake_() after the backoff delay, loop() is never held
+        this->handshake_.retry_later(CUSTOM_MILLIS);
     }
 }
 
@@ -88,12 +76,19 @@ void CN105Climate::prepareSetPacket(uint8_t* packet, int length) {
     }
 }
 
-void CN105Climate::writePacket(uint8_t* packet, int length, bool checkIsActive) {
+/**
+ * Writes a packet to the UART, or keeps it in pending_packet_ for try_write_pending_packet() when the
+ * UART is not ready / the link is inactive.
+ * @return true if the bytes were written now: performQueuedWrite() only expects an ACK in that case
+ */
+bool CN105Climate::writePacket(uint8_t* packet, int length, bool checkIsActive) {
+    CN105_PROFILE_PHASE(WRITE);
 
     if ((this->isUARTReady_()) &&
         (this->isHeatpumpConnectionActive() || (!checkIsActive))) {
 
         ESP_LOGD(TAG, "writing packet...");
+        CN105_CAPTURE_FRAME(TX, CUSTOM_MILLIS, packet, static_cast<size_t>(length));
         this->hpPacketDebug(packet, length, "WRITE");
 
         for (int i = 0; i < length; i++) {
@@ -102,6 +97,7 @@ void CN105Climate::writePacket(uint8_t* packet, int length, bool checkIsActive)
 
         // Prevent sending wantedSettings too soon after writing for example the remote temperature update packet
         this->lastSend = CUSTOM_MILLIS;
+        return true;
 
     } else {
         ESP_LOGW(TAG, "could not write as asked, because UART is not connected");
@@ -109,13 +105,14 @@ void CN105Climate::writePacket(uint8_t* packet, int length, bool checkIsActive)
         ESP_LOGW(TAG, "delaying packet writing because we need to reconnect first...");
         if (length > PACKET_LEN) {
             ESP_LOGE(TAG, "Packet length %d exceeds PACKET_LEN %d, dropping.", length, PACKET_LEN);
-            return;
+            return false;
         }
         memcpy(this->pending_packet_, packet, static_cast<size_t>(length));
         this->pending_packet_len_ = length;
         this->pending_check_is_active_ = checkIsActive;
         this->has_pending_packet_ = true;
         this->set_timeout("write", 4000, [this]() { this->try_write_pending_packet(); });
+        return false;
     }
 }
 
@@ -130,33 +127,22 @@ void CN105Climate::try_write_pending_packet() {
     this->has_pending_packet_ = false;
 }
 
-const char* CN105Climate::getModeSetting() {
-    if (this->wantedSettings.mode) {
-        return this->wantedSettings.mode;
-    } else {
-        return this->currentSettings.mode;
-    }
+cn105_protocol::Mode CN105Climate::getModeSetting() {
+    return is_set(this->wantedSettings.mode) ? this->wantedSettings.mode : this->currentSettings.mode;
 }
 
-const char* CN105Climate::getPowerSetting() {
-    if (this->wantedSettings.power) {
-        return this->wantedSettings.power;
-    } else {
-        return this->currentSettings.power;
-    }
+cn105_protocol::Power CN105Climate::getPowerSetting() {
+    return is_set(this->wantedSettings.power) ? this->wantedSettings.power : this->currentSettings.power;
 }
 
-const char* CN105Climate::getVaneSetting() {
-    if (this->wantedSettings.vane) {
-        return this->wantedSettings.vane;
-    } else {
-        return this->currentSettings.vane;
-    }
+cn105_protocol::Vane CN105Climate::getVaneSetting() {
+    return is_set(this->wantedSettings.vane) ? this->wantedSettings.vane : this->currentSettings.vane;
 }
 
-const char* CN105Climate::getWideVaneSetting() {
-    if (this->wantedSettings.wideVane) {
-        if (strcmp(this->wantedSettings.wideVane, lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 8, 0x80 & 0x0F)) == 0 && !this->currentSettings.iSee) {
+cn105_protocol::WideVane CN105Climate::getWideVaneSetting() {
+    if (is_set(this->wantedSettings.wideVane)) {
+        // AIRFLOW CONTROL (wide vane byte 0x00) needs an active i-See sensor
+        if (this->wantedSettings.wideVane == cn105_protocol::WideVane::AIRFLOW_CONTROL && !this->currentSettings.iSee) {
             this->wantedSettings.wideVane = this->currentSettings.wideVane;
         }
         return this->wantedSettings.wideVane;
@@ -165,12 +151,8 @@ const char* CN105Climate::getWideVaneSetting() {
     }
 }
 
-const char* CN105Climate::getFanSpeedSetting() {
-    if (this->wantedSettings.fan) {
-        return this->wantedSettings.fan;
-    } else {
-        return this->currentSettings.fan;
-    }
+cn105_protocol::Fan CN105Climate::getFanSpeedSetting() {
+    return is_set(this->wantedSettings.fan) ? this->wantedSettings.fan : this->currentSettings.fan;
 }
 
 float CN105Climate::getTemperatureSetting() {
@@ -180,12 +162,8 @@ float CN105Climate::getTemperatureSetting() {
         return this->currentSettings.temperature;
     }
 }
-const char* CN105Climate::getAirflowControlSetting() {
-    if (this->wantedRunStates.airflow_control) {
-        return this->wantedRunStates.airflow_control;
-    } else {
-        return this->currentRunStates.airflow_control;
-    }
+cn105_protocol::AirflowControl CN105Climate::getAirflowControlSetting() {
+    return is_set(this->wantedRunStates.airflow_control) ? this->wantedRunStates.airflow_control : this->currentRunStates.airflow_control;
 }
 bool CN105Climate::getAirPurifierRunState() {
     if (this->wantedRunStates.air_purifier != this->currentRunStates.air_purifier) {
@@ -211,81 +189,61 @@ bool CN105Climate::getCirculatorRunState() {
 
 
 void CN105Climate::createPacket(uint8_t* packet) {
-    prepareSetPacket(packet, PACKET_LEN);
-
     //ESP_LOGD(TAG, "checking differences bw asked settings and current ones...");
     ESP_LOGD(TAG, "building packet for writing...");
 
-    if (this->wantedSettings.power != nullptr) {
-        ESP_LOGD(TAG, "power -> %s", getPowerSetting());
-        int idx = lookupByteMapIndex(POWER_MAP, 2, getPowerSetting(), "power (write)");
-        if (idx >= 0) { packet[8] = POWER[idx]; packet[6] += CONTROL_PACKET_1[0]; } else { ESP_LOGW(TAG, "Ignoring invalid power setting while building packet"); }
+    cn105_protocol::SetRequest req;
+
+    if (is_set(this->wantedSettings.power)) {
+        ESP_LOGD(TAG, "power -> %s", getIfNotNull(to_label(getPowerSetting()), "-"));
+        req.power = getPowerSetting();
     }
 
-    if (this->wantedSettings.mode != nullptr) {
-        ESP_LOGD(TAG, "heatpump mode -> %s", getModeSetting());
-        int idx = lookupByteMapIndex(MODE_MAP, 5, getModeSetting(), "mode (write)");
-        if (idx >= 0) { packet[9] = MODE[idx]; packet[6] += CONTROL_PACKET_1[1]; } else { ESP_LOGW(TAG, "Ignoring invalid mode setting while building packet"); }
+    if (is_set(this->wantedSettings.mode)) {
+        ESP_LOGD(TAG, "heatpump mode -> %s", getIfNotNull(to_label(getModeSetting()), "-"));
+        req.mode = getModeSetting();
     }
 
     if (wantedSettings.temperature != -1) {
-        if (!use_temperature_encoding_b_) {
-            ESP_LOGD(TAG, "temperature (tempmode is false) -> %f", getTemperatureSetting());
-            int idx = lookupByteMapIndex(TEMP_MAP, 16, getTemperatureSetting(), "temperature (write)");
-            if (idx >= 0) { packet[10] = TEMP[idx]; packet[6] += CONTROL_PACKET_1[2]; } else { ESP_LOGW(TAG, "Ignoring invalid temperature setting while building packet"); }
-        } else {
-            ESP_LOGD(TAG, "temperature (tempmode is true) -> %f", getTemperatureSetting());
-            float temp = (getTemperatureSetting() * 2) + 128;
-            packet[19] = (int)temp;
-            packet[6] += CONTROL_PACKET_1[2];
-        }
+        ESP_LOGD(TAG, "temperature (tempmode is %s) -> %f", use_temperature_encoding_b_ ? "true" : "false", getTemperatureSetting());
+        req.temperature = getTemperatureSetting();
+        req.temperature_encoding_b = use_temperature_encoding_b_;
     }
 
-    if (this->wantedSettings.fan != nullptr) {
-        ESP_LOGD(TAG, "heatpump fan -> %s", getFanSpeedSetting());
-        int idx = lookupByteMapIndex(FAN_MAP, 6, getFanSpeedSetting(), "fan (write)");
-        if (idx >= 0) { packet[11] = FAN[idx]; packet[6] += CONTROL_PACKET_1[3]; } else { ESP_LOGW(TAG, "Ignoring invalid fan setting while building packet"); }
+    if (is_set(this->wantedSettings.fan)) {
+        ESP_LOGD(TAG, "heatpump fan -> %s", getIfNotNull(to_label(getFanSpeedSetting()), "-"));
+        req.fan = getFanSpeedSetting();
     }
 
-    if (this->wantedSettings.vane != nullptr) {
-        ESP_LOGD(TAG, "heatpump vane -> %s", getVaneSetting());
-        int idx = lookupByteMapIndex(VANE_MAP, 7, getVaneSetting(), "vane (write)");
-        if (idx >= 0) { packet[12] = VANE[idx]; packet[6] += CONTROL_PACKET_1[4]; } else { ESP_LOGW(TAG, "Ignoring invalid vane setting while building packet"); }
+    if (is_set(this->wantedSettings.vane)) {
+        ESP_LOGD(TAG, "heatpump vane -> %s", getIfNotNull(to_label(getVaneSetting()), "-"));
+        req.vane = getVaneSetting();
     }
 
-    if (this->wantedSettings.wideVane != nullptr) {
-        ESP_LOGD(TAG, "heatpump widevane -> %s", getWideVaneSetting());
-        int idx = lookupByteMapIndex(WIDEVANE_MAP, 8, getWideVaneSetting(), "wideVane (write)");
-        if (idx >= 0) {
-            packet[18] = WIDEVANE[idx] | (this->wideVaneAdj ? 0x80 : 0x00);
-            packet[7] += CONTROL_PACKET_2[0];
-
-
-            switch (this->vane_type_) {
-                case VaneType::SPLIT_HORIZONTAL:
-                    // Experimental: Left Horizontal Vane support for dual vane units (Type A)
-                    // Byte 16 is used in IR protocol for Left Vane (which corresponds to Horizontal/Wide Vane on these units)
-                    // Copy the base WIDEVANE value (without adjustment bit) to Byte 16
-                    packet[16] = WIDEVANE[idx];
-                    break;
-                case VaneType::SPLIT_VERTICAL:
-                    // Experimental: Split Vertical Vane support (Type B)
-                    // TODO: Reverse engineering required for Byte 12 or other control bytes.
-                    // For now, logging to help debugging.
-                    ESP_LOGD(TAG, "Split Vertical Vane: WideVane set to %s (Index %d). Packet[12] (Vertical) is %02X", getWideVaneSetting(), idx, packet[12]);
-                    break;
-                case VaneType::STANDARD:
-                default:
-                    // No special handling
-                    break;
-            }
-        } else { ESP_LOGW(TAG, "Ignoring invalid wideVane setting while building packet"); }
+    if (is_set(this->wantedSettings.wideVane)) {
+        ESP_LOGD(TAG, "heatpump widevane -> %s", getIfNotNull(to_label(getWideVaneSetting()), "-"));
+        req.wide_vane = getWideVaneSetting();
+        req.wide_vane_adj = this->wideVaneAdj;
+        // Experimental: Left Horizontal Vane support for dual vane units (Type A)
+        // Byte 16 is used in IR protocol for Left Vane (which corresponds to Horizontal/Wide Vane on these units)
+        req.split_horizontal_vane = (this->vane_type_ == VaneType::SPLIT_HORIZONTAL);
     }
 
+    uint8_t rejected = cn105_protocol::build_set_packet(packet, req);
 
-    // add the checksum
-    uint8_t chkSum = checkSum(packet, 21);
-    packet[21] = chkSum;
+    if (rejected & cn105_protocol::SET_FIELD_POWER) { ESP_LOGW(TAG, "Ignoring invalid power setting while building packet"); }
+    if (rejected & cn105_protocol::SET_FIELD_MODE) { ESP_LOGW(TAG, "Ignoring invalid mode setting while building packet"); }
+    if (rejected & cn105_protocol::SET_FIELD_TEMPERATURE) { ESP_LOGW(TAG, "Ignoring invalid temperature setting while building packet"); }
+    if (rejected & cn105_protocol::SET_FIELD_FAN) { ESP_LOGW(TAG, "Ignoring invalid fan setting while building packet"); }
+    if (rejected & cn105_protocol::SET_FIELD_VANE) { ESP_LOGW(TAG, "Ignoring invalid vane setting while building packet"); }
+    if (rejected & cn105_protocol::SET_FIELD_WIDE_VANE) { ESP_LOGW(TAG, "Ignoring invalid wideVane setting while building packet"); }
+
+    if (is_set(req.wide_vane) && !(rejected & cn105_protocol::SET_FIELD_WIDE_VANE) && (this->vane_type_ == VaneType::SPLIT_VERTICAL)) {
+        // Experimental: Split Vertical Vane support (Type B)
+        // TODO: Reverse engineering required for Byte 12 or other control bytes.
+        // For now, logging to help debugging.
+        ESP_LOGD(TAG, "Split Vertical Vane: WideVane set to %s. Packet[12] (Vertical) is %02X", to_label(req.wide_vane), packet[12]);
+    }
     //ESP_LOGD(TAG, "debug before write packet:");
     //this->hpPacketDebug(packet, 22, "WRITE");
 }
@@ -296,21 +254,21 @@ void CN105Climate::createPacket(uint8_t* packet) {
 
 void CN105Climate::publishWantedSettingsStateToHA() {
 
-    if ((this->wantedSettings.mode != nullptr) || (this->wantedSettings.power != nullptr)) {
+    if (is_set(this->wantedSettings.mode) || is_set(this->wantedSettings.power)) {
         checkPowerAndModeSettings(this->wantedSettings, false);
         this->updateAction();       // update action info on HA climate component
     }
 
-    if (this->wantedSettings.fan != nullptr) {
+    if (is_set(this->wantedSettings.fan)) {
         checkFanSettings(this->wantedSettings, false);
     }
 
 
-    if ((this->wantedSettings.vane != nullptr) || (this->wantedSettings.wideVane != nullptr)) {
-        if (this->wantedSettings.vane == nullptr) { // to prevent a nullpointer error
+    if (is_set(this->wantedSettings.vane) || is_set(this->wantedSettings.wideVane)) {
+        if (!is_set(this->wantedSettings.vane)) {
             this->wantedSettings.vane = this->currentSettings.vane;
         }
-        if (this->wantedSettings.wideVane == nullptr) { // to prevent a nullpointer error
+        if (!is_set(this->wantedSettings.wideVane)) {
             this->wantedSettings.wideVane = this->currentSettings.wideVane;
         }
 
@@ -329,13 +287,10 @@ void CN105Climate::publishWantedSettingsStateToHA() {
 }
 
 void CN105Climate::publishWantedRunStatesStateToHA() {
-    if (this->wantedRunStates.airflow_control != nullptr) {
-        if (this->wantedRunStates.airflow_control == nullptr) {
-            this->wantedRunStates.airflow_control = this->currentRunStates.airflow_control;
-        }
-        if (this->hasChanged(this->airflow_control_select_->current_option(), this->wantedRunStates.airflow_control, "select airflow control")) {
+    if (is_set(this->wantedRunStates.airflow_control)) {
+        if (this->hasChanged(this->airflow_control_select_->current_option(), to_label(this->wantedRunStates.airflow_control), "select airflow control")) {
             ESP_LOGI(TAG, "airflow control setting changed");
-            this->airflow_control_select_->publish_state(wantedRunStates.airflow_control);
+            this->airflow_control_select_->publish_state(to_label(wantedRunStates.airflow_control));
         }
     }
     if (this->wantedRunStates.air_purifier > -1) {
@@ -368,7 +323,7 @@ void CN105Climate::publishWantedRunStatesStateToHA() {
 }
 
 
-void CN105Climate::sendWantedSettingsDelegate() {
+bool CN105Climate::sendWantedSettingsDelegate() {
     this->wantedSettings.hasBeenSent = true;
     this->lastSend = CUSTOM_MILLIS;
     ESP_LOGI(TAG, "sending wantedSettings..");
@@ -376,45 +331,96 @@ void CN105Climate::sendWantedSettingsDelegate() {
     // and then we send the update packet
     uint8_t packet[PACKET_LEN] = {};
     this->createPacket(packet);
-    this->writePacket(packet, PACKET_LEN);
+    const bool written = this->writePacket(packet, PACKET_LEN);
     this->hpPacketDebug(packet, 22, "WRITE_SETTINGS");
 
     this->publishWantedSettingsStateToHA();
 
+    // kept for the command latency tracker: the 0x02 readback showing these values confirms the write
+    this->lastWrittenSettings_ = this->wantedSettings;
+
     // as soon as the packet is sent, we reset the settings
     this->wantedSettings.resetSettings();
 
-    // as we've just sent a packet to the heatpump, we let it time for process
-    // this might not be necessary but, we give it a try because of issue #32
-    // https://github.com/echavet/MitsubishiCN105ESPHome/issues/32
-    this->loopCycle.deferCycle();
+    // read the settings back on the next cycle even if adaptive polling had stretched 0x02
+    this->scheduler_.timer_bypass(0x02);
+
+    // No fixed pause for the unit to process it (issue #32): the scheduler holds the line
+    // until the 0x61 ACK arrives, paced by the measured ACK round trip.
+    return written;
 }
 
 /**
  * builds and send all an update packet to the heatpump
- *
- *
+ * Called by performQueuedWrite(): the scheduler only runs it when no other packet awaits a reply,
+ * which replaces the former 300 ms throttle on lastSend.
+ * @return true if the packet was written
 */
-void CN105Climate::sendWantedSettings() {
+bool CN105Climate::sendWantedSettings() {
     if (this->isHeatpumpConnectionActive() && this->isUARTReady_()) {
-        if (CUSTOM_MILLIS - this->lastSend > 300) {        // we don't want to send too many packets
-
-            //this->cycleEnded();   // only if we let the cycle be interrupted to send wented settings
+        //this->cycleEnded();   // only if we let the cycle be interrupted to send wented settings
 
 #ifdef USE_ESP32
-            std::lock_guard<std::mutex> guard(wantedSettingsMutex);
-            this->sendWantedSettingsDelegate();
+        std::lock_guard<std::mutex> guard(wantedSettingsMutex);
+        return this->sendWantedSettingsDelegate();
 #else
-            this->emulateMutex("WRITE_SETTINGS", std::bind(&CN105Climate::sendWantedSettingsDelegate, this));
-
-#endif
-
-        } else {
-            ESP_LOGD(TAG, "will sendWantedSettings later because we've sent one too recently...");
+        // control() holds the mutex: not deferred through set_timeout, which would write outside the
+        // scheduler's write slot; checkPendingWantedSettings() queues it again on a later loop
+        if (this->wantedSettingsMutex) {
+            ESP_LOGD(TAG, "wantedSettings locked by control(), write requeued");
+            return false;
         }
-    } else {
-        this->reconnectIfConnectionLost();
+        bool written = false;
+        this->emulateMutex("WRITE_SETTINGS", [this, &written]() { written = this->sendWantedSettingsDelegate(); });
+        return written;
+#endif
     }
+    this->reconnectIfConnectionLost();
+    return false;
+}
+
+/**
+ * Performs a SET write queued with scheduler_.enqueue_write(), once it reaches the head of the queue.
+ * @return the number of packets written, each one answered by a 0x61 ACK
+ */
+uint8_t CN105Climate::performQueuedWrite(uint8_t write_id) {
+    CommandKind kind;
+    bool more_packets = false;
+    bool written = false;
+    switch (write_id) {
+    case WRITE_SETTINGS:
+        if (!this->wantedSettings.hasChanged || this->wantedSettings.hasBeenSent) return 0;
+        kind = CommandKind::SETTINGS;
+        written = this->sendWantedSettings();
+        break;
+    case WRITE_RUN_STATES:
+        if (!this->wantedRunStates.hasChanged || this->wantedRunStates.hasBeenSent) return 0;
+        kind = CommandKind::RUN_STATES;
+        written = this->sendWantedRunStates();
+        break;
+    case WRITE_REMOTE_TEMP:
+        kind = CommandKind::REMOTE_TEMP;
+        written = this->writeRemoteTemperaturePacket();
+        break;
+    case WRITE_FUNCTIONS_1:
+        kind = CommandKind::FUNCTIONS;
+        more_packets = true;
+        written = this->writeFunctionsPacket(FUNCTIONS_SET_PART1);
+        break;
+    case WRITE_FUNCTIONS_2:
+        // Also request to get function settings from heat pump to update UI with latest values.
+        this->isGetFunctions_ = true;
+        kind = CommandKind::FUNCTIONS;
+        written = this->writeFunctionsPacket(FUNCTIONS_SET_PART2);
+        break;
+    default:
+        return 0;
+    }
+    // Only once the bytes are on the UART: ACKs are matched to writes in order, so a written()
+    // that never gets its 0x61 would shift every later ACK onto the wrong command
+    if (!written) return 0;
+    this->commandLatency_.written(kind, CUSTOM_MILLIS, more_packets);
+    return 1;
 }
 
 void CN105Climate::buildAndSendRequestPacket(int packetType) {
@@ -448,8 +454,8 @@ void CN105Climate::buildAndSendRequestsInfoPackets() {
         ESP_LOGV("CONTROL_WANTED_SETTINGS", "hasChanged is %s", wantedSettings.hasChanged ? "true" : "false");
         this->loopCycle.cycleStarted();
         this->nbCycles_++;
-        // Envoie la première requête activable (la liste est enregistrée une fois au constructeur)
-        this->scheduler_.send_next_after(0x00); // 0x00 -> start, pick first eligible
+        // Met en file toutes les requêtes dues (la liste est enregistrée une fois au setup)
+        this->scheduler_.start_cycle();
     } else {
         this->reconnectIfConnectionLost();
     }
@@ -481,7 +487,7 @@ void CN105Climate::createInfoPacket(uint8_t* packet, uint8_t code) {
 
 
 void CN105Climate::sendRemoteTemperaturePacket() {
-    // Build and send the remote temperature packet (0x07) without affecting watchdog/keep-alive timers
+    // Queue the remote temperature packet (0x07) without affecting watchdog/keep-alive timers
 
     // Debounce logic: avoid flooding the bus with identical temperature values
     // Only skip if: same temperature AND sent recently (within half of keep-alive interval, min 5s)
@@ -520,6 +526,17 @@ void CN105Climate::sendRemoteTemperaturePacket() {
     // Reset debounce skip counter on successful send
     this->remote_temp_debounce_skip_count_ = 0;
 
+    // Ordered with the other SET writes; a value queued twice before it goes out is sent once (the latest)
+    this->scheduler_.enqueue_write(WRITE_REMOTE_TEMP);
+}
+
+/**
+ * Builds and writes the 0x07 remote temperature packet from the current remoteTemperature_.
+ * Called by performQueuedWrite() when the queued write reaches the head of the TX queue.
+ * @return true if the packet was written (false: UART not ready, kept for try_write_pending_packet())
+ */
+bool CN105Climate::writeRemoteTemperaturePacket() {
+    const bool temp_changed = (this->remoteTemperature_ != this->last_remote_temp_sent_);
     uint8_t packet[PACKET_LEN] = {};
 
     prepareSetPacket(packet, PACKET_LEN);
@@ -539,11 +556,12 @@ void CN105Climate::sendRemoteTemperaturePacket() {
 
     ESP_LOGD(LOG_REMOTE_TEMP, "Sending remote temperature packet... -> %.1f%s",
         this->remoteTemperature_, temp_changed ? " (changed)" : " (keep-alive)");
-    writePacket(packet, PACKET_LEN);
+    const bool written = writePacket(packet, PACKET_LEN);
 
     // Update debounce tracking
-    this->last_remote_temp_send_ms_ = now;
+    this->last_remote_temp_send_ms_ = CUSTOM_MILLIS;
     this->last_remote_temp_sent_ = this->remoteTemperature_;
+    return written;
 }
 
 void CN105Climate::sendRemoteTemperature() {
@@ -553,16 +571,21 @@ void CN105Climate::sendRemoteTemperature() {
     this->sendRemoteTemperaturePacket();
 }
 
-void CN105Climate::sendWantedRunStates() {
+bool CN105Climate::sendWantedRunStates() {
     uint8_t packet[PACKET_LEN] = {};
 
     prepareSetPacket(packet, PACKET_LEN);
 
     packet[5] = 0x08;
-    if (this->wantedRunStates.airflow_control != nullptr) {
-        ESP_LOGD(TAG, "airflow control -> %s", getAirflowControlSetting());
-        packet[11] = AIRFLOW_CONTROL[lookupByteMapIndex(AIRFLOW_CONTROL_MAP, 3, getAirflowControlSetting(), "run state (write)")];
-        packet[6] += RUN_STATE_PACKET_1[4];
+    if (is_set(this->wantedRunStates.airflow_control)) {
+        const cn105_protocol::AirflowControl airflow = getAirflowControlSetting();
+        ESP_LOGD(TAG, "airflow control -> %s", getIfNotNull(to_label(airflow), "-"));
+        if (AIRFLOW_CONTROL_TABLE.has(airflow)) {
+            packet[11] = AIRFLOW_CONTROL_TABLE.encode(airflow);
+            packet[6] += RUN_STATE_PACKET_1[4];
+        } else {
+            ESP_LOGW(TAG, "run state (write): unknown airflow control %u, not sent", static_cast<unsigned>(airflow));
+        }
     }
     if (this->wantedRunStates.air_purifier > -1) {
         if (getAirPurifierRunState() != currentRunStates.air_purifier) {
@@ -590,10 +613,12 @@ void CN105Climate::sendWantedRunStates() {
     uint8_t chkSum = checkSum(packet, 21);
     packet[21] = chkSum;
     ESP_LOGD(LOG_SET_RUN_STATE, "Sending set run state package (0x08)");
-    writePacket(packet, PACKET_LEN);
+    const bool written = writePacket(packet, PACKET_LEN);
 
     this->publishWantedRunStatesStateToHA();
 
     this->wantedRunStates.resetSettings();
-    this->loopCycle.deferCycle();
+    this->scheduler_.timer_bypass(0x02);   // airflow control is reported in 0x02
+    this->scheduler_.timer_bypass(0x42);
+    return written;
 }
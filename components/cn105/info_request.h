@@ -1,35 +1,48 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
-#include <string>
-#include <cstdio>
+#include "adaptive_polling.h"
+
+namespace cn105_protocol {
+    struct FrameView;
+}
 
 namespace esphome {
 
     class CN105Climate; // forward declaration
 
-    struct InfoRequest {
+    enum RequestFlag : uint8_t {
+        REQUEST_START_DISABLED = 0x01,  // registered disabled; enable_request() turns it on
+    };
+
+    /**
+     * Immutable description of an INFO request. Catalogues are constexpr tables (flash on ESP32,
+     * .rodata on ESP8266): RequestScheduler keeps a pointer to the descriptor and only the
+     * RequestState below is mutable, so registering requests allocates nothing.
+     */
+    struct RequestDescriptor {
+        // Plain function pointers (captureless lambdas): no heap, no type erasure
+        using CanSendFn = bool (*)(const CN105Climate&);
+        using ResponseFn = void (*)(CN105Climate&, const cn105_protocol::FrameView&);
+
         const char* id;
         const char* description;
         uint8_t code;                 // e.g. 0x02, 0x03, 0x06, 0x09, 0x42
         uint8_t maxFailures;          // disable after this many soft failures
-        uint8_t failures;             // current failure count
-        bool disabled;                // permanently disabled when not supported
-        bool awaiting;                // awaiting a matching response
+        uint8_t flags;                // RequestFlag bits
+        PollClass poll_class;         // adaptive polling behaviour (see adaptive_polling.h)
         uint32_t soft_timeout_ms;     // optional: skip forward on timeout without blocking cycle
-        uint32_t interval_ms;         // Minimum time between requests for this specific code
-        uint32_t last_request_time;   // Last time this request was sent (millis)
-        std::string timeout_name;     // unique scheduler name for soft-timeout
+        uint32_t interval_ms;         // default minimum time between requests (RequestScheduler::set_request_interval())
         const char* log_tag;          // Custom log tag (optional), defaults to LOG_CYCLE_TAG logic
 
         // Optional condition to decide whether this request should be sent in this device/config
-        std::function<bool(const CN105Climate&)> canSend;
+        CanSendFn canSend;
 
-        // Optional response handler invoked when the matching response (code) is received
-        std::function<void(CN105Climate&)> onResponse;
+        // Optional response handler invoked when the matching response (code) is received;
+        // the frame view is only valid for the duration of the call
+        ResponseFn onResponse;
 
-        InfoRequest(
+        constexpr RequestDescriptor(
             const char* id,
             const char* description,
             uint8_t code,
@@ -37,12 +50,26 @@ namespace esphome {
             uint32_t soft_timeout_ms = 0,
             uint32_t interval_ms = 0,
             const char* log_tag = nullptr
-        ) : id(id), description(description), code(code), maxFailures(maxFailures), failures(0), disabled(false), awaiting(false), soft_timeout_ms(soft_timeout_ms), interval_ms(interval_ms), last_request_time(0), timeout_name(""), log_tag(log_tag), canSend(nullptr), onResponse(nullptr) {
-            char buf[32];
-            std::snprintf(buf, sizeof(buf), "info_timeout_0x%02X", code);
-            timeout_name = buf;
-        }
-    };
-}
+        ) : id(id), description(description), code(code), maxFailures(maxFailures), flags(0), poll_class(PollClass::FIXED), soft_timeout_ms(soft_timeout_ms), interval_ms(interval_ms), log_tag(log_tag), canSend(nullptr), onResponse(nullptr) {}
 
+        // Builders for the constexpr tables: RequestDescriptor(...).polled(...).on_response(...)
+        constexpr RequestDescriptor polled(PollClass poll) const { RequestDescriptor d = *this; d.poll_class = poll; return d; }
+        constexpr RequestDescriptor can_send(CanSendFn fn) const { RequestDescriptor d = *this; d.canSend = fn; return d; }
+        constexpr RequestDescriptor on_response(ResponseFn fn) const { RequestDescriptor d = *this; d.onResponse = fn; return d; }
+        constexpr RequestDescriptor start_disabled() const { RequestDescriptor d = *this; d.flags |= REQUEST_START_DISABLED; return d; }
+    };
 
+    /**
+     * Per-request mutable state, the only RAM a registered request costs (slot-indexed array in RequestScheduler).
+     */
+    struct RequestState {
+        uint32_t last_request_time = 0;   // Last time this request was sent (millis)
+        uint32_t timeout_at = 0;          // soft-timeout deadline while awaiting (millis), checked by RequestScheduler::loop()
+        uint32_t interval_ms = 0;         // descriptor interval, or the one given to set_request_interval()
+        uint32_t payload_hash = 0;        // fingerprint of the last response payload
+        uint8_t failures = 0;             // current failure count
+        uint8_t stable_count = 0;         // consecutive responses with an unchanged payload
+        bool disabled = false;            // permanently disabled when not supported
+        bool awaiting = false;            // awaiting a matching response
+    };
+}
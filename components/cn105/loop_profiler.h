@@ -0,0 +1,243 @@
+/// loop_profiler.h — Optional per-phase timing of CN105Climate::loop() (min / avg / max / p99 per window).
+/// Deps: none (timestamps are passed in; the component macro reads micros())
+///
+/// Enabled by `loop_profiler:` in YAML, which defines USE_CN105_LOOP_PROFILER. Without it the
+/// CN105_PROFILE_PHASE() markers expand to nothing and no profiler member exists.
+///
+/// Phases nest (a decode that publishes, a write that formats hpPacketDebug): each sample is the
+/// phase's *own* time, nested phases excluded, so the phases of one loop() add up to at most the
+/// LOOP total. A phase entered several times in one loop() (one DECODE per frame) gives one sample
+/// per entry. Statistics cover one window (default 60 s) and are reset once reported.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+namespace esphome {
+
+    enum class LoopPhase : uint8_t {
+        LOOP,           // whole loop() call (total, not own time)
+        CONNECTION,     // maybe_start_connection_(): bootstrap FSM + CONNECT handshake
+        SCHEDULER,      // RequestScheduler::loop(), pending-write checks, cycle start
+        UART_READ,      // processInput(): UART reads + FrameParser
+        DECODE,         // processDataPacket() for one frame
+        PUBLISH,        // publish_state() and sensor publishes
+        WRITE,          // writePacket(): UART writes
+        PACKET_DEBUG,   // hpPacketDebug() formatting and logging
+        COUNT
+    };
+
+    inline const char* loop_phase_to_str(LoopPhase phase) {
+        switch (phase) {
+        case LoopPhase::LOOP: return "loop";
+        case LoopPhase::CONNECTION: return "conn";
+        case LoopPhase::SCHEDULER: return "sched";
+        case LoopPhase::UART_READ: return "read";
+        case LoopPhase::DECODE: return "decode";
+        case LoopPhase::PUBLISH: return "publish";
+        case LoopPhase::WRITE: return "write";
+        case LoopPhase::PACKET_DEBUG: return "pktdbg";
+        default: return "?";
+        }
+    }
+
+    /// Durations of one phase over the current window, in µs. p99 comes from log2 buckets
+    /// (16 µs … 2 s), so it is the upper bound of its bucket, capped by the max seen.
+    class PhaseStats {
+    public:
+        static constexpr uint8_t BUCKETS = 18;      // ≤ 16 << i µs, the last one is overflow
+
+        void record(uint32_t us) {
+            uint8_t i = 0;
+            while (i < BUCKETS - 1 && us > bound_us(i)) i++;
+            buckets_[i]++;
+            if (count_ == 0 || us < min_us_) min_us_ = us;
+            if (us > max_us_) max_us_ = us;
+            sum_us_ += us;
+            count_++;
+        }
+
+        uint32_t percentile(uint8_t pct) const {
+            if (count_ == 0) return 0;
+            const uint64_t rank = (uint64_t(count_) * pct + 99) / 100;
+            uint64_t seen = 0;
+            for (uint8_t i = 0; i < BUCKETS - 1; i++) {
+                seen += buckets_[i];
+                if (seen >= rank) return bound_us(i) < max_us_ ? bound_us(i) : max_us_;
+            }
+            return max_us_;
+        }
+
+        uint32_t count() const { return count_; }
+        uint32_t min_us() const { return min_us_; }
+        uint32_t max_us() const { return max_us_; }
+        uint32_t mean_us() const { return count_ ? static_cast<uint32_t>(sum_us_ / count_) : 0; }
+        uint32_t bucket(uint8_t i) const { return i < BUCKETS ? buckets_[i] : 0; }
+        static constexpr uint32_t bound_us(uint8_t i) { return uint32_t(16) << i; }
+
+        void reset() { *this = PhaseStats(); }
+
+    private:
+        uint32_t buckets_[BUCKETS] = {};
+        uint64_t sum_us_ = 0;
+        uint32_t count_ = 0;
+        uint32_t min_us_ = 0;
+        uint32_t max_us_ = 0;
+    };
+
+    class LoopProfiler {
+    public:
+        static constexpr uint8_t MAX_DEPTH = 4;
+        static constexpr uint32_t DEFAULT_WINDOW_MS = 60000;
+        static constexpr uint32_t BLOCKING_WARN_US = 30000;    // ESPHome's "took a long time" threshold
+
+        void set_window_ms(uint32_t window_ms) { window_ms_ = window_ms; }
+        uint32_t window_ms() const { return window_ms_; }
+
+        void loop_begin(uint32_t now_us) {
+            loop_start_us_ = now_us;
+            mark_us_ = now_us;
+        }
+
+        void loop_end(uint32_t now_us) { stats_[idx(LoopPhase::LOOP)].record(now_us - loop_start_us_); }
+
+        void enter(LoopPhase phase, uint32_t now_us) {
+            if (depth_ == MAX_DEPTH) {
+                overflow_++;            // too deep: counted in the enclosing phase
+                return;
+            }
+            charge(now_us);
+            stack_[depth_].phase = phase;
+            stack_[depth_].own_us = 0;
+            depth_++;
+        }
+
+        void leave(uint32_t now_us) {
+            if (overflow_ > 0) {
+                overflow_--;
+                return;
+            }
+            if (depth_ == 0) return;
+            charge(now_us);
+            depth_--;
+            stats_[idx(stack_[depth_].phase)].record(stack_[depth_].own_us);
+        }
+
+        /// True once per window: the caller reports, then calls start_window().
+        bool window_elapsed(uint32_t now_ms) {
+            if (!started_) {
+                start_window(now_ms);
+                return false;
+            }
+            return now_ms - window_start_ms_ >= window_ms_;
+        }
+
+        void start_window(uint32_t now_ms) {
+            for (auto& s : stats_) s.reset();
+            window_start_ms_ = now_ms;
+            started_ = true;
+        }
+
+        const PhaseStats& stats(LoopPhase phase) const { return stats_[idx(phase)]; }
+
+        /// Phase (LOOP excluded) with the largest max own time in the window.
+        LoopPhase slowest_phase() const {
+            LoopPhase worst = LoopPhase::LOOP;
+            uint32_t worst_us = 0;
+            for (uint8_t i = idx(LoopPhase::LOOP) + 1; i < idx(LoopPhase::COUNT); i++) {
+                if (stats_[i].max_us() > worst_us) {
+                    worst_us = stats_[i].max_us();
+                    worst = static_cast<LoopPhase>(i);
+                }
+            }
+            return worst;
+        }
+
+        /// "loop 12/40/3100/512 conn ..." — min/avg/max/p99 in µs, phases with samples only.
+        /// Fits a text sensor state (< 255 chars) with every phase present as long as no max reaches 100 ms;
+        /// entries that do not fit in `len` are dropped whole.
+        size_t format(char* out, size_t len) const {
+            if (len == 0) return 0;
+            size_t pos = 0;
+            out[0] = '\0';
+            for (uint8_t i = 0; i < idx(LoopPhase::COUNT); i++) {
+                const PhaseStats& s = stats_[i];
+                if (s.count() == 0) continue;
+                int n = snprintf(out + pos, len - pos, "%s%s %u/%u/%u/%u", pos ? " " : "",
+                    loop_phase_to_str(static_cast<LoopPhase>(i)), (unsigned)s.min_us(), (unsigned)s.mean_us(),
+                    (unsigned)s.max_us(), (unsigned)s.percentile(99));
+                if (n < 0 || static_cast<size_t>(n) >= len - pos) {
+                    out[pos] = '\0';        // drop the entry that does not fit
+                    break;
+                }
+                pos += static_cast<size_t>(n);
+            }
+            return pos;
+        }
+
+        uint8_t depth() const { return depth_; }
+
+    private:
+        struct Frame {
+            LoopPhase phase;
+            uint32_t own_us;
+        };
+
+        static constexpr uint8_t idx(LoopPhase phase) { return static_cast<uint8_t>(phase); }
+
+        void charge(uint32_t now_us) {
+            if (depth_ > 0) stack_[depth_ - 1].own_us += now_us - mark_us_;
+            mark_us_ = now_us;
+        }
+
+        PhaseStats stats_[static_cast<uint8_t>(LoopPhase::COUNT)];
+        Frame stack_[MAX_DEPTH] = {};
+        uint8_t depth_ = 0;
+        uint8_t overflow_ = 0;
+        uint32_t mark_us_ = 0;
+        uint32_t loop_start_us_ = 0;
+        uint32_t window_ms_ = DEFAULT_WINDOW_MS;
+        uint32_t window_start_ms_ = 0;
+        bool started_ = false;
+    };
+
+    /// RAII timer of the whole loop() call (LoopPhase::LOOP).
+    class ScopedLoopTotal {
+    public:
+        ScopedLoopTotal(LoopProfiler& profiler, uint32_t (*clock_us)())
+            : profiler_(profiler), clock_us_(clock_us) {
+            profiler_.loop_begin(clock_us_());
+        }
+        ~ScopedLoopTotal() { profiler_.loop_end(clock_us_()); }
+        ScopedLoopTotal(const ScopedLoopTotal&) = delete;
+        ScopedLoopTotal& operator=(const ScopedLoopTotal&) = delete;
+
+    private:
+        LoopProfiler& profiler_;
+        uint32_t (*clock_us_)();
+    };
+
+    /// RAII marker used by CN105_PROFILE_PHASE(): enter() now, leave() at the end of the scope.
+    class ScopedLoopPhase {
+    public:
+        ScopedLoopPhase(LoopProfiler& profiler, LoopPhase phase, uint32_t (*clock_us)())
+            : profiler_(profiler), clock_us_(clock_us) {
+            profiler_.enter(phase, clock_us_());
+        }
+        ~ScopedLoopPhase() { profiler_.leave(clock_us_()); }
+        ScopedLoopPhase(const ScopedLoopPhase&) = delete;
+        ScopedLoopPhase& operator=(const ScopedLoopPhase&) = delete;
+
+    private:
+        LoopProfiler& profiler_;
+        uint32_t (*clock_us_)();
+    };
+
+}
+
+#ifdef USE_CN105_LOOP_PROFILER
+#define CN105_PROFILE_PHASE(phase) \
+    ::esphome::ScopedLoopPhase cn105_loop_phase_(this->loopProfiler_, ::esphome::LoopPhase::phase, ::esphome::micros)
+#else
+#define CN105_PROFILE_PHASE(phase) do {} while (0)
+#endif
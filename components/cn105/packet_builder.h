@@ -0,0 +1,92 @@
+/// packet_builder.h — Pure SET (0x41/0x01) packet construction for the CN105 protocol.
+/// Role: Extracts the byte layout done by CN105Climate::createPacket() so it can be
+///       unit-tested and benchmarked on the host.
+/// Deps: cn105_protocol.h (checksum), cn105_types.h (HEADER, byte maps and their *_TABLE encoders)
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "cn105_protocol.h"
+#include "cn105_types.h"
+
+namespace cn105_protocol {
+
+/// Requested fields of a settings write. UNSET / -1 means "not requested".
+struct SetRequest {
+    Power power = Power::UNSET;
+    Mode mode = Mode::UNSET;
+    float temperature = -1;
+    Fan fan = Fan::UNSET;
+    Vane vane = Vane::UNSET;
+    WideVane wide_vane = WideVane::UNSET;
+    bool wide_vane_adj = false;             // sets bit 7 of the wide vane byte
+    bool temperature_encoding_b = false;    // half-degree encoding in byte 19 instead of TEMP_MAP in byte 10
+    bool split_horizontal_vane = false;     // VaneType::SPLIT_HORIZONTAL: mirror wide vane into byte 16
+};
+
+/// Bits returned by build_set_packet() for requested fields that could not be encoded.
+enum SetPacketField : uint8_t {
+    SET_FIELD_POWER = 0x01,
+    SET_FIELD_MODE = 0x02,
+    SET_FIELD_TEMPERATURE = 0x04,
+    SET_FIELD_FAN = 0x08,
+    SET_FIELD_VANE = 0x10,
+    SET_FIELD_WIDE_VANE = 0x20,
+};
+
+/// Build a complete 22-byte SET settings packet (header, flags, payload, checksum).
+/// Requested fields that are not an entry of their byte map are left out of the packet.
+///
+/// @param[out] packet  Buffer of at least PACKET_LEN bytes.
+/// @param req          Fields to write.
+/// @return             Bitmask of SetPacketField values that were requested but rejected (0 = all ok).
+inline uint8_t build_set_packet(uint8_t* packet, const SetRequest& req) {
+    uint8_t rejected = 0;
+    std::memset(packet, 0, PACKET_LEN);
+    std::memcpy(packet, HEADER, HEADER_LEN);
+
+    if (req.power != Power::UNSET) {
+        if (POWER_TABLE.has(req.power)) { packet[8] = POWER_TABLE.encode(req.power); packet[6] += CONTROL_PACKET_1[0]; } else { rejected |= SET_FIELD_POWER; }
+    }
+
+    if (req.mode != Mode::UNSET) {
+        if (MODE_TABLE.has(req.mode)) { packet[9] = MODE_TABLE.encode(req.mode); packet[6] += CONTROL_PACKET_1[1]; } else { rejected |= SET_FIELD_MODE; }
+    }
+
+    if (req.temperature != -1) {
+        if (!req.temperature_encoding_b) {
+            auto temp = TEMP_TABLE.find(TEMP_MAP, static_cast<int>(req.temperature));
+            if (temp) { packet[10] = TEMP_TABLE.encode(*temp); packet[6] += CONTROL_PACKET_1[2]; } else { rejected |= SET_FIELD_TEMPERATURE; }
+        } else {
+            float temp = (req.temperature * 2) + 128;
+            packet[19] = (int)temp;
+            packet[6] += CONTROL_PACKET_1[2];
+        }
+    }
+
+    if (req.fan != Fan::UNSET) {
+        if (FAN_TABLE.has(req.fan)) { packet[11] = FAN_TABLE.encode(req.fan); packet[6] += CONTROL_PACKET_1[3]; } else { rejected |= SET_FIELD_FAN; }
+    }
+
+    if (req.vane != Vane::UNSET) {
+        if (VANE_TABLE.has(req.vane)) { packet[12] = VANE_TABLE.encode(req.vane); packet[6] += CONTROL_PACKET_1[4]; } else { rejected |= SET_FIELD_VANE; }
+    }
+
+    if (req.wide_vane != WideVane::UNSET) {
+        if (WIDEVANE_TABLE.has(req.wide_vane)) {
+            packet[18] = WIDEVANE_TABLE.encode(req.wide_vane) | (req.wide_vane_adj ? 0x80 : 0x00);
+            packet[7] += CONTROL_PACKET_2[0];
+            if (req.split_horizontal_vane) {
+                // Left horizontal vane on dual vane units (Type A) mirrors the base wide vane value
+                packet[16] = WIDEVANE_TABLE.encode(req.wide_vane);
+            }
+        } else {
+            rejected |= SET_FIELD_WIDE_VANE;
+        }
+    }
+
+    packet[21] = checksum(packet, 21);
+    return rejected;
+}
+
+}  // namespace cn105_protocol
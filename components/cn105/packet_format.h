@@ -0,0 +1,132 @@
+/// packet_format.h — Allocation-free text formatting of CN105 frames for the packet debug logs.
+/// Role: Backs CN105Climate::hpPacketDebug() / hpFunctionsDebug(): stack buffer, no std::string, no snprintf.
+/// Deps: <cstddef>, <cstdint> (no ESPHome dependency)
+///
+/// Output is truncated (never overflows) when the buffer is too small; PACKET_DEBUG_LEN fits a
+/// full 22-byte frame with its prefix and label.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cn105_protocol {
+
+static constexpr size_t PACKET_DEBUG_LEN = 160;
+
+/// "SET", "RESPONSE", ... from byte 1 of a frame.
+inline const char* packet_type_label(const uint8_t* packet, size_t length) {
+    if (length < 2 || packet[0] != 0xFC) return "UNKNOWN";
+    switch (packet[1]) {
+    case 0x5A: return "CONNECT";
+    case 0x5B: return "CONN_INST";     // Installer mode
+    case 0x41: return "SET";           // Command sent to HP
+    case 0x42: return "ACK/INFO";      // Response/Info from HP
+    case 0x61: return "GET";           // Request data from HP
+    case 0x62: return "RESPONSE";      // Data response from HP
+    default: return "UNKNOWN";
+    }
+}
+
+/// ":Settings", ":RoomTemp", ... from byte 5 (sub-command) of a frame, "" if unknown.
+inline const char* packet_sub_label(const uint8_t* packet, size_t length) {
+    if (length <= 5) return "";
+    switch (packet[5]) {
+    case 0x01: return ":Start";
+    case 0x02: return ":Settings";
+    case 0x03: return ":RoomTemp";
+    case 0x04: return ":Status";       // RQST_PKT_STATUS
+    case 0x05: return ":Standby";      // RQST_PKT_STANDBY
+    case 0x06: return ":Status";       // operating / compressor / power
+    case 0x09: return ":Power";
+    case 0x10: return ":Hello";        // Connect response
+    case 0x20: return ":Func1";        // Functions part 1
+    case 0x22: return ":Func2";        // Functions part 2
+    default: return "";
+    }
+}
+
+/// Appends to a fixed buffer, keeping it NUL-terminated; characters past the end are dropped.
+class TextBuffer {
+public:
+    TextBuffer(char* out, size_t len) : out_(out), len_(len) {
+        if (len_ > 0) out_[0] = '\0';
+    }
+
+    void put(char c) {
+        if (pos_ + 1 >= len_) return;
+        out_[pos_++] = c;
+        out_[pos_] = '\0';
+    }
+
+    void put(const char* s) {
+        while (*s) put(*s++);
+    }
+
+    void hex(uint8_t byte) {
+        static constexpr char DIGITS[] = "0123456789ABCDEF";
+        put(DIGITS[byte >> 4]);
+        put(DIGITS[byte & 0x0F]);
+    }
+
+    /// "XX XX XX " (each byte followed by a space, like the "%02X " loops it replaces).
+    void hex_spaced(const uint8_t* data, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            hex(data[i]);
+            put(' ');
+        }
+    }
+
+    void decimal(unsigned value) {
+        char digits[10];
+        size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) put(digits[--n]);
+    }
+
+    size_t size() const { return pos_; }
+
+private:
+    char* out_;
+    size_t len_;
+    size_t pos_ = 0;
+};
+
+/// "<prefix>|FC 62 01 30 10 |->[02 00 ... ](A9) <RESPONSE:Settings>": header, payload, checksum, label.
+/// Frames shorter than 5 bytes: "SHORT: FC 62 ".
+inline size_t format_packet_debug(char* out, size_t len, const uint8_t* packet, size_t length, const char* prefix) {
+    TextBuffer buf(out, len);
+    if (length < 5) {
+        buf.put("SHORT: ");
+        buf.hex_spaced(packet, length);
+        return buf.size();
+    }
+    buf.put(prefix);
+    buf.put('|');
+    buf.hex_spaced(packet, 5);
+    buf.put("|->[");
+    if (length > 6) buf.hex_spaced(packet + 5, length - 6);
+    buf.put("](");
+    buf.hex(packet[length - 1]);
+    buf.put(") <");
+    buf.put(packet_type_label(packet, length));
+    buf.put(packet_sub_label(packet, length));
+    buf.put('>');
+    return buf.size();
+}
+
+/// " 101:1 102:3 ..." — function code:value pairs of a 0x20 / 0x22 functions payload (byte 0 is the command).
+inline size_t format_functions_debug(char* out, size_t len, const uint8_t* packet, size_t length) {
+    TextBuffer buf(out, len);
+    for (size_t i = 1; i < length; i++) {
+        buf.put(' ');
+        buf.decimal(((packet[i] >> 2) & 0xff) + 100u);
+        buf.put(':');
+        buf.decimal(packet[i] & 3u);
+    }
+    return buf.size();
+}
+
+}  // namespace cn105_protocol
@@ -0,0 +1,96 @@
+/// publish_coalescer.h — Dirty-field set filled by the decoders and flushed once per cycle, with a
+/// per-sensor deadband so jittering values (input power, outside temperature) are not republished.
+/// Deps: none
+///
+/// Decoders call mark(field) instead of publishing; CN105Climate::flushPublishes_() (end of cycle,
+/// or when no cycle is running) takes the set, publishes the climate entity once and each numeric
+/// sensor only when should_publish() says its value left the deadband around the last value sent.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+
+    enum class PublishField : uint8_t {
+        CLIMATE,                    // climate entity: current temperature, action (publish_state())
+        COMPRESSOR_FREQUENCY,
+        INPUT_POWER,
+        KWH,
+        RUNTIME_HOURS,
+        OUTSIDE_AIR_TEMPERATURE,
+        COUNT
+    };
+
+    /// A new value is published once it differs from the last one sent by more than
+    /// max(absolute, relative × |last|). Both 0 (default): any change is published.
+    struct Deadband {
+        float absolute = 0.0f;
+        float relative = 0.0f;      // fraction: 0.05 = 5 %
+
+        bool exceeded(float last, float value) const {
+            if (std::isnan(last) || std::isnan(value)) return std::isnan(last) != std::isnan(value);
+            const float delta = std::fabs(value - last);
+            const float rel = relative * std::fabs(last);
+            return delta > (absolute > rel ? absolute : rel);
+        }
+    };
+
+    class PublishCoalescer {
+    public:
+        void mark(PublishField field) { dirty_ |= bit(field); }
+        bool is_dirty(PublishField field) const { return (dirty_ & bit(field)) != 0; }
+        bool pending() const { return dirty_ != 0; }
+
+        /// Returns the dirty set and clears it (one flush).
+        uint16_t take() {
+            const uint16_t dirty = dirty_;
+            dirty_ = 0;
+            if (dirty) flushes_++;
+            return dirty;
+        }
+
+        static constexpr uint16_t bit(PublishField field) { return uint16_t(1u << static_cast<uint8_t>(field)); }
+
+        void set_deadband(PublishField field, float absolute, float relative) {
+            channels_[idx(field)].deadband.absolute = absolute;
+            channels_[idx(field)].deadband.relative = relative;
+        }
+        const Deadband& deadband(PublishField field) const { return channels_[idx(field)].deadband; }
+
+        /// True when `value` has to be sent: never sent yet, or outside the deadband of the last value sent.
+        bool should_publish(PublishField field, float value) {
+            const Channel& c = channels_[idx(field)];
+            if (!c.sent || c.deadband.exceeded(c.last, value)) return true;
+            suppressed_++;
+            return false;
+        }
+
+        void published(PublishField field, float value) {
+            Channel& c = channels_[idx(field)];
+            c.last = value;
+            c.sent = true;
+            c.count++;
+        }
+
+        uint32_t publishes(PublishField field) const { return channels_[idx(field)].count; }
+        uint32_t suppressed() const { return suppressed_; }     // values kept back by a deadband
+        uint32_t flushes() const { return flushes_; }
+
+    private:
+        struct Channel {
+            Deadband deadband;
+            float last = NAN;
+            bool sent = false;
+            uint32_t count = 0;
+        };
+
+        static constexpr uint8_t idx(PublishField field) { return static_cast<uint8_t>(field); }
+
+        Channel channels_[static_cast<uint8_t>(PublishField::COUNT)];
+        uint16_t dirty_ = 0;
+        uint32_t suppressed_ = 0;
+        uint32_t flushes_ = 0;
+    };
+
+}
@@ -1,228 +1,400 @@
 #include "request_scheduler.h"
+#include "frame_queue.h"
 #include "Globals.h"
-#include "cn105.h"
-#include <esphome.h>
+#include <cstring>
 
 using namespace esphome;
 
 RequestScheduler::RequestScheduler(
     SendCallback send_callback,
-    TimeoutCallback timeout_callback,
     TerminateCallback terminate_callback,
     ContextCallback context_callback
-) : current_request_index_(-1),
-send_callback_(send_callback),
-timeout_callback_(timeout_callback),
+) : send_callback_(send_callback),
 terminate_callback_(terminate_callback),
-context_callback_(context_callback) {}
+context_callback_(context_callback) {
+    memset(route_by_code_, NO_SLOT, sizeof(route_by_code_));
+    memset(unknown_seen_, 0, sizeof(unknown_seen_));
+}
 
-void RequestScheduler::register_request(InfoRequest& req) {
-    requests_.push_back(req);
+void RequestScheduler::register_request(const RequestDescriptor& desc) {
+    uint8_t slot = slot_of(desc.code);
+    if (slot != NO_SLOT) {
+        ESP_LOGW(LOG_CYCLE_TAG, "%s (0x%02X) already registered, replacing it", desc.description, desc.code);
+    } else if (request_count_ >= MAX_REQUESTS) {
+        ESP_LOGE(LOG_CYCLE_TAG, "Cannot register %s (0x%02X): request table full", desc.description, desc.code);
+        return;
+    } else {
+        slot = request_count_++;
+        route_by_code_[desc.code] = slot;       // takes over a reply-only handler
+    }
+    descriptors_[slot] = &desc;
+    states_[slot] = RequestState();
+    states_[slot].interval_ms = desc.interval_ms;
+    states_[slot].disabled = (desc.flags & REQUEST_START_DISABLED) != 0;
 }
 
-void RequestScheduler::clear_requests() {
-    requests_.clear();
-    current_request_index_ = -1;
+void RequestScheduler::register_requests(const RequestDescriptor* table, size_t count) {
+    for (size_t i = 0; i < count; i++) register_request(table[i]);
 }
 
-void RequestScheduler::disable_request(uint8_t code) {
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            req.disabled = true;
-            break;
-        }
+bool RequestScheduler::register_response_handler(uint8_t code, RequestDescriptor::ResponseFn handler) {
+    if (route_by_code_[code] != NO_SLOT || handler_count_ >= MAX_HANDLERS) {
+        ESP_LOGE(LOG_CYCLE_TAG, "Cannot route replies 0x%02X: code already routed or handler table full", code);
+        return false;
     }
+    handlers_[handler_count_] = handler;
+    route_by_code_[code] = HANDLER_ROUTE | handler_count_++;
+    return true;
 }
 
-void RequestScheduler::enable_request(uint8_t code) {
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            req.disabled = false;
-            break;
-        }
-    }
+void RequestScheduler::clear_requests() {
+    request_count_ = 0;
+    memset(route_by_code_, NO_SLOT, sizeof(route_by_code_));
+    handler_count_ = 0;
+    queue_.clear();
+    queued_info_ = 0;
+    in_flight_ = 0;
+    cycle_active_ = false;
+    write_in_flight_ = NO_SLOT;
+    acks_expected_ = 0;
 }
 
-void RequestScheduler::timer_bypass(uint8_t code) {
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            req.last_request_time = 0;
-            break;
-        }
-    }
+uint8_t RequestScheduler::slot_of(uint8_t code) const {
+    const uint8_t route = route_by_code_[code];
+    return route < MAX_REQUESTS ? route : NO_SLOT;
 }
 
-bool RequestScheduler::is_empty() const {
-    return requests_.empty();
+RequestState* RequestScheduler::find(uint8_t code) {
+    const uint8_t slot = slot_of(code);
+    return slot == NO_SLOT ? nullptr : &states_[slot];
 }
 
-void RequestScheduler::send_request(uint8_t code, CN105Climate* context) {
+CN105Climate* RequestScheduler::resolve_context(CN105Climate* context) const {
     // Get context if not provided but callback is available
     if (!context && context_callback_) {
         context = context_callback_();
     }
+    return context;
+}
 
-    for (size_t i = 0; i < requests_.size(); ++i) {
-        auto& req = requests_[i];
-        if (req.code != code) continue;
-        if (req.disabled) { return; }
+void RequestScheduler::disable_request(uint8_t code) {
+    if (auto* state = find(code)) state->disabled = true;
+}
 
-        // Check canSend if present and if context is available
-        if (req.canSend && context) {
-            if (!req.canSend(*context)) {
-                return;
-            }
-        }
+void RequestScheduler::enable_request(uint8_t code) {
+    if (auto* state = find(code)) state->disabled = false;
+}
 
-        const char* tag = req.log_tag ? req.log_tag : LOG_CYCLE_TAG;
-        ESP_LOGD(tag, "Sending %s (0x%02X)", req.description, req.code);
+void RequestScheduler::set_request_interval(uint8_t code, uint32_t interval_ms) {
+    if (auto* state = find(code)) state->interval_ms = interval_ms;
+}
 
-        req.awaiting = true;
-        req.last_request_time = CUSTOM_MILLIS;
+void RequestScheduler::timer_bypass(uint8_t code) {
+    if (auto* state = find(code)) {
+        state->last_request_time = 0;
+        state->stable_count = 0;    // and restart any adaptive back-off
+    }
+}
 
-        // Send the packet via callback
-        if (send_callback_) {
-            send_callback_(req.code);
-        }
+void RequestScheduler::set_pipeline_window(uint8_t window) {
+    pipeline_window_ = window < 1 ? 1 : window;
+    if (pipeline_window_ > MAX_REQUESTS) pipeline_window_ = MAX_REQUESTS;
+}
 
-        // Manage the timeout if configured and if the callback is available
-        if (req.soft_timeout_ms > 0 && timeout_callback_) {
-            uint8_t code_copy = req.code;
-            const std::string tname = req.timeout_name.empty() ?
-                (std::string("info_timeout_") + std::to_string(code_copy)) :
-                req.timeout_name;
-
-            timeout_callback_(tname, req.soft_timeout_ms, [this, code_copy]() {
-                // Get context for send_next_after
-                CN105Climate* ctx = nullptr;
-                if (this->context_callback_) {
-                    ctx = this->context_callback_();
-                }
-
-                // If the response is still expected, consider it a soft failure and continue
-                for (auto& r : this->requests_) {
-                    if (r.code == code_copy && r.awaiting) {
-                        r.awaiting = false;
-                        r.failures++;
-                        ESP_LOGW(LOG_CYCLE_TAG, "Soft timeout for %s (0x%02X), failures: %d",
-                            r.description, r.code, r.failures);
-                        if (r.failures >= r.maxFailures) {
-                            r.disabled = true;
-                            ESP_LOGW(LOG_CYCLE_TAG, "%s (0x%02X) disabled (not supported)",
-                                r.description, r.code);
-                        }
-                        this->send_next_after(code_copy, ctx);
-                        break;
-                    }
-                }
-                });
-        }
+void RequestScheduler::set_adaptive_polling(const AdaptivePollingConfig& config, uint32_t base_interval_ms) {
+    adaptive_ = config;
+    base_interval_ms_ = base_interval_ms;
+}
 
-        current_request_index_ = static_cast<int>(i);
-        return;
+void RequestScheduler::set_unit_active(bool active) {
+    if (active != unit_active_) {
+        ESP_LOGD(LOG_CYCLE_TAG, "Adaptive polling: unit %s", active ? "active, fast polling" : "idle");
     }
+    unit_active_ = active;
 }
 
-void RequestScheduler::mark_response_seen(uint8_t code, CN105Climate* context) {
-    // Get context if not provided but callback is available
-    if (!context && context_callback_) {
-        context = context_callback_();
+uint32_t RequestScheduler::effective_interval(uint8_t slot) const {
+    const auto& state = states_[slot];
+    if (!adaptive_.enabled) return state.interval_ms;
+
+    const uint32_t base = state.interval_ms > base_interval_ms_ ? state.interval_ms : base_interval_ms_;
+    switch (descriptors_[slot]->poll_class) {
+    case PollClass::FAST_WHEN_ACTIVE:
+        return unit_active_ ? fast_interval() : base;
+    case PollClass::STRETCH_WHEN_STABLE:
+        return base * adaptive_polling::stretch_factor(state.stable_count, adaptive_);
+    default:
+        return base;
     }
+}
 
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            req.awaiting = false;
-            req.failures = 0;
-            ESP_LOGD(LOG_CYCLE_TAG, "Received %s <0x%02X>", req.description, req.code);
-
-            // Call the onResponse callback if present and if the context is available
-            if (req.onResponse && context) {
-                req.onResponse(*context);
-            }
-            return;
+uint32_t RequestScheduler::fast_interval() const {
+    uint8_t fast_count = 0;
+    uint32_t slow_load = 0;
+    for (uint8_t slot = 0; slot < request_count_; slot++) {
+        if (states_[slot].disabled) continue;
+        if (descriptors_[slot]->poll_class == PollClass::FAST_WHEN_ACTIVE) {
+            fast_count++;
+        } else {
+            slow_load += adaptive_polling::load_permille(effective_interval(slot));
         }
     }
+    return adaptive_polling::budgeted_fast_interval(base_interval_ms_, fast_count, slow_load, adaptive_);
 }
 
-void RequestScheduler::send_next_after(uint8_t previous_code, CN105Climate* context) {
-    // Get context if not provided but callback is available
-    if (!context && context_callback_) {
-        context = context_callback_();
-    }
+uint32_t RequestScheduler::poll_period_ms(uint32_t update_interval_ms) const {
+    if (!adaptive_.enabled || !unit_active_) return update_interval_ms;
+    const uint32_t fast = fast_interval();
+    return fast < update_interval_ms ? fast : update_interval_ms;
+}
+
+uint32_t RequestScheduler::get_effective_interval(uint8_t code) const {
+    const uint8_t slot = slot_of(code);
+    return slot == NO_SLOT ? 0 : effective_interval(slot);
+}
+
+bool RequestScheduler::is_empty() const {
+    return request_count_ == 0;
+}
 
-    // Find the starting index (by code) then try the next activateable entries in order
-    int start = -1;
-    for (size_t i = 0; i < requests_.size(); ++i) {
-        if (requests_[i].code == previous_code) {
-            start = static_cast<int>(i);
-            break;
+bool RequestScheduler::is_eligible(uint8_t slot, CN105Climate* context) const {
+    const auto& req = *descriptors_[slot];
+    const auto& state = states_[slot];
+    if (state.disabled) {
+        if (req.log_tag) {
+            ESP_LOGD(req.log_tag, "Skipping %s (0x%02X): disabled", req.description, req.code);
         }
+        return false;
     }
-    int idx = (start < 0) ? 0 : start + 1;
 
-    for (; idx < static_cast<int>(requests_.size()); ++idx) {
-        auto& req = requests_[idx];
-        if (req.disabled) {
+    // Check canSend if present and if context is available
+    if (req.canSend && context) {
+        if (!req.canSend(*context)) {
             if (req.log_tag) {
-                ESP_LOGD(req.log_tag, "Skipping %s (0x%02X): disabled", req.description, req.code);
+                ESP_LOGD(req.log_tag, "Skipping %s (0x%02X): canSend returned false", req.description, req.code);
             }
-            continue;
+            return false;
         }
+    }
 
-        // Check canSend if present and if context is available
-        if (req.canSend && context) {
-            if (!req.canSend(*context)) {
-                if (req.log_tag) {
-                    ESP_LOGD(req.log_tag, "Skipping %s (0x%02X): canSend returned false", req.description, req.code);
-                }
-                continue;
-            }
+    const uint32_t interval = effective_interval(slot);
+    if (interval > 0 && (CUSTOM_MILLIS - state.last_request_time < interval) && state.last_request_time > 0) {
+        if (req.log_tag) {
+            ESP_LOGD(req.log_tag, "Skipping %s (0x%02X) - interval not elapsed (elapsed: %lu, interval: %u)",
+                req.description, req.code,
+                (unsigned long)(CUSTOM_MILLIS - state.last_request_time), interval);
         }
+        return false;
+    }
+    return true;
+}
 
-        if (req.interval_ms > 0 && (CUSTOM_MILLIS - req.last_request_time < req.interval_ms) && req.last_request_time > 0) {
-            if (req.log_tag) {
-                ESP_LOGD(req.log_tag, "Skipping %s (0x%02X) - interval not elapsed (elapsed: %lu, interval: %u)",
-                    req.description, req.code,
-                    (unsigned long)(CUSTOM_MILLIS - req.last_request_time), req.interval_ms);
+void RequestScheduler::start_cycle(CN105Climate* context) {
+    context = resolve_context(context);
+
+    // Forget whatever the previous cycle left outstanding (cycle timeout, reconnection...)
+    for (uint8_t slot = 0; slot < request_count_; slot++) {
+        if (queue_.remove(slot)) queued_info_--;
+        states_[slot].awaiting = false;
+    }
+    in_flight_ = 0;
+    cycle_active_ = true;
+
+    // Queue every due request by its due time; registration order breaks ties (0x20 before 0x22)
+    for (uint8_t slot = 0; slot < request_count_; slot++) {
+        if (!is_eligible(slot, context)) continue;
+        if (queue_.push(slot, states_[slot].last_request_time + effective_interval(slot))) queued_info_++;
+    }
+    dispatch(context);
+}
+
+bool RequestScheduler::enqueue_write(uint8_t write_id) {
+    if (write_id >= MAX_WRITES) return false;
+    if (queue_.contains(WRITE_ID_FLAG | write_id)) {
+        coalesced_writes_++;
+        return true;
+    }
+    queue_.push(WRITE_ID_FLAG | write_id, CUSTOM_MILLIS, WRITE_PRIORITY);
+    dispatch(resolve_context(nullptr));
+    return true;
+}
+
+bool RequestScheduler::is_write_pending(uint8_t write_id) const {
+    return write_in_flight_ == write_id || queue_.contains(WRITE_ID_FLAG | write_id);
+}
+
+void RequestScheduler::send_request(uint8_t slot) {
+    const auto& req = *descriptors_[slot];
+    auto& state = states_[slot];
+    const char* tag = req.log_tag ? req.log_tag : LOG_CYCLE_TAG;
+    ESP_LOGD(tag, "Sending %s (0x%02X)", req.description, req.code);
+
+    // Pipelined: this reply will queue behind the ones still in flight on the unit TX line
+    const uint32_t queued_ahead = in_flight_;
+    in_flight_slots_[in_flight_++] = slot;
+    state.awaiting = true;
+    state.last_request_time = CUSTOM_MILLIS;
+    state.timeout_at = CUSTOM_MILLIS + req.soft_timeout_ms + queued_ahead * INFO_REPLY_SLOT_MS;
+
+    // Send the packet via callback
+    if (send_callback_) {
+        send_callback_(req.code);
+    }
+}
+
+void RequestScheduler::dispatch(CN105Climate* context) {
+    if (dispatching_) return;       // a callback below re-entered the scheduler; the outer call continues
+    dispatching_ = true;
+
+    while (!queue_.empty() && write_in_flight_ == NO_SLOT) {
+        const uint8_t id = queue_.top();
+
+        if (id & WRITE_ID_FLAG) {
+            // A SET write needs the line to itself: wait for the replies already requested
+            if (in_flight_ > 0) break;
+            queue_.pop();
+            const uint8_t write_id = id & ~WRITE_ID_FLAG;
+            const uint8_t packets = write_callback_ ? write_callback_(write_id) : 0;
+            if (packets > 0) {
+                write_in_flight_ = write_id;
+                acks_expected_ = packets;
+                write_sent_ms_ = CUSTOM_MILLIS;
+                write_ack_deadline_ = write_sent_ms_ + packets * ack_timeout_ms();
             }
             continue;
         }
 
-        // Send found request
-        send_request(req.code, context);
-        return;
+        if (in_flight_ >= pipeline_window_) break;
+        queue_.pop();
+        queued_info_--;
+        // Re-checked: it may have been disabled (or its canSend changed) while queued
+        if (!is_eligible(id, context)) continue;
+        send_request(id);
     }
+    dispatching_ = false;
 
-    // No more requests → end the cycle
-    if (terminate_callback_) {
-        terminate_callback_();
+    // Everything sent and answered (or timed out) → end the cycle; queued writes do not hold it open
+    if (cycle_active_ && queued_info_ == 0 && in_flight_ == 0) {
+        cycle_active_ = false;
+        if (terminate_callback_) {
+            terminate_callback_();
+        }
     }
 }
 
-bool RequestScheduler::process_response(uint8_t code, CN105Climate* context) {
-    // Get context if not provided but callback is available
-    if (!context && context_callback_) {
-        context = context_callback_();
+void RequestScheduler::release(uint8_t slot) {
+    states_[slot].awaiting = false;
+    for (uint8_t i = 0; i < in_flight_; i++) {
+        if (in_flight_slots_[i] == slot) {
+            in_flight_slots_[i] = in_flight_slots_[--in_flight_];
+            return;
+        }
     }
+}
+
+void RequestScheduler::write_completed() {
+    write_in_flight_ = NO_SLOT;
+    acks_expected_ = 0;
+}
+
+uint32_t RequestScheduler::ack_timeout_ms() const {
+    if (ack_rtt_ms_ == 0) return WRITE_ACK_TIMEOUT_MS;
+    const uint32_t t = 2 * ack_rtt_ms_;
+    if (t < INFO_EXCHANGE_WIRE_MS) return INFO_EXCHANGE_WIRE_MS;
+    return t > WRITE_ACK_TIMEOUT_MS ? WRITE_ACK_TIMEOUT_MS : t;
+}
 
-    // Find out if the code is managed by the scheduler
-    bool handled = false;
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            handled = true;
-            break;
+void RequestScheduler::process_ack() {
+    if (write_in_flight_ == NO_SLOT) return;
+    const uint32_t rtt = CUSTOM_MILLIS - write_sent_ms_;
+    ack_rtt_ms_ = ack_rtt_ms_ == 0 ? rtt : (3 * ack_rtt_ms_ + rtt) / 4;
+    write_sent_ms_ = CUSTOM_MILLIS;
+    if (--acks_expected_ > 0) return;
+    write_completed();
+    dispatch(resolve_context(nullptr));
+}
+
+void RequestScheduler::record_response(uint8_t slot, const cn105_protocol::FrameView& frame, CN105Climate* context) {
+    const auto& req = *descriptors_[slot];
+    auto& state = states_[slot];
+    state.failures = 0;
+    ESP_LOGD(LOG_CYCLE_TAG, "Received %s <0x%02X>", req.description, req.code);
+
+    if (req.poll_class == PollClass::STRETCH_WHEN_STABLE) {
+        const uint32_t hash = adaptive_polling::payload_hash(frame.payload, frame.length);
+        if (hash == state.payload_hash) {
+            if (state.stable_count < 255) state.stable_count++;
+        } else {
+            state.payload_hash = hash;
+            state.stable_count = 0;
         }
     }
-    if (!handled) return false;
 
-    mark_response_seen(code, context);
-    send_next_after(code, context);
-    return true;
+    // Call the onResponse callback if present and if the context is available
+    if (req.onResponse && context) {
+        req.onResponse(*context, frame);
+    }
 }
 
-void RequestScheduler::loop() {
-    // Currently, timeouts are managed via callbacks
-    // This method is intended for future management if necessary
-    // (for example, to check timeouts manually in the main loop)
+bool RequestScheduler::process_response(const cn105_protocol::FrameView& frame, CN105Climate* context) {
+    const uint8_t code = frame[0];
+    const uint8_t route = route_by_code_[code];
+
+    if (route == NO_SLOT) {
+        // Counted, and logged once per code: a unit sending unsolicited replies must not flood the log
+        unknown_responses_++;
+        last_unknown_code_ = code;
+        if (!(unknown_seen_[code >> 3] & (1u << (code & 7)))) {
+            unknown_seen_[code >> 3] |= static_cast<uint8_t>(1u << (code & 7));
+            ESP_LOGW(LOG_CYCLE_TAG, "packet type [%02X] <-- unknown and unexpected (further ones only counted)", code);
+        }
+        return false;
+    }
+    context = resolve_context(context);
+
+    if (route & HANDLER_ROUTE) {
+        if (context) handlers_[route & ~HANDLER_ROUTE](*context, frame);
+        return true;
+    }
+
+    // A late reply (after its soft timeout) must not free a window slot twice
+    const bool was_awaiting = states_[route].awaiting;
+    record_response(route, frame, context);
+    if (was_awaiting) {
+        release(route);         // clears `awaiting`
+        dispatch(context);
+    }
+    return true;
 }
 
+void RequestScheduler::loop(CN105Climate* context) {
+    const uint32_t now = CUSTOM_MILLIS;
+    bool changed = false;
+
+    // If a response is still expected past its deadline, consider it a soft failure and continue
+    for (uint8_t i = in_flight_; i-- > 0;) {
+        const auto& req = *descriptors_[in_flight_slots_[i]];
+        auto& state = states_[in_flight_slots_[i]];
+        if (req.soft_timeout_ms == 0 || static_cast<int32_t>(now - state.timeout_at) < 0) continue;
+        state.failures++;
+        ESP_LOGW(LOG_CYCLE_TAG, "Soft timeout for %s (0x%02X), failures: %d",
+            req.description, req.code, state.failures);
+        if (state.failures >= req.maxFailures) {
+            state.disabled = true;
+            ESP_LOGW(LOG_CYCLE_TAG, "%s (0x%02X) disabled (not supported)",
+                req.description, req.code);
+        }
+        release(in_flight_slots_[i]);
+        changed = true;
+    }
+
+    if (write_in_flight_ != NO_SLOT && static_cast<int32_t>(now - write_ack_deadline_) >= 0) {
+        ESP_LOGW(LOG_CYCLE_TAG, "No ACK for write %u, moving on", write_in_flight_);
+        write_completed();
+        changed = true;
+    }
+
+    if (changed) {
+        dispatch(resolve_context(context));
+    }
+}
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "info_request.h"
-#include <vector>
+#include "deadline_queue.h"
+#include <cstddef>
 #include <functional>
-#include <string>
 
 namespace esphome {
 
@@ -15,9 +15,22 @@ namespace esphome {
      *
      *This class extracts INFO request management logic from the CN105Climate component
      *to respect the single responsibility principle (SRP).
+     *
+     *Every 0x62 reply is routed through one 256-entry table indexed by its code: a registered
+     *request slot (bookkeeping, decoder, next request in one call), a reply-only handler, or
+     *unknown (counted). Due INFO polls and pending SET writes share one earliest-deadline-first
+     *queue; loop() enforces soft timeouts and dispatches whatever is next once the line is free.
      */
     class RequestScheduler {
     public:
+        static constexpr uint8_t NO_SLOT = 0xFF;
+        static constexpr uint8_t MAX_REQUESTS = 16;         // INFO requests registered at setup
+        static constexpr uint8_t MAX_WRITES = 8;            // distinct pending SET writes
+        static constexpr uint8_t WRITE_ID_FLAG = 0x80;      // queue ids: slot, or WRITE_ID_FLAG | write id
+        static constexpr uint8_t MAX_HANDLERS = 4;          // reply codes handled without being polled
+        static constexpr uint8_t HANDLER_ROUTE = 0x80;      // routes: slot, or HANDLER_ROUTE | handler index
+        static constexpr uint8_t WRITE_PRIORITY = 1;        // queue priority class of SET writes (INFO polls: 0)
+
         /**
          * @brief Type of callback for sending a packet
          * @param code The code of the request to send
@@ -25,12 +38,11 @@ namespace esphome {
         using SendCallback = std::function<void(uint8_t)>;
 
         /**
-         * @brief Type of callback for timeout management
-         * @param name Unique name of the timeout
-         * @param timeout_ms Duration of the timeout in milliseconds
-         * @param callback Function to call when timeout expires
+         * @brief Type of callback performing a queued SET write
+         * @param write_id The id given to enqueue_write()
+         * @return Number of SET packets written, each answered by one 0x61 ACK (0 = nothing was sent)
          */
-        using TimeoutCallback = std::function<void(const std::string&, uint32_t, std::function<void()>)>;
+        using WriteCallback = std::function<uint8_t(uint8_t)>;
 
         /**
          * @brief Type of callback to end a cycle
@@ -46,25 +58,36 @@ namespace esphome {
         /**
          * @brief Constructor
          * @param send_callback Callback to send a packet
-         * @param timeout_callback Callback to manage timeouts (can be nullptr if not used)
          * @param terminate_callback Callback to end a cycle
          * @param context_callback Callback to get the CN105Climate context (for canSend and onResponse)
          */
         RequestScheduler(
             SendCallback send_callback,
-            TimeoutCallback timeout_callback = nullptr,
             TerminateCallback terminate_callback = nullptr,
             ContextCallback context_callback = nullptr
         );
 
         /**
-         * @brief Saves a request to the queue
-         * @param req The query to save (non-const reference to allow modification)
+         * @brief Registers a request; only its RequestState is kept in RAM
+         * @param desc The request descriptor, referenced (not copied): it must outlive the scheduler (constexpr catalogue)
+         */
+        void register_request(const RequestDescriptor& desc);
+
+        /**
+         * @brief Registers every descriptor of a catalogue table, in order (registration order breaks due-time ties)
          */
-        void register_request(InfoRequest& req);
+        void register_requests(const RequestDescriptor* table, size_t count);
 
         /**
-         * @brief Empty the list of requests
+         * @brief Routes replies with `code` to `handler` without polling that code (e.g. unsolicited or not yet decoded)
+         * @param code The reply code (frame[0])
+         * @param handler Called with the reply; a code already registered as a request keeps its request
+         * @return false if the handler table is full or the code is already routed
+         */
+        bool register_response_handler(uint8_t code, RequestDescriptor::ResponseFn handler);
+
+        /**
+         * @brief Empty the list of requests and reply handlers
          */
         void clear_requests();
 
@@ -80,12 +103,63 @@ namespace esphome {
          */
         void enable_request(uint8_t code);
 
+        /**
+         * @brief Overrides the descriptor's minimum time between two polls of a request
+         * @param code The request code
+         * @param interval_ms 0 = every cycle
+         */
+        void set_request_interval(uint8_t code, uint32_t interval_ms);
+
         /**
          * @brief Bypass the interval timer of a request by its code
          * @param code The request code to bypass
          */
         void timer_bypass(uint8_t code);
 
+        /**
+         * @brief Set how many INFO requests may be outstanding at once
+         * @param window 1 = strictly sequential (default); N > 1 = pipelined, up to N requests in flight.
+         *        Responses are matched by their code (frame[0]) and each request keeps its own soft timeout.
+         */
+        void set_pipeline_window(uint8_t window);
+
+        /**
+         * @brief Current in-flight window (1 = sequential)
+         */
+        uint8_t get_pipeline_window() const { return pipeline_window_; }
+
+        /**
+         * @brief Number of INFO requests sent and still awaiting a response
+         */
+        uint8_t get_in_flight() const { return in_flight_; }
+
+        /**
+         * @brief Enable/configure adaptive polling (see adaptive_polling.h)
+         * @param config Adaptive policy; config.enabled = false restores fixed periods
+         * @param base_interval_ms The climate update_interval, period of FIXED requests
+         */
+        void set_adaptive_polling(const AdaptivePollingConfig& config, uint32_t base_interval_ms);
+
+        /**
+         * @brief Tell the scheduler whether the unit is active (compressor running, temperature moving)
+         * @param active true to poll FAST_WHEN_ACTIVE requests at the fast period
+         */
+        void set_unit_active(bool active);
+        bool is_unit_active() const { return unit_active_; }
+
+        /**
+         * @brief Delay between the end of a cycle and the start of the next one
+         * @param update_interval_ms The climate update_interval
+         * @return update_interval_ms, or the budgeted fast period while adaptive polling and the unit are active
+         */
+        uint32_t poll_period_ms(uint32_t update_interval_ms) const;
+
+        /**
+         * @brief Current minimum period between two polls of a request (0 = every cycle)
+         * @param code The request code
+         */
+        uint32_t get_effective_interval(uint8_t code) const;
+
         /**
          * @brief Check if the queue is empty
          * @return true if empty, false otherwise
@@ -93,49 +167,163 @@ namespace esphome {
         bool is_empty() const;
 
         /**
-         * @brief Send the next request after the one with the specified code
-         * @param previous_code The code of the previous request (0x00 to start)
+         * @brief Starts a cycle: queues every eligible request by due time and sends the first ones
          * @param context CN105Climate context to check canSend (can be nullptr, uses context_callback_ if provided)
          */
-        void send_next_after(uint8_t previous_code, CN105Climate* context = nullptr);
+        void start_cycle(CN105Climate* context = nullptr);
+
+        /**
+         * @brief True between start_cycle() and the terminate callback
+         */
+        bool is_cycle_active() const { return cycle_active_; }
+
+        /**
+         * @brief Sets the callback performing queued SET writes
+         */
+        void set_write_callback(WriteCallback write_callback) { write_callback_ = std::move(write_callback); }
+
+        /**
+         * @brief Queues a SET write. It is performed as soon as no INFO reply or ACK is pending, ahead of every
+         *        queued INFO poll (higher queue priority class); writes go out in the order they were queued.
+         *        Queuing an id still waiting in the queue merges into it (the callback reads the latest state).
+         * @param write_id Caller-defined id (< MAX_WRITES), handed back to the write callback
+         * @return false if write_id is out of range
+         */
+        bool enqueue_write(uint8_t write_id);
+
+        /**
+         * @brief True while a write is queued or awaiting its ACK
+         */
+        bool is_write_pending(uint8_t write_id) const;
+
+        /**
+         * @brief Reports a 0x61 ACK: completes the write in flight, if any, and updates the ACK round trip
+         */
+        void process_ack();
+
+        /**
+         * @brief Smoothed write → 0x61 ACK delay (0 until the first ACK)
+         */
+        uint32_t get_ack_rtt_ms() const { return ack_rtt_ms_; }
+
+        /**
+         * @brief How long the line is held for the ACK of one SET packet: twice the measured round trip,
+         *        bounded by INFO_EXCHANGE_WIRE_MS and WRITE_ACK_TIMEOUT_MS (the latter until a first ACK is seen)
+         */
+        uint32_t ack_timeout_ms() const;
+
+        /**
+         * @brief Number of enqueue_write() calls merged into a write that was already queued
+         */
+        uint32_t get_coalesced_writes() const { return coalesced_writes_; }
+
+        /**
+         * @brief Routes a received response by its code: for a registered request, marks it answered, runs its
+         *        onResponse decoder and sends the next queued request; for a reply-only code, calls its handler.
+         *        Unknown codes are only counted.
+         * @param frame The 0x62 response frame (request code in frame[0])
+         * @param context CN105Climate context for the callbacks (can be nullptr, uses context_callback_ if provided)
+         * @return true if the code is routed, false if it is unknown
+         */
+        bool process_response(const cn105_protocol::FrameView& frame, CN105Climate* context = nullptr);
 
         /**
-         * @brief Marks a response as received for a given code and calls the onResponse callback if present
-         * @param code The code of the request whose response was received
-         * @param context CN105Climate context to call onResponse (can be nullptr)
+         * @brief Number of responses whose code has no route
          */
-        void mark_response_seen(uint8_t code, CN105Climate* context = nullptr);
+        uint32_t get_unknown_responses() const { return unknown_responses_; }
 
         /**
-         * @brief Processes a response received
-         * @param code The code of the response received
-         * @param context CN105Climate context to call onResponse (can be nullptr, uses context_callback_ if provided)
-         * @return true if the response has been processed, false otherwise
+         * @brief Code of the last unknown response (meaningful once get_unknown_responses() > 0)
          */
-        bool process_response(uint8_t code, CN105Climate* context = nullptr);
+        uint8_t get_last_unknown_code() const { return last_unknown_code_; }
 
         /**
-         * @brief Method to call in the main loop to manage timeouts
-         *Note: Timeout management is currently managed via callbacks,
-         *this method is intended for future management if necessary.
+         * @brief Method to call in the main loop: expires soft timeouts / ACK waits and dispatches
+         *        queued writes and INFO requests when the line is free
+         * @param context CN105Climate context (can be nullptr, uses context_callback_ if provided)
          */
-        void loop();
+        void loop(CN105Climate* context = nullptr);
 
     private:
-        std::vector<InfoRequest> requests_;         // Requests queue
-        int current_request_index_;                 // Index of the current request
+        const RequestDescriptor* descriptors_[MAX_REQUESTS];  // slot → descriptor (constexpr catalogue)
+        RequestState states_[MAX_REQUESTS];         // slot → mutable state, the only per-request RAM
+        uint8_t request_count_ = 0;                 // registered requests (slots 0 … request_count_ - 1)
+        uint8_t route_by_code_[256];                // code → request slot, HANDLER_ROUTE | handler, NO_SLOT if unknown
+        RequestDescriptor::ResponseFn handlers_[MAX_HANDLERS];  // reply-only handlers
+        uint8_t handler_count_ = 0;
+        uint8_t unknown_seen_[256 / 8];             // unknown codes already logged once
+        uint32_t unknown_responses_ = 0;            // responses with an unrouted code
+        uint8_t last_unknown_code_ = 0;
+        cn105_protocol::DeadlineQueue<MAX_REQUESTS + MAX_WRITES> queue_;   // due INFO polls + pending writes
+        uint8_t in_flight_slots_[MAX_REQUESTS];     // slots awaiting a response
         SendCallback send_callback_;                // Callback to send a packet
-        TimeoutCallback timeout_callback_;          // Callback to manage timeouts
+        WriteCallback write_callback_;              // Callback to perform a SET write
         TerminateCallback terminate_callback_;      // Callback to end a cycle
         ContextCallback context_callback_;          // Callback to get the CN105Climate context
+        uint8_t pipeline_window_ = 1;               // Max outstanding requests (1 = sequential)
+        uint8_t in_flight_ = 0;                     // Outstanding INFO requests
+        bool cycle_active_ = false;                 // A cycle was started and has not been terminated yet
+        uint8_t queued_info_ = 0;                   // INFO requests waiting in queue_
+        uint8_t write_in_flight_ = NO_SLOT;         // Write awaiting its ACK(s)
+        uint8_t acks_expected_ = 0;                 // ACKs still expected for that write
+        uint32_t write_ack_deadline_ = 0;           // When to give up waiting for that ACK (millis)
+        uint32_t write_sent_ms_ = 0;                // When that write went out (millis)
+        uint32_t ack_rtt_ms_ = 0;                   // EWMA of the write → ACK delay
+        uint32_t coalesced_writes_ = 0;             // enqueue_write() calls merged into a pending write
+        bool dispatching_ = false;                  // Re-entrancy guard for dispatch()
+        AdaptivePollingConfig adaptive_;            // Adaptive polling policy (disabled by default)
+        uint32_t base_interval_ms_ = 0;             // update_interval, period of FIXED requests under adaptive polling
+        bool unit_active_ = false;                  // compressor running or room temperature moving
 
         /**
-         * @brief Sends a specific request by its code
-         * @param code The code of the request to send
+         * @brief Slot of the request registered for `code`, NO_SLOT if none (reply-only handlers excluded)
+         */
+        uint8_t slot_of(uint8_t code) const;
+
+        RequestState* find(uint8_t code);
+        CN105Climate* resolve_context(CN105Climate* context) const;
+
+        /**
+         * @brief Checks whether a request may be sent now (enabled, canSend, interval elapsed)
+         * @param slot The request to check
          * @param context CN105Climate context to check canSend (can be nullptr)
          */
-        void send_request(uint8_t code, CN105Climate* context = nullptr);
+        bool is_eligible(uint8_t slot, CN105Climate* context) const;
+
+        /**
+         * @brief Sends the request in `slot` and arms its soft timeout
+         */
+        void send_request(uint8_t slot);
+
+        /**
+         * @brief Sends queued writes / requests while the window allows, ends the cycle when all are done
+         */
+        void dispatch(CN105Climate* context);
+
+        /**
+         * @brief Response bookkeeping for the request in `slot`: failures reset, stability hash, onResponse
+         */
+        void record_response(uint8_t slot, const cn105_protocol::FrameView& frame, CN105Climate* context);
+
+        /**
+         * @brief Frees the window slot of a request that got its response or timed out
+         */
+        void release(uint8_t slot);
+
+        /**
+         * @brief Ends the write in flight (all ACKs received or ACK wait expired)
+         */
+        void write_completed();
+
+        /**
+         * @brief Minimum period between two polls of the request in `slot` under the current policy
+         */
+        uint32_t effective_interval(uint8_t slot) const;
+
+        /**
+         * @brief Budgeted FAST_WHEN_ACTIVE period (see adaptive_polling::budgeted_fast_interval)
+         */
+        uint32_t fast_interval() const;
     };
 
 }
-
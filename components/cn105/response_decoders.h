@@ -0,0 +1,190 @@
+/// response_decoders.h — Pure decoders for the 0x62 reply payloads (settings, room temperature, status, stage, HVAC options, error info).
+/// Role: Byte layout only: no logging, no sensors, no CN105Climate state. hp_readings.cpp applies and publishes the results.
+/// Deps: cn105_types.h (entry enums, *_TABLE byte maps, RESPONSE_DATA_LEN) (no ESPHome dependency)
+///
+/// Every decoder takes the payload (data[0] = reply code) and reads fixed offsets below
+/// RESPONSE_DATA_LEN: the caller guarantees that many bytes (processCommand() drops shorter replies).
+/// An entry whose byte is not in its map is returned UNSET and a temperature that cannot be
+/// decoded NaN, so the caller decides whether to keep the previous value.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "cn105_types.h"
+
+namespace cn105_protocol {
+
+// ════════════════════════════════════════════════════════════════
+// Decoded payloads
+// ════════════════════════════════════════════════════════════════
+
+/// 0x02 — settings.
+///   data[3] power, data[4] mode (+0x08 with i-See), data[5] temperature (encoding A), data[6] fan,
+///   data[7] vane, data[10] wide vane (low nibble, 0x80 = adjust flag), data[11] temperature
+///   (encoding B), data[12] target humidity %, data[14] airflow control (i-See units)
+struct SettingsFrame {
+    Power power = Power::UNSET;
+    Mode mode = Mode::UNSET;
+    Fan fan = Fan::UNSET;
+    Vane vane = Vane::UNSET;
+    WideVane wide_vane = WideVane::UNSET;
+    AirflowControl airflow_control = AirflowControl::UNSET;
+    float temperature = NAN;
+    uint8_t target_humidity = 0;            // raw data[12]; 1..100 on models reporting it
+    bool isee = false;
+    bool temperature_encoding_b = false;    // data[11] carried the half-degree encoding
+    bool wide_vane_reported = false;        // data[10] != 0: the unit has a wide vane
+    bool wide_vane_adjust = false;
+};
+
+/// 0x03 — room / outside temperature, indoor unit runtime.
+///   data[3] room temperature (encoding A), data[5] outside air, data[6] room temperature
+///   (encoding B), data[11..13] runtime in minutes (big-endian)
+struct RoomTemperatureFrame {
+    float room_temperature = NAN;
+    float outside_air_temperature = NAN;    // NaN when the unit does not report it (data[5] ≤ 1)
+    float runtime_hours = 0;
+    bool room_encoding_b = false;
+};
+
+/// 0x06 — operating state, compressor frequency, input power and energy counters (raw units).
+///   data[3] compressor Hz, data[4] operating, data[5..6] input power, data[7..8] energy
+struct StatusFrame {
+    bool operating = false;
+    uint8_t compressor_frequency = 0;       // forced to 0 when not operating (noisy on some models)
+    uint16_t raw_input_power = 0;           // W, or BTU/s with power_unit_is_btu
+    uint16_t raw_energy = 0;                // kWh × 10, or kBTU with power_unit_is_btu
+};
+
+/// 0x09 — standby / stage and sub modes.
+///   data[3] sub mode, data[4] stage, data[5] auto sub mode
+struct StageFrame {
+    SubMode sub_mode = SubMode::UNSET;
+    Stage stage = Stage::UNSET;
+    AutoSubMode auto_sub_mode = AutoSubMode::UNSET;
+};
+
+/// 0x42 — HVAC options (MSZ-LN).
+///   data[1] air purifier, data[2] night mode, data[3] circulator
+struct HvacOptionsFrame {
+    bool air_purifier = false;
+    bool night_mode = false;
+    bool circulator = false;
+};
+
+/// 0x04 — error info.
+///   data[4] error code (bit 7 = "error reporting available" flag, not part of the code), data[5] sub code
+struct ErrorInfoFrame {
+    uint8_t code = 0;
+    uint8_t sub_code = 0;
+    bool reporting_flag = false;
+
+    bool has_error() const { return (code | sub_code) != 0; }
+};
+
+// ════════════════════════════════════════════════════════════════
+// Decoders
+// ════════════════════════════════════════════════════════════════
+
+template <typename Entry, typename Table>
+inline Entry decode_entry(const Table& table, uint8_t byte) {
+    auto value = table.decode(byte);
+    return value ? *value : Entry::UNSET;
+}
+
+inline SettingsFrame decode_settings(const uint8_t* data) {
+    SettingsFrame f;
+    f.power = decode_entry<Power>(POWER_TABLE, data[3]);
+    f.isee = data[4] > 0x08;
+    f.mode = decode_entry<Mode>(MODE_TABLE, f.isee ? static_cast<uint8_t>(data[4] - 0x08) : data[4]);
+    f.temperature_encoding_b = data[11] != 0x00;
+    if (f.temperature_encoding_b) {
+        f.temperature = static_cast<float>(static_cast<int>(data[11]) - 128) / 2;
+    } else {
+        auto temperature = TEMP_TABLE.lookup(TEMP_MAP, data[5]);
+        if (temperature) f.temperature = static_cast<float>(*temperature);
+    }
+    f.fan = decode_entry<Fan>(FAN_TABLE, data[6]);
+    f.vane = decode_entry<Vane>(VANE_TABLE, data[7]);
+    f.wide_vane_reported = data[10] != 0;
+    if (f.wide_vane_reported) {
+        f.wide_vane = decode_entry<WideVane>(WIDEVANE_TABLE, static_cast<uint8_t>(data[10] & 0x0F));
+        f.wide_vane_adjust = (data[10] & 0xF0) == 0x80;
+    }
+    f.target_humidity = data[12];
+    // data[10] == 0x80 without i-See: real airflow mode unknown (maybe powersave), reported as even
+    f.airflow_control = (data[10] == 0x80 && f.isee) ? decode_entry<AirflowControl>(AIRFLOW_CONTROL_TABLE, data[14])
+        : AirflowControl::EVEN;
+    return f;
+}
+
+inline RoomTemperatureFrame decode_room_temperature(const uint8_t* data) {
+    RoomTemperatureFrame f;
+    if (data[5] > 1) f.outside_air_temperature = (data[5] - 128) / 2.0f;
+    f.room_encoding_b = data[6] != 0x00;
+    if (f.room_encoding_b) {
+        f.room_temperature = (static_cast<int>(data[6]) - 128) / 2.0f;
+    } else {
+        auto room = ROOM_TEMP_TABLE.lookup(ROOM_TEMP_MAP, data[3]);
+        if (room) f.room_temperature = static_cast<float>(*room);
+    }
+    f.runtime_hours = float((data[11] << 16) | (data[12] << 8) | data[13]) / 60;
+    return f;
+}
+
+inline StatusFrame decode_status(const uint8_t* data) {
+    StatusFrame f;
+    f.operating = data[4] != 0;
+    f.compressor_frequency = f.operating ? data[3] : 0;
+    f.raw_input_power = static_cast<uint16_t>((data[5] << 8) | data[6]);
+    f.raw_energy = static_cast<uint16_t>((data[7] << 8) | data[8]);
+    return f;
+}
+
+inline StageFrame decode_stage(const uint8_t* data) {
+    StageFrame f;
+    f.sub_mode = decode_entry<SubMode>(SUB_MODE_TABLE, data[3]);
+    f.stage = decode_entry<Stage>(STAGE_TABLE, data[4]);
+    f.auto_sub_mode = decode_entry<AutoSubMode>(AUTO_SUB_MODE_TABLE, data[5]);
+    return f;
+}
+
+inline HvacOptionsFrame decode_hvac_options(const uint8_t* data) {
+    HvacOptionsFrame f;
+    f.air_purifier = data[1] != 0;
+    f.night_mode = data[2] != 0;
+    f.circulator = data[3] != 0;
+    return f;
+}
+
+inline ErrorInfoFrame decode_error_info(const uint8_t* data) {
+    ErrorInfoFrame f;
+    f.code = data[4] & 0x7F;
+    f.reporting_flag = (data[4] & 0x80) != 0;
+    f.sub_code = data[5];
+    return f;
+}
+
+// ════════════════════════════════════════════════════════════════
+// Units
+// ════════════════════════════════════════════════════════════════
+
+/// Input power in W. BTU units: raw [BTU/s] × 3600 / 1055.056 (1 W = 1 J/s, 1 BTU = 1055.056 J).
+inline float input_power_to_W(float raw_input_power, bool power_unit_is_btu) {
+    if (power_unit_is_btu) {
+        static constexpr float conv_factor = 3600.0f / 1055.05558262f;
+        return raw_input_power * conv_factor;
+    }
+    return raw_input_power;
+}
+
+/// Energy in kWh: raw / 10 by default; BTU units: raw [kBTU] × 1055.056 / 3 600 000 × 1000.
+inline float energy_usage_to_kWh(float raw_energy_usage, bool power_unit_is_btu) {
+    if (power_unit_is_btu) {
+        static constexpr float conv_factor = 1055.05585262f / 3600000.0f;
+        return 1000.0f * raw_energy_usage * conv_factor;
+    }
+    return raw_energy_usage / 10.0f;
+}
+
+}  // namespace cn105_protocol
@@ -0,0 +1,109 @@
+/// state_snapshot.h — Field-level change masks of the decoded settings / status, and the versioned
+/// state they are committed to.
+/// Deps: cn105_types.h
+///
+/// A decoder diffs what it received against the current state (diff_settings(), diff_status()) and
+/// passes the mask on: heatpumpUpdate() / statusChanged() then only run the checks and publishers
+/// whose field bit is set, instead of comparing whole structs and re-evaluating every consumer.
+/// A field the frame did not carry (UNSET entry) is not a change; NaN → NaN is not a change.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "cn105_types.h"
+
+namespace esphome {
+
+    enum class SettingsField : uint8_t {
+        POWER,
+        MODE,
+        TEMPERATURE,
+        FAN,
+        VANE,
+        WIDE_VANE,
+        ISEE,
+        COUNT
+    };
+
+    enum class StatusField : uint8_t {
+        OPERATING,
+        ROOM_TEMPERATURE,
+        OUTSIDE_AIR_TEMPERATURE,
+        COMPRESSOR_FREQUENCY,
+        INPUT_POWER,
+        KWH,
+        RUNTIME_HOURS,
+        COUNT
+    };
+
+    using FieldMask = uint16_t;
+
+    template <typename Field>
+    constexpr FieldMask field_bit(Field field) { return FieldMask(1u << static_cast<uint8_t>(field)); }
+
+    template <typename Field>
+    constexpr bool has_field(FieldMask mask, Field field) { return (mask & field_bit(field)) != 0; }
+
+    /// Bit of `field` when an entry the frame carried differs from the current one.
+    template <typename Entry, typename Field>
+    constexpr FieldMask entry_changed(Entry current, Entry received, Field field) {
+        return (is_set(received) & (current != received)) ? field_bit(field) : 0;
+    }
+
+    /// Bit of `field` when two readings differ, NaN being equal to NaN.
+    template <typename Field>
+    inline FieldMask value_changed(float current, float received, Field field) {
+        const bool both_nan = std::isnan(current) & std::isnan(received);
+        return (!both_nan & !(current == received)) ? field_bit(field) : 0;
+    }
+
+    /// Fields of a decoded 0x02 settings reply that differ from `current`.
+    inline FieldMask diff_settings(const heatpumpSettings& current, const heatpumpSettings& received) {
+        return entry_changed(current.power, received.power, SettingsField::POWER) |
+            entry_changed(current.mode, received.mode, SettingsField::MODE) |
+            value_changed(current.temperature, received.temperature, SettingsField::TEMPERATURE) |
+            entry_changed(current.fan, received.fan, SettingsField::FAN) |
+            entry_changed(current.vane, received.vane, SettingsField::VANE) |
+            entry_changed(current.wideVane, received.wideVane, SettingsField::WIDE_VANE) |
+            ((current.iSee != received.iSee) ? field_bit(SettingsField::ISEE) : 0);
+    }
+
+    /// Fields of a decoded 0x03 / 0x06 status reply that differ from `current`.
+    inline FieldMask diff_status(const heatpumpStatus& current, const heatpumpStatus& received) {
+        return ((current.operating != received.operating) ? field_bit(StatusField::OPERATING) : 0) |
+            value_changed(current.roomTemperature, received.roomTemperature, StatusField::ROOM_TEMPERATURE) |
+            value_changed(current.outsideAirTemperature, received.outsideAirTemperature, StatusField::OUTSIDE_AIR_TEMPERATURE) |
+            value_changed(current.compressorFrequency, received.compressorFrequency, StatusField::COMPRESSOR_FREQUENCY) |
+            value_changed(current.inputPower, received.inputPower, StatusField::INPUT_POWER) |
+            value_changed(current.kWh, received.kWh, StatusField::KWH) |
+            value_changed(current.runtimeHours, received.runtimeHours, StatusField::RUNTIME_HOURS);
+    }
+
+    /// Version counter of one state part: bumped by every decode that changed at least one field,
+    /// with the version at which each field last changed ("has X moved since I last looked?").
+    template <typename Field>
+    class VersionedState {
+    public:
+        /// Records the mask of one decode; returns it so the call can be chained into the consumers.
+        FieldMask commit(FieldMask changed) {
+            last_changed_ = changed;
+            if (changed == 0) return 0;
+            version_++;
+            for (uint8_t i = 0; i < static_cast<uint8_t>(Field::COUNT); i++) {
+                if (changed & FieldMask(1u << i)) field_version_[i] = version_;
+            }
+            return changed;
+        }
+
+        uint32_t version() const { return version_; }
+        FieldMask last_changed() const { return last_changed_; }
+        uint32_t field_version(Field field) const { return field_version_[static_cast<uint8_t>(field)]; }
+        bool changed_since(Field field, uint32_t version) const { return field_version(field) > version; }
+
+    private:
+        uint32_t version_ = 0;
+        uint32_t field_version_[static_cast<uint8_t>(Field::COUNT)] = {};
+        FieldMask last_changed_ = 0;
+    };
+
+}
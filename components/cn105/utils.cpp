@@ -1,7 +1,11 @@
 #include "cn105.h"
 #include "Globals.h"
+#include "packet_format.h"
 #include <math.h>
 #include <memory>
+#ifdef USE_LOGGER
+#include "esphome/components/logger/logger.h"
+#endif
 
 using namespace esphome;
 
@@ -65,11 +69,7 @@ float CN105Climate::calculateTemperatureSetting(float setting) {
  *   => raw [BTU/s] * (3600 / 1055.056) = Watts
  */
 float CN105Climate::convert_input_power_to_W(float raw_input_power) {
-    if (power_unit_is_btu_) {
-        static constexpr float conv_factor = 3600.0f / 1055.05558262f;
-        return raw_input_power * conv_factor;
-    }
-    return raw_input_power;  // already in Watts
+    return cn105_protocol::input_power_to_W(raw_input_power, power_unit_is_btu_);
 }
 
 /**
@@ -82,11 +82,7 @@ float CN105Climate::convert_input_power_to_W(float raw_input_power) {
  *   => raw [kBTU] * (1055.056 / 3 600 000) * 1000 = kWh
  */
 float CN105Climate::convert_energy_usage_to_kWh(float raw_energy_usage) {
-    if (power_unit_is_btu_) {
-        static constexpr float conv_factor = 1055.05585262f / 3600000.0f;
-        return 1000.0f * raw_energy_usage * conv_factor;
-    }
-    return raw_energy_usage / 10.0f;  // already in kWh/10
+    return cn105_protocol::energy_usage_to_kWh(raw_energy_usage, power_unit_is_btu_);
 }
 
 /**
@@ -169,24 +165,24 @@ void CN105Climate::debugSettings(const char* settingName, wantedHeatpumpSettings
 #ifdef USE_ESP32
     ESP_LOGD(LOG_ACTION_EVT_TAG, "[%s]-> [power: %s, target °C: %.1f, mode: %s, fan: %s, vane: %s, wvane: %s, hasChanged ? -> %s, hasBeenSent ? -> %s]",
         getIfNotNull(settingName, "unnamed"),
-        getIfNotNull(settings.power, "-"),
+        getIfNotNull(to_label(settings.power), "-"),
         settings.temperature,
-        getIfNotNull(settings.mode, "-"),
-        getIfNotNull(settings.fan, "-"),
-        getIfNotNull(settings.vane, "-"),
-        getIfNotNull(settings.wideVane, "-"),
+        getIfNotNull(to_label(settings.mode), "-"),
+        getIfNotNull(to_label(settings.fan), "-"),
+        getIfNotNull(to_label(settings.vane), "-"),
+        getIfNotNull(to_label(settings.wideVane), "-"),
         settings.hasChanged ? "YES" : " NO",
         settings.hasBeenSent ? "YES" : " NO"
     );
 #else
     ESP_LOGD(LOG_ACTION_EVT_TAG, "[%-*s]-> [power: %-*s, target °C: %.1f, mode: %-*s, fan: %-*s, vane: %-*s, wvane: %-*s, hasChanged ? -> %s, hasBeenSent ? -> %s]",
         15, getIfNotNull(settingName, "unnamed"),
-        3, getIfNotNull(settings.power, "-"),
+        3, getIfNotNull(to_label(settings.power), "-"),
         settings.temperature,
-        6, getIfNotNull(settings.mode, "-"),
-        6, getIfNotNull(settings.fan, "-"),
-        6, getIfNotNull(settings.vane, "-"),
-        6, getIfNotNull(settings.wideVane, "-"),
+        6, getIfNotNull(to_label(settings.mode), "-"),
+        6, getIfNotNull(to_label(settings.fan), "-"),
+        6, getIfNotNull(to_label(settings.vane), "-"),
+        6, getIfNotNull(to_label(settings.wideVane), "-"),
         settings.hasChanged ? "YES" : " NO",
         settings.hasBeenSent ? "YES" : " NO"
     );
@@ -303,22 +299,22 @@ void CN105Climate::debugSettings(const char* settingName, heatpumpSettings& sett
 #ifdef USE_ESP32
     ESP_LOGD(LOG_SETTINGS_TAG, "[%s]-> [power: %s, target °C: %.1f, mode: %s, fan: %s, vane: %s, wvane: %s]",
         getIfNotNull(settingName, "unnamed"),
-        getIfNotNull(settings.power, "-"),
+        getIfNotNull(to_label(settings.power), "-"),
         settings.temperature,
-        getIfNotNull(settings.mode, "-"),
-        getIfNotNull(settings.fan, "-"),
-        getIfNotNull(settings.vane, "-"),
-        getIfNotNull(settings.wideVane, "-")
+        getIfNotNull(to_label(settings.mode), "-"),
+        getIfNotNull(to_label(settings.fan), "-"),
+        getIfNotNull(to_label(settings.vane), "-"),
+        getIfNotNull(to_label(settings.wideVane), "-")
     );
 #else
     ESP_LOGD(LOG_SETTINGS_TAG, "[%-*s]-> [power: %-*s, target °C: %.1f, mode: %-*s, fan: %-*s, vane: %-*s, wvane: %-*s]",
         15, getIfNotNull(settingName, "unnamed"),
-        3, getIfNotNull(settings.power, "-"),
+        3, getIfNotNull(to_label(settings.power), "-"),
         settings.temperature,
-        6, getIfNotNull(settings.mode, "-"),
-        6, getIfNotNull(settings.fan, "-"),
-        6, getIfNotNull(settings.vane, "-"),
-        6, getIfNotNull(settings.wideVane, "-")
+        6, getIfNotNull(to_label(settings.mode), "-"),
+        6, getIfNotNull(to_label(settings.fan), "-"),
+        6, getIfNotNull(to_label(settings.vane), "-"),
+        6, getIfNotNull(to_label(settings.wideVane), "-")
     );
 #endif
 }
@@ -364,119 +360,56 @@ void CN105Climate::debugSettingsAndStatus(const char* settingName, heatpumpSetti
 
 
 
-void CN105Climate::hpPacketDebug(const uint8_t* packet, unsigned int length, const char* packetDirection, const char* log_prefix) {
-    if (length < 5) {
-        // Fallback for too short packets
-        std::string output;
-        char byteBuf[4];
-        for (unsigned int i = 0; i < length; i++) {
-            snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
-            output += byteBuf;
-        }
-        ESP_LOGD(packetDirection, "SHORT: %s", output.c_str());
-        return;
-    }
-
-    // Determine packet type label
-    const char* label = "UNKNOWN";
-    if (packet[0] == 0xFC) {
-        switch (packet[1]) {
-        case 0x5A: label = "CONNECT"; break;
-        case 0x5B: label = "CONN_INST"; break; // Installer mode
-        case 0x41: label = "SET"; break;       // Command sent to HP
-        case 0x42: label = "ACK/INFO"; break;  // Response/Info from HP
-        case 0x61: label = "GET"; break;       // Request data from HP
-        case 0x62: label = "RESPONSE"; break;  // Data response from HP
-        }
-    }
-
-    // Determine specific command/data type (Semantic decoding)
-    // Byte 5 (index 5) is usually the subcommand
-    const char* subLabel = "";
-    if (length > 5) {
-        switch (packet[5]) {
-        case 0x01: subLabel = ":Start"; break; // Or "Connect" ?
-        case 0x02: subLabel = ":Settings"; break;
-        case 0x03: subLabel = ":RoomTemp"; break;
-        case 0x04: subLabel = ":Status"; break; // Or "Unknown"? 0x04 is RQST_PKT_STATUS in cn105_types.h
-        case 0x05: subLabel = ":Standby"; break; // RQST_PKT_STANDBY
-        case 0x06: subLabel = ":Status"; break;  // RQST_PKT_HVAC_OPTIONS? Wait, need to check types map.
-                                                 // In cn105_types: 0x06 is RQST_PKT_HVAC_OPTIONS? 
-                                                 // Actually 0x06 in RCVD_PKT is TIMER? 
-                                                 // Let's stick to common ones seen in logs:
-                                                 // 02=Settings, 03=RoomTemp, 06=Status/Timers?, 09=Power?
-                                                 // 0x09 is RCVD_PKT_STATUS in some contexts or Power?
-                                                 // Looking at logs:
-                                                 // FC 62 ... 09 ... -> Power/Standby?
-                                                 // FC 62 ... 06 ... -> Status?
-        case 0x09: subLabel = ":Power"; break;
-        case 0x10: subLabel = ":Hello"; break; // Connect response 
-        case 0x20: subLabel = ":Func1"; break; // Functions part 1
-        case 0x22: subLabel = ":Func2"; break; // Functions part 2
-        }
-    }
-    
-    // For 0x06 specifically, in many logs it's Status or Timers. 
-    // In types.h: RCVD_PKT_STATUS = 5, RCVD_PKT_TIMER = 6.
-    // Let's use generic names if unsure, but user wants semantic.
-    if (packet[5] == 0x06) subLabel = ":Status"; 
-    
-    char fullLabel[20];
-    snprintf(fullLabel, sizeof(fullLabel), "%s%s", label, subLabel);
-
-    // Format strings
-    std::string headerStr, dataStr, csStr;
-    char byteBuf[4];
-
-    // HEADER: First 5 bytes
-    for (unsigned int i = 0; i < 5 && i < length; i++) {
-        snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
-        headerStr += byteBuf;
-    }
-
-    // DATA: Bytes 5 to Length-2 (payload)
-    if (length > 6) {
-        for (unsigned int i = 5; i < length - 1; i++) {
-            snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
-            dataStr += byteBuf;
-        }
-    }
-
-    // CHECKSUM: Last byte
-    snprintf(byteBuf, sizeof(byteBuf), "%02X", packet[length - 1]);
-    csStr = byteBuf;
+// Packet dumps are DEBUG lines: compiled out below that log level or with `packet_debug: false`
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_DEBUG && !defined(CN105_DISABLE_PACKET_DEBUG)
+#define CN105_PACKET_DEBUG
+#endif
 
-// Output format: [LABEL:SubLabel ] HEADER -> [ PAYLOAD ] CS
-    ESP_LOGD(packetDirection, "%s|%s|->[%s](%s) <%s>", 
-        log_prefix, headerStr.c_str(), dataStr.c_str(), csStr.c_str(), fullLabel);
+#ifdef CN105_PACKET_DEBUG
+// Checked before any formatting: the logger level can be lowered at runtime (logger.set_level),
+// and a `logs:` entry can lower it for one tag only. level_for() is the level ESP_LOGD tests.
+static bool packetDebugLogged(const char* tag) {
+#ifdef USE_LOGGER
+    return logger::global_logger == nullptr || logger::global_logger->level_for(tag) >= ESPHOME_LOG_LEVEL_DEBUG;
+#else
+    (void)tag;
+    return false;
+#endif
 }
+#endif
 
-void CN105Climate::hpFunctionsDebug(uint8_t* packet, unsigned int length) {
-    if (length < 2) return; // Pas de données à décoder
-
-    std::string output;
-    output.reserve(length * 8); // Pré-allocation pour éviter les réallocations
-
-    char buffer[16];
-
-    // On commence à i=1 pour sauter l'octet de commande (0x20 ou 0x22)
-    for (unsigned int i = 1; i < length; i++) {
-        uint8_t byte = packet[i];
-
-        // Logique de décodage Mitsubishi (copiée de heatpumpFunctions)
-        int code = ((byte >> 2) & 0xff) + 100;
-        int value = byte & 3;
-
-        // Formatage "Code:Valeur" (ex: " 102:3")
-        snprintf(buffer, sizeof(buffer), " %d:%d", code, value);
-        output += buffer;
-    }
+void CN105Climate::hpPacketDebug(const uint8_t* packet, unsigned int length, const char* packetDirection, const char* log_prefix) {
+#ifdef CN105_PACKET_DEBUG
+    if (!packetDebugLogged(packetDirection)) return;
+    CN105_PROFILE_PHASE(PACKET_DEBUG);
+    // Output format: <prefix>|HEADER|->[PAYLOAD](CS) <LABEL:SubLabel>
+    char line[cn105_protocol::PACKET_DEBUG_LEN];
+    cn105_protocol::format_packet_debug(line, sizeof(line), packet, length, log_prefix);
+    ESP_LOGD(packetDirection, "%s", line);
+#endif
+}
 
-    // Affichage avec le tag LOG_FUNCTIONS_TAG (défini dans cn105_types.h)
+void CN105Climate::hpFunctionsDebug(const uint8_t* packet, unsigned int length) {
+#ifdef CN105_PACKET_DEBUG
+    if (length < 2 || !packetDebugLogged(LOG_FUNCTIONS_TAG)) return; // Pas de données à décoder
     // Affiche par exemple : [FUNCTIONS] Decoded 20: 101:1 102:3 103:2 ...
-    ESP_LOGD(LOG_FUNCTIONS_TAG, "Decoded %02X:%s", packet[0], output.c_str());
+    char line[cn105_protocol::PACKET_DEBUG_LEN];
+    cn105_protocol::format_functions_debug(line, sizeof(line), packet, length);
+    ESP_LOGD(LOG_FUNCTIONS_TAG, "Decoded %02X:%s", packet[0], line);
+#endif
 }
 
+#ifdef USE_CN105_FRAME_CAPTURE
+// Logged at WARN so the dump is printed by production builds running at that level
+void CN105Climate::dump_frame_capture() {
+    const FrameCapture& capture = this->frameCapture_;
+    ESP_LOGW(LOG_CAPTURE_TAG, "BEGIN %u/%u frames (%u dropped), %u bytes, base64:", capture.size(), capture.capacity(),
+        (unsigned)capture.dropped(), (unsigned)capture.blob_size());
+    capture.dump_base64(CUSTOM_MILLIS, [](const char* line) { ESP_LOGW(LOG_CAPTURE_TAG, "%s", line); });
+    ESP_LOGW(LOG_CAPTURE_TAG, "END");
+}
+#endif
+
 int CN105Climate::lookupByteMapIndex(const int valuesMap[], int len, int lookupValue, const char* debugInfo) {
     int idx = cn105_protocol::lookup_index(valuesMap, len, lookupValue);
     if (idx < 0) {
@@ -520,12 +453,14 @@ int CN105Climate::lookupByteMapValue(const int valuesMap[], const uint8_t byteMa
 #ifndef USE_ESP32
 /**
  * This methode emulates the esp32 lock_guard feature with a boolean variable
- *
+ * Slow path of emulateMutex() (cn105.h): only reached while the mutex is held
 */
-void CN105Climate::emulateMutex(const char* retryName, std::function<void()>&& f) {
+void CN105Climate::emulateMutexDeferred(const char* retryName, std::function<void()>&& f) {
     auto callback = std::make_shared<std::function<void()>>(std::move(f));
     auto retry = std::make_shared<std::function<void(uint8_t, uint32_t)>>();
-    *retry = [this, retryName, retry, callback](uint8_t retry_count, uint32_t delay_ms) {
+    // weak self-reference: only the pending set_timeout owns the chain, freed once the callback has run
+    std::weak_ptr<std::function<void(uint8_t, uint32_t)>> weak_retry = retry;
+    *retry = [this, retryName, weak_retry, callback](uint8_t retry_count, uint32_t delay_ms) {
         if (this->wantedSettingsMutex) {
             if (retry_count >= 10) {
                 ESP_LOGW(retryName, "10 retry calls failed because mutex was locked, forcing unlock...");
@@ -536,6 +471,7 @@ void CN105Climate::emulateMutex(const char* retryName, std::function<void()>&& f
             }
             ESP_LOGI(retryName, "wantedSettingsMutex is already locked, defferring...");
             const uint32_t next_delay_ms = static_cast<uint32_t>(delay_ms * 1.2f);
+            auto retry = weak_retry.lock();     // alive: held by the caller or by the timeout running us
             this->set_timeout(retryName, delay_ms, [retry, retry_count, next_delay_ms]() {
                 (*retry)(retry_count + 1, next_delay_ms);
             });
@@ -556,7 +492,9 @@ void CN105Climate::emulateMutex(const char* retryName, std::function<void()>&& f
 void CN105Climate::testEmulateMutex(const char* retryName, std::function<void()>&& f) {
     auto callback = std::make_shared<std::function<void()>>(std::move(f));
     auto retry = std::make_shared<std::function<void(uint8_t, uint32_t)>>();
-    *retry = [this, retryName, retry, callback](uint8_t retry_count, uint32_t delay_ms) {
+    // weak self-reference: only the pending set_timeout owns the chain, freed once the callback has run
+    std::weak_ptr<std::function<void(uint8_t, uint32_t)>> weak_retry = retry;
+    *retry = [this, retryName, weak_retry, callback](uint8_t retry_count, uint32_t delay_ms) {
         if (this->esp8266Mutex) {
             if (retry_count >= 10) {
                 ESP_LOGW(retryName, "10 retry calls failed because mutex was locked, forcing unlock...");
@@ -567,6 +505,7 @@ void CN105Climate::testEmulateMutex(const char* retryName, std::function<void()>
             }
             ESP_LOGI(retryName, "testMutex is already locked, defferring...");
             const uint32_t next_delay_ms = static_cast<uint32_t>(delay_ms * 1.2f);
+            auto retry = weak_retry.lock();     // alive: held by the caller or by the timeout running us
             this->set_timeout(retryName, delay_ms, [retry, retry_count, next_delay_ms]() {
                 (*retry)(retry_count + 1, next_delay_ms);
             });
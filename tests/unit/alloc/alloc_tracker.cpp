@@ -0,0 +1,265 @@
+/// alloc_tracker.cpp — Replacement global operator new/delete counting heap use, with call-site attribution.
+/// Deps: alloc_tracker.h, <execinfo.h> / <dlfcn.h> / <cxxabi.h> (glibc, for call sites only)
+///
+/// Every replaceable form is provided (plain, array, nothrow, sized and aligned delete, aligned new)
+/// so no allocation bypasses the counters. Nothing here allocates through operator new itself:
+/// the site table is fixed-size and the demangler's malloc() buffer is freed immediately.
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#define CN105_ALLOC_SITES 1
+#else
+#define CN105_ALLOC_SITES 0
+#endif
+
+namespace cn105_alloc {
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{ 0 };
+std::atomic<uint64_t> g_frees{ 0 };
+std::atomic<uint64_t> g_bytes{ 0 };
+
+// Site table, written only while a Window is armed (single-threaded tests)
+bool g_armed = false;
+Site g_sites[MAX_SITES];
+size_t g_site_count = 0;
+uint64_t g_unattributed = 0;
+
+// backtrace()/dladdr() may allocate on first use: never account (or recurse into) those
+thread_local bool t_in_hook = false;
+
+// ════════════════════════════════════════════════════════════════
+// Call-site resolution
+// ════════════════════════════════════════════════════════════════
+
+#if CN105_ALLOC_SITES
+
+/// Copies the qualified name of a demangled symbol into out: return type and arguments stripped.
+void copy_qualified_name(const char* symbol, char* out, size_t out_len) {
+    const char* end = symbol + std::strlen(symbol);
+    // Arguments: first '(' at template depth 0
+    int depth = 0;
+    const char* args = end;
+    const char* start = symbol;
+    for (const char* p = symbol; p < end; p++) {
+        if (*p == '<') depth++;
+        else if (*p == '>') depth--;
+        else if (depth == 0 && *p == '(') {
+            // "operator()" is part of the name, not its arguments
+            if (p >= symbol + 8 && std::strncmp(p - 8, "operator", 8) == 0) { p++; continue; }
+            args = p;
+            break;
+        } else if (depth == 0 && *p == ' ') {
+            start = p + 1;  // template function: "void ns::f<T>(...)" → skip the return type
+        }
+    }
+    size_t len = static_cast<size_t>(args - start);
+    if (len >= out_len) len = out_len - 1;
+    std::memcpy(out, start, len);
+    out[len] = '\0';
+}
+
+bool is_skipped(const char* name) {
+    static const char* const prefixes[] = { "operator new", "operator delete", "std::", "__gnu_cxx::", "cn105_alloc::" };
+    for (const char* prefix : prefixes) {
+        if (std::strncmp(name, prefix, std::strlen(prefix)) == 0) return true;
+    }
+    return false;
+}
+
+/// First frame above the allocator and the standard library, e.g. the function calling push_back().
+void resolve_site(char* out, size_t out_len) {
+    void* frames[MAX_FRAMES];
+    const int depth = backtrace(frames, MAX_FRAMES);
+    for (int i = 1; i < depth; i++) {
+        Dl_info info;
+        if (!dladdr(frames[i], &info) || info.dli_sname == nullptr) continue;
+        int status = -1;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        const char* symbol = status == 0 ? demangled : info.dli_sname;
+        // Raw check too: "operator new(unsigned long)" would otherwise be cut to "new"
+        const bool skipped = is_skipped(symbol);
+        copy_qualified_name(symbol, out, out_len);
+        std::free(demangled);
+        if (!skipped && !is_skipped(out)) return;
+    }
+    std::snprintf(out, out_len, "?");
+}
+
+#else
+
+void resolve_site(char* out, size_t out_len) { std::snprintf(out, out_len, "?"); }
+
+#endif
+
+void record_site(size_t size) {
+    char name[SITE_NAME_LEN];
+    resolve_site(name, sizeof(name));
+    for (size_t i = 0; i < g_site_count; i++) {
+        if (std::strcmp(g_sites[i].name, name) == 0) {
+            g_sites[i].count++;
+            g_sites[i].bytes += size;
+            return;
+        }
+    }
+    if (g_site_count == MAX_SITES) {
+        g_unattributed++;
+        return;
+    }
+    Site& site = g_sites[g_site_count++];
+    std::memcpy(site.name, name, sizeof(name));
+    site.count = 1;
+    site.bytes = size;
+}
+
+void on_alloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (!g_armed || t_in_hook) return;
+    t_in_hook = true;
+    record_site(size);
+    t_in_hook = false;
+}
+
+void* checked_alloc(size_t size) {
+    if (size == 0) size = 1;
+    void* p = std::malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    on_alloc(size);
+    return p;
+}
+
+void* checked_aligned_alloc(size_t size, std::align_val_t align) {
+    const size_t alignment = static_cast<size_t>(align);
+    // aligned_alloc() wants a size multiple of the alignment
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    if (rounded == 0) rounded = alignment;
+    void* p = std::aligned_alloc(alignment, rounded);
+    if (p == nullptr) throw std::bad_alloc();
+    on_alloc(size);
+    return p;
+}
+
+void release(void* p) {
+    if (p == nullptr) return;
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+}  // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Counters / Window
+// ════════════════════════════════════════════════════════════════
+
+Counters totals() {
+    Counters c;
+    c.allocations = g_allocations.load(std::memory_order_relaxed);
+    c.frees = g_frees.load(std::memory_order_relaxed);
+    c.bytes = g_bytes.load(std::memory_order_relaxed);
+    return c;
+}
+
+bool sites_supported() { return CN105_ALLOC_SITES != 0; }
+
+Window::Window() : active_(true) {
+#if CN105_ALLOC_SITES
+    // First backtrace() loads libgcc_s (allocates): do it before counting starts
+    void* warmup[2];
+    backtrace(warmup, 2);
+#endif
+    g_site_count = 0;
+    g_unattributed = 0;
+    start_ = totals();
+    g_armed = true;
+}
+
+Window::~Window() { stop(); }
+
+void Window::stop() {
+    if (!active_) return;
+    g_armed = false;
+    end_ = totals();
+    active_ = false;
+    std::sort(g_sites, g_sites + g_site_count, [](const Site& a, const Site& b) { return a.count > b.count; });
+}
+
+Counters Window::counters() const {
+    const Counters end = active_ ? totals() : end_;
+    Counters c;
+    c.allocations = end.allocations - start_.allocations;
+    c.frees = end.frees - start_.frees;
+    c.bytes = end.bytes - start_.bytes;
+    return c;
+}
+
+size_t Window::site_count() const { return g_site_count; }
+const Site& Window::site(size_t index) const { return g_sites[index]; }
+uint64_t Window::unattributed() const { return g_unattributed; }
+
+std::string Window::report(const char* label) const {
+    char line[SITE_NAME_LEN + 64];
+    std::snprintf(line, sizeof(line), "[  ALLOC   ] %s: %llu allocations, %llu bytes, %llu frees\n", label,
+        static_cast<unsigned long long>(allocations()), static_cast<unsigned long long>(bytes()),
+        static_cast<unsigned long long>(frees()));
+    std::string out = line;
+    for (size_t i = 0; i < g_site_count; i++) {
+        std::snprintf(line, sizeof(line), "[  ALLOC   ]   %6llu × %8llu B  %s\n",
+            static_cast<unsigned long long>(g_sites[i].count), static_cast<unsigned long long>(g_sites[i].bytes),
+            g_sites[i].name);
+        out += line;
+    }
+    if (g_unattributed != 0) {
+        std::snprintf(line, sizeof(line), "[  ALLOC   ]   %6llu more beyond %zu sites\n",
+            static_cast<unsigned long long>(g_unattributed), MAX_SITES);
+        out += line;
+    }
+    return out;
+}
+
+}  // namespace cn105_alloc
+
+// ════════════════════════════════════════════════════════════════
+// Replaceable allocation functions
+// ════════════════════════════════════════════════════════════════
+
+void* operator new(std::size_t size) { return cn105_alloc::checked_alloc(size); }
+void* operator new[](std::size_t size) { return cn105_alloc::checked_alloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return cn105_alloc::checked_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return cn105_alloc::checked_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return cn105_alloc::checked_aligned_alloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return cn105_alloc::checked_aligned_alloc(size, align); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return cn105_alloc::checked_aligned_alloc(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return cn105_alloc::checked_aligned_alloc(size, align); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p) noexcept { cn105_alloc::release(p); }
+void operator delete(void* p, std::size_t) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p, std::size_t) noexcept { cn105_alloc::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { cn105_alloc::release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { cn105_alloc::release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { cn105_alloc::release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { cn105_alloc::release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { cn105_alloc::release(p); }
@@ -0,0 +1,81 @@
+/// alloc_tracker.h — Heap accounting for host tests: global operator new/delete replaced by counters.
+/// Role: Lets a test assert that a code path (e.g. a steady-state poll cycle) performs no heap
+///       allocation, and reports the allocating call sites when it does.
+/// Deps: alloc_tracker.cpp (the operator new/delete replacements; link it only into executables
+///       that want the accounting, never into the ASan fuzz targets)
+///
+/// Usage:
+///   cn105_alloc::Window w;          // starts counting, call sites recorded
+///   ... code under test ...
+///   w.stop();
+///   EXPECT_EQ(w.allocations(), 0u) << w.report("steady state");
+///
+/// Call sites are resolved with glibc backtrace()/dladdr(): the executable must export its symbols
+/// (-rdynamic, ENABLE_EXPORTS in CMake) and static / anonymous-namespace functions show up as the
+/// nearest exported caller. Frames inside operator new, std:: and __gnu_cxx:: are skipped, so a
+/// vector growth is reported at the function calling push_back().
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cn105_alloc {
+
+static constexpr size_t MAX_SITES = 32;
+static constexpr size_t SITE_NAME_LEN = 160;
+static constexpr int MAX_FRAMES = 24;
+
+struct Counters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+};
+
+/// One allocating call site seen while a Window was active.
+struct Site {
+    char name[SITE_NAME_LEN];   // demangled, arguments stripped; "?" when unresolved
+    uint64_t count;
+    uint64_t bytes;
+};
+
+/// Process-wide totals since start-up (every thread).
+Counters totals();
+
+/// True when call sites can be resolved on this platform (glibc).
+bool sites_supported();
+
+/**
+ * Counts the allocations made between construction and stop() (or destruction) and records their
+ * call sites. Only one Window may be active at a time; the site table is reset on construction.
+ */
+class Window {
+public:
+    Window();
+    ~Window();
+    Window(const Window&) = delete;
+    Window& operator=(const Window&) = delete;
+
+    void stop();
+
+    uint64_t allocations() const { return counters().allocations; }
+    uint64_t frees() const { return counters().frees; }
+    uint64_t bytes() const { return counters().bytes; }
+
+    size_t site_count() const;
+    const Site& site(size_t index) const;   // sorted by count, highest first, after stop()
+    uint64_t unattributed() const;          // allocations beyond MAX_SITES distinct sites
+
+    /// "[  ALLOC   ] <label>: N allocations, B bytes" then one line per call site.
+    /// Builds a std::string: call it after stop().
+    std::string report(const char* label) const;
+
+private:
+    Counters counters() const;
+
+    Counters start_;
+    Counters end_;
+    bool active_;
+};
+
+}  // namespace cn105_alloc
@@ -0,0 +1,333 @@
+/// bench_protocol.cpp — Microbenchmarks for the per-byte / per-frame protocol hot paths.
+/// Deps: google-benchmark, frame_parser.h, cn105_protocol.h, packet_builder.h, packet_format.h, cn105_types.h (byte maps, *_TABLE)
+///
+/// Run and compare against the checked-in baseline:
+///   cmake --build build --target bench_compare
+/// or manually:
+///   ./cn105_benchmarks --benchmark_out=current.json --benchmark_out_format=json
+///   python3 benchmarks/compare_baseline.py benchmarks/baseline.json current.json
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include "frame_parser.h"
+#include "cn105_protocol.h"
+#include "packet_builder.h"
+#include "packet_format.h"
+#include "cn105_types.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+// Real 0x62/0x02 settings response (see test_real_frames.cpp)
+const uint8_t SETTINGS_FRAME[22] = {
+    0xFC,0x62,0x01,0x30,0x10, 0x02,0x00,0x00,0x00,0x01,0x1C,0x00,0x00,0x00,0x00,0x03,0xA7,0x00,0x00,0x00,0x00, 0x94
+};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// FrameParser
+// ════════════════════════════════════════════════════════════════
+
+static void BM_FrameParser_FeedFrame(benchmark::State& state) {
+    FrameParser parser;
+    for (auto _ : state) {
+        for (uint8_t b : SETTINGS_FRAME) {
+            parser.feed(b);
+        }
+        benchmark::DoNotOptimize(parser.checksum_valid());
+        parser.reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * sizeof(SETTINGS_FRAME));
+}
+BENCHMARK(BM_FrameParser_FeedFrame);
+
+static void BM_FrameParser_GarbageThenFrame(benchmark::State& state) {
+    // Line noise before the start byte (e.g. after a reconnect)
+    uint8_t stream[64 + sizeof(SETTINGS_FRAME)];
+    for (int i = 0; i < 64; i++) stream[i] = static_cast<uint8_t>(i * 7 + 1);
+    memcpy(&stream[64], SETTINGS_FRAME, sizeof(SETTINGS_FRAME));
+    FrameParser parser;
+    for (auto _ : state) {
+        for (uint8_t b : stream) {
+            parser.feed(b);
+        }
+        benchmark::DoNotOptimize(parser.frame_complete());
+        parser.reset();
+    }
+    state.SetBytesProcessed(state.iterations() * sizeof(stream));
+}
+BENCHMARK(BM_FrameParser_GarbageThenFrame);
+
+static void BM_FrameParser_FeedBulk(benchmark::State& state) {
+    // processInput() path: one chunk holding garbage + a full frame
+    uint8_t stream[64 + sizeof(SETTINGS_FRAME)];
+    for (int i = 0; i < 64; i++) stream[i] = static_cast<uint8_t>(i * 7 + 1);
+    memcpy(&stream[64], SETTINGS_FRAME, sizeof(SETTINGS_FRAME));
+    FrameParser parser;
+    for (auto _ : state) {
+        size_t frames = parser.feed(stream, sizeof(stream), [](const FrameParser& p) {
+            benchmark::DoNotOptimize(p.checksum_valid());
+        });
+        benchmark::DoNotOptimize(frames);
+    }
+    state.SetBytesProcessed(state.iterations() * sizeof(stream));
+}
+BENCHMARK(BM_FrameParser_FeedBulk);
+
+static void BM_FrameParser_MalformedFrames(benchmark::State& state) {
+    // Cost per frame for a chunk of 8 frames of one kind, up to the processCommand() length guard:
+    // 0 = valid settings reply, 1 = bad checksum, 2 = bad header byte, 3 = short 0x62 reply
+    const int kind = static_cast<int>(state.range(0));
+    uint8_t frame[22];
+    memcpy(frame, SETTINGS_FRAME, sizeof(frame));
+    size_t frame_len = sizeof(frame);
+    if (kind == 1) frame[21] ^= 0x5A;
+    if (kind == 2) frame[3] = 0x31;
+    if (kind == 3) {
+        frame[4] = 0x04;
+        frame[9] = checksum(frame, 9);
+        frame_len = 10;
+    }
+    uint8_t stream[8 * 22];
+    for (size_t i = 0; i < 8; i++) memcpy(&stream[i * frame_len], frame, frame_len);
+    FrameParser parser;
+    for (auto _ : state) {
+        size_t decodable = 0;
+        parser.feed(stream, 8 * frame_len, [&decodable](const FrameParser& p) {
+            decodable += p.checksum_valid() && p.data_length() >= RESPONSE_DATA_LEN;
+        });
+        benchmark::DoNotOptimize(decodable);
+    }
+    state.SetItemsProcessed(state.iterations() * 8);
+}
+BENCHMARK(BM_FrameParser_MalformedFrames)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+// ════════════════════════════════════════════════════════════════
+// Checksum / temperature
+// ════════════════════════════════════════════════════════════════
+
+static void BM_Checksum(benchmark::State& state) {
+    uint8_t frame[sizeof(SETTINGS_FRAME)];
+    memcpy(frame, SETTINGS_FRAME, sizeof(frame));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frame);
+        benchmark::DoNotOptimize(checksum(frame, 21));
+    }
+    state.SetBytesProcessed(state.iterations() * 21);
+}
+BENCHMARK(BM_Checksum);
+
+static void BM_DecodeTemperature(benchmark::State& state) {
+    uint8_t enc_a = 0x0D, enc_b = static_cast<uint8_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enc_a);
+        benchmark::DoNotOptimize(enc_b);
+        benchmark::DoNotOptimize(decode_temperature(enc_a, enc_b));
+    }
+}
+BENCHMARK(BM_DecodeTemperature)->Arg(0x00)->Arg(0xAE);
+
+// ════════════════════════════════════════════════════════════════
+// Byte-map lookups (arg = position of the hit in the map)
+// ════════════════════════════════════════════════════════════════
+
+static void BM_LookupValue_String(benchmark::State& state) {
+    uint8_t byte = WIDEVANE[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(lookup_value(WIDEVANE_MAP, WIDEVANE, 8, byte));
+    }
+}
+BENCHMARK(BM_LookupValue_String)->Arg(0)->Arg(7);
+
+static void BM_LookupValue_Int(benchmark::State& state) {
+    uint8_t byte = TEMP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(lookup_value(TEMP_MAP, TEMP, 16, byte));
+    }
+}
+BENCHMARK(BM_LookupValue_Int)->Arg(0)->Arg(15);
+
+static void BM_LookupValueOpt_String(benchmark::State& state) {
+    uint8_t byte = FAN[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(lookup_value_opt(FAN_MAP, FAN, 6, byte));
+    }
+}
+BENCHMARK(BM_LookupValueOpt_String)->Arg(0)->Arg(5);
+
+static void BM_LookupIndex_Int(benchmark::State& state) {
+    int value = TEMP_MAP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(lookup_index(TEMP_MAP, 16, value));
+    }
+}
+BENCHMARK(BM_LookupIndex_Int)->Arg(0)->Arg(15);
+
+static void BM_LookupIndex_String(benchmark::State& state) {
+    // strcasecmp variant, used on every SET packet for each requested field
+    const char* value = WIDEVANE_MAP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(lookup_index(WIDEVANE_MAP, 8, value));
+    }
+}
+BENCHMARK(BM_LookupIndex_String)->Arg(0)->Arg(7);
+
+static void BM_LookupIndexOpt_String(benchmark::State& state) {
+    const char* value = MODE_MAP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(lookup_index_opt(MODE_MAP, 5, value));
+    }
+}
+BENCHMARK(BM_LookupIndexOpt_String)->Arg(0)->Arg(4);
+
+// ════════════════════════════════════════════════════════════════
+// Generated *_TABLE decode / encode (byte_maps.h), same args as above
+// ════════════════════════════════════════════════════════════════
+
+static void BM_TableLookup_String(benchmark::State& state) {
+    uint8_t byte = WIDEVANE[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(WIDEVANE_TABLE.lookup(WIDEVANE_MAP, byte));
+    }
+}
+BENCHMARK(BM_TableLookup_String)->Arg(0)->Arg(7);
+
+static void BM_TableLookup_Int(benchmark::State& state) {
+    uint8_t byte = ROOM_TEMP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(ROOM_TEMP_TABLE.lookup(ROOM_TEMP_MAP, byte));
+    }
+}
+BENCHMARK(BM_TableLookup_Int)->Arg(0)->Arg(31);
+
+static void BM_LookupValueOpt_RoomTemp(benchmark::State& state) {
+    // Linear reference for BM_TableLookup_Int (32 entries, the longest map)
+    uint8_t byte = ROOM_TEMP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(byte);
+        benchmark::DoNotOptimize(lookup_value_opt(ROOM_TEMP_MAP, ROOM_TEMP, 32, byte));
+    }
+}
+BENCHMARK(BM_LookupValueOpt_RoomTemp)->Arg(0)->Arg(31);
+
+static void BM_TableFind_String(benchmark::State& state) {
+    // Pointer into the label map, as stored in wantedSettings
+    const char* value = WIDEVANE_MAP[state.range(0)];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(WIDEVANE_TABLE.find(WIDEVANE_MAP, value));
+    }
+}
+BENCHMARK(BM_TableFind_String)->Arg(0)->Arg(7);
+
+static void BM_TableFind_StringCopy(benchmark::State& state) {
+    // Label from elsewhere (select option string): strcasecmp fallback
+    std::string copy(WIDEVANE_MAP[state.range(0)]);
+    const char* value = copy.c_str();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(WIDEVANE_TABLE.find(WIDEVANE_MAP, value));
+    }
+}
+BENCHMARK(BM_TableFind_StringCopy)->Arg(0)->Arg(7);
+
+// ════════════════════════════════════════════════════════════════
+// SET packet construction (CN105Climate::createPacket)
+// ════════════════════════════════════════════════════════════════
+
+static void BM_BuildSetPacket_Full(benchmark::State& state) {
+    SetRequest req;
+    req.power = Power::ON;
+    req.mode = Mode::AUTO;
+    req.temperature = 21.5f;
+    req.temperature_encoding_b = true;
+    req.fan = Fan::SPEED_4;
+    req.vane = Vane::SWING;
+    req.wide_vane = WideVane::AIRFLOW_CONTROL;
+    uint8_t packet[PACKET_LEN];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(req);
+        benchmark::DoNotOptimize(build_set_packet(packet, req));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BuildSetPacket_Full);
+
+static void BM_BuildSetPacket_TemperatureOnly(benchmark::State& state) {
+    SetRequest req;
+    req.temperature = 22;
+    uint8_t packet[PACKET_LEN];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(req);
+        benchmark::DoNotOptimize(build_set_packet(packet, req));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BuildSetPacket_TemperatureOnly);
+
+// ════════════════════════════════════════════════════════════════
+// Packet debug line (hpPacketDebug) — former std::string + snprintf vs stack buffer
+// ════════════════════════════════════════════════════════════════
+
+static const uint8_t DEBUG_FRAME[22] = {0xFC,0x62,0x01,0x30,0x10, 0x02,0x00,0x00,0x01,0x01,0x0A,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x59};
+
+static void BM_PacketDebug_StringSnprintf(benchmark::State& state) {
+    char byteBuf[4];
+    char line[PACKET_DEBUG_LEN];
+    for (auto _ : state) {
+        std::string headerStr, dataStr, csStr;
+        for (unsigned int i = 0; i < 5; i++) {
+            snprintf(byteBuf, sizeof(byteBuf), "%02X ", DEBUG_FRAME[i]);
+            headerStr += byteBuf;
+        }
+        for (unsigned int i = 5; i < 21; i++) {
+            snprintf(byteBuf, sizeof(byteBuf), "%02X ", DEBUG_FRAME[i]);
+            dataStr += byteBuf;
+        }
+        snprintf(byteBuf, sizeof(byteBuf), "%02X", DEBUG_FRAME[21]);
+        csStr = byteBuf;
+        snprintf(line, sizeof(line), "%s|%s|->[%s](%s) <%s>", "READ", headerStr.c_str(), dataStr.c_str(), csStr.c_str(), "RESPONSE:Settings");
+        benchmark::DoNotOptimize(line);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketDebug_StringSnprintf);
+
+static void BM_PacketDebug_Format(benchmark::State& state) {
+    char line[PACKET_DEBUG_LEN];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(format_packet_debug(line, sizeof(line), DEBUG_FRAME, sizeof(DEBUG_FRAME), "READ"));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketDebug_Format);
+
+// BENCHMARK_MAIN() plus the build flavour in the JSON context: compare_baseline.py refuses to compare
+// an unoptimised run with the (optimised) baseline
+int main(int argc, char** argv) {
+#ifdef __OPTIMIZE__
+    benchmark::AddCustomContext("cn105_optimized", "true");
+#else
+    benchmark::AddCustomContext("cn105_optimized", "false");
+#endif
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""compare_baseline.py — Compare a google-benchmark JSON run against the checked-in baseline.
+
+Usage: compare_baseline.py BASELINE.json CURRENT.json [--threshold 0.15]
+
+Prints one line per benchmark (baseline ns, current ns, delta) and exits with status 1
+if any benchmark got slower than the threshold (relative cpu_time increase).
+Benchmarks missing on either side are reported but never fail the run.
+Exits with status 2, without comparing, if the two runs were not built the same way
+(context "cn105_optimized", set by bench_protocol.cpp): an -O0 run is several times slower.
+To refresh the baseline, run `cmake --build build --target bench_compare`, copy
+build/bench_current.json over benchmarks/baseline.json and drop the machine-local
+"executable" path from its context.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        doc = json.load(f)
+    return doc.get("context", {}), times(doc)
+
+
+def times(doc):
+    iterations, medians = {}, {}
+    for b in doc.get("benchmarks", []):
+        if b.get("run_type", "iteration") == "aggregate":
+            # --benchmark_repetitions: compare medians, keyed by the plain run name
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = float(b["cpu_time"])
+        else:
+            iterations.setdefault(b["name"], float(b["cpu_time"]))
+    return medians or iterations
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=0.15,
+                    help="max allowed relative slowdown (default: 0.15 = +15%%)")
+    args = ap.parse_args()
+
+    base_ctx, base = load(args.baseline)
+    cur_ctx, cur = load(args.current)
+    base_opt = base_ctx.get("cn105_optimized", "unknown")
+    cur_opt = cur_ctx.get("cn105_optimized", "unknown")
+    if base_opt != cur_opt or cur_opt != "true":
+        print(f"refusing to compare: baseline cn105_optimized={base_opt}, current cn105_optimized={cur_opt} "
+              "(the benchmarks must be built optimised, see CMakeLists.txt)")
+        return 2
+    regressions = []
+
+    print(f"{'benchmark':<44} {'baseline':>10} {'current':>10} {'delta':>8}")
+    for name in sorted(set(base) | set(cur)):
+        if name not in base or name not in cur:
+            side = "baseline" if name not in base else "current run"
+            print(f"{name:<44} (missing from {side})")
+            continue
+        delta = (cur[name] - base[name]) / base[name] if base[name] > 0 else 0.0
+        flag = ""
+        if delta > args.threshold:
+            flag = "  << REGRESSION"
+            regressions.append(name)
+        print(f"{name:<44} {base[name]:>10.2f} {cur[name]:>10.2f} {delta:>+7.1%}{flag}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than +{args.threshold:.0%}: {', '.join(regressions)}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,324 @@
+/// heatpump_emulator.h — Virtual Mitsubishi heat pump speaking the CN105 protocol on a simulated UART.
+/// Role: Lets the host tests drive the real request/cycle/parser path without hardware and
+///       measure poll latency in virtual time.
+/// Deps: frame_parser.h, cn105_protocol.h, cn105_types.h (no ESPHome dependency)
+///
+/// Timing model:
+///   - 2400 baud 8E1 → 11 bits on the wire per byte (start + 8 data + parity + stop),
+///     i.e. ~4.583 ms per byte, ~100.8 ms for a 22-byte frame, in both directions.
+///   - The unit starts answering `response_latency_us` (+ uniform jitter) after the last
+///     byte of a request has been clocked in. Its TX line is serial: replies never overlap.
+///
+/// Usage:
+///   HeatPumpEmulator hp;                       // or HeatPumpEmulator hp(config)
+///   hp.host_write(packet, 22, now_us);         // host → unit
+///   while (hp.available(now_us)) parser.feed(hp.read(now_us));
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <random>
+#include "frame_parser.h"
+#include "cn105_protocol.h"
+#include "cn105_types.h"
+
+namespace cn105_emulator {
+
+/// How the virtual unit reacts to a given INFO (0x42) request code.
+enum class InfoReply : uint8_t {
+    NORMAL,         // realistic 0x62 payload
+    SILENT,         // no reply at all (e.g. 0x09/0x42 on older units)
+    ZEROS,          // 0x62 echoing the code with an all-zero payload (e.g. 0x20/0x22 outside installer mode)
+};
+
+struct EmulatorConfig {
+    uint32_t baud_rate = 2400;
+    uint8_t bits_per_byte = 11;             // 8E1: start + 8 data + parity + stop
+    uint32_t response_latency_us = 20000;   // last request byte in → first reply byte out
+    uint32_t jitter_us = 0;                 // uniform [0, jitter_us] added to each reply latency
+    uint32_t seed = 0x105;                  // jitter PRNG seed (runs are reproducible)
+    bool accept_user_connect = true;        // answer 0x5A with 0x7A
+    bool accept_installer_connect = true;   // answer 0x5B with 0x7B
+    InfoReply info_reply[256];              // per-code behaviour, NORMAL by default
+
+    EmulatorConfig() {
+        for (auto& r : info_reply) r = InfoReply::NORMAL;
+        // Codes real units never answer with data
+        info_reply[0x05] = InfoReply::SILENT;
+    }
+
+    /// Convenience: mark a code as unsupported by the unit.
+    EmulatorConfig& unsupported(uint8_t code, InfoReply how = InfoReply::SILENT) {
+        info_reply[code] = how;
+        return *this;
+    }
+};
+
+class HeatPumpEmulator {
+public:
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    explicit HeatPumpEmulator(const EmulatorConfig& config = EmulatorConfig())
+        : config_(config), rng_(config.seed) {
+        reset_state();
+    }
+
+    /// Time on the wire for one byte, in microseconds (4583 µs at 2400 8E1).
+    uint32_t byte_time_us() const {
+        return static_cast<uint32_t>((uint64_t(config_.bits_per_byte) * 1000000ULL) / config_.baud_rate);
+    }
+
+    /// Host → unit. Bytes are clocked out back to back starting at `now_us`
+    /// (or when the host TX line becomes free). Complete frames are answered.
+    void host_write(const uint8_t* buf, size_t len, uint64_t now_us) {
+        uint64_t t = now_us > host_line_free_us_ ? now_us : host_line_free_us_;
+        for (size_t i = 0; i < len; i++) {
+            t += byte_time_us();
+            bytes_from_host_++;
+            rx_parser_.feed(buf[i]);
+            if (rx_parser_.frame_complete()) {
+                if (rx_parser_.checksum_valid()) {
+                    handle_frame(rx_parser_.command(), rx_parser_.data(), rx_parser_.data_length(), t);
+                } else {
+                    bad_checksums_++;
+                }
+                rx_parser_.reset();
+            }
+        }
+        host_line_free_us_ = t;
+    }
+
+    /// Number of reply bytes fully received by the host at `now_us`.
+    size_t available(uint64_t now_us) const {
+        size_t n = 0;
+        while (n < tx_queue_.size() && tx_queue_[n].at_us <= now_us) n++;
+        return n;
+    }
+
+    /// Pops the next reply byte, or -1 if none is available yet.
+    int read(uint64_t now_us) {
+        if (tx_queue_.empty() || tx_queue_.front().at_us > now_us) return -1;
+        uint8_t b = tx_queue_.front().value;
+        tx_queue_.pop_front();
+        return b;
+    }
+
+    /// Pops up to `len` available reply bytes into `out` (UARTComponent::read_array equivalent).
+    size_t read_array(uint8_t* out, size_t len, uint64_t now_us) {
+        size_t n = 0;
+        while (n < len && !tx_queue_.empty() && tx_queue_.front().at_us <= now_us) {
+            out[n++] = tx_queue_.front().value;
+            tx_queue_.pop_front();
+        }
+        return n;
+    }
+
+    /// Timestamp at which the next reply byte becomes readable (NEVER if idle).
+    uint64_t next_byte_us() const { return tx_queue_.empty() ? NEVER : tx_queue_.front().at_us; }
+
+    /// True once a 0x5A/0x5B handshake has been accepted.
+    bool connected() const { return connected_; }
+    bool installer_mode() const { return installer_mode_; }
+
+    // ── Virtual unit state (what 0x02/0x03/0x06 report) ──
+    uint8_t power = 0x01;           // POWER[]: 0x00 OFF, 0x01 ON
+    uint8_t mode = 0x01;            // MODE[]: HEAT
+    uint8_t temp_encoded = 0xAB;    // 0x41/0x62 "temperature B" encoding: (°C * 2) + 128 → 21.5 °C
+    uint8_t fan = 0x00;             // FAN[]: AUTO
+    uint8_t vane = 0x00;            // VANE[]: AUTO
+    uint8_t wide_vane = 0x03;       // WIDEVANE[]: |
+    uint8_t room_temp_encoded = 0xAE;   // 23.0 °C
+    uint8_t outside_temp_encoded = 0x00;
+    uint8_t operating = 0x00;
+    uint8_t compressor_hz = 0x00;
+    uint8_t remote_temp_encoded = 0x00; // last 0x41/0x07 value, 0 = internal sensor
+
+    // ── Counters ──
+    uint32_t frames_received() const { return frames_received_; }
+    uint32_t frames_sent() const { return frames_sent_; }
+    uint32_t info_requests(uint8_t code) const { return info_requests_[code]; }
+    uint32_t set_requests() const { return set_requests_; }
+    uint32_t bad_checksums() const { return bad_checksums_; }
+    uint64_t bytes_from_host() const { return bytes_from_host_; }
+
+    const EmulatorConfig& config() const { return config_; }
+    EmulatorConfig& config() { return config_; }
+
+private:
+    struct TimedByte {
+        uint64_t at_us;
+        uint8_t value;
+    };
+
+    /// Fixed ring of reply bytes in flight: no heap traffic while frames are queued and read,
+    /// so the host loop can be heap-accounted (test_allocations.cpp).
+    class TxQueue {
+    public:
+        static constexpr size_t CAPACITY = 1024;   // ~46 full frames, far more than any pipeline window
+
+        bool empty() const { return count_ == 0; }
+        size_t size() const { return count_; }
+        const TimedByte& front() const { return bytes_[head_]; }
+        const TimedByte& operator[](size_t i) const { return bytes_[(head_ + i) % CAPACITY]; }
+        void pop_front() { head_ = (head_ + 1) % CAPACITY; count_--; }
+        /// Drops the byte when full (a unit whose TX buffer overflows loses bytes, like the wire would).
+        void push_back(const TimedByte& b) {
+            if (count_ == CAPACITY) return;
+            bytes_[(head_ + count_) % CAPACITY] = b;
+            count_++;
+        }
+        void clear() { head_ = count_ = 0; }
+
+    private:
+        TimedByte bytes_[CAPACITY];
+        size_t head_ = 0;
+        size_t count_ = 0;
+    };
+
+    void reset_state() {
+        connected_ = false;
+        installer_mode_ = false;
+        host_line_free_us_ = 0;
+        unit_line_free_us_ = 0;
+        frames_received_ = frames_sent_ = set_requests_ = bad_checksums_ = 0;
+        bytes_from_host_ = 0;
+        std::memset(info_requests_, 0, sizeof(info_requests_));
+        tx_queue_.clear();
+        rx_parser_.reset();
+    }
+
+    uint32_t reply_latency_us() {
+        if (config_.jitter_us == 0) return config_.response_latency_us;
+        std::uniform_int_distribution<uint32_t> dist(0, config_.jitter_us);
+        return config_.response_latency_us + dist(rng_);
+    }
+
+    /// Queues a full frame (header + payload + checksum) on the unit TX line.
+    void send_frame(uint8_t command, const uint8_t* payload, uint8_t len, uint64_t request_done_us) {
+        uint8_t frame[MAX_DATA_BYTES];
+        frame[0] = 0xFC;
+        frame[1] = command;
+        frame[2] = 0x01;
+        frame[3] = 0x30;
+        frame[4] = len;
+        std::memcpy(&frame[5], payload, len);
+        frame[5 + len] = cn105_protocol::checksum(frame, 5 + len);
+
+        uint64_t t = request_done_us + reply_latency_us();
+        if (t < unit_line_free_us_) t = unit_line_free_us_;
+        for (int i = 0; i < len + 6; i++) {
+            t += byte_time_us();
+            tx_queue_.push_back({ t, frame[i] });
+        }
+        unit_line_free_us_ = t;
+        frames_sent_++;
+    }
+
+    void handle_frame(uint8_t command, const uint8_t* data, int len, uint64_t done_us) {
+        frames_received_++;
+        switch (command) {
+        case 0x5A:
+        case 0x5B: {
+            bool installer = (command == 0x5B);
+            if ((installer && !config_.accept_installer_connect) || (!installer && !config_.accept_user_connect)) {
+                return;
+            }
+            connected_ = true;
+            installer_mode_ = installer;
+            const uint8_t ack[1] = { 0x00 };
+            send_frame(installer ? 0x7B : 0x7A, ack, 1, done_us);
+            break;
+        }
+        case 0x41:
+            if (!connected_ || len < 1) return;
+            set_requests_++;
+            apply_set(data, len);
+            {
+                uint8_t ack[16] = {};
+                send_frame(0x61, ack, sizeof(ack), done_us);
+            }
+            break;
+        case 0x42:
+            if (!connected_ || len < 1) return;
+            info_requests_[data[0]]++;
+            reply_info(data[0], done_us);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void apply_set(const uint8_t* data, int len) {
+        if (len < 16) return;
+        if (data[0] == 0x01) {
+            // Flags in data[1]/data[2] tell which fields are meaningful (see CONTROL_PACKET_1/2)
+            if (data[1] & CONTROL_PACKET_1[0]) power = data[3];
+            if (data[1] & CONTROL_PACKET_1[1]) mode = data[4];
+            if (data[1] & CONTROL_PACKET_1[2]) temp_encoded = data[14] != 0 ? data[14] : uint8_t(((31 - data[5]) * 2) + 128);
+            if (data[1] & CONTROL_PACKET_1[3]) fan = data[6];
+            if (data[1] & CONTROL_PACKET_1[4]) vane = data[7];
+            if (data[2] & CONTROL_PACKET_2[0]) wide_vane = data[13];
+        } else if (data[0] == 0x07) {
+            remote_temp_encoded = (data[1] == 0x01) ? data[3] : 0x00;
+        }
+    }
+
+    void reply_info(uint8_t code, uint64_t done_us) {
+        InfoReply how = config_.info_reply[code];
+        if (how == InfoReply::SILENT) return;
+
+        uint8_t p[16] = {};
+        p[0] = code;
+        if (how == InfoReply::NORMAL) {
+            switch (code) {
+            case 0x02:
+                p[3] = power;
+                p[4] = mode;
+                p[6] = fan;
+                p[7] = vane;
+                p[10] = wide_vane;
+                p[11] = temp_encoded;
+                break;
+            case 0x03:
+                p[5] = outside_temp_encoded;
+                p[6] = room_temp_encoded;
+                break;
+            case 0x06:
+                p[3] = compressor_hz;
+                p[4] = operating;
+                break;
+            case 0x09:
+                p[3] = 0x00;    // sub mode: normal
+                p[4] = 0x00;    // stage: idle
+                break;
+            case 0x20:
+            case 0x22:
+                // code/value pairs: report a handful of functions so the payload is not all zeros
+                for (int i = 1; i < 16; i++) p[i] = static_cast<uint8_t>((i << 2) | 0x01);
+                break;
+            default:
+                break;
+            }
+        }
+        send_frame(0x62, p, sizeof(p), done_us);
+    }
+
+    EmulatorConfig config_;
+    std::mt19937 rng_;
+    cn105_protocol::FrameParser rx_parser_;
+    TxQueue tx_queue_;
+    uint64_t host_line_free_us_ = 0;
+    uint64_t unit_line_free_us_ = 0;
+    bool connected_ = false;
+    bool installer_mode_ = false;
+    uint32_t frames_received_ = 0;
+    uint32_t frames_sent_ = 0;
+    uint32_t set_requests_ = 0;
+    uint32_t bad_checksums_ = 0;
+    uint32_t info_requests_[256] = {};
+    uint64_t bytes_from_host_ = 0;
+};
+
+} // namespace cn105_emulator
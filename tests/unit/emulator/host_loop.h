@@ -0,0 +1,437 @@
+/// host_loop.h — Host replica of the CN105Climate polling loop, wired to HeatPumpEmulator.
+/// Role: Runs the real RequestScheduler + cycleManagement + FrameParser in virtual time so
+///       full-cycle durations can be measured for a given update_interval / soft-timeout setup.
+/// Deps: request_scheduler.h, cycle_management.h, frame_parser.h, heatpump_emulator.h,
+///       mocks/esphome.h (virtual millis())
+///
+/// What is mirrored from the component (componentEntries.cpp / cn105.cpp / hp_writings.cpp):
+///   - loop(): bulk-read every available byte, queue completed frames and decode them from the ring,
+///     and only when no input was read check the cycle timeout or start a new cycle once
+///     update_interval has passed;
+///   - the INFO request catalogue registered by registerInfoRequests() (same codes/timeouts, constexpr table);
+///   - SET writes (settings deltas, 0x07 remote temperature) queued on the scheduler (performQueuedWrite()
+///     equivalent) and 0x61 → process_ack();
+///   - CommandTracker fed like the component: control at queue time, written in perform_write(),
+///     0x61 → ack(), 0x02 showing the written setpoint → confirmed();
+///   - CONNECT retried by HandshakeEngine (runHandshake_() equivalent) when started with start_handshake();
+///   - warm reconnect: stateFreshness kept across lose_link(), 0x02/0x03/0x06 "published" only when their
+///     payload differs from the last one (heatpumpUpdate() / statusChanged() equivalent);
+///   - RequestScheduler::loop() runs every iteration, before the input is read, every `loop_interval_ms` (16 ms).
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "esphome.h"
+#include "cn105_types.h"
+#include "frame_parser.h"
+#include "frame_queue.h"
+#include "packet_builder.h"
+#include "command_latency.h"
+#include "handshake.h"
+#include "request_scheduler.h"
+#include "cycle_management.h"
+#include "heatpump_emulator.h"
+
+namespace cn105_emulator {
+
+struct DriverConfig {
+    uint32_t update_interval_ms = 2000;     // climate `update_interval`
+    uint32_t loop_interval_ms = 16;         // ESPHome main loop period
+    bool hvac_options = true;               // 0x42 canSend (a night/purifier/circulator switch is configured)
+    uint32_t hardware_settings_interval_ms = 0;     // 0 → 0x20/0x22 disabled (no hardware_settings in YAML)
+    uint8_t pipeline_window = 1;            // climate `info_pipeline_window` (1 = sequential)
+    esphome::AdaptivePollingConfig adaptive;    // climate `adaptive_polling` (disabled by default)
+    uint32_t warm_reconnect_window_ms = 300000; // climate `warm_reconnect_window` (0 = full resync)
+};
+
+/// Minimal CN105Climate stand-in: the same scheduler/cycle/parser objects, no HA entities.
+class HostDriver {
+public:
+    HostDriver(HeatPumpEmulator& hp, const DriverConfig& config = DriverConfig())
+        : hp_(hp), config_(config),
+        scheduler_(
+            [this](uint8_t code) { this->send_info(code); },
+            [this]() { this->terminate_cycle(); },
+            []() -> esphome::CN105Climate* { return nullptr; }) {
+        register_requests();
+        // Harness bookkeeping sized up front: keeps test_allocations.cpp's steady-state window at zero
+        cycle_durations_ms_.reserve(RESERVED_RECORDS);
+        set_packets_.reserve(RESERVED_RECORDS);
+        scheduler_.set_write_callback([this](uint8_t write_id) { return this->perform_write(write_id); });
+        scheduler_.set_pipeline_window(config_.pipeline_window);
+        scheduler_.set_adaptive_polling(config_.adaptive, config_.update_interval_ms);
+        cycle_.init();
+    }
+
+    /// Sends CONNECT (0x5A, or 0x5B for installer mode) like sendFirstConnectionPacket().
+    void connect(bool installer = false) {
+        uint8_t packet[CONNECT_LEN];
+        std::memcpy(packet, CONNECT, CONNECT_LEN);
+        if (installer) {
+            packet[1] = 0x5B;
+            packet[CONNECT_LEN - 1] = cn105_protocol::checksum(packet, CONNECT_LEN - 1);
+        }
+        write(packet, CONNECT_LEN);
+    }
+
+    /// Lets HandshakeEngine send CONNECT from loop_once(), with its reply timeout and backoff.
+    void start_handshake(bool installer = false) {
+        handshake_.set_installer_mode(installer);
+        handshake_.begin(esphome::millis());
+    }
+
+    /// The link went down (reconnectUART() equivalent): polling stops until CONNECT is answered again.
+    void lose_link() {
+        connected_ = false;
+        freshness_.linkLost(esphome::millis());
+        handshake_.link_lost(esphome::millis());
+    }
+
+    /// One ESPHome main-loop iteration (component loop()).
+    void loop_once() {
+        run_handshake();
+        scheduler_.loop();
+        if (!process_input()) {
+            if (!connected_) return;
+            if (cycle_.isCycleRunning()) {
+                cycle_.checkTimeout(config_.update_interval_ms);
+                if (!cycle_.isCycleRunning()) nb_timed_out_cycles_++;
+            } else if (cycle_.hasUpdateIntervalPassed(scheduler_.poll_period_ms(config_.update_interval_ms))) {
+                cycle_.cycleStarted();
+                nb_cycles_++;
+                scheduler_.start_cycle();
+            }
+        }
+    }
+
+    /// Advances virtual time loop by loop until `done()` or `max_ms` elapsed. Returns true if done.
+    bool run_until(const std::function<bool()>& done, uint32_t max_ms) {
+        const uint64_t limit_us = esphome::host_clock_us() + uint64_t(max_ms) * 1000;
+        while (!done()) {
+            if (esphome::host_clock_us() >= limit_us) return false;
+            esphome::host_clock_us() += uint64_t(config_.loop_interval_ms) * 1000;
+            loop_once();
+        }
+        return true;
+    }
+
+    /// Runs until `count` more cycles have completed through terminateCycle().
+    bool run_cycles(uint32_t count, uint32_t max_ms) {
+        const uint32_t target = static_cast<uint32_t>(cycle_durations_ms_.size()) + count;
+        return run_until([this, target]() { return cycle_durations_ms_.size() >= target; }, max_ms);
+    }
+
+    bool connected() const { return connected_; }
+    uint8_t connect_reply() const { return connect_reply_; }
+    uint32_t nb_cycles() const { return nb_cycles_; }
+    uint32_t nb_complete_cycles() const { return nb_complete_cycles_; }
+    uint32_t nb_timed_out_cycles() const { return nb_timed_out_cycles_; }
+    uint32_t responses(uint8_t code) const { return responses_[code]; }
+    uint32_t last_response_ms(uint8_t code) const { return last_response_ms_[code]; }
+    uint32_t acks() const { return acks_; }
+    uint32_t bad_checksums() const { return bad_checksums_; }
+    /// State changes pushed to HA from 0x02 / 0x03 / 0x06 replies.
+    uint32_t publishes(uint8_t code) const { return publishes_[code]; }
+    const stateFreshness& freshness() const { return freshness_; }
+    const std::vector<uint32_t>& cycle_durations_ms() const { return cycle_durations_ms_; }
+
+    esphome::RequestScheduler& scheduler() { return scheduler_; }
+    const esphome::HandshakeEngine& handshake() const { return handshake_; }
+    uint32_t connect_timeouts() const { return connect_timeouts_; }
+    cycleManagement& cycle() { return cycle_; }
+
+    /// Queues a settings delta (0x41/0x01) like control() + checkPendingWantedSettings(): fields set
+    /// here are merged into the write still waiting in the queue, if any.
+    void queue_settings(const cn105_protocol::SetRequest& delta) {
+        if (is_set(delta.power)) wanted_.power = delta.power;
+        if (is_set(delta.mode)) wanted_.mode = delta.mode;
+        if (delta.temperature != -1) wanted_.temperature = delta.temperature;
+        if (is_set(delta.fan)) wanted_.fan = delta.fan;
+        if (is_set(delta.vane)) wanted_.vane = delta.vane;
+        if (is_set(delta.wide_vane)) wanted_.wide_vane = delta.wide_vane;
+        write_queued_ms_ = esphome::millis();
+        latency_.control(esphome::CommandKind::SETTINGS, esphome::millis());
+        scheduler_.enqueue_write(WRITE_SETTINGS);
+    }
+
+    void queue_settings_write(float temperature) {
+        cn105_protocol::SetRequest delta;
+        delta.temperature = temperature;
+        queue_settings(delta);
+    }
+
+    /// Queues a 0x41/0x07 remote temperature write (sendRemoteTemperaturePacket() equivalent).
+    void queue_remote_temperature(float temperature) {
+        remote_temperature_ = temperature;
+        write_queued_ms_ = esphome::millis();
+        latency_.control(esphome::CommandKind::REMOTE_TEMP, esphome::millis());
+        scheduler_.enqueue_write(WRITE_REMOTE_TEMP);
+    }
+
+    /// Queue → 0x61 ACK delay of the last write (0 until it has been acknowledged).
+    uint32_t last_write_latency_ms() const { return write_latency_ms_; }
+
+    /// Command latency histograms (commandLatency_ equivalent).
+    const esphome::CommandTracker& latency() const { return latency_; }
+
+    /// Sub-command (packet[5]) of every SET packet written, in bus order.
+    const std::vector<uint8_t>& set_packets() const { return set_packets_; }
+
+    /// SET packets written while a previous one had not been acknowledged yet.
+    uint32_t unacked_overlaps() const { return unacked_overlaps_; }
+
+    /// Raw write path (writePacket() equivalent), timestamped on the virtual clock.
+    /// Returns false, nothing on the wire, while the UART is down (see set_uart_ready()).
+    bool write(const uint8_t* packet, size_t len) {
+        if (!uart_ready_) return false;
+        hp_.host_write(packet, len, esphome::host_clock_us());
+        return true;
+    }
+
+    /// isUARTReady_() equivalent: while false every write is skipped, like writePacket() stashing it.
+    void set_uart_ready(bool ready) { uart_ready_ = ready; }
+
+public:
+    /// registerInfoRequests() catalogue: same codes, timeouts and poll classes, no decoders.
+    static constexpr esphome::RequestDescriptor REQUESTS[] = {
+        esphome::RequestDescriptor("settings", "Settings", 0x02, 3, 0).polled(esphome::PollClass::STRETCH_WHEN_STABLE),
+        esphome::RequestDescriptor("room_temp", "Room temperature", 0x03, 3, 0).polled(esphome::PollClass::FAST_WHEN_ACTIVE),
+        esphome::RequestDescriptor("status", "Status", 0x06, 3, 0).polled(esphome::PollClass::FAST_WHEN_ACTIVE),
+        esphome::RequestDescriptor("standby", "Power/Standby", 0x09, 3, 500).polled(esphome::PollClass::STRETCH_WHEN_STABLE),
+        esphome::RequestDescriptor("hvac_options", "HVAC options", 0x42, 3, 500).polled(esphome::PollClass::STRETCH_WHEN_STABLE),
+        esphome::RequestDescriptor("error_info", "Error Info", 0x04, 3, 0).polled(esphome::PollClass::STRETCH_WHEN_STABLE),
+        esphome::RequestDescriptor("timers", "Timers", 0x05, 1, 0).start_disabled(),
+        esphome::RequestDescriptor("functions1", "Functions Part 1", 0x20, 3, 0, 0, LOG_FUNCTIONS_TAG),
+        esphome::RequestDescriptor("functions2", "Functions Part 2", 0x22, 3, 0, 0, LOG_FUNCTIONS_TAG),
+    };
+    static constexpr size_t REQUEST_COUNT = sizeof(REQUESTS) / sizeof(REQUESTS[0]);
+
+private:
+    void register_requests() {
+        scheduler_.clear_requests();
+        scheduler_.register_requests(REQUESTS, REQUEST_COUNT);
+        if (!config_.hvac_options) scheduler_.disable_request(0x42);
+
+        const uint32_t hw_interval = config_.hardware_settings_interval_ms;
+        scheduler_.set_request_interval(0x20, hw_interval);
+        scheduler_.set_request_interval(0x22, hw_interval);
+        if (hw_interval == 0) {
+            scheduler_.disable_request(0x20);
+            scheduler_.disable_request(0x22);
+        }
+    }
+
+    static constexpr uint8_t WRITE_SETTINGS = 0;
+    static constexpr uint8_t WRITE_REMOTE_TEMP = 2;
+    static constexpr size_t RESERVED_RECORDS = 512;   // cycle durations / SET packets recorded without regrowth
+
+    uint8_t perform_write(uint8_t write_id) {
+        uint8_t packet[PACKET_LEN];
+        esphome::CommandKind kind;
+        if (write_id == WRITE_SETTINGS) {
+            wanted_.temperature_encoding_b = true;
+            cn105_protocol::build_set_packet(packet, wanted_);
+            // 0x02 readback confirming the write: same encoded setpoint (any 0x02 if no setpoint was written)
+            confirm_temp_encoded_ = wanted_.temperature != -1 ? packet[19] : -1;
+            wanted_ = cn105_protocol::SetRequest();
+            kind = esphome::CommandKind::SETTINGS;
+        } else if (write_id == WRITE_REMOTE_TEMP) {
+            std::memset(packet, 0, PACKET_LEN);
+            std::memcpy(packet, HEADER, HEADER_LEN);
+            packet[5] = 0x07;
+            const float temp = std::round(remote_temperature_ * 2);
+            packet[6] = 0x01;
+            packet[7] = static_cast<uint8_t>(temp - 16);
+            packet[8] = static_cast<uint8_t>(temp + 128);
+            packet[PACKET_LEN - 1] = cn105_protocol::checksum(packet, PACKET_LEN - 1);
+            kind = esphome::CommandKind::REMOTE_TEMP;
+        } else {
+            return 0;
+        }
+        if (!write(packet, PACKET_LEN)) return 0;     // no ACK to wait for: the line stays free
+        latency_.written(kind, esphome::millis());    // only bytes on the wire get an ACK to match
+        if (write_pending_ack_) unacked_overlaps_++;
+        set_packets_.push_back(packet[5]);
+        write_pending_ack_ = true;
+        return 1;
+    }
+
+    void run_handshake() {
+        switch (handshake_.poll(esphome::millis())) {
+        case esphome::HandshakeEngine::Action::SEND_CONNECT: {
+            uint8_t packet[CONNECT_LEN];
+            std::memcpy(packet, CONNECT, CONNECT_LEN);
+            packet[1] = handshake_.connect_command();
+            packet[CONNECT_LEN - 1] = cn105_protocol::checksum(packet, CONNECT_LEN - 1);
+            write(packet, CONNECT_LEN);
+            handshake_.sent(esphome::millis());
+            break;
+        }
+        case esphome::HandshakeEngine::Action::TIMED_OUT:
+        case esphome::HandshakeEngine::Action::PROBE_FAILED:
+            connect_timeouts_++;
+            parser_.reset();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void send_info(uint8_t code) {
+        uint8_t packet[PACKET_LEN] = {};
+        std::memcpy(packet, INFOHEADER, INFOHEADER_LEN);
+        packet[5] = code;
+        packet[PACKET_LEN - 1] = cn105_protocol::checksum(packet, PACKET_LEN - 1);
+        write(packet, PACKET_LEN);
+    }
+
+    void terminate_cycle() {
+        cycle_.cycleEnded();
+        cycle_durations_ms_.push_back(esphome::millis() - static_cast<uint32_t>(cycle_.lastCycleStartMs));
+        nb_complete_cycles_++;
+    }
+
+    bool process_input() {
+        const uint64_t now = esphome::host_clock_us();
+        uint8_t chunk[UART_READ_CHUNK_SIZE];
+        bool processed = false;
+        size_t avail;
+        while ((avail = hp_.available(now)) > 0) {
+            size_t n = hp_.read_array(chunk, avail < sizeof(chunk) ? avail : sizeof(chunk), now);
+            processed = true;
+            parser_.feed(chunk, n, [this](const cn105_protocol::FrameParser& parser) {
+                if (rx_frames_.full()) drain_frames();
+                rx_frames_.push(parser, esphome::millis());
+            });
+            drain_frames();
+        }
+        return processed;
+    }
+
+    void drain_frames() {
+        while (!rx_frames_.empty()) {
+            process_frame(rx_frames_.front());
+            rx_frames_.pop();
+        }
+    }
+
+    void process_frame(const cn105_protocol::FrameView& frame) {
+        if (!frame.checksum_ok) {
+            bad_checksums_++;
+            return;
+        }
+        switch (frame.command) {
+        case 0x61:
+            acks_++;
+            if (write_pending_ack_) {
+                write_pending_ack_ = false;
+                write_latency_ms_ = esphome::millis() - write_queued_ms_;
+            }
+            latency_.ack(esphome::millis());
+            scheduler_.process_ack();
+            break;
+        case 0x62:
+            responses_[frame[0]]++;
+            last_response_ms_[frame[0]] = esphome::millis();
+            scheduler_.process_response(frame);
+            if (frame[0] == 0x02 && latency_.awaiting_confirm(esphome::CommandKind::SETTINGS) &&
+                (confirm_temp_encoded_ < 0 || frame[11] == confirm_temp_encoded_)) {
+                latency_.confirmed(esphome::CommandKind::SETTINGS, esphome::millis());
+            }
+            update_activity(frame);
+            publish_if_changed(frame);
+            break;
+        case 0x7A:
+        case 0x7B:
+            handshake_.connected(esphome::millis());
+            connected_ = true;
+            connect_reply_ = frame.command;
+            cycle_.lastCompleteCycleMs = esphome::millis();
+            if (!freshness_.warmStart(esphome::millis(), config_.warm_reconnect_window_ms)) {
+                snapshot_valid_[0] = false;         // currentSettings.resetSettings()
+            }
+            scheduler_.timer_bypass(0x02);
+            scheduler_.timer_bypass(0x03);
+            scheduler_.timer_bypass(0x06);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /// Diffs a 0x02/0x03/0x06 payload against the last one and counts a publish when it changed.
+    void publish_if_changed(const cn105_protocol::FrameView& frame) {
+        int slot;
+        uint8_t part;
+        switch (frame[0]) {
+        case 0x02: slot = 0; part = stateFreshness::SETTINGS; break;
+        case 0x03: slot = 1; part = stateFreshness::ROOM; break;
+        case 0x06: slot = 2; part = stateFreshness::STATUS; break;
+        default: return;
+        }
+        bool changed = !snapshot_valid_[slot];
+        for (int i = 0; i < 16; i++) {
+            if (snapshot_[slot][i] != frame[i]) changed = true;
+            snapshot_[slot][i] = frame[i];
+        }
+        snapshot_valid_[slot] = true;
+        if (changed) publishes_[frame[0]]++;
+        freshness_.refreshed(part);
+    }
+
+    /// updatePollingActivity() equivalent, from the raw 0x03/0x06 payloads.
+    void update_activity(const cn105_protocol::FrameView& frame) {
+        if (frame[0] == 0x06) {
+            compressor_hz_ = frame[3];
+        } else if (frame[0] == 0x03) {
+            if (room_temp_seen_ && frame[6] != room_temp_) room_temp_changed_ms_ = esphome::millis();
+            room_temp_ = frame[6];
+            room_temp_seen_ = true;
+        } else {
+            return;
+        }
+        const bool moving = room_temp_changed_ms_ != 0 && esphome::millis() - room_temp_changed_ms_ < ADAPTIVE_TEMP_MOVING_MS;
+        scheduler_.set_unit_active(compressor_hz_ > 0 || moving);
+    }
+
+    HeatPumpEmulator& hp_;
+    DriverConfig config_;
+    esphome::RequestScheduler scheduler_;
+    cycleManagement cycle_;
+    cn105_protocol::FrameParser parser_;
+    cn105_protocol::FrameQueue<RX_FRAME_QUEUE_SIZE> rx_frames_;
+    bool connected_ = false;
+    bool uart_ready_ = true;
+    uint8_t connect_reply_ = 0;
+    uint32_t nb_cycles_ = 0;
+    uint32_t nb_complete_cycles_ = 0;
+    uint32_t nb_timed_out_cycles_ = 0;
+    uint32_t responses_[256] = {};
+    uint32_t last_response_ms_[256] = {};
+    uint8_t compressor_hz_ = 0;
+    uint8_t room_temp_ = 0;
+    bool room_temp_seen_ = false;
+    uint32_t room_temp_changed_ms_ = 0;
+    uint32_t acks_ = 0;
+    cn105_protocol::SetRequest wanted_;
+    float remote_temperature_ = 0;
+    std::vector<uint8_t> set_packets_;
+    uint32_t unacked_overlaps_ = 0;
+    bool write_pending_ack_ = false;
+    uint32_t write_queued_ms_ = 0;
+    uint32_t write_latency_ms_ = 0;
+    esphome::CommandTracker latency_;
+    esphome::HandshakeEngine handshake_;
+    uint32_t connect_timeouts_ = 0;
+    int16_t confirm_temp_encoded_ = -1;
+    uint32_t bad_checksums_ = 0;
+    stateFreshness freshness_;
+    uint8_t snapshot_[3][16] = {};
+    bool snapshot_valid_[3] = {};
+    uint32_t publishes_[256] = {};
+    std::vector<uint32_t> cycle_durations_ms_;
+};
+
+} // namespace cn105_emulator
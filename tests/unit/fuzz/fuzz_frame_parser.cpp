@@ -0,0 +1,83 @@
+/// fuzz_frame_parser.cpp — Fuzz target: arbitrary UART bytes into FrameParser.
+/// Deps: frame_parser.h, cn105_protocol.h (libFuzzer entry point; fuzz_main.cpp when built without it)
+///
+/// Input: byte 0 picks the chunk size of the bulk path (1..64), the rest is the UART stream.
+/// Checked on every completed frame: header bytes, frame_size() == data_length() + 6 within the
+/// buffer, checksum_valid() agreeing with checksum(). The stream is fed byte by byte, whole and in
+/// chunks: both overloads share the resync logic and the bulk path keeps a partial frame across
+/// calls, so all three must hand out the same frames and counters.
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "frame_parser.h"
+
+using namespace cn105_protocol;
+
+#define FUZZ_CHECK(cond) do { if (!(cond)) abort(); } while (0)
+
+namespace {
+
+struct FrameLog {
+    static constexpr size_t LEN = 4096;
+    uint8_t bytes[LEN];
+    size_t size = 0;
+    size_t frames = 0;
+
+    void add(const FrameParser& p) {
+        const int n = p.frame_size();
+        FUZZ_CHECK(n == p.data_length() + 6);
+        FUZZ_CHECK(n >= 6 && n <= MAX_DATA_BYTES);
+        const uint8_t* raw = p.raw();
+        FUZZ_CHECK(raw[0] == 0xFC && raw[1] == p.command() && raw[2] == 0x01 && raw[3] == 0x30);
+        FUZZ_CHECK(raw[4] == p.data_length());
+        FUZZ_CHECK(p.data() == raw + 5);
+        FUZZ_CHECK(p.checksum_valid() == (checksum(raw, static_cast<size_t>(n - 1)) == raw[n - 1]));
+        frames++;
+        if (size + static_cast<size_t>(n) > LEN) return;
+        memcpy(bytes + size, raw, static_cast<size_t>(n));
+        size += static_cast<size_t>(n);
+    }
+};
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 1) return 0;
+    const size_t chunk = (data[0] & 0x3F) + 1;
+    const uint8_t* stream = data + 1;
+    const size_t len = size - 1;
+
+    // Byte-wise path: the caller calls next() after each completed frame
+    FrameParser bytewise;
+    FrameLog bytewise_log;
+    for (size_t i = 0; i < len; i++) {
+        bytewise.feed(stream[i]);
+        while (bytewise.frame_complete()) {
+            bytewise_log.add(bytewise);
+            bytewise.next();
+        }
+    }
+
+    // Bulk path: whole stream vs chunked reads
+    FrameParser whole;
+    FrameLog whole_log;
+    whole.feed(stream, len, [&whole_log](const FrameParser& p) { whole_log.add(p); });
+
+    FrameParser chunked;
+    FrameLog chunked_log;
+    for (size_t i = 0; i < len; i += chunk) {
+        const size_t n = len - i < chunk ? len - i : chunk;
+        chunked.feed(stream + i, n, [&chunked_log](const FrameParser& p) { chunked_log.add(p); });
+    }
+
+    FUZZ_CHECK(whole_log.frames == chunked_log.frames);
+    FUZZ_CHECK(whole_log.size == chunked_log.size && memcmp(whole_log.bytes, chunked_log.bytes, whole_log.size) == 0);
+    FUZZ_CHECK(whole.resync_count() == chunked.resync_count());
+    FUZZ_CHECK(whole.drop_count() == chunked.drop_count());
+    FUZZ_CHECK(bytewise_log.frames == whole_log.frames);
+    FUZZ_CHECK(bytewise_log.size == whole_log.size && memcmp(bytewise_log.bytes, whole_log.bytes, whole_log.size) == 0);
+    FUZZ_CHECK(bytewise.resync_count() == whole.resync_count());
+    FUZZ_CHECK(bytewise.drop_count() == whole.drop_count());
+    return 0;
+}
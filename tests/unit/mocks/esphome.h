@@ -0,0 +1,35 @@
+/// esphome.h — Stub hôte de <esphome.h> pour compiler RequestScheduler et cycleManagement hors ESPHome.
+/// Deps: esphome_stubs.h (macros de log no-op)
+///
+/// millis()/delay() lisent une horloge virtuelle en microsecondes pilotée par les tests
+/// (voir emulator/host_loop.h) : aucune attente réelle, les durées mesurées sont déterministes.
+#pragma once
+
+#include <cstdint>
+#include "esphome_stubs.h"
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+#ifndef ESPHOME_LOG_LEVEL
+#define ESPHOME_LOG_LEVEL ESPHOME_LOG_LEVEL_DEBUG
+#endif
+
+namespace esphome {
+
+/// Horloge virtuelle partagée (µs). Seuls les tests la font avancer.
+inline uint64_t& host_clock_us() {
+    static uint64_t now_us = 0;
+    return now_us;
+}
+
+inline uint32_t micros() { return static_cast<uint32_t>(host_clock_us()); }
+inline uint32_t millis() { return static_cast<uint32_t>(host_clock_us() / 1000); }
+inline void delay(uint32_t ms) { host_clock_us() += static_cast<uint64_t>(ms) * 1000; }
+
+} // namespace esphome
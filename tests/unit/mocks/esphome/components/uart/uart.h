@@ -0,0 +1,2 @@
+/// uart.h — Stub vide de esphome/components/uart/uart.h (inclus par Globals.h).
+#pragma once
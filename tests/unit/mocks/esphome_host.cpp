@@ -0,0 +1,10 @@
+/// esphome_host.cpp — Définitions hôte des helpers de log déclarés dans Globals.h.
+/// Deps: Globals.h (via le stub mocks/esphome.h)
+#include "Globals.h"
+
+void esphome::log_info_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix) {
+    ESP_LOGI(tag, "%s %lu %s", msg, (unsigned long)value, suffix);
+}
+void esphome::log_debug_uint32(const char* tag, const char* msg, uint32_t value, const char* suffix) {
+    ESP_LOGD(tag, "%s %lu %s", msg, (unsigned long)value, suffix);
+}
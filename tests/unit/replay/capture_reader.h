@@ -0,0 +1,276 @@
+/// capture_reader.h — Extracts CN105 frames from captured bus traffic (packet debug logs or FrameCapture dumps).
+/// Role: Front end of the replay harness: turns text lines / binary blobs into timestamped raw frames.
+/// Deps: frame_capture.h (blob layout), <cstdint>, <cstring>, <vector> (no ESPHome dependency)
+///
+/// Accepted inputs:
+///   - hpPacketDebug() lines as printed by the ESPHome logger, with or without the wall-clock
+///     timestamp and ANSI colours:  "[14:04:58.120][D][READ:057]: |FC 62 01 30 10 |->[02 ...](8C) <RESPONSE:Settings>"
+///     or bare "READ |FC 62 01 30 10 |->[...](8C)" lines. Only the READ / WRITE tags are taken: the
+///     CN105_CONN / ACK / WRITE_SETTINGS / RX 0x2x lines repeat frames already logged under those two.
+///   - Bare hex lines starting with "FC " (one frame per line).
+///   - FrameCapture dumps: the base64 lines between "CN105_CAPTURE ... BEGIN" and "END" in a log, or
+///     the decoded blob itself as a binary file (parse_capture_blob()).
+/// Every other line is skipped. Direction comes from the command byte (0x6x / 0x7x = unit → host),
+/// so mislabelled prefixes cannot swap RX and TX.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "frame_capture.h"
+
+namespace cn105_replay {
+
+enum class Direction : uint8_t { RX, TX };
+
+struct CaptureFrame {
+    static constexpr size_t MAX_BYTES = 64;         // FrameParser buffer (MAX_DATA_BYTES)
+    static constexpr uint64_t UNKNOWN_MS = UINT64_MAX;
+
+    uint64_t ms = UNKNOWN_MS;       // log wall clock (ms since the first midnight) or device millis() for dumps
+    uint64_t line = 0;              // 1-based source line (0 for binary captures)
+    Direction direction = Direction::RX;
+    uint8_t length = 0;
+    uint8_t bytes[MAX_BYTES] = {};
+};
+
+/// Unit → host commands have bit 5 set (0x61 ACK, 0x62 reply, 0x7A / 0x7B connect reply).
+inline Direction direction_of(const uint8_t* bytes, size_t length) {
+    return (length > 1 && (bytes[1] & 0x20)) ? Direction::RX : Direction::TX;
+}
+
+inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+inline int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+inline uint32_t read_u32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+/// Walks a FrameCapture blob ('C' 'N' 'C' v1), calling on_frame(const CaptureFrame&) per record.
+/// @return false when the header is not recognised or a record runs past the end.
+template <typename OnFrame>
+bool parse_capture_blob(const uint8_t* blob, size_t size, OnFrame&& on_frame) {
+    if (size < 14 || blob[0] != 'C' || blob[1] != 'N' || blob[2] != 'C' ||
+        blob[3] != esphome::FrameCapture::FORMAT_VERSION) {
+        return false;
+    }
+    const uint16_t count = static_cast<uint16_t>(blob[4] | (blob[5] << 8));
+    size_t pos = 14;
+    CaptureFrame frame;
+    for (uint16_t i = 0; i < count; i++) {
+        if (pos + 6 > size) return false;
+        const uint8_t length = blob[pos + 5];
+        if (pos + 6 + length > size || length > CaptureFrame::MAX_BYTES) return false;
+        frame.ms = read_u32(blob + pos);
+        frame.direction = (blob[pos + 4] & esphome::CapturedFrame::FLAG_TX) ? Direction::TX : Direction::RX;
+        frame.length = length;
+        memcpy(frame.bytes, blob + pos + 6, length);
+        on_frame(static_cast<const CaptureFrame&>(frame));
+        pos += 6 + length;
+    }
+    return true;
+}
+
+/// Line-oriented reader; keeps the clock (midnight roll-over) and the dump block state between lines.
+class CaptureReader {
+public:
+    /// Parses one line (trailing "\r\n" allowed) and hands every frame it carries to on_frame.
+    template <typename OnFrame>
+    void line(const char* text, size_t len, OnFrame&& on_frame) {
+        lines_++;
+        const char* p = text;
+        const char* end = text + len;
+        while (end > p && (end[-1] == '\n' || end[-1] == '\r')) end--;
+
+        // Leading "[time][level][tag:line]:" groups, colour escapes in between
+        uint64_t ms = CaptureFrame::UNKNOWN_MS;
+        const char* tag = nullptr;
+        size_t tag_len = 0;
+        for (;;) {
+            p = skip_escapes(p, end);
+            if (p == end || *p != '[') break;
+            const char* close = static_cast<const char*>(memchr(p, ']', static_cast<size_t>(end - p)));
+            if (close == nullptr) break;
+            const char* group = p + 1;
+            const size_t group_len = static_cast<size_t>(close - group);
+            uint64_t stamp;
+            if (parse_clock(group, group_len, stamp)) {
+                ms = stamp;
+            } else if (group_len > 2 && tag == nullptr) {
+                tag = group;
+                const char* colon = static_cast<const char*>(memchr(group, ':', group_len));
+                tag_len = colon ? static_cast<size_t>(colon - group) : group_len;
+            }
+            p = close + 1;
+        }
+        while (p < end && (*p == ':' || *p == ' ')) p++;
+        p = skip_escapes(p, end);
+        if (ms != CaptureFrame::UNKNOWN_MS) ms = unwrap_clock(ms);
+
+        if (tag != nullptr && tag_is(tag, tag_len, "CN105_CAPTURE")) {
+            capture_line(p, end, on_frame);
+            return;
+        }
+
+        const char* bar = static_cast<const char*>(memchr(p, '|', static_cast<size_t>(end - p)));
+        const char* hex = nullptr;
+        if (bar != nullptr) {
+            if (tag == nullptr) {
+                // "READ |FC 62 ..." — prefix word as the tag
+                tag = p;
+                tag_len = static_cast<size_t>(bar - p);
+                while (tag_len > 0 && tag[tag_len - 1] == ' ') tag_len--;
+            }
+            if (tag_len > 0 && !tag_is(tag, tag_len, "READ") && !tag_is(tag, tag_len, "WRITE")) {
+                skipped_++;
+                return;
+            }
+            hex = bar + 1;
+        } else if (end - p >= 3 && (p[0] == 'F' || p[0] == 'f') && (p[1] == 'C' || p[1] == 'c') && p[2] == ' ') {
+            hex = p;
+        } else {
+            skipped_++;
+            return;
+        }
+
+        CaptureFrame frame;
+        frame.ms = ms;
+        frame.line = lines_;
+        if (!parse_hex(hex, end, frame) || frame.length < 6) {
+            malformed_++;
+            return;
+        }
+        frame.direction = direction_of(frame.bytes, frame.length);
+        packet_lines_++;
+        on_frame(static_cast<const CaptureFrame&>(frame));
+    }
+
+    uint64_t lines() const { return lines_; }
+    uint64_t packet_lines() const { return packet_lines_; }
+    uint64_t dump_frames() const { return dump_frames_; }
+    uint64_t skipped() const { return skipped_; }
+    uint64_t malformed() const { return malformed_; }     // packet lines / dumps that could not be decoded
+
+private:
+    static const char* skip_escapes(const char* p, const char* end) {
+        while (p < end && *p == '\033') {
+            while (p < end && *p != 'm') p++;
+            if (p < end) p++;
+        }
+        return p;
+    }
+
+    static bool tag_is(const char* tag, size_t len, const char* name) {
+        return strlen(name) == len && memcmp(tag, name, len) == 0;
+    }
+
+    static bool two_digits(const char* p, unsigned& value) {
+        if (p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9') return false;
+        value = unsigned(p[0] - '0') * 10 + unsigned(p[1] - '0');
+        return true;
+    }
+
+    /// "HH:MM:SS" or "HH:MM:SS.mmm" → ms since midnight.
+    static bool parse_clock(const char* p, size_t len, uint64_t& ms) {
+        if (len != 8 && len != 12) return false;
+        unsigned h, m, s;
+        if (p[2] != ':' || p[5] != ':' || !two_digits(p, h) || !two_digits(p + 3, m) || !two_digits(p + 6, s)) return false;
+        unsigned frac = 0;
+        if (len == 12) {
+            if (p[8] != '.') return false;
+            for (size_t i = 9; i < 12; i++) {
+                if (p[i] < '0' || p[i] > '9') return false;
+                frac = frac * 10 + unsigned(p[i] - '0');
+            }
+        }
+        ms = ((uint64_t(h) * 60 + m) * 60 + s) * 1000 + frac;
+        return true;
+    }
+
+    /// Keeps log time monotonic across midnight: a jump back of more than 12 h starts a new day.
+    uint64_t unwrap_clock(uint64_t ms_of_day) {
+        static constexpr uint64_t DAY_MS = 24ull * 3600 * 1000;
+        if (last_ms_of_day_ != CaptureFrame::UNKNOWN_MS && ms_of_day + DAY_MS / 2 < last_ms_of_day_) day_offset_ += DAY_MS;
+        last_ms_of_day_ = ms_of_day;
+        return day_offset_ + ms_of_day;
+    }
+
+    /// "FC 62 01 30 10 |->[02 00 ... ](8C) <...>": two-digit hex tokens up to the '<' label.
+    static bool parse_hex(const char* p, const char* end, CaptureFrame& frame) {
+        while (p < end && *p != '<') {
+            const int hi = hex_value(*p);
+            if (hi < 0) {
+                p++;
+                continue;
+            }
+            const int lo = (p + 1 < end) ? hex_value(p[1]) : -1;
+            if (lo < 0 || (p + 2 < end && hex_value(p[2]) >= 0)) return false;
+            if (frame.length == CaptureFrame::MAX_BYTES) return false;
+            frame.bytes[frame.length++] = static_cast<uint8_t>((hi << 4) | lo);
+            p += 2;
+        }
+        return true;
+    }
+
+    template <typename OnFrame>
+    void capture_line(const char* p, const char* end, OnFrame&& on_frame) {
+        const size_t len = static_cast<size_t>(end - p);
+        if (len >= 5 && memcmp(p, "BEGIN", 5) == 0) {
+            in_dump_ = true;
+            blob_.clear();
+            acc_bits_ = 0;
+            return;
+        }
+        if (!in_dump_) return;
+        if (len >= 3 && memcmp(p, "END", 3) == 0) {
+            in_dump_ = false;
+            const bool ok = parse_capture_blob(blob_.data(), blob_.size(), [&](const CaptureFrame& frame) {
+                dump_frames_++;
+                CaptureFrame numbered = frame;
+                numbered.line = lines_;
+                on_frame(static_cast<const CaptureFrame&>(numbered));
+            });
+            if (!ok) malformed_++;
+            return;
+        }
+        for (; p < end; p++) {
+            const int v = base64_value(*p);
+            if (v < 0) continue;            // '=' padding
+            acc_ = (acc_ << 6) | uint32_t(v);
+            acc_bits_ += 6;
+            if (acc_bits_ >= 8) {
+                acc_bits_ -= 8;
+                blob_.push_back(static_cast<uint8_t>(acc_ >> acc_bits_));
+            }
+        }
+    }
+
+    uint64_t lines_ = 0;
+    uint64_t packet_lines_ = 0;
+    uint64_t dump_frames_ = 0;
+    uint64_t skipped_ = 0;
+    uint64_t malformed_ = 0;
+    uint64_t last_ms_of_day_ = CaptureFrame::UNKNOWN_MS;
+    uint64_t day_offset_ = 0;
+
+    bool in_dump_ = false;
+    std::vector<uint8_t> blob_;
+    uint32_t acc_ = 0;
+    int acc_bits_ = 0;
+};
+
+}  // namespace cn105_replay
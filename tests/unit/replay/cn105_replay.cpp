@@ -0,0 +1,189 @@
+/// cn105_replay.cpp — Command-line replay of captured CN105 traffic into a JSON-lines state trace.
+/// Deps: replay.h, capture_reader.h
+///
+/// Usage: cn105_replay [--all] [--btu] [--stats] [--expect TRACE.jsonl] CAPTURE...
+///   CAPTURE   packet debug log / FrameCapture dump log, or a binary FrameCapture blob; "-" reads stdin.
+///             Each capture is replayed from a blank state.
+///   --all     also trace frames that changed nothing (see ReplayOptions::all_frames)
+///   --btu     decode input power / energy as BTU (power_unit_is_btu: true)
+///   --stats   per-capture counters and throughput on stderr
+///   --expect  compare the trace with a golden file instead of printing it (exit 1 on the first difference)
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "replay.h"
+
+using namespace cn105_replay;
+
+namespace {
+
+struct Output {
+    FILE* file = nullptr;       // nullptr: collected in `text` (--expect)
+    std::string text;
+
+    void operator()(const char* line, size_t len) {
+        if (file != nullptr) {
+            fwrite(line, 1, len, file);
+        } else {
+            text.append(line, len);
+        }
+    }
+};
+
+struct Stats {
+    uint64_t lines = 0;
+    uint64_t frames = 0;
+    uint64_t dump_frames = 0;
+    uint64_t malformed = 0;
+    uint64_t rejected = 0;
+    uint64_t trace_lines = 0;
+};
+
+/// Splits the file into lines with memchr over 1 MiB reads (no per-line allocation).
+template <typename OnLine>
+void for_each_line(FILE* in, const uint8_t* first, size_t first_len, OnLine&& on_line) {
+    static constexpr size_t CHUNK = 1 << 20;
+    std::vector<char> buffer(CHUNK * 2);
+    size_t filled = first_len;
+    memcpy(buffer.data(), first, first_len);
+    for (;;) {
+        const size_t n = fread(buffer.data() + filled, 1, buffer.size() - filled, in);
+        filled += n;
+        const bool eof = n == 0;
+        size_t start = 0;
+        for (;;) {
+            const char* nl = static_cast<const char*>(memchr(buffer.data() + start, '\n', filled - start));
+            if (nl == nullptr) break;
+            const size_t end = static_cast<size_t>(nl - buffer.data());
+            on_line(buffer.data() + start, end - start);
+            start = end + 1;
+        }
+        if (eof) {
+            if (start < filled) on_line(buffer.data() + start, filled - start);
+            return;
+        }
+        if (start == 0 && filled == buffer.size()) {
+            on_line(buffer.data(), filled);     // line longer than the buffer: not a packet line
+            filled = 0;
+            continue;
+        }
+        memmove(buffer.data(), buffer.data() + start, filled - start);
+        filled -= start;
+    }
+}
+
+bool replay_file(const char* path, const ReplayOptions& options, Output& out, Stats& stats) {
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "cn105_replay: cannot open %s\n", path);
+        return false;
+    }
+    Replayer<Output> replayer(out, options);
+    auto on_frame = [&replayer](const CaptureFrame& frame) { replayer.frame(frame); };
+
+    uint8_t head[4] = {};
+    const size_t head_len = fread(head, 1, sizeof(head), in);
+    bool ok = true;
+    if (head_len == 4 && head[0] == 'C' && head[1] == 'N' && head[2] == 'C') {
+        std::vector<uint8_t> blob(head, head + head_len);
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) blob.insert(blob.end(), chunk, chunk + n);
+        ok = parse_capture_blob(blob.data(), blob.size(), on_frame);
+        if (!ok) fprintf(stderr, "cn105_replay: %s: truncated or unsupported capture blob\n", path);
+        stats.dump_frames += replayer.frames();
+    } else {
+        CaptureReader reader;
+        for_each_line(in, head, head_len, [&](const char* line, size_t len) { reader.line(line, len, on_frame); });
+        stats.lines += reader.lines();
+        stats.dump_frames += reader.dump_frames();
+        stats.malformed += reader.malformed();
+    }
+    stats.frames += replayer.frames();
+    stats.rejected += replayer.rejected();
+    stats.trace_lines += replayer.trace_lines();
+    if (in != stdin) fclose(in);
+    return ok;
+}
+
+/// Line-by-line comparison with the golden trace; reports the first difference.
+bool matches_golden(const std::string& trace, const char* golden_path) {
+    FILE* golden = fopen(golden_path, "rb");
+    if (golden == nullptr) {
+        fprintf(stderr, "cn105_replay: cannot open %s\n", golden_path);
+        return false;
+    }
+    std::string expected;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), golden)) > 0) expected.append(chunk, n);
+    fclose(golden);
+
+    size_t pos = 0, line = 1;
+    while (pos < trace.size() || pos < expected.size()) {
+        const size_t got_end = trace.find('\n', pos);
+        const size_t want_end = expected.find('\n', pos);
+        const std::string got = pos < trace.size() ? trace.substr(pos, got_end - pos) : "<end of trace>";
+        const std::string want = pos < expected.size() ? expected.substr(pos, want_end - pos) : "<end of file>";
+        if (got != want) {
+            fprintf(stderr, "cn105_replay: trace differs from %s at line %zu\n  expected: %s\n  actual:   %s\n",
+                golden_path, line, want.c_str(), got.c_str());
+            return false;
+        }
+        if (got_end == std::string::npos) break;
+        pos = got_end + 1;
+        line++;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    bool stats_wanted = false;
+    const char* golden = nullptr;
+    std::vector<const char*> captures;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--all") == 0) {
+            options.all_frames = true;
+        } else if (strcmp(argv[i], "--btu") == 0) {
+            options.power_unit_is_btu = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats_wanted = true;
+        } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            golden = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "usage: cn105_replay [--all] [--btu] [--stats] [--expect TRACE.jsonl] CAPTURE...\n");
+            return 2;
+        } else {
+            captures.push_back(argv[i]);
+        }
+    }
+    if (captures.empty()) captures.push_back("-");
+
+    static char stdout_buffer[1 << 16];
+    setvbuf(stdout, stdout_buffer, _IOFBF, sizeof(stdout_buffer));
+    Output out;
+    out.file = golden == nullptr ? stdout : nullptr;
+
+    bool ok = true;
+    for (const char* path : captures) {
+        Stats stats;
+        const auto start = std::chrono::steady_clock::now();
+        ok &= replay_file(path, options, out, stats);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (stats_wanted) {
+            fprintf(stderr, "%s: %llu lines, %llu frames (%llu from dumps), %llu malformed lines, %llu rejected frames, "
+                "%llu trace lines, %.3f s (%.1f Mlines/s)\n", path, (unsigned long long)stats.lines,
+                (unsigned long long)stats.frames, (unsigned long long)stats.dump_frames, (unsigned long long)stats.malformed,
+                (unsigned long long)stats.rejected, (unsigned long long)stats.trace_lines, seconds,
+                seconds > 0 ? stats.lines / seconds / 1e6 : 0.0);
+        }
+    }
+    fflush(stdout);
+    if (golden != nullptr) ok &= matches_golden(out.text, golden);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,376 @@
+/// replay.h — Replays captured CN105 frames through FrameParser and the reply decoders into a JSON-lines state trace.
+/// Role: Back end of the replay harness (cn105_replay tool, test_replay.cpp).
+/// Deps: capture_reader.h, frame_parser.h, response_decoders.h, state_snapshot.h, packet_format.h (TextBuffer), cn105_types.h
+///
+/// Each frame goes through a fresh FrameParser of its direction (one capture entry = one frame), so
+/// the header / length / checksum checks are the component's own. Replies go through the component's
+/// response_decoders.h, merged like hp_readings.cpp does it (an unknown byte keeps the previous value) and diffed with
+/// diff_settings() / diff_status(): a trace line is written only when a decoded field moved, e.g.
+///   {"t":50698120,"line":12,"dir":"rx","kind":"settings","changed":["power"],"power":"ON","mode":"HEAT",...}
+/// Host writes (SET, CONNECT) and connect replies are always traced; checksum failures too.
+/// "t" is omitted when the capture had no timestamp. No allocation per frame: lines are built in a
+/// stack buffer and handed to `sink(const char* line, size_t len)` (newline included).
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include "capture_reader.h"
+#include "cn105_types.h"
+#include "frame_parser.h"
+#include "packet_format.h"
+#include "response_decoders.h"
+#include "state_snapshot.h"
+
+namespace cn105_replay {
+
+struct ReplayOptions {
+    bool power_unit_is_btu = false;     // same meaning as the YAML option (input power / energy units)
+    bool all_frames = false;            // also trace frames that changed nothing ("frame" / "ack" lines)
+};
+
+// ════════════════════════════════════════════════════════════════
+// Reply decoders (response_decoders.h, merged like hp_readings.cpp)
+// ════════════════════════════════════════════════════════════════
+
+template <typename Entry>
+Entry decoded_or(Entry decoded, Entry previous) {
+    return is_set(decoded) ? decoded : previous;
+}
+
+/// 0x02 settings (getSettingsFromResponsePacket). Wide vane is applied whenever data[10] is non-zero.
+inline heatpumpSettings decode_settings(const uint8_t* data, const heatpumpSettings& previous) {
+    const cn105_protocol::SettingsFrame f = cn105_protocol::decode_settings(data);
+    heatpumpSettings s{};
+    s.connected = true;
+    s.power = decoded_or(f.power, previous.power);
+    s.iSee = f.isee;
+    s.mode = decoded_or(f.mode, previous.mode);
+    s.temperature = std::isnan(f.temperature) ? previous.temperature : f.temperature;
+    s.fan = decoded_or(f.fan, previous.fan);
+    s.vane = decoded_or(f.vane, previous.vane);
+    if (f.wide_vane_reported) s.wideVane = decoded_or(f.wide_vane, previous.wideVane);
+    return s;
+}
+
+/// 0x03 room / outside temperature and runtime (getRoomTemperatureFromResponsePacket).
+inline heatpumpStatus decode_room_temperature(const uint8_t* data, const heatpumpStatus& previous) {
+    const cn105_protocol::RoomTemperatureFrame f = cn105_protocol::decode_room_temperature(data);
+    heatpumpStatus s = previous;
+    s.outsideAirTemperature = f.outside_air_temperature;
+    if (!std::isnan(f.room_temperature)) s.roomTemperature = f.room_temperature;
+    s.runtimeHours = f.runtime_hours;
+    return s;
+}
+
+/// 0x06 operating / compressor / power (getOperatingAndCompressorFreqFromResponsePacket).
+inline heatpumpStatus decode_operating(const uint8_t* data, const heatpumpStatus& previous, bool power_unit_is_btu) {
+    const cn105_protocol::StatusFrame f = cn105_protocol::decode_status(data);
+    heatpumpStatus s = previous;
+    s.operating = f.operating;
+    s.compressorFrequency = f.compressor_frequency;
+    s.inputPower = cn105_protocol::input_power_to_W(f.raw_input_power, power_unit_is_btu);
+    s.kWh = cn105_protocol::energy_usage_to_kWh(f.raw_energy, power_unit_is_btu);
+    return s;
+}
+
+/// 0x09 stage / sub modes (getPowerFromResponsePacket): only the three stage fields are filled.
+inline heatpumpSettings decode_stage(const uint8_t* data, const heatpumpSettings& previous) {
+    const cn105_protocol::StageFrame f = cn105_protocol::decode_stage(data);
+    heatpumpSettings s{};
+    s.stage = decoded_or(f.stage, previous.stage);
+    s.sub_mode = decoded_or(f.sub_mode, previous.sub_mode);
+    s.auto_sub_mode = decoded_or(f.auto_sub_mode, previous.auto_sub_mode);
+    return s;
+}
+
+// ════════════════════════════════════════════════════════════════
+// Trace lines
+// ════════════════════════════════════════════════════════════════
+
+static constexpr const char* SETTINGS_FIELD_NAMES[] = {
+    "power", "mode", "temperature", "fan", "vane", "wide_vane", "isee" };
+static constexpr const char* STATUS_FIELD_NAMES[] = {
+    "operating", "room_temperature", "outside_air_temperature", "compressor_frequency", "input_power", "kwh", "runtime_hours" };
+static constexpr const char* STAGE_FIELD_NAMES[] = { "stage", "sub_mode", "auto_sub_mode" };
+
+static_assert(sizeof(SETTINGS_FIELD_NAMES) / sizeof(SETTINGS_FIELD_NAMES[0]) == size_t(esphome::SettingsField::COUNT), "one name per SettingsField");
+static_assert(sizeof(STATUS_FIELD_NAMES) / sizeof(STATUS_FIELD_NAMES[0]) == size_t(esphome::StatusField::COUNT), "one name per StatusField");
+
+/// One JSON object on one line, written into a fixed buffer.
+class JsonLine {
+public:
+    static constexpr size_t LEN = 512;
+
+    JsonLine() : buf_(line_, LEN) { buf_.put('{'); }
+    JsonLine(const JsonLine&) = delete;
+    JsonLine& operator=(const JsonLine&) = delete;
+
+    void key(const char* name) {
+        if (fields_++ > 0) buf_.put(',');
+        buf_.put('"');
+        buf_.put(name);
+        buf_.put("\":");
+    }
+
+    /// Label or null; labels are UTF-8 and only '"' / '\\' need escaping.
+    void string(const char* value) {
+        if (value == nullptr) {
+            buf_.put("null");
+            return;
+        }
+        buf_.put('"');
+        for (; *value; value++) {
+            if (*value == '"' || *value == '\\') buf_.put('\\');
+            buf_.put(*value);
+        }
+        buf_.put('"');
+    }
+
+    void number(float value) {
+        if (std::isnan(value)) {
+            buf_.put("null");
+            return;
+        }
+        char text[24];
+        snprintf(text, sizeof(text), "%g", static_cast<double>(value));
+        buf_.put(text);
+    }
+
+    void integer(uint64_t value) {
+        char digits[20];
+        size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) buf_.put(digits[--n]);
+    }
+
+    void boolean(bool value) { buf_.put(value ? "true" : "false"); }
+
+    void hex(const uint8_t* data, size_t n) {
+        buf_.put('"');
+        for (size_t i = 0; i < n; i++) buf_.hex(data[i]);
+        buf_.put('"');
+    }
+
+    /// ["name",...] of the set bits of `mask`.
+    void names(uint16_t mask, const char* const* names, size_t count) {
+        buf_.put('[');
+        bool first = true;
+        for (size_t i = 0; i < count; i++) {
+            if (!(mask & (1u << i))) continue;
+            if (!first) buf_.put(',');
+            first = false;
+            string(names[i]);
+        }
+        buf_.put(']');
+    }
+
+    /// Closes the object and appends the newline.
+    size_t finish(const char*& text) {
+        buf_.put('}');
+        buf_.put('\n');
+        text = line_;
+        return buf_.size();
+    }
+
+private:
+    char line_[LEN];
+    cn105_protocol::TextBuffer buf_;
+    size_t fields_ = 0;
+};
+
+// ════════════════════════════════════════════════════════════════
+// Replayer
+// ════════════════════════════════════════════════════════════════
+
+template <typename Sink>
+class Replayer {
+public:
+    explicit Replayer(Sink& sink, ReplayOptions options = {}) : sink_(sink), options_(options) {}
+
+    void frame(const CaptureFrame& frame) {
+        frames_++;
+        cn105_protocol::FrameParser& parser = parsers_[frame.direction == Direction::TX ? 1 : 0];
+        parser.reset();
+        const size_t parsed = parser.feed(frame.bytes, frame.length,
+            [&](const cn105_protocol::FrameParser& p) { this->parsed(frame, p); });
+        if (parsed == 0) {
+            rejected_++;
+            JsonLine out;
+            begin(out, frame, "malformed");
+            out.key("raw");
+            out.hex(frame.bytes, frame.length);
+            emit(out);
+        }
+    }
+
+    const heatpumpSettings& settings() const { return settings_; }
+    const heatpumpStatus& status() const { return status_; }
+    uint64_t frames() const { return frames_; }
+    uint64_t rejected() const { return rejected_; }         // malformed or bad checksum
+    uint64_t trace_lines() const { return trace_lines_; }
+
+private:
+    void parsed(const CaptureFrame& frame, const cn105_protocol::FrameParser& p) {
+        if (!p.checksum_valid()) {
+            rejected_++;
+            JsonLine out;
+            begin(out, frame, "bad_checksum");
+            out.key("raw");
+            out.hex(p.raw(), p.frame_size());
+            emit(out);
+            return;
+        }
+        const uint8_t* data = p.data();
+        const bool has_payload = p.data_length() >= RESPONSE_DATA_LEN;     // processCommand() guard
+        switch (p.command()) {
+        case 0x62:
+            if (has_payload && data[0] == 0x02) return settings_reply(frame, data);
+            if (has_payload && data[0] == 0x03) return status_reply(frame, decode_room_temperature(data, status_));
+            if (has_payload && data[0] == 0x06) return status_reply(frame, decode_operating(data, status_, options_.power_unit_is_btu));
+            if (has_payload && data[0] == 0x09) return stage_reply(frame, data);
+            break;
+        case 0x41:
+        case 0x5A:
+        case 0x5B:
+        case 0x7A:
+        case 0x7B: {
+            JsonLine out;
+            begin(out, frame, p.command() == 0x41 ? "set" : (p.command() & 0x20) ? "connected" : "connect");
+            out.key("data");
+            out.hex(data, static_cast<size_t>(p.data_length()));
+            return emit(out);
+        }
+        case 0x61:
+            if (options_.all_frames) {
+                JsonLine out;
+                begin(out, frame, "ack");
+                emit(out);
+            }
+            return;
+        default:
+            break;
+        }
+        if (options_.all_frames) {
+            JsonLine out;
+            begin(out, frame, "frame");
+            out.key("raw");
+            out.hex(p.raw(), p.frame_size());
+            emit(out);
+        }
+    }
+
+    void settings_reply(const CaptureFrame& frame, const uint8_t* data) {
+        heatpumpSettings received = decode_settings(data, settings_);
+        const esphome::FieldMask changed = esphome::diff_settings(settings_, received);
+        if (changed == 0 && !options_.all_frames) return;
+        received.stage = settings_.stage;
+        received.sub_mode = settings_.sub_mode;
+        received.auto_sub_mode = settings_.auto_sub_mode;
+        if (!is_set(received.wideVane)) received.wideVane = settings_.wideVane;
+        settings_ = received;
+
+        JsonLine out;
+        begin(out, frame, "settings");
+        out.key("changed");
+        out.names(changed, SETTINGS_FIELD_NAMES, size_t(esphome::SettingsField::COUNT));
+        out.key("power");
+        out.string(to_label(settings_.power));
+        out.key("mode");
+        out.string(to_label(settings_.mode));
+        out.key("temperature");
+        out.number(settings_.temperature);
+        out.key("fan");
+        out.string(to_label(settings_.fan));
+        out.key("vane");
+        out.string(to_label(settings_.vane));
+        out.key("wide_vane");
+        out.string(to_label(settings_.wideVane));
+        out.key("isee");
+        out.boolean(settings_.iSee);
+        emit(out);
+    }
+
+    void status_reply(const CaptureFrame& frame, const heatpumpStatus& received) {
+        const esphome::FieldMask changed = esphome::diff_status(status_, received);
+        if (changed == 0 && !options_.all_frames) return;
+        status_ = received;
+
+        JsonLine out;
+        begin(out, frame, "status");
+        out.key("changed");
+        out.names(changed, STATUS_FIELD_NAMES, size_t(esphome::StatusField::COUNT));
+        out.key("operating");
+        out.boolean(status_.operating);
+        out.key("room_temperature");
+        out.number(status_.roomTemperature);
+        out.key("outside_air_temperature");
+        out.number(status_.outsideAirTemperature);
+        out.key("compressor_frequency");
+        out.number(status_.compressorFrequency);
+        out.key("input_power");
+        out.number(status_.inputPower);
+        out.key("kwh");
+        out.number(status_.kWh);
+        out.key("runtime_hours");
+        out.number(status_.runtimeHours);
+        emit(out);
+    }
+
+    void stage_reply(const CaptureFrame& frame, const uint8_t* data) {
+        const heatpumpSettings received = decode_stage(data, settings_);
+        const uint16_t changed = uint16_t((received.stage != settings_.stage ? 1u : 0u) |
+            (received.sub_mode != settings_.sub_mode ? 2u : 0u) |
+            (received.auto_sub_mode != settings_.auto_sub_mode ? 4u : 0u));
+        if (changed == 0 && !options_.all_frames) return;
+        settings_.stage = received.stage;
+        settings_.sub_mode = received.sub_mode;
+        settings_.auto_sub_mode = received.auto_sub_mode;
+
+        JsonLine out;
+        begin(out, frame, "stage");
+        out.key("changed");
+        out.names(changed, STAGE_FIELD_NAMES, 3);
+        out.key("stage");
+        out.string(to_label(settings_.stage));
+        out.key("sub_mode");
+        out.string(to_label(settings_.sub_mode));
+        out.key("auto_sub_mode");
+        out.string(to_label(settings_.auto_sub_mode));
+        emit(out);
+    }
+
+    static void begin(JsonLine& out, const CaptureFrame& frame, const char* kind) {
+        if (frame.ms != CaptureFrame::UNKNOWN_MS) {
+            out.key("t");
+            out.integer(frame.ms);
+        }
+        out.key("line");
+        out.integer(frame.line);
+        out.key("dir");
+        out.string(frame.direction == Direction::TX ? "tx" : "rx");
+        out.key("kind");
+        out.string(kind);
+    }
+
+    void emit(JsonLine& out) {
+        const char* text;
+        const size_t len = out.finish(text);
+        trace_lines_++;
+        sink_(text, len);
+    }
+
+    Sink& sink_;
+    ReplayOptions options_;
+    cn105_protocol::FrameParser parsers_[2];        // RX, TX
+    heatpumpSettings settings_{};
+    heatpumpStatus status_{};
+    uint64_t frames_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t trace_lines_ = 0;
+};
+
+}  // namespace cn105_replay
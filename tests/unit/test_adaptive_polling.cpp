@@ -0,0 +1,62 @@
+/// test_adaptive_polling.cpp — Tests for the adaptive polling policy helpers.
+/// Deps: adaptive_polling.h, cn105_types.h
+#include <gtest/gtest.h>
+#include "adaptive_polling.h"
+
+using namespace esphome;
+using namespace esphome::adaptive_polling;
+
+TEST(AdaptivePolling, PayloadHashDetectsSingleByteChange) {
+    uint8_t a[16] = { 0x02, 0, 0, 0x01, 0x01 };
+    uint8_t b[16] = { 0x02, 0, 0, 0x01, 0x01 };
+    EXPECT_EQ(payload_hash(a, 16), payload_hash(b, 16));
+    b[15] = 0x01;
+    EXPECT_NE(payload_hash(a, 16), payload_hash(b, 16));
+}
+
+TEST(AdaptivePolling, StretchFactorDoublesAfterStableCyclesAndCaps) {
+    AdaptivePollingConfig cfg;
+    cfg.stable_cycles = 3;
+    cfg.max_stretch = 8;
+    EXPECT_EQ(stretch_factor(0, cfg), 1u);
+    EXPECT_EQ(stretch_factor(2, cfg), 1u);
+    EXPECT_EQ(stretch_factor(3, cfg), 2u);
+    EXPECT_EQ(stretch_factor(4, cfg), 4u);
+    EXPECT_EQ(stretch_factor(5, cfg), 8u);
+    EXPECT_EQ(stretch_factor(6, cfg), 8u);
+    EXPECT_EQ(stretch_factor(255, cfg), 8u);
+    cfg.max_stretch = 1;
+    EXPECT_EQ(stretch_factor(10, cfg), 1u);
+}
+
+TEST(AdaptivePolling, FastIntervalHonoursConfiguredPeriodWhenBudgetAllows) {
+    AdaptivePollingConfig cfg;
+    cfg.fast_interval_ms = 2000;
+    cfg.bus_budget_pct = 50;
+    // 2 fast requests need 444 ms of wire per period: 2 s is well within 50 %
+    EXPECT_EQ(budgeted_fast_interval(5000, 2, 100, cfg), 2000u);
+}
+
+TEST(AdaptivePolling, FastIntervalIsLengthenedToFitBudget) {
+    AdaptivePollingConfig cfg;
+    cfg.fast_interval_ms = 100;
+    cfg.bus_budget_pct = 50;
+    const uint32_t slow = 200;     // 20 % already used by the other requests
+    const uint32_t period = budgeted_fast_interval(10000, 2, slow, cfg);
+    // 2 × 222 ms in (500 - 200) ‰ → 1480 ms
+    EXPECT_EQ(period, 2u * INFO_EXCHANGE_WIRE_MS * 1000 / 300);
+    EXPECT_LE(slow + 2 * load_permille(period), 500u + 1);
+}
+
+TEST(AdaptivePolling, NoHeadroomFallsBackToBaseInterval) {
+    AdaptivePollingConfig cfg;
+    cfg.bus_budget_pct = 20;
+    EXPECT_EQ(budgeted_fast_interval(2000, 2, 250, cfg), 2000u);
+    EXPECT_EQ(budgeted_fast_interval(2000, 0, 0, cfg), 2000u);
+}
+
+TEST(AdaptivePolling, FastIntervalNeverExceedsBase) {
+    AdaptivePollingConfig cfg;
+    cfg.fast_interval_ms = 5000;
+    EXPECT_EQ(budgeted_fast_interval(2000, 2, 0, cfg), 2000u);
+}
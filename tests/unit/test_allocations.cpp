@@ -0,0 +1,147 @@
+/// test_allocations.cpp — Heap accounting of the host driver loop: a steady-state poll cycle must not allocate.
+/// Deps: alloc/alloc_tracker.cpp (global operator new/delete), emulator/host_loop.h, emulator/heatpump_emulator.h,
+///       response_decoders.h, request_scheduler.cpp, cycle_management.cpp
+///
+/// Each test connects, lets a few cycles run (the first ones may size buffers), then counts every
+/// heap allocation over N more cycles. The per-call-site report is printed to stdout so a
+/// regression names the function that allocates.
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+#include "alloc/alloc_tracker.h"
+#include "emulator/heatpump_emulator.h"
+#include "emulator/host_loop.h"
+#include "response_decoders.h"
+
+using namespace cn105_emulator;
+
+// Outside the anonymous namespace and not inlined: exported, so dladdr() names it
+namespace cn105_alloc_probe {
+__attribute__((noinline)) std::vector<int>* make_vector(size_t n) {
+    auto* v = new std::vector<int>();
+    v->resize(n);
+    return v;
+}
+}  // namespace cn105_alloc_probe
+
+namespace {
+
+static constexpr uint32_t WARMUP_CYCLES = 3;
+static constexpr uint32_t MEASURED_CYCLES = 20;
+
+class AllocationTest : public ::testing::Test {
+protected:
+    void SetUp() override { esphome::host_clock_us() = 0; }
+
+    /// Connects, warms up, then counts allocations over MEASURED_CYCLES cycles.
+    static void expect_steady_state_allocates_nothing(const DriverConfig& cfg, const char* label) {
+        HeatPumpEmulator hp;
+        HostDriver drv(hp, cfg);
+        drv.start_handshake();
+        ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 5000));
+        ASSERT_TRUE(drv.run_cycles(WARMUP_CYCLES, 60000));
+        const uint32_t completed = drv.nb_complete_cycles();
+
+        cn105_alloc::Window window;
+        const bool ran = drv.run_cycles(MEASURED_CYCLES, 200000);
+        window.stop();
+
+        const std::string report = window.report(label);
+        std::fputs(report.c_str(), stdout);
+        ASSERT_TRUE(ran);
+        EXPECT_EQ(drv.nb_complete_cycles() - completed, MEASURED_CYCLES);
+        EXPECT_EQ(window.allocations(), 0u) << report;
+        EXPECT_EQ(window.frees(), 0u) << report;
+    }
+};
+
+// ════════════════════════════════════════════════════════════════
+// Tracker
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(AllocationTest, CountsAndAttributesCallSites) {
+    cn105_alloc::Window window;
+    std::vector<int>* v = cn105_alloc_probe::make_vector(100);
+    delete v;
+    window.stop();
+
+    EXPECT_EQ(window.allocations(), 2u);    // vector object + its buffer
+    EXPECT_EQ(window.frees(), 2u);
+    EXPECT_EQ(window.bytes(), sizeof(std::vector<int>) + 100 * sizeof(int));
+    if (!cn105_alloc::sites_supported()) GTEST_SKIP() << "no call-site resolution on this platform";
+    ASSERT_EQ(window.site_count(), 1u) << window.report("probe");
+    EXPECT_STREQ(window.site(0).name, "cn105_alloc_probe::make_vector");
+    EXPECT_EQ(window.site(0).count, 2u);
+}
+
+TEST_F(AllocationTest, StoppedWindowIgnoresLaterAllocations) {
+    cn105_alloc::Window window;
+    window.stop();
+    std::vector<int>* v = cn105_alloc_probe::make_vector(8);
+    delete v;
+    EXPECT_EQ(window.allocations(), 0u);
+    EXPECT_EQ(window.site_count(), 0u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Steady-state poll cycles
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(AllocationTest, SequentialPollCycle) {
+    expect_steady_state_allocates_nothing(DriverConfig(), "sequential poll, 20 cycles");
+}
+
+TEST_F(AllocationTest, PipelinedPollCycle) {
+    DriverConfig cfg;
+    cfg.pipeline_window = 3;
+    expect_steady_state_allocates_nothing(cfg, "pipeline window 3, 20 cycles");
+}
+
+TEST_F(AllocationTest, AdaptivePollingWithHardwareSettings) {
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    cfg.hardware_settings_interval_ms = 10000;
+    expect_steady_state_allocates_nothing(cfg, "adaptive + hardware settings, 20 cycles");
+}
+
+TEST_F(AllocationTest, WritesBetweenPollCycles) {
+    // SET writes queued on the scheduler (control() / remote temperature) are part of the steady state too
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.start_handshake();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 5000));
+    ASSERT_TRUE(drv.run_cycles(WARMUP_CYCLES, 60000));
+    const uint32_t acks = drv.acks();
+
+    cn105_alloc::Window window;
+    for (int i = 0; i < 5; i++) {
+        drv.queue_settings_write(20.0f + i);
+        drv.queue_remote_temperature(21.0f + i * 0.5f);
+        ASSERT_TRUE(drv.run_cycles(2, 60000));
+    }
+    window.stop();
+
+    const std::string report = window.report("10 SET writes over 10 cycles");
+    std::fputs(report.c_str(), stdout);
+    EXPECT_EQ(drv.acks() - acks, 10u);
+    EXPECT_EQ(window.allocations(), 0u) << report;
+}
+
+TEST_F(AllocationTest, ResponseDecodersDoNotAllocate) {
+    const uint8_t settings[] = {0x02,0x00,0x00,0x01,0x01,0x1A,0x03,0x07,0x00,0x00,0x03,0xAB,0x00,0x00,0x00,0x00};
+    const uint8_t room[] = {0x03,0x00,0x00,0x0D,0x00,0x8A,0xAE,0x00,0x00,0x00,0x00,0x00,0x0E,0x10,0x00,0x00};
+    const uint8_t status[] = {0x06,0x00,0x00,0x2A,0x01,0x01,0xF4,0x00,0x7B,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+
+    cn105_alloc::Window window;
+    const auto s = cn105_protocol::decode_settings(settings);
+    const auto r = cn105_protocol::decode_room_temperature(room);
+    const auto st = cn105_protocol::decode_status(status);
+    window.stop();
+
+    EXPECT_EQ(s.power, cn105_protocol::Power::ON);
+    EXPECT_FLOAT_EQ(r.room_temperature, 23.0f);
+    EXPECT_TRUE(st.operating);
+    EXPECT_EQ(window.allocations(), 0u) << window.report("0x62 decoders");
+}
+
+}  // namespace
@@ -0,0 +1,134 @@
+/// test_byte_maps.cpp — Equivalence of the generated *_TABLE decode / encode tables with the legacy linear lookups.
+/// Deps: byte_maps.h, cn105_protocol.h, cn105_types.h
+#include <gtest/gtest.h>
+#include <string>
+#include "cn105_protocol.h"
+#include "cn105_types.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+/// Every byte value decodes like lookup_value_opt() over the parallel arrays.
+template <typename Table, typename T, size_t N>
+void expect_decode_equivalent(const Table& table, const T (&values)[N], const uint8_t (&bytes)[N]) {
+    for (int b = 0; b < 256; b++) {
+        const uint8_t byte = static_cast<uint8_t>(b);
+        const auto expected = lookup_value_opt(values, bytes, static_cast<int>(N), byte);
+        const auto actual = table.lookup(values, byte);
+        ASSERT_EQ(actual.has_value(), expected.has_value()) << "byte 0x" << std::hex << b;
+        if (expected) {
+            EXPECT_EQ(*actual, *expected) << "byte 0x" << std::hex << b;
+            EXPECT_EQ(table.encode(*table.decode(byte)), byte) << "byte 0x" << std::hex << b;
+        } else {
+            EXPECT_FALSE(table.decode(byte).has_value()) << "byte 0x" << std::hex << b;
+        }
+    }
+}
+
+/// Every label (as stored, lower-cased, as a copy) encodes like lookup_index() + byte array.
+template <typename Table, size_t N>
+void expect_encode_equivalent(const Table& table, const char* (&labels)[N], const uint8_t (&bytes)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        std::string copy(labels[i]);
+        std::string lower(copy);
+        for (auto& c : lower) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        for (const char* label : {labels[i], copy.c_str(), lower.c_str()}) {
+            const int expected = lookup_index(labels, static_cast<int>(N), label);
+            const auto entry = table.find(labels, label);
+            ASSERT_GE(expected, 0) << label;
+            ASSERT_TRUE(entry.has_value()) << label;
+            EXPECT_EQ(static_cast<int>(*entry), expected) << label;
+            EXPECT_EQ(table.encode(*entry), bytes[expected]) << label;
+        }
+    }
+    EXPECT_FALSE(table.find(labels, "NOT A LABEL").has_value());
+    EXPECT_FALSE(table.find(labels, "").has_value());
+    EXPECT_FALSE(table.find(labels, nullptr).has_value());
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Compile-time generation
+// ════════════════════════════════════════════════════════════════
+
+static_assert(MODE_TABLE.encode(Mode::AUTO) == 0x08, "MODE encode");
+static_assert(*MODE_TABLE.decode(0x07) == Mode::FAN, "MODE decode");
+static_assert(!MODE_TABLE.decode(0x04).has_value(), "MODE gap");
+static_assert(WIDEVANE_TABLE.encode(WideVane::AIRFLOW_CONTROL) == 0x00, "WIDEVANE encode");
+static_assert(*AUTO_SUB_MODE_TABLE.decode(0x43) == AutoSubMode::AUTO_ACTIVE, "AUTO_SUB_MODE decode");
+
+TEST(ByteMaps, SpanIsLargestBytePlusOne) {
+    EXPECT_EQ(POWER_TABLE.span(), 2u);
+    EXPECT_EQ(MODE_TABLE.span(), 9u);
+    EXPECT_EQ(WIDEVANE_TABLE.span(), 13u);
+    EXPECT_EQ(ROOM_TEMP_TABLE.span(), 32u);
+    EXPECT_EQ(SUB_MODE_TABLE.span(), 17u);
+    EXPECT_EQ(AUTO_SUB_MODE_TABLE.span(), 0x44u);
+}
+
+TEST(ByteMaps, DuplicateByteDecodesToFirstEntry) {
+    static constexpr uint8_t bytes[3] = {0x05, 0x02, 0x05};
+    constexpr auto table = CN105_BYTE_MAP(uint8_t, bytes);
+    EXPECT_EQ(*table.decode(0x05), 0);
+    EXPECT_EQ(*table.decode(0x02), 1);
+    EXPECT_EQ(table.encode(2), 0x05);
+    EXPECT_FALSE(table.decode(0x06).has_value());
+}
+
+// ════════════════════════════════════════════════════════════════
+// Decode: all 256 bytes against lookup_value_opt()
+// ════════════════════════════════════════════════════════════════
+
+TEST(ByteMaps, DecodeMatchesLinearLookup) {
+    expect_decode_equivalent(POWER_TABLE, POWER_MAP, POWER);
+    expect_decode_equivalent(MODE_TABLE, MODE_MAP, MODE);
+    expect_decode_equivalent(TEMP_TABLE, TEMP_MAP, TEMP);
+    expect_decode_equivalent(FAN_TABLE, FAN_MAP, FAN);
+    expect_decode_equivalent(VANE_TABLE, VANE_MAP, VANE);
+    expect_decode_equivalent(WIDEVANE_TABLE, WIDEVANE_MAP, WIDEVANE);
+    expect_decode_equivalent(ROOM_TEMP_TABLE, ROOM_TEMP_MAP, ROOM_TEMP);
+    expect_decode_equivalent(AIRFLOW_CONTROL_TABLE, AIRFLOW_CONTROL_MAP, AIRFLOW_CONTROL);
+    expect_decode_equivalent(STAGE_TABLE, STAGE_MAP, STAGE);
+    expect_decode_equivalent(SUB_MODE_TABLE, SUB_MODE_MAP, SUB_MODE);
+    expect_decode_equivalent(AUTO_SUB_MODE_TABLE, AUTO_SUB_MODE_MAP, AUTO_SUB_MODE);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Encode: every label against lookup_index()
+// ════════════════════════════════════════════════════════════════
+
+TEST(ByteMaps, EncodeMatchesLinearLookup) {
+    expect_encode_equivalent(POWER_TABLE, POWER_MAP, POWER);
+    expect_encode_equivalent(MODE_TABLE, MODE_MAP, MODE);
+    expect_encode_equivalent(FAN_TABLE, FAN_MAP, FAN);
+    expect_encode_equivalent(VANE_TABLE, VANE_MAP, VANE);
+    expect_encode_equivalent(WIDEVANE_TABLE, WIDEVANE_MAP, WIDEVANE);
+    expect_encode_equivalent(AIRFLOW_CONTROL_TABLE, AIRFLOW_CONTROL_MAP, AIRFLOW_CONTROL);
+    expect_encode_equivalent(STAGE_TABLE, STAGE_MAP, STAGE);
+    expect_encode_equivalent(SUB_MODE_TABLE, SUB_MODE_MAP, SUB_MODE);
+    expect_encode_equivalent(AUTO_SUB_MODE_TABLE, AUTO_SUB_MODE_MAP, AUTO_SUB_MODE);
+}
+
+TEST(ByteMaps, SetpointEncodeMatchesLinearLookup) {
+    for (int t = 0; t < 50; t++) {
+        const int expected = lookup_index(TEMP_MAP, 16, t);
+        const auto entry = TEMP_TABLE.find(TEMP_MAP, t);
+        ASSERT_EQ(entry.has_value(), expected >= 0) << t;
+        if (entry) {
+            EXPECT_EQ(TEMP_TABLE.encode(*entry), TEMP[expected]) << t;
+        }
+    }
+}
+
+TEST(ByteMaps, EnumEntriesFollowLabelOrder) {
+    EXPECT_STREQ(MODE_MAP[static_cast<int>(Mode::COOL)], "COOL");
+    EXPECT_STREQ(FAN_MAP[static_cast<int>(Fan::SPEED_4)], "4");
+    EXPECT_STREQ(VANE_MAP[static_cast<int>(Vane::SWING)], "SWING");
+    EXPECT_STREQ(WIDEVANE_MAP[static_cast<int>(WideVane::AIRFLOW_CONTROL)], "AIRFLOW CONTROL");
+    EXPECT_STREQ(AIRFLOW_CONTROL_MAP[static_cast<int>(AirflowControl::DIRECT)], "DIRECT");
+    EXPECT_STREQ(STAGE_MAP[static_cast<int>(Stage::STAGE_DIFFUSE)], "DIFFUSE");
+    EXPECT_STREQ(SUB_MODE_MAP[static_cast<int>(SubMode::OFF)], "OFF");
+    EXPECT_STREQ(AUTO_SUB_MODE_MAP[static_cast<int>(AutoSubMode::AUTO_ACTIVE)], "AUTO_ACTIVE");
+}
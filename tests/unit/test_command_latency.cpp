@@ -0,0 +1,162 @@
+/// test_command_latency.cpp — Tests for LatencyHistogram and CommandTracker (0x61 ACK correlation).
+/// Deps: command_latency.h
+#include <gtest/gtest.h>
+#include "command_latency.h"
+
+using namespace esphome;
+
+// ════════════════════════════════════════════════════════════════
+// LatencyHistogram
+// ════════════════════════════════════════════════════════════════
+
+TEST(LatencyHistogram, EmptyReportsZero) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.percentile(95), 0u);
+    EXPECT_EQ(h.mean_ms(), 0u);
+}
+
+TEST(LatencyHistogram, BucketBoundsAreInclusive) {
+    LatencyHistogram h;
+    h.record(50);       // bucket 0 (≤ 50)
+    h.record(51);       // bucket 1 (≤ 100)
+    h.record(5000);     // last bounded bucket
+    h.record(9000);     // overflow
+    EXPECT_EQ(h.bucket(0), 1u);
+    EXPECT_EQ(h.bucket(1), 1u);
+    EXPECT_EQ(h.bucket(LatencyHistogram::BUCKETS - 2), 1u);
+    EXPECT_EQ(h.bucket(LatencyHistogram::BUCKETS - 1), 1u);
+    EXPECT_EQ(h.max_ms(), 9000u);
+}
+
+TEST(LatencyHistogram, PercentileReturnsBucketUpperBound) {
+    LatencyHistogram h;
+    for (int i = 0; i < 90; i++) h.record(180);     // ≤ 200
+    for (int i = 0; i < 10; i++) h.record(700);     // ≤ 750
+    EXPECT_EQ(h.percentile(50), 200u);
+    EXPECT_EQ(h.percentile(90), 200u);
+    EXPECT_EQ(h.percentile(95), 700u);              // capped by the max seen
+    EXPECT_EQ(h.percentile(100), 700u);
+    EXPECT_EQ(h.mean_ms(), (90u * 180 + 10u * 700) / 100);
+}
+
+TEST(LatencyHistogram, OverflowPercentileIsMax) {
+    LatencyHistogram h;
+    h.record(12000);
+    EXPECT_EQ(h.percentile(50), 12000u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max_ms(), 0u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// CommandTracker
+// ════════════════════════════════════════════════════════════════
+
+TEST(CommandTracker, AcksMatchWritesInOrder) {
+    CommandTracker t;
+    t.control(CommandKind::SETTINGS, 1000);
+    t.control(CommandKind::REMOTE_TEMP, 1010);
+    t.written(CommandKind::SETTINGS, 1100);
+    t.written(CommandKind::REMOTE_TEMP, 1120);
+    EXPECT_EQ(t.outstanding(), 2u);
+
+    CommandKind kind;
+    ASSERT_TRUE(t.ack(1300, &kind));
+    EXPECT_EQ(kind, CommandKind::SETTINGS);
+    EXPECT_EQ(t.last_ack_ms(), 200u);
+    ASSERT_TRUE(t.ack(1500, &kind));
+    EXPECT_EQ(kind, CommandKind::REMOTE_TEMP);
+    EXPECT_EQ(t.last_ack_ms(), 380u);
+
+    EXPECT_EQ(t.to_write().count(), 2u);
+    EXPECT_EQ(t.bus().count(), 2u);
+    EXPECT_EQ(t.to_ack().count(), 2u);
+    EXPECT_EQ(t.to_ack().max_ms(), 490u);           // 1010 → 1500
+    EXPECT_FALSE(t.ack(1600));
+    EXPECT_EQ(t.unmatched_acks(), 1u);
+}
+
+TEST(CommandTracker, ControlClockStartsAtFirstChange) {
+    // Changes merged into one write are timed from the first one
+    CommandTracker t;
+    t.control(CommandKind::SETTINGS, 0);
+    t.control(CommandKind::SETTINGS, 300);
+    t.written(CommandKind::SETTINGS, 400);
+    t.ack(600);
+    EXPECT_EQ(t.to_write().max_ms(), 400u);
+    EXPECT_EQ(t.to_ack().max_ms(), 600u);
+}
+
+TEST(CommandTracker, ConfirmClosesEndToEndMeasurement) {
+    CommandTracker t;
+    t.control(CommandKind::SETTINGS, 0);
+    t.written(CommandKind::SETTINGS, 100);
+    EXPECT_FALSE(t.awaiting_confirm(CommandKind::SETTINGS));
+    t.ack(320);
+    EXPECT_TRUE(t.awaiting_confirm(CommandKind::SETTINGS));
+    t.confirmed(CommandKind::SETTINGS, 900);
+    EXPECT_FALSE(t.awaiting_confirm(CommandKind::SETTINGS));
+    EXPECT_EQ(t.to_confirm().count(), 1u);
+    EXPECT_EQ(t.to_confirm().max_ms(), 900u);
+    t.confirmed(CommandKind::SETTINGS, 2000);        // later readbacks are ignored
+    EXPECT_EQ(t.to_confirm().count(), 1u);
+}
+
+TEST(CommandTracker, FunctionsCountAsOneCommandOverTwoPackets) {
+    CommandTracker t;
+    t.control(CommandKind::FUNCTIONS, 0);
+    t.written(CommandKind::FUNCTIONS, 50, true);     // part 1
+    t.ack(250);
+    EXPECT_EQ(t.to_ack().count(), 0u);
+    t.written(CommandKind::FUNCTIONS, 260);          // part 2
+    t.ack(480);
+    EXPECT_EQ(t.bus().count(), 2u);
+    EXPECT_EQ(t.to_write().count(), 1u);
+    EXPECT_EQ(t.to_ack().count(), 1u);
+    EXPECT_EQ(t.to_ack().max_ms(), 480u);
+}
+
+TEST(CommandTracker, UncommandedWritesOnlyFeedBusHistogram) {
+    // Remote temperature keep-alive: no control() call
+    CommandTracker t;
+    t.written(CommandKind::REMOTE_TEMP, 1000);
+    CommandKind kind;
+    ASSERT_TRUE(t.ack(1224, &kind));
+    EXPECT_EQ(kind, CommandKind::REMOTE_TEMP);
+    EXPECT_EQ(t.bus().count(), 1u);
+    EXPECT_EQ(t.to_write().count(), 0u);
+    EXPECT_EQ(t.to_ack().count(), 0u);
+    EXPECT_FALSE(t.awaiting_confirm(CommandKind::REMOTE_TEMP));
+}
+
+TEST(CommandTracker, StaleWritesAreDroppedAsLost) {
+    CommandTracker t;
+    t.control(CommandKind::SETTINGS, 0);
+    t.written(CommandKind::SETTINGS, 0);             // its ACK never comes
+    t.control(CommandKind::RUN_STATES, CommandTracker::STALE_MS + 100);
+    t.written(CommandKind::RUN_STATES, CommandTracker::STALE_MS + 100);
+    CommandKind kind;
+    ASSERT_TRUE(t.ack(CommandTracker::STALE_MS + 300, &kind));
+    EXPECT_EQ(kind, CommandKind::RUN_STATES);
+    EXPECT_EQ(t.lost_acks(), 1u);
+}
+
+TEST(CommandTracker, ResetLinkForgetsOutstandingWrites) {
+    CommandTracker t;
+    t.control(CommandKind::SETTINGS, 0);
+    t.written(CommandKind::SETTINGS, 10);
+    t.reset_link();
+    EXPECT_EQ(t.outstanding(), 0u);
+    EXPECT_FALSE(t.ack(100));
+}
+
+TEST(CommandTracker, DirtyOnlyAfterNewSample) {
+    CommandTracker t;
+    EXPECT_FALSE(t.take_dirty());
+    t.control(CommandKind::SETTINGS, 0);
+    t.written(CommandKind::SETTINGS, 10);
+    t.ack(200);
+    EXPECT_TRUE(t.take_dirty());
+    EXPECT_FALSE(t.take_dirty());
+}
@@ -0,0 +1,91 @@
+/// test_deadline_queue.cpp — Tests for DeadlineQueue (EDF queue shared by INFO polls and SET writes).
+/// Deps: deadline_queue.h
+#include <gtest/gtest.h>
+#include <vector>
+#include "deadline_queue.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+template <size_t N>
+std::vector<uint8_t> pop_all(DeadlineQueue<N>& q) {
+    std::vector<uint8_t> out;
+    while (!q.empty()) out.push_back(q.pop());
+    return out;
+}
+
+} // namespace
+
+TEST(DeadlineQueue, StartsEmpty) {
+    DeadlineQueue<4> q;
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.size(), 0u);
+    EXPECT_EQ(q.capacity(), 4u);
+    EXPECT_FALSE(q.contains(0));
+}
+
+TEST(DeadlineQueue, PopsEarliestDeadlineFirst) {
+    DeadlineQueue<8> q;
+    q.push(1, 500);
+    q.push(2, 100);
+    q.push(3, 300);
+    q.push(4, 200);
+    EXPECT_EQ(q.top(), 2);
+    EXPECT_EQ(q.top_due(), 100u);
+    EXPECT_EQ(pop_all(q), (std::vector<uint8_t>{ 2, 4, 3, 1 }));
+}
+
+TEST(DeadlineQueue, EqualDeadlinesKeepInsertionOrder) {
+    // Requests queued at the same due time go out in registration order (0x20 before 0x22)
+    DeadlineQueue<16> q;
+    for (uint8_t id = 0; id < 10; id++) q.push(id, 1000);
+    EXPECT_EQ(pop_all(q), (std::vector<uint8_t>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+TEST(DeadlineQueue, DeadlinesCompareAcrossMillisWrap) {
+    DeadlineQueue<4> q;
+    q.push(1, 0x00000010);          // just after the wrap
+    q.push(2, 0xFFFFFFF0);          // just before it
+    EXPECT_EQ(pop_all(q), (std::vector<uint8_t>{ 2, 1 }));
+}
+
+TEST(DeadlineQueue, HigherPriorityClassPopsFirst) {
+    // SET writes (class 1) go ahead of INFO polls however overdue, FIFO among themselves
+    DeadlineQueue<8> q;
+    q.push(1, 100);
+    q.push(0x80, 50000, 1);
+    q.push(2, 200);
+    q.push(0x81, 40000, 1);
+    EXPECT_EQ(q.top(), 0x81);
+    EXPECT_EQ(pop_all(q), (std::vector<uint8_t>{ 0x81, 0x80, 1, 2 }));
+}
+
+TEST(DeadlineQueue, RejectsDuplicatesAndOverflow) {
+    DeadlineQueue<2> q;
+    EXPECT_TRUE(q.push(7, 10));
+    EXPECT_FALSE(q.push(7, 5));     // already queued: keeps its first deadline
+    EXPECT_EQ(q.top_due(), 10u);
+    EXPECT_TRUE(q.push(8, 20));
+    EXPECT_FALSE(q.push(9, 1));
+    EXPECT_EQ(q.size(), 2u);
+}
+
+TEST(DeadlineQueue, RemoveKeepsHeapOrder) {
+    DeadlineQueue<8> q;
+    for (uint8_t id = 0; id < 6; id++) q.push(id, 600 - id * 100u);
+    EXPECT_TRUE(q.remove(3));
+    EXPECT_FALSE(q.remove(3));
+    EXPECT_FALSE(q.contains(3));
+    EXPECT_TRUE(q.contains(5));
+    EXPECT_EQ(pop_all(q), (std::vector<uint8_t>{ 5, 4, 2, 1, 0 }));
+}
+
+TEST(DeadlineQueue, ClearEmptiesQueue) {
+    DeadlineQueue<4> q;
+    q.push(1, 1);
+    q.push(2, 2);
+    q.clear();
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.push(1, 3));
+}
@@ -0,0 +1,1075 @@
+/// test_emulator.cpp — Tests for the virtual CN105 heat pump and end-to-end cycle timing.
+/// Deps: emulator/heatpump_emulator.h, emulator/host_loop.h, request_scheduler.cpp, cycle_management.cpp
+///
+/// All durations are virtual (esphome::host_clock_us()), so results are exact and reproducible.
+/// Measured cycle durations are printed to stdout to quantify the effect of
+/// update_interval / soft timeouts / unit latency on real poll latency.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+#include "emulator/heatpump_emulator.h"
+#include "emulator/host_loop.h"
+
+using namespace cn105_emulator;
+
+namespace {
+
+class EmulatorTest : public ::testing::Test {
+protected:
+    void SetUp() override { esphome::host_clock_us() = 0; }
+
+    /// Reads every byte the emulator has emitted by `until_us`.
+    static std::vector<uint8_t> drain(HeatPumpEmulator& hp, uint64_t until_us) {
+        std::vector<uint8_t> out;
+        while (hp.available(until_us)) out.push_back(static_cast<uint8_t>(hp.read(until_us)));
+        return out;
+    }
+
+    static void info_packet(uint8_t* packet, uint8_t code) {
+        std::memset(packet, 0, PACKET_LEN);
+        std::memcpy(packet, INFOHEADER, INFOHEADER_LEN);
+        packet[5] = code;
+        packet[PACKET_LEN - 1] = cn105_protocol::checksum(packet, PACKET_LEN - 1);
+    }
+
+    static uint32_t average(const std::vector<uint32_t>& v) {
+        return v.empty() ? 0 : static_cast<uint32_t>(std::accumulate(v.begin(), v.end(), 0ULL) / v.size());
+    }
+
+    static void report(const char* label, const HostDriver& drv) {
+        const auto& d = drv.cycle_durations_ms();
+        if (d.empty()) return;
+        std::printf("[  CYCLE   ] %-40s n=%zu min=%u avg=%u max=%u ms\n", label, d.size(),
+            *std::min_element(d.begin(), d.end()), average(d), *std::max_element(d.begin(), d.end()));
+    }
+};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Wire timing
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, ByteTimeIs2400Baud8E1) {
+    HeatPumpEmulator hp;
+    // 11 bits per byte at 2400 bit/s
+    EXPECT_EQ(hp.byte_time_us(), 4583u);
+}
+
+TEST_F(EmulatorTest, ReplyStartsAfterRequestPlusLatency) {
+    EmulatorConfig cfg;
+    cfg.response_latency_us = 10000;
+    HeatPumpEmulator hp(cfg);
+    const uint64_t bt = hp.byte_time_us();
+
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    // First reply byte lands after 8 request bytes + latency + 1 reply byte
+    const uint64_t first = 8 * bt + 10000 + bt;
+    EXPECT_EQ(hp.next_byte_us(), first);
+    EXPECT_EQ(hp.available(first - 1), 0u);
+    EXPECT_EQ(hp.available(first), 1u);
+    // 7-byte 0x7A frame fully received 6 byte-times later
+    EXPECT_EQ(hp.available(first + 6 * bt), 7u);
+}
+
+TEST_F(EmulatorTest, RepliesAreSerializedOnTheUnitLine) {
+    HeatPumpEmulator hp;
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    uint8_t a[PACKET_LEN], b[PACKET_LEN];
+    info_packet(a, 0x02);
+    info_packet(b, 0x03);
+    hp.host_write(a, PACKET_LEN, 0);
+    hp.host_write(b, PACKET_LEN, 0);     // queued behind `a` on the host line
+
+    auto bytes = drain(hp, 10000000);
+    ASSERT_EQ(bytes.size(), 7u + 22u + 22u);
+    EXPECT_EQ(bytes[7 + 5], 0x02);
+    EXPECT_EQ(bytes[7 + 22 + 5], 0x03);
+}
+
+TEST_F(EmulatorTest, JitterIsBoundedAndReproducible) {
+    EmulatorConfig cfg;
+    cfg.response_latency_us = 5000;
+    cfg.jitter_us = 30000;
+    HeatPumpEmulator a(cfg), b(cfg);
+    const uint64_t bt = a.byte_time_us();
+
+    a.host_write(CONNECT, CONNECT_LEN, 0);
+    b.host_write(CONNECT, CONNECT_LEN, 0);
+    EXPECT_EQ(a.next_byte_us(), b.next_byte_us());
+    EXPECT_GE(a.next_byte_us(), 8 * bt + 5000 + bt);
+    EXPECT_LE(a.next_byte_us(), 8 * bt + 35000 + bt);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Protocol replies
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, UserConnectGets7A) {
+    HeatPumpEmulator hp;
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    auto bytes = drain(hp, 1000000);
+    const std::vector<uint8_t> expected = { 0xFC, 0x7A, 0x01, 0x30, 0x01, 0x00, 0x54 };
+    EXPECT_EQ(bytes, expected);
+    EXPECT_TRUE(hp.connected());
+    EXPECT_FALSE(hp.installer_mode());
+}
+
+TEST_F(EmulatorTest, InstallerConnectGets7B) {
+    HeatPumpEmulator hp;
+    uint8_t pkt[CONNECT_LEN];
+    std::memcpy(pkt, CONNECT, CONNECT_LEN);
+    pkt[1] = 0x5B;
+    pkt[CONNECT_LEN - 1] = cn105_protocol::checksum(pkt, CONNECT_LEN - 1);
+    hp.host_write(pkt, CONNECT_LEN, 0);
+    auto bytes = drain(hp, 1000000);
+    ASSERT_EQ(bytes.size(), 7u);
+    EXPECT_EQ(bytes[1], 0x7B);
+    EXPECT_TRUE(hp.installer_mode());
+}
+
+TEST_F(EmulatorTest, RejectedConnectStaysSilent) {
+    EmulatorConfig cfg;
+    cfg.accept_user_connect = false;
+    HeatPumpEmulator hp(cfg);
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    EXPECT_EQ(hp.next_byte_us(), HeatPumpEmulator::NEVER);
+    EXPECT_FALSE(hp.connected());
+}
+
+TEST_F(EmulatorTest, InfoIgnoredBeforeConnect) {
+    HeatPumpEmulator hp;
+    uint8_t pkt[PACKET_LEN];
+    info_packet(pkt, 0x02);
+    hp.host_write(pkt, PACKET_LEN, 0);
+    EXPECT_EQ(hp.next_byte_us(), HeatPumpEmulator::NEVER);
+}
+
+TEST_F(EmulatorTest, SettingsReplyIsAValidFrame) {
+    HeatPumpEmulator hp;
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    uint8_t pkt[PACKET_LEN];
+    info_packet(pkt, 0x02);
+    hp.host_write(pkt, PACKET_LEN, 0);
+    auto bytes = drain(hp, 10000000);
+
+    cn105_protocol::FrameParser parser;
+    int frames = 0;
+    for (uint8_t b : bytes) {
+        parser.feed(b);
+        if (!parser.frame_complete()) continue;
+        ASSERT_TRUE(parser.checksum_valid());
+        if (parser.command() == 0x62) {
+            EXPECT_EQ(parser.data_length(), 0x10);
+            EXPECT_EQ(parser.data()[0], 0x02);
+            EXPECT_EQ(parser.data()[3], 0x01);     // power ON
+            EXPECT_EQ(parser.data()[4], 0x01);     // HEAT
+            EXPECT_EQ(parser.data()[11], 0xAB);    // 21.5 °C
+        }
+        frames++;
+        parser.reset();
+    }
+    EXPECT_EQ(frames, 2);
+    EXPECT_EQ(hp.info_requests(0x02), 1u);
+}
+
+TEST_F(EmulatorTest, SetIsAcknowledgedAndApplied) {
+    HeatPumpEmulator hp;
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    // WRITE_SETTINGS frame (layout from test_real_frames.cpp): power ON + mode COOL + temp 0xAC (22 °C)
+    uint8_t set[PACKET_LEN] = { 0xFC,0x41,0x01,0x30,0x10, 0x01,0x07,0x00,0x01,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xAC,0x00 };
+    set[PACKET_LEN - 1] = cn105_protocol::checksum(set, PACKET_LEN - 1);
+    hp.host_write(set, PACKET_LEN, 0);
+
+    auto bytes = drain(hp, 10000000);
+    ASSERT_EQ(bytes.size(), 7u + 22u);
+    EXPECT_EQ(bytes[7 + 1], 0x61);
+    EXPECT_EQ(hp.set_requests(), 1u);
+    EXPECT_EQ(hp.power, 0x01);
+    EXPECT_EQ(hp.mode, 0x03);
+    EXPECT_EQ(hp.temp_encoded, 0xAC);
+}
+
+TEST_F(EmulatorTest, UnsupportedCodesAreSilentOrZeroed) {
+    EmulatorConfig cfg;
+    cfg.unsupported(0x09).unsupported(0x20, InfoReply::ZEROS);
+    HeatPumpEmulator hp(cfg);
+    hp.host_write(CONNECT, CONNECT_LEN, 0);
+    drain(hp, 1000000);
+
+    uint8_t pkt[PACKET_LEN];
+    info_packet(pkt, 0x09);
+    hp.host_write(pkt, PACKET_LEN, 1000000);
+    EXPECT_EQ(hp.next_byte_us(), HeatPumpEmulator::NEVER);
+
+    info_packet(pkt, 0x20);
+    hp.host_write(pkt, PACKET_LEN, 2000000);
+    auto bytes = drain(hp, 10000000);
+    ASSERT_EQ(bytes.size(), 22u);
+    EXPECT_EQ(bytes[5], 0x20);
+    for (int i = 6; i < 21; i++) EXPECT_EQ(bytes[i], 0x00);
+}
+
+TEST_F(EmulatorTest, BadChecksumIsIgnored) {
+    HeatPumpEmulator hp;
+    uint8_t pkt[CONNECT_LEN];
+    std::memcpy(pkt, CONNECT, CONNECT_LEN);
+    pkt[CONNECT_LEN - 1] ^= 0xFF;
+    hp.host_write(pkt, CONNECT_LEN, 0);
+    EXPECT_EQ(hp.bad_checksums(), 1u);
+    EXPECT_EQ(hp.next_byte_us(), HeatPumpEmulator::NEVER);
+}
+
+// ════════════════════════════════════════════════════════════════
+// End-to-end: RequestScheduler + cycleManagement + FrameParser
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, HandshakeThenFullCycle) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    EXPECT_EQ(drv.connect_reply(), 0x7A);
+
+    ASSERT_TRUE(drv.run_cycles(3, 20000));
+    for (uint8_t code : { 0x02, 0x03, 0x06, 0x09, 0x42, 0x04 }) {
+        EXPECT_EQ(drv.responses(code), 3u) << "code 0x" << std::hex << int(code);
+    }
+    EXPECT_EQ(drv.responses(0x05), 0u);     // timers: disabled
+    EXPECT_EQ(drv.responses(0x20), 0u);     // no hardware_settings
+    EXPECT_EQ(drv.bad_checksums(), 0u);
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    EXPECT_EQ(drv.scheduler().get_unknown_responses(), 0u);
+
+    // 6 requests, each 22 bytes out + 22 bytes in + 20 ms latency, plus loop quantization
+    const uint32_t wire_ms = 6 * (2 * 22 * hp.byte_time_us() + 20000) / 1000;
+    for (uint32_t d : drv.cycle_durations_ms()) {
+        EXPECT_GE(d, wire_ms);
+        EXPECT_LE(d, wire_ms + 6 * 2 * 16 + 16);
+    }
+    report("sequential, 6 requests", drv);
+}
+
+TEST_F(EmulatorTest, UpdateIntervalSetsCyclePeriodNotDuration) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.update_interval_ms = 5000;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    const uint64_t start = esphome::host_clock_us();
+    ASSERT_TRUE(drv.run_cycles(3, 60000));
+    const uint32_t elapsed_ms = static_cast<uint32_t>((esphome::host_clock_us() - start) / 1000);
+    // Each cycle waits update_interval after the previous one ended
+    EXPECT_GE(elapsed_ms, 3 * 5000u);
+    EXPECT_LT(average(drv.cycle_durations_ms()), 2000u);
+    report("sequential, update_interval=5000", drv);
+}
+
+TEST_F(EmulatorTest, SilentStandbyCostsSoftTimeoutUntilDisabled) {
+    EmulatorConfig hp_cfg;
+    hp_cfg.unsupported(0x09).unsupported(0x42);
+    HeatPumpEmulator hp(hp_cfg);
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_cycles(5, 60000));
+    const auto& d = drv.cycle_durations_ms();
+    // First 3 cycles pay 2 × 500 ms soft timeouts (request TX included), then both codes are
+    // disabled (maxFailures = 3) and the cycle only carries the 4 answered requests
+    for (int i = 0; i < 3; i++) EXPECT_GE(d[i], d[4] + 2 * 500);
+    EXPECT_LT(d[4], d[0]);
+    EXPECT_EQ(hp.info_requests(0x09), 3u);
+    EXPECT_EQ(hp.info_requests(0x42), 3u);
+    EXPECT_EQ(drv.responses(0x02), 5u);
+    report("0x09 + 0x42 unsupported", drv);
+}
+
+TEST_F(EmulatorTest, SilentSettingsStallsCycleUntilTimeout) {
+    // 0x02 has no soft timeout: a missing reply blocks the cycle until checkTimeout()
+    EmulatorConfig hp_cfg;
+    hp_cfg.unsupported(0x02);
+    HeatPumpEmulator hp(hp_cfg);
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_until([&]() { return drv.nb_timed_out_cycles() > 0; }, 20000));
+    EXPECT_EQ(drv.nb_complete_cycles(), 0u);
+    EXPECT_EQ(drv.responses(0x03), 0u);
+}
+
+TEST_F(EmulatorTest, HardwareSettingsAddTwoRequests) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.hardware_settings_interval_ms = 60000;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_cycles(3, 20000));
+    // 0x20/0x22 are sent once, then throttled by their interval
+    EXPECT_EQ(drv.responses(0x20), 1u);
+    EXPECT_EQ(drv.responses(0x22), 1u);
+    const auto& d = drv.cycle_durations_ms();
+    EXPECT_GT(d[0], d[1] + 2 * 2 * 22 * hp.byte_time_us() / 1000);
+    report("with 0x20/0x22 (first cycle only)", drv);
+}
+
+TEST_F(EmulatorTest, LatencyJitterSpreadsCycleDuration) {
+    EmulatorConfig hp_cfg;
+    hp_cfg.response_latency_us = 10000;
+    hp_cfg.jitter_us = 80000;
+    HeatPumpEmulator hp(hp_cfg);
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_cycles(20, 120000));
+    const auto& d = drv.cycle_durations_ms();
+    EXPECT_GT(*std::max_element(d.begin(), d.end()), *std::min_element(d.begin(), d.end()));
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    report("latency 10 ms + jitter 0..80 ms", drv);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Pipelined INFO requests (info_pipeline_window)
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, PipelinedCycleGetsEveryResponse) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.pipeline_window = 2;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_cycles(3, 20000));
+    for (uint8_t code : { 0x02, 0x03, 0x06, 0x09, 0x42, 0x04 }) {
+        EXPECT_EQ(drv.responses(code), 3u) << "code 0x" << std::hex << int(code);
+        EXPECT_EQ(hp.info_requests(code), 3u) << "code 0x" << std::hex << int(code);
+    }
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    EXPECT_EQ(drv.scheduler().get_in_flight(), 0u);
+}
+
+TEST_F(EmulatorTest, PipelinedVsSequentialCycleTime) {
+    uint32_t avg[5] = {};
+    for (uint8_t window = 1; window <= 4; window++) {
+        esphome::host_clock_us() = 0;
+        HeatPumpEmulator hp;
+        DriverConfig cfg;
+        cfg.pipeline_window = window;
+        HostDriver drv(hp, cfg);
+        drv.connect();
+        ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+        ASSERT_TRUE(drv.run_cycles(5, 30000));
+        EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+        avg[window] = average(drv.cycle_durations_ms());
+        char label[48];
+        std::snprintf(label, sizeof(label), "pipeline window %u, 6 requests", window);
+        report(label, drv);
+    }
+    // Replies are serialized on the unit line: overlapping requests with replies roughly halves
+    // the cycle; wider windows cannot beat the reply stream itself (6 × 22 bytes)
+    const uint32_t reply_stream_ms = 6 * 22 * HeatPumpEmulator().byte_time_us() / 1000;
+    EXPECT_LT(avg[2], avg[1] * 2 / 3);
+    EXPECT_LE(avg[3], avg[2]);
+    EXPECT_GE(avg[4], reply_stream_ms);
+    std::printf("[  CYCLE   ] pipelining gain: window 2 = -%u%%, window 4 = -%u%%\n",
+        100 - avg[2] * 100 / avg[1], 100 - avg[4] * 100 / avg[1]);
+}
+
+TEST_F(EmulatorTest, PipelinedSoftTimeoutsStillApply) {
+    EmulatorConfig hp_cfg;
+    hp_cfg.unsupported(0x09).unsupported(0x42);
+    HeatPumpEmulator hp(hp_cfg);
+    DriverConfig cfg;
+    cfg.pipeline_window = 3;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    ASSERT_TRUE(drv.run_cycles(5, 60000));
+    // Both silent codes still count failures and get disabled after maxFailures
+    EXPECT_EQ(hp.info_requests(0x09), 3u);
+    EXPECT_EQ(hp.info_requests(0x42), 3u);
+    EXPECT_EQ(drv.responses(0x04), 5u);
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    const auto& d = drv.cycle_durations_ms();
+    EXPECT_LT(d[4], d[0]);
+    report("window 3, 0x09 + 0x42 unsupported", drv);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Adaptive polling
+// ════════════════════════════════════════════════════════════════
+
+namespace {
+
+uint32_t polls(const HeatPumpEmulator& hp, std::initializer_list<uint8_t> codes) {
+    uint32_t n = 0;
+    for (uint8_t c : codes) n += hp.info_requests(c);
+    return n;
+}
+
+} // namespace
+
+TEST_F(EmulatorTest, AdaptiveIdleStretchesStableRequests) {
+    HeatPumpEmulator hp;    // compressor off, nothing changes
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    drv.run_until([]() { return false; }, 120000);
+    EXPECT_FALSE(drv.scheduler().is_unit_active());
+    // 0x03/0x06 keep the update_interval rhythm, stable codes end up 8× slower
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x03), cfg.update_interval_ms);
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x02), 8 * cfg.update_interval_ms);
+    EXPECT_LT(hp.info_requests(0x02) * 3, hp.info_requests(0x03));
+    EXPECT_LT(hp.info_requests(0x09) * 3, hp.info_requests(0x03));
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    std::printf("[  CYCLE   ] adaptive idle, 120 s: 0x03=%u 0x02=%u 0x09=%u 0x04=%u 0x42=%u polls\n",
+        hp.info_requests(0x03), hp.info_requests(0x02), hp.info_requests(0x09), hp.info_requests(0x04), hp.info_requests(0x42));
+}
+
+TEST_F(EmulatorTest, AdaptiveActivePollsRoomTempAndStatusFaster) {
+    uint32_t fixed_polls = 0;
+    {
+        HeatPumpEmulator hp;
+        hp.compressor_hz = 42;
+        hp.operating = 1;
+        HostDriver drv(hp);
+        drv.connect();
+        ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+        drv.run_until([]() { return false; }, 60000);
+        fixed_polls = polls(hp, { 0x03, 0x06 });
+    }
+    esphome::host_clock_us() = 0;
+    HeatPumpEmulator hp;
+    hp.compressor_hz = 42;
+    hp.operating = 1;
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    cfg.adaptive.fast_interval_ms = 500;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    drv.run_until([]() { return false; }, 60000);
+
+    EXPECT_TRUE(drv.scheduler().is_unit_active());
+    const uint32_t adaptive_polls = polls(hp, { 0x03, 0x06 });
+    EXPECT_GT(adaptive_polls, fixed_polls * 3 / 2);
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    std::printf("[  CYCLE   ] compressor on, 60 s: 0x03+0x06 polls fixed=%u adaptive=%u (0x02=%u)\n",
+        fixed_polls, adaptive_polls, hp.info_requests(0x02));
+}
+
+TEST_F(EmulatorTest, AdaptiveFastPollingStaysWithinBusBudget) {
+    HeatPumpEmulator hp;
+    hp.compressor_hz = 42;
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    cfg.adaptive.fast_interval_ms = 50;     // far below what the link can carry
+    cfg.adaptive.bus_budget_pct = 30;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    drv.run_until([]() { return false; }, 20000);      // let the stable codes stretch
+    const uint32_t before = polls(hp, { 0x02, 0x03, 0x04, 0x06, 0x09, 0x42 });
+    const uint64_t start = esphome::host_clock_us();
+    drv.run_until([]() { return false; }, 60000);
+
+    const uint32_t sent = polls(hp, { 0x02, 0x03, 0x04, 0x06, 0x09, 0x42 }) - before;
+    const double occupancy = double(sent) * INFO_EXCHANGE_WIRE_MS * 1000 / double(esphome::host_clock_us() - start);
+    EXPECT_LE(occupancy, 0.30 * 1.10);      // quantization to the 16 ms loop
+    EXPECT_GT(occupancy, 0.15);             // and the budget is actually used
+    std::printf("[  CYCLE   ] fast_interval 50 ms, budget 30%%: measured bus occupancy %.0f%%\n", occupancy * 100);
+}
+
+TEST_F(EmulatorTest, AdaptiveBackoffResetsOnTimerBypass) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    drv.run_until([]() { return false; }, 60000);
+    ASSERT_GT(drv.scheduler().get_effective_interval(0x02), cfg.update_interval_ms);
+
+    // A SET (sendWantedSettingsDelegate) bypasses 0x02: it must be read on the very next cycle
+    drv.scheduler().timer_bypass(0x02);
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x02), cfg.update_interval_ms);
+    const uint32_t before = hp.info_requests(0x02);
+    ASSERT_TRUE(drv.run_cycles(1, 10000));
+    EXPECT_EQ(hp.info_requests(0x02), before + 1);
+}
+
+TEST_F(EmulatorTest, AdaptiveStretchRestartsWhenPayloadChanges) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.adaptive.enabled = true;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    drv.run_until([]() { return false; }, 60000);
+    ASSERT_EQ(drv.scheduler().get_effective_interval(0x02), 8 * cfg.update_interval_ms);
+
+    hp.fan = 0x03;      // changed with the IR remote
+    const uint32_t before = drv.responses(0x02);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.responses(0x02) > before; }, 20000));
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x02), cfg.update_interval_ms);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Deadline-ordered scheduler: SET writes share the INFO queue
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, IdleSetWriteGoesOutImmediately) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_FALSE(drv.cycle().isCycleRunning());
+
+    drv.queue_settings_write(24.0f);
+    EXPECT_EQ(hp.set_requests(), 1u);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.last_write_latency_ms() > 0; }, 2000));
+    EXPECT_EQ(hp.temp_encoded, 24 * 2 + 128);
+    // 0x41 out + 0x61 back on the wire, nothing else in between
+    EXPECT_LT(drv.last_write_latency_ms(), 2 * INFO_EXCHANGE_WIRE_MS);
+    std::printf("[  WRITE   ] idle: queue -> ACK %u ms\n", drv.last_write_latency_ms());
+}
+
+TEST_F(EmulatorTest, SetWritePreemptsRemainingPolls) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_until([&]() { return drv.scheduler().get_in_flight() > 0; }, 5000));
+    const uint32_t cycles_before = drv.nb_complete_cycles();
+
+    // Queued behind the 0x02 reply in flight, ahead of 0x03/0x06/0x09/0x42/0x04
+    drv.queue_settings_write(25.0f);
+    EXPECT_EQ(hp.set_requests(), 0u);
+    EXPECT_TRUE(drv.scheduler().is_write_pending(0));
+    ASSERT_TRUE(drv.run_until([&]() { return drv.last_write_latency_ms() > 0; }, 5000));
+    EXPECT_TRUE(drv.cycle().isCycleRunning());
+    EXPECT_EQ(drv.nb_complete_cycles(), cycles_before);
+    EXPECT_EQ(hp.info_requests(0x04), 0u);
+    EXPECT_LT(drv.last_write_latency_ms(), 3 * INFO_EXCHANGE_WIRE_MS);
+
+    // The cycle then resumes and still gets every response
+    ASSERT_TRUE(drv.run_cycles(1, 10000));
+    for (uint8_t code : { 0x02, 0x03, 0x06, 0x09, 0x42, 0x04 }) {
+        EXPECT_EQ(drv.responses(code), 1u) << "code 0x" << std::hex << int(code);
+    }
+    EXPECT_EQ(drv.acks(), 1u);
+    EXPECT_FALSE(drv.scheduler().is_write_pending(0));
+    std::printf("[  WRITE   ] mid-cycle: queue -> ACK %u ms (cycle %u ms)\n",
+        drv.last_write_latency_ms(), drv.cycle_durations_ms().back());
+}
+
+TEST_F(EmulatorTest, SkippedWriteDoesNotHoldTheLine) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+
+    // UART not ready: writePacket() stashes the packet, performQueuedWrite() reports nothing written
+    drv.set_uart_ready(false);
+    drv.queue_remote_temperature(22.0f);
+    EXPECT_FALSE(drv.scheduler().is_write_pending(2));
+    EXPECT_EQ(hp.set_requests(), 0u);
+
+    // Back up: the next write goes out at once instead of waiting out an ACK timeout
+    drv.set_uart_ready(true);
+    drv.queue_settings_write(23.0f);
+    EXPECT_EQ(hp.set_requests(), 1u);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.acks() == 1; }, 2000));
+    EXPECT_EQ(drv.unacked_overlaps(), 0u);
+}
+
+TEST_F(EmulatorTest, SetWritePreemptsPollsWithLongUpdateInterval) {
+    // update_interval well above the old 10 s write priority: polls queued by a cycle are
+    // due since their last send, i.e. update_interval ago, and must still wait for the write
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.update_interval_ms = 30000;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_cycles(1, 40000));
+    ASSERT_TRUE(drv.run_until([&]() { return drv.cycle().isCycleRunning() && drv.scheduler().get_in_flight() > 0; }, 40000));
+    const uint32_t polls_04 = hp.info_requests(0x04);
+
+    drv.queue_settings_write(25.0f);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.last_write_latency_ms() > 0; }, 5000));
+    EXPECT_EQ(hp.info_requests(0x04), polls_04);
+    EXPECT_LT(drv.last_write_latency_ms(), 3 * INFO_EXCHANGE_WIRE_MS);
+    ASSERT_TRUE(drv.run_cycles(1, 40000));
+    EXPECT_EQ(hp.info_requests(0x04), polls_04 + 1);
+}
+
+TEST_F(EmulatorTest, PipelinedWindowDrainsBeforeSetWrite) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.pipeline_window = 3;
+    HostDriver drv(hp, cfg);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_until([&]() { return drv.scheduler().get_in_flight() == 3; }, 5000));
+
+    drv.queue_settings_write(20.0f);
+    // No new poll while the write waits for the window to drain
+    ASSERT_TRUE(drv.run_until([&]() { return hp.set_requests() > 0; }, 5000));
+    EXPECT_EQ(drv.scheduler().get_in_flight(), 0u);
+    EXPECT_EQ(hp.info_requests(0x42), 0u);
+    ASSERT_TRUE(drv.run_cycles(1, 10000));
+    EXPECT_EQ(drv.responses(0x04), 1u);
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+}
+
+TEST_F(EmulatorTest, SoftTimeoutsRunFromSchedulerLoop) {
+    EmulatorConfig hp_cfg;
+    hp_cfg.unsupported(0x09);
+    HeatPumpEmulator hp(hp_cfg);
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_until([&]() { return hp.info_requests(0x09) == 1; }, 5000));
+    const uint32_t sent_ms = esphome::millis();
+
+    // The 500 ms soft timeout expires in RequestScheduler::loop(), then 0x42 goes out
+    ASSERT_TRUE(drv.run_until([&]() { return hp.info_requests(0x42) == 1; }, 2000));
+    const uint32_t waited = esphome::millis() - sent_ms;
+    EXPECT_GE(waited, 500u);
+    EXPECT_LT(waited, 500u + 2 * 16u);
+    EXPECT_EQ(drv.scheduler().get_in_flight(), 1u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// TX queue: merged settings deltas, ordered 0x07, ACK pacing
+// ════════════════════════════════════════════════════════════════
+
+TEST_F(EmulatorTest, SettingsDeltasMergeIntoOneWrite) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_until([&]() { return drv.scheduler().get_in_flight() > 0; }, 5000));
+
+    // Three HA calls while the line is busy: one 0x41/0x01 carries all of them
+    cn105_protocol::SetRequest fan, mode;
+    fan.fan = cn105_protocol::Fan::QUIET;
+    mode.mode = cn105_protocol::Mode::COOL;
+    drv.queue_settings_write(19.0f);
+    drv.queue_settings(fan);
+    drv.queue_settings(mode);
+    EXPECT_EQ(drv.scheduler().get_coalesced_writes(), 2u);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.last_write_latency_ms() > 0; }, 5000));
+
+    EXPECT_EQ(drv.set_packets(), (std::vector<uint8_t>{ 0x01 }));
+    EXPECT_EQ(hp.temp_encoded, 19 * 2 + 128);
+    EXPECT_EQ(hp.fan, FAN[1]);
+    EXPECT_EQ(hp.mode, MODE[2]);
+}
+
+TEST_F(EmulatorTest, RemoteTemperatureWaitsForSettingsAck) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    drv.queue_settings_write(23.0f);
+    drv.queue_remote_temperature(20.5f);
+    EXPECT_EQ(hp.set_requests(), 1u);       // 0x07 held until the settings ACK
+    ASSERT_TRUE(drv.run_until([&]() { return drv.acks() == 2; }, 5000));
+
+    EXPECT_EQ(drv.set_packets(), (std::vector<uint8_t>{ 0x01, 0x07 }));
+    EXPECT_EQ(drv.unacked_overlaps(), 0u);
+    EXPECT_EQ(hp.temp_encoded, 23 * 2 + 128);
+    EXPECT_EQ(hp.remote_temp_encoded, 41 + 128);
+}
+
+TEST_F(EmulatorTest, AckRoundTripPacesWrites) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    EXPECT_EQ(drv.scheduler().ack_timeout_ms(), uint32_t(WRITE_ACK_TIMEOUT_MS));
+
+    drv.queue_settings_write(21.0f);
+    drv.queue_remote_temperature(21.0f);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.acks() == 2; }, 5000));
+
+    // 2 × 22 bytes at 2400 8E1 + unit latency, measured from the bus rather than a fixed pause
+    const uint32_t rtt = drv.scheduler().get_ack_rtt_ms();
+    const uint32_t wire_ms = 2 * 22 * hp.byte_time_us() / 1000;
+    EXPECT_GE(rtt, wire_ms);
+    EXPECT_LT(rtt, wire_ms + 2 * 16 + hp.config().response_latency_us / 1000);
+    EXPECT_EQ(drv.scheduler().ack_timeout_ms(), std::max<uint32_t>(INFO_EXCHANGE_WIRE_MS, 2 * rtt));
+    std::printf("[  WRITE   ] measured ACK round trip %u ms -> ACK timeout %u ms\n", rtt, drv.scheduler().ack_timeout_ms());
+}
+
+TEST_F(EmulatorTest, BurstyAutomationNeverOverlapsWrites) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+
+    // 20 HA calls in 2 s (temperature slider + remote sensor) on top of the polling cycles
+    for (int i = 0; i < 20; i++) {
+        if (i % 2) drv.queue_remote_temperature(20.0f + i * 0.5f);
+        else drv.queue_settings_write(18.0f + i / 2);
+        drv.run_until([]() { return false; }, 100);
+    }
+    ASSERT_TRUE(drv.run_cycles(2, 20000));
+
+    EXPECT_EQ(drv.unacked_overlaps(), 0u);
+    EXPECT_LT(drv.set_packets().size(), 20u);
+    EXPECT_EQ(drv.acks(), drv.set_packets().size());
+    EXPECT_EQ(hp.temp_encoded, 27 * 2 + 128);           // last values win
+    EXPECT_EQ(hp.remote_temp_encoded, 59 + 128);       // 29.5 °C
+    EXPECT_EQ(drv.nb_timed_out_cycles(), 0u);
+    std::printf("[  WRITE   ] 20 calls -> %zu SET packets, %u merged\n",
+        drv.set_packets().size(), drv.scheduler().get_coalesced_writes());
+}
+
+TEST_F(EmulatorTest, CommandLatencyCorrelatesAcksAndReadback) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+
+    // One setpoint change mid-cycle and one remote temperature, 10 times
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(drv.run_until([&]() { return drv.responses(0x03) > 0 && drv.cycle().isCycleRunning(); }, 5000));
+        drv.queue_settings_write(20.0f + (i % 2));
+        drv.queue_remote_temperature(21.0f + i * 0.5f);
+        ASSERT_TRUE(drv.run_cycles(2, 10000));
+    }
+
+    const auto& latency = drv.latency();
+    EXPECT_EQ(latency.bus().count(), drv.acks());
+    EXPECT_EQ(latency.to_ack().count(), 20u);
+    EXPECT_EQ(latency.unmatched_acks(), 0u);
+    EXPECT_EQ(latency.lost_acks(), 0u);
+    EXPECT_EQ(latency.outstanding(), 0u);
+    // 0x02 is polled every cycle: each settings write is confirmed by the next readback
+    EXPECT_EQ(latency.to_confirm().count(), 10u);
+    EXPECT_LE(latency.bus().max_ms(), 2 * INFO_EXCHANGE_WIRE_MS);
+    EXPECT_GE(latency.to_confirm().percentile(50), latency.to_ack().percentile(50));
+    std::printf("[ LATENCY  ] p95: write->ack %u ms, control->ack %u ms, control->0x02 %u ms\n",
+        latency.bus().percentile(95), latency.to_ack().percentile(95), latency.to_confirm().percentile(95));
+}
+
+TEST_F(EmulatorTest, SkippedWritesDoNotShiftAckAttribution) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.connect();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 1000));
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+
+    // Two writes skipped while the UART is down: nothing written, nothing outstanding
+    drv.set_uart_ready(false);
+    drv.queue_remote_temperature(22.0f);
+    drv.queue_settings_write(21.0f);
+    EXPECT_EQ(drv.latency().outstanding(), 0u);
+
+    // The next real write is the one its ACK is matched to, and is then confirmed by 0x02
+    drv.set_uart_ready(true);
+    drv.queue_settings_write(23.0f);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.acks() == 1; }, 2000));
+    ASSERT_TRUE(drv.run_cycles(1, 10000));
+    const auto& latency = drv.latency();
+    EXPECT_EQ(latency.to_ack().count(), 1u);
+    EXPECT_EQ(latency.unmatched_acks(), 0u);
+    EXPECT_EQ(latency.lost_acks(), 0u);
+    EXPECT_EQ(latency.outstanding(), 0u);
+    EXPECT_EQ(latency.to_confirm().count(), 1u);
+}
+
+TEST_F(EmulatorTest, UnpluggedUnitReconnectsWithBackoff) {
+    EmulatorConfig cfg;
+    cfg.accept_user_connect = false;                    // unit unplugged at boot
+    HeatPumpEmulator hp(cfg);
+    HostDriver drv(hp);
+    drv.start_handshake();
+    EXPECT_FALSE(drv.run_until([&]() { return drv.connected(); }, 30000));
+    const uint32_t sent_while_unplugged = drv.handshake().nb_sent();
+    // Old behaviour: one CONNECT per 10 s. Backoff: quick first retries, then at most one per cap + reply timeout
+    EXPECT_GE(sent_while_unplugged, 4u);
+    EXPECT_LE(sent_while_unplugged, 12u);
+
+    hp.config().accept_user_connect = true;             // plugged back in
+    const uint32_t back_ms = esphome::millis();
+    const esphome::HandshakeConfig hs;
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, hs.backoff_max_ms + hs.reply_timeout_ms + 500));
+    const uint32_t reconnect_ms = esphome::millis() - back_ms;
+    EXPECT_EQ(drv.handshake().attempts(), 0u);
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+    std::printf("[ CONNECT  ] %u CONNECT in 30 s unplugged, reconnected %u ms after replug\n",
+        sent_while_unplugged, reconnect_ms);
+
+    // Link lost while the unit is still there: back within the first backoff step
+    drv.lose_link();
+    const uint32_t lost_ms = esphome::millis();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 2000));
+    EXPECT_LE(esphome::millis() - lost_ms, hs.backoff_min_ms + 200);
+}
+
+TEST_F(EmulatorTest, InstallerProbeFallsBackToStandard) {
+    EmulatorConfig cfg;
+    cfg.accept_installer_connect = false;
+    HeatPumpEmulator hp(cfg);
+    HostDriver drv(hp);
+    drv.start_handshake(true);
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    EXPECT_EQ(drv.connect_reply(), 0x7A);
+    EXPECT_EQ(drv.connect_timeouts(), 1u);
+    EXPECT_TRUE(drv.handshake().installer_fallback_done());
+    EXPECT_LT(esphome::millis(), esphome::HandshakeConfig().installer_probe_ms + 500);
+}
+
+namespace {
+
+/// Publishes of 0x02 / 0x03 / 0x06 changes so far.
+struct Publishes {
+    uint32_t settings, room, status;
+    explicit Publishes(const HostDriver& drv)
+        : settings(drv.publishes(0x02)), room(drv.publishes(0x03)), status(drv.publishes(0x06)) {}
+};
+
+/// Drops the link, waits for the handshake to bring it back and for one full cycle.
+void bounce_link(HostDriver& drv) {
+    drv.lose_link();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+}
+
+} // namespace
+
+TEST_F(EmulatorTest, WarmReconnectPublishesOnlyRealChanges) {
+    HeatPumpEmulator hp;
+    HostDriver drv(hp);
+    drv.start_handshake();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    ASSERT_TRUE(drv.run_cycles(2, 10000));
+    const Publishes boot(drv);
+    EXPECT_EQ(boot.settings, 1u);
+    EXPECT_TRUE(drv.freshness().valid);
+
+    // Nothing changed while the link was down: nothing is published again
+    bounce_link(drv);
+    const Publishes warm(drv);
+    EXPECT_EQ(warm.settings, boot.settings);
+    EXPECT_EQ(warm.room, boot.room);
+    EXPECT_EQ(warm.status, boot.status);
+    EXPECT_FALSE(drv.freshness().stale);
+    EXPECT_EQ(drv.freshness().pending, 0u);
+
+    // Setpoint changed with the IR remote during the outage: only that reaches HA
+    drv.lose_link();
+    hp.temp_encoded = 0xAD;     // 22.5 °C
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    ASSERT_TRUE(drv.run_cycles(1, 5000));
+    EXPECT_EQ(drv.publishes(0x02), warm.settings + 1);
+    EXPECT_EQ(drv.publishes(0x03), warm.room);
+    EXPECT_EQ(drv.publishes(0x06), warm.status);
+}
+
+TEST_F(EmulatorTest, ColdReconnectResyncsSettings) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.warm_reconnect_window_ms = 0;
+    HostDriver drv(hp, cfg);
+    drv.start_handshake();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    ASSERT_TRUE(drv.run_cycles(2, 10000));
+    const Publishes boot(drv);
+
+    bounce_link(drv);
+    EXPECT_EQ(drv.publishes(0x02), boot.settings + 1);      // full 0x02 resync, as before
+    EXPECT_EQ(drv.publishes(0x03), boot.room);              // status was never reset on reconnect
+}
+
+// ════════════════════════════════════════════════════════════════
+// Response routing: one 256-entry table for requests, reply-only handlers and unknown codes
+// ════════════════════════════════════════════════════════════════
+
+namespace {
+
+cn105_protocol::FrameView reply_view(uint8_t* payload, uint8_t code) {
+    std::memset(payload, 0, RESPONSE_DATA_LEN);
+    payload[0] = code;
+    cn105_protocol::FrameView view;
+    view.command = 0x62;
+    view.payload = payload;
+    view.length = RESPONSE_DATA_LEN;
+    view.checksum_ok = true;
+    return view;
+}
+
+}  // namespace
+
+TEST_F(EmulatorTest, UnknownResponseCodesAreCountedNotRouted) {
+    std::vector<uint8_t> sent;
+    esphome::RequestScheduler scheduler([&](uint8_t code) { sent.push_back(code); });
+    static constexpr esphome::RequestDescriptor settings("settings", "Settings", 0x02);
+    scheduler.register_request(settings);
+
+    uint8_t payload[RESPONSE_DATA_LEN];
+    for (int i = 0; i < 3; i++) EXPECT_FALSE(scheduler.process_response(reply_view(payload, 0x77)));
+    EXPECT_FALSE(scheduler.process_response(reply_view(payload, 0x10)));
+    EXPECT_EQ(scheduler.get_unknown_responses(), 4u);
+    EXPECT_EQ(scheduler.get_last_unknown_code(), 0x10);
+
+    EXPECT_TRUE(scheduler.process_response(reply_view(payload, 0x02)));
+    EXPECT_EQ(scheduler.get_unknown_responses(), 4u);
+    EXPECT_TRUE(sent.empty());          // a reply outside a cycle sends nothing
+}
+
+TEST_F(EmulatorTest, ReplyOnlyHandlersShareTheRouteTable) {
+    esphome::RequestScheduler scheduler([](uint8_t) {});
+    const auto ignore = [](esphome::CN105Climate&, const cn105_protocol::FrameView&) {};
+    ASSERT_TRUE(scheduler.register_response_handler(0x10, ignore));
+    EXPECT_FALSE(scheduler.register_response_handler(0x10, ignore));     // already routed
+
+    uint8_t payload[RESPONSE_DATA_LEN];
+    EXPECT_TRUE(scheduler.process_response(reply_view(payload, 0x10)));
+    EXPECT_EQ(scheduler.get_unknown_responses(), 0u);
+    EXPECT_EQ(scheduler.get_effective_interval(0x10), 0u);                 // not a polled request
+    scheduler.disable_request(0x10);                                      // no request there: no-op
+
+    // A request registered later for the same code takes the route over
+    static constexpr esphome::RequestDescriptor polled("unknown10", "Unknown 0x10", 0x10, 3, 0, 5000);
+    scheduler.register_request(polled);
+    EXPECT_EQ(scheduler.get_effective_interval(0x10), 5000u);
+    EXPECT_TRUE(scheduler.process_response(reply_view(payload, 0x10)));
+
+    for (uint8_t i = 0; i < esphome::RequestScheduler::MAX_HANDLERS - 1; i++) {
+        EXPECT_TRUE(scheduler.register_response_handler(0xA0 + i, ignore));
+    }
+    EXPECT_FALSE(scheduler.register_response_handler(0xB0, ignore));     // handler table full
+
+    scheduler.clear_requests();
+    EXPECT_FALSE(scheduler.process_response(reply_view(payload, 0x10)));
+    EXPECT_TRUE(scheduler.register_response_handler(0x10, ignore));
+}
+
+// ════════════════════════════════════════════════════════════════
+// Request catalogue: constexpr descriptors + per-slot RequestState
+// ════════════════════════════════════════════════════════════════
+
+namespace {
+
+// Layout of the former InfoRequest (descriptor and state in one object, copied into a std::vector)
+struct LegacyInfoRequest {
+    const char* id;
+    const char* description;
+    uint8_t code, maxFailures, failures;
+    bool disabled, awaiting;
+    uint32_t soft_timeout_ms, interval_ms, last_request_time, timeout_at;
+    const char* log_tag;
+    esphome::PollClass poll_class;
+    uint32_t payload_hash;
+    uint8_t stable_count;
+    esphome::RequestDescriptor::CanSendFn canSend;
+    esphome::RequestDescriptor::ResponseFn onResponse;
+};
+
+// Same layout with 32-bit pointers, as on ESP32 / ESP8266
+struct LegacyInfoRequest32 {
+    uint32_t id, description;
+    uint8_t code, maxFailures, failures;
+    bool disabled, awaiting;
+    uint32_t soft_timeout_ms, interval_ms, last_request_time, timeout_at;
+    uint32_t log_tag;
+    esphome::PollClass poll_class;
+    uint32_t payload_hash;
+    uint8_t stable_count;
+    uint32_t canSend, onResponse;
+};
+
+struct CatalogueRam {
+    size_t legacy_heap;             // vector storage left allocated after registration
+    size_t legacy_allocated;        // every vector allocation made while registering (growth included)
+    size_t legacy_allocations;
+    size_t legacy_in_object;        // the std::vector itself
+    size_t now_in_object;           // descriptor pointers + RequestState array + count
+};
+
+template <typename Legacy>
+CatalogueRam catalogue_ram(size_t requests, size_t pointer_size, size_t vector_size) {
+    CatalogueRam ram{};
+    std::vector<Legacy> v;
+    size_t capacity = 0;
+    for (size_t i = 0; i < requests; i++) {
+        v.push_back(Legacy{});
+        if (v.capacity() != capacity) {
+            capacity = v.capacity();
+            ram.legacy_allocated += capacity * sizeof(Legacy);
+            ram.legacy_allocations++;
+        }
+    }
+    ram.legacy_heap = v.capacity() * sizeof(Legacy);
+    ram.legacy_in_object = vector_size;
+    ram.now_in_object = esphome::RequestScheduler::MAX_REQUESTS * (pointer_size + sizeof(esphome::RequestState)) + 1;
+    return ram;
+}
+
+void report_ram(const char* target, const CatalogueRam& ram) {
+    const long saved = long(ram.legacy_heap + ram.legacy_in_object) - long(ram.now_in_object);
+    std::printf("[  RAM     ] %-10s before: %zu B heap (%zu allocations, %zu B allocated) + %zu B vector"
+        " | after: 0 B heap + %zu B in RequestScheduler | saved %ld B, %zu allocations\n", target,
+        ram.legacy_heap, ram.legacy_allocations, ram.legacy_allocated, ram.legacy_in_object,
+        ram.now_in_object, saved, ram.legacy_allocations);
+}
+
+// The catalogue is a compile-time constant: nothing is built at setup
+static_assert(HostDriver::REQUESTS[0].code == 0x02 && HostDriver::REQUESTS[0].poll_class == esphome::PollClass::STRETCH_WHEN_STABLE,
+    "constexpr request descriptors");
+static_assert(std::is_trivially_copyable<esphome::RequestState>::value, "RequestState is plain data");
+
+}  // namespace
+
+TEST_F(EmulatorTest, RequestCatalogueRamSaving) {
+    // Mutable per-request data: the former InfoRequest minus what moved to flash
+    EXPECT_EQ(sizeof(esphome::RequestState), 20u);
+    EXPECT_EQ(sizeof(LegacyInfoRequest32), 56u);
+
+    const size_t n = HostDriver::REQUEST_COUNT;
+    const CatalogueRam esp = catalogue_ram<LegacyInfoRequest32>(n, 4, 12);
+    const CatalogueRam host = catalogue_ram<LegacyInfoRequest>(n, sizeof(void*), sizeof(std::vector<LegacyInfoRequest>));
+    report_ram("ESP (32b)", esp);
+    report_ram("host", host);
+
+    EXPECT_GT(esp.legacy_allocations, 1u);     // growth reallocations fragmenting the heap at boot
+    EXPECT_LT(esp.now_in_object, esp.legacy_heap + esp.legacy_in_object);
+    EXPECT_LT(host.now_in_object, host.legacy_heap + host.legacy_in_object);
+}
+
+TEST_F(EmulatorTest, CatalogueStateIsPerSlot) {
+    HeatPumpEmulator hp;
+    DriverConfig cfg;
+    cfg.hardware_settings_interval_ms = 30000;
+    HostDriver drv(hp, cfg);
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x20), 30000u);     // set_request_interval() over the descriptor's 0
+    EXPECT_EQ(drv.scheduler().get_effective_interval(0x02), 0u);
+
+    drv.start_handshake();
+    ASSERT_TRUE(drv.run_until([&]() { return drv.connected(); }, 3000));
+    ASSERT_TRUE(drv.run_cycles(2, 10000));
+    EXPECT_EQ(drv.responses(0x20), 1u);         // interval honoured from RequestState
+    EXPECT_EQ(drv.responses(0x02), 2u);
+    EXPECT_EQ(drv.responses(0x05), 0u);         // REQUEST_START_DISABLED
+}
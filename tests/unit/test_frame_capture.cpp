@@ -0,0 +1,157 @@
+/// test_frame_capture.cpp — Tests for the FrameCapture ring and its base64 dump.
+/// Deps: frame_capture.h
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "frame_capture.h"
+
+using namespace esphome;
+
+namespace {
+
+std::vector<uint8_t> base64_decode(const std::string& text) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+    std::vector<uint8_t> out;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : text) {
+        const int v = value(c);
+        if (v < 0) continue;        // '=' padding
+        acc = (acc << 6) | uint32_t(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<uint8_t>(acc >> bits));
+        }
+    }
+    return out;
+}
+
+std::vector<std::string> dump_lines(const FrameCapture& capture, uint32_t now_ms) {
+    std::vector<std::string> lines;
+    capture.dump_base64(now_ms, [&lines](const char* line) { lines.emplace_back(line); });
+    return lines;
+}
+
+std::vector<uint8_t> dump_blob(const FrameCapture& capture, uint32_t now_ms) {
+    std::string text;
+    for (const auto& line : dump_lines(capture, now_ms)) text += line;
+    return base64_decode(text);
+}
+
+uint32_t u32_at(const std::vector<uint8_t>& b, size_t i) {
+    return uint32_t(b[i]) | (uint32_t(b[i + 1]) << 8) | (uint32_t(b[i + 2]) << 16) | (uint32_t(b[i + 3]) << 24);
+}
+
+const uint8_t GET_SETTINGS[22] = {0xFC,0x42,0x01,0x30,0x10, 0x02,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0x7B};
+const uint8_t ACK[6] = {0xFC,0x61,0x01,0x30,0x10, 0x00};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Ring
+// ════════════════════════════════════════════════════════════════
+
+TEST(FrameCapture, DisabledUntilInit) {
+    FrameCapture capture;
+    capture.record(FrameDirection::RX, 10, ACK, sizeof(ACK));
+    EXPECT_EQ(capture.size(), 0u);
+    capture.init(0);
+    capture.record(FrameDirection::RX, 10, ACK, sizeof(ACK));
+    EXPECT_EQ(capture.size(), 0u);
+}
+
+TEST(FrameCapture, KeepsTheLastFramesOldestFirst) {
+    FrameCapture capture;
+    capture.init(4);
+    for (uint8_t i = 0; i < 6; i++) {
+        uint8_t frame[6] = {0xFC, 0x62, 0x01, 0x30, 0x10, i};
+        capture.record(i % 2 ? FrameDirection::TX : FrameDirection::RX, 1000u + i, frame, sizeof(frame));
+    }
+    EXPECT_EQ(capture.size(), 4u);
+    EXPECT_EQ(capture.dropped(), 2u);
+    for (uint16_t i = 0; i < 4; i++) {
+        EXPECT_EQ(capture.at(i).ms, 1002u + i);
+        EXPECT_EQ(capture.at(i).bytes[5], 2 + i);
+        EXPECT_EQ(capture.at(i).direction(), i % 2 ? FrameDirection::TX : FrameDirection::RX);
+    }
+    capture.clear();
+    EXPECT_EQ(capture.size(), 0u);
+    EXPECT_EQ(capture.dropped(), 0u);
+}
+
+TEST(FrameCapture, LongFramesAreTruncated) {
+    FrameCapture capture;
+    capture.init(2);
+    uint8_t longFrame[40] = {0xFC};
+    capture.record(FrameDirection::RX, 5, longFrame, sizeof(longFrame));
+    EXPECT_EQ(capture.at(0).length, CapturedFrame::MAX_BYTES);
+    EXPECT_TRUE(capture.at(0).truncated());
+}
+
+// ════════════════════════════════════════════════════════════════
+// Base64 dump
+// ════════════════════════════════════════════════════════════════
+
+TEST(FrameCapture, DumpRoundTrips) {
+    FrameCapture capture;
+    capture.init(8);
+    capture.record(FrameDirection::TX, 123456, GET_SETTINGS, sizeof(GET_SETTINGS));
+    capture.record(FrameDirection::RX, 123560, ACK, sizeof(ACK));
+
+    const auto blob = dump_blob(capture, 130000);
+    ASSERT_EQ(blob.size(), capture.blob_size());
+    EXPECT_EQ(blob[0], 'C');
+    EXPECT_EQ(blob[1], 'N');
+    EXPECT_EQ(blob[2], 'C');
+    EXPECT_EQ(blob[3], FrameCapture::FORMAT_VERSION);
+    EXPECT_EQ(blob[4] | (blob[5] << 8), 2);
+    EXPECT_EQ(u32_at(blob, 6), 130000u);
+    EXPECT_EQ(u32_at(blob, 10), 0u);
+
+    size_t pos = 14;
+    EXPECT_EQ(u32_at(blob, pos), 123456u);
+    EXPECT_EQ(blob[pos + 4], CapturedFrame::FLAG_TX);
+    ASSERT_EQ(blob[pos + 5], sizeof(GET_SETTINGS));
+    EXPECT_TRUE(std::equal(GET_SETTINGS, GET_SETTINGS + sizeof(GET_SETTINGS), blob.begin() + pos + 6));
+    pos += 6 + sizeof(GET_SETTINGS);
+    EXPECT_EQ(u32_at(blob, pos), 123560u);
+    EXPECT_EQ(blob[pos + 4], 0);
+    ASSERT_EQ(blob[pos + 5], sizeof(ACK));
+    EXPECT_TRUE(std::equal(ACK, ACK + sizeof(ACK), blob.begin() + pos + 6));
+}
+
+TEST(FrameCapture, DumpLinesAreBoundedAndPadded) {
+    FrameCapture capture;
+    capture.init(64);
+    for (uint32_t i = 0; i < 64; i++) capture.record(FrameDirection::RX, i, GET_SETTINGS, sizeof(GET_SETTINGS));
+
+    const auto lines = dump_lines(capture, 0);
+    ASSERT_GT(lines.size(), 1u);
+    size_t chars = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        EXPECT_LE(lines[i].size(), Base64Lines<int>::LINE_CHARS);
+        EXPECT_EQ(lines[i].size() % 4, 0u);
+        if (i + 1 < lines.size()) {
+            EXPECT_EQ(lines[i].size(), Base64Lines<int>::LINE_CHARS);
+        }
+        chars += lines[i].size();
+    }
+    EXPECT_EQ(chars, (capture.blob_size() + 2) / 3 * 4);
+    EXPECT_EQ(dump_blob(capture, 0).size(), capture.blob_size());
+}
+
+TEST(FrameCapture, EmptyDumpIsHeaderOnly) {
+    FrameCapture capture;
+    capture.init(4);
+    const auto blob = dump_blob(capture, 42);
+    EXPECT_EQ(blob.size(), 14u);
+    EXPECT_EQ(capture.blob_size(), 14u);
+}
@@ -4,6 +4,8 @@
 /// TDD: these tests were written BEFORE the FrameParser implementation.
 #include <gtest/gtest.h>
 #include "frame_parser.h"
+#include <algorithm>
+#include <vector>
 
 using namespace cn105_protocol;
 
@@ -199,3 +201,272 @@ TEST(FrameParser, SequentialFrames) {
     EXPECT_EQ(parser.data()[0], 0x03);  // room temp
     EXPECT_EQ(parser.data()[3], 0x0D);  // 23°C encoding A
 }
+
+// ════════════════════════════════════════════════════════════════
+// Bulk feed (one call per UART read_array chunk)
+// ════════════════════════════════════════════════════════════════
+
+namespace {
+
+const uint8_t BULK_SETTINGS[] = {
+    0xFC, 0x62, 0x01, 0x30, 0x10,
+    0x02, 0x00, 0x00, 0x01, 0x01, 0x1A, 0x03, 0x07,
+    0x00, 0x00, 0x03, 0xAB, 0x00, 0x00, 0x00, 0x00,
+    0x87
+};
+const uint8_t BULK_ROOMTEMP[] = {
+    0xFC, 0x62, 0x01, 0x30, 0x10,
+    0x03, 0x00, 0x00, 0x0D, 0x00, 0x00, 0xAE, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x9F
+};
+const uint8_t BULK_ACK[] = {0xFC, 0x7A, 0x01, 0x30, 0x01, 0x00, 0x54};
+
+struct SeenFrame {
+    uint8_t command;
+    uint8_t first_data;
+    int length;
+    bool checksum_ok;
+};
+
+std::vector<uint8_t> concat(std::initializer_list<std::pair<const uint8_t*, size_t>> parts) {
+    std::vector<uint8_t> out;
+    for (auto& p : parts) out.insert(out.end(), p.first, p.first + p.second);
+    return out;
+}
+
+} // namespace
+
+TEST(FrameParserBulk, SingleFrameInOneChunk) {
+    FrameParser parser;
+    std::vector<SeenFrame> seen;
+    size_t n = parser.feed(BULK_SETTINGS, sizeof(BULK_SETTINGS), [&](const FrameParser& p) {
+        seen.push_back({p.command(), p.data()[0], p.data_length(), p.checksum_valid()});
+    });
+    EXPECT_EQ(n, 1u);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].command, 0x62);
+    EXPECT_EQ(seen[0].first_data, 0x02);
+    EXPECT_EQ(seen[0].length, 16);
+    EXPECT_TRUE(seen[0].checksum_ok);
+    EXPECT_FALSE(parser.frame_complete());     // reset after the callback
+}
+
+TEST(FrameParserBulk, SeveralFramesAndGarbageInOneChunk) {
+    const uint8_t noise[] = {0x00, 0x13, 0xFF};
+    auto stream = concat({{noise, sizeof(noise)}, {BULK_SETTINGS, sizeof(BULK_SETTINGS)},
+                          {noise, sizeof(noise)}, {BULK_ROOMTEMP, sizeof(BULK_ROOMTEMP)},
+                          {BULK_ACK, sizeof(BULK_ACK)}});
+    FrameParser parser;
+    std::vector<SeenFrame> seen;
+    size_t n = parser.feed(stream.data(), stream.size(), [&](const FrameParser& p) {
+        seen.push_back({p.command(), p.data()[0], p.data_length(), p.checksum_valid()});
+    });
+    EXPECT_EQ(n, 3u);
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0].first_data, 0x02);
+    EXPECT_EQ(seen[1].first_data, 0x03);
+    EXPECT_EQ(seen[2].command, 0x7A);
+    for (auto& f : seen) EXPECT_TRUE(f.checksum_ok);
+}
+
+TEST(FrameParserBulk, FrameSplitAcrossChunksAtEveryOffset) {
+    for (size_t cut = 0; cut <= sizeof(BULK_ROOMTEMP); ++cut) {
+        FrameParser parser;
+        int frames = 0;
+        auto cb = [&](const FrameParser& p) {
+            frames++;
+            EXPECT_TRUE(p.checksum_valid()) << "cut at " << cut;
+            EXPECT_EQ(p.data()[3], 0x0D) << "cut at " << cut;
+        };
+        parser.feed(BULK_ROOMTEMP, cut, cb);
+        parser.feed(BULK_ROOMTEMP + cut, sizeof(BULK_ROOMTEMP) - cut, cb);
+        EXPECT_EQ(frames, 1) << "cut at " << cut;
+    }
+}
+
+TEST(FrameParserBulk, MatchesByteWiseParsing) {
+    // Same stream through both paths, with chunk sizes 1..stream length
+    const uint8_t noise[] = {0x42, 0xFC, 0x62, 0x01, 0x30, 0xFF};  // oversize length → rejected
+    auto stream = concat({{BULK_ACK, sizeof(BULK_ACK)}, {noise, sizeof(noise)},
+                          {BULK_SETTINGS, sizeof(BULK_SETTINGS)}, {BULK_ROOMTEMP, sizeof(BULK_ROOMTEMP)}});
+
+    std::vector<uint8_t> expected;
+    FrameParser byte_parser;
+    for (uint8_t b : stream) {
+        byte_parser.feed(b);
+        if (byte_parser.frame_complete()) {
+            expected.push_back(byte_parser.command());
+            expected.push_back(byte_parser.data()[0]);
+            byte_parser.reset();
+        }
+    }
+    ASSERT_EQ(expected.size(), 6u);
+
+    for (size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+        FrameParser parser;
+        std::vector<uint8_t> got;
+        for (size_t i = 0; i < stream.size(); i += chunk) {
+            size_t n = std::min(chunk, stream.size() - i);
+            parser.feed(stream.data() + i, n, [&](const FrameParser& p) {
+                got.push_back(p.command());
+                got.push_back(p.data()[0]);
+            });
+        }
+        EXPECT_EQ(got, expected) << "chunk size " << chunk;
+    }
+}
+
+TEST(FrameParserBulk, BadChecksumStillReported) {
+    const uint8_t frame[] = {0xFC, 0x7A, 0x01, 0x30, 0x01, 0x00, 0x55};
+    FrameParser parser;
+    bool ok = true;
+    EXPECT_EQ(parser.feed(frame, sizeof(frame), [&](const FrameParser& p) { ok = p.checksum_valid(); }), 1u);
+    EXPECT_FALSE(ok);
+}
+
+TEST(FrameParserBulk, NoStartByteConsumesNothing) {
+    const uint8_t garbage[] = {0x00, 0x01, 0x02, 0x03};
+    FrameParser parser;
+    EXPECT_EQ(parser.feed(garbage, sizeof(garbage), [](const FrameParser&) { FAIL(); }), 0u);
+    EXPECT_EQ(parser.feed(garbage, 0, [](const FrameParser&) { FAIL(); }), 0u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Resynchronization (header validation + rescan of buffered bytes)
+// ════════════════════════════════════════════════════════════════
+
+TEST(FrameParserResync, BadHeaderByteIsDropped) {
+    FrameParser parser;
+    const uint8_t bad[] = {0xFC, 0x62, 0x02};      // offset 2 must be 0x01
+    for (auto b : bad) parser.feed(b);
+    EXPECT_EQ(parser.drop_count(), 1u);
+    EXPECT_EQ(parser.resync_count(), 0u);
+
+    // Next frame parses normally
+    for (auto b : BULK_ACK) parser.feed(b);
+    EXPECT_TRUE(parser.frame_complete());
+    EXPECT_TRUE(parser.checksum_valid());
+}
+
+TEST(FrameParserResync, DoubledStartByteRecoversFrame) {
+    // Line glitch duplicates the start byte: FC FC 62 01 30 ...
+    // Without header validation the parser took 0x30 as the length and swallowed the frame.
+    FrameParser parser;
+    parser.feed(0xFC);
+    for (auto b : BULK_SETTINGS) parser.feed(b);
+    EXPECT_TRUE(parser.frame_complete());
+    EXPECT_TRUE(parser.checksum_valid());
+    EXPECT_EQ(parser.data()[0], 0x02);
+    EXPECT_EQ(parser.resync_count(), 1u);
+    EXPECT_EQ(parser.drop_count(), 0u);
+}
+
+TEST(FrameParserResync, OversizedLengthThatIsAStartByte) {
+    // Truncated header "FC 62 01 30" immediately followed by a connect ACK:
+    // the ACK's 0xFC lands in the length slot and must be replayed as a start byte.
+    FrameParser parser;
+    const uint8_t truncated[] = {0xFC, 0x62, 0x01, 0x30};
+    for (auto b : truncated) parser.feed(b);
+    for (auto b : BULK_ACK) parser.feed(b);
+    EXPECT_TRUE(parser.frame_complete());
+    EXPECT_TRUE(parser.checksum_valid());
+    EXPECT_EQ(parser.command(), 0x7A);
+    EXPECT_EQ(parser.resync_count(), 1u);
+}
+
+TEST(FrameParserResync, BadChecksumRescansBufferedBytes) {
+    // A settings frame cut short after 8 bytes, then a room temp response.
+    // The parser trusts len=0x10 and swallows the start of the room temp frame;
+    // the checksum fails and the swallowed bytes are rescanned.
+    const uint8_t cut[] = {0xFC, 0x62, 0x01, 0x30, 0x10, 0x02, 0x00, 0x00};
+    auto stream = concat({{cut, sizeof(cut)}, {BULK_ROOMTEMP, sizeof(BULK_ROOMTEMP)},
+                          {BULK_ACK, sizeof(BULK_ACK)}});
+    FrameParser parser;
+    std::vector<SeenFrame> seen;
+    parser.feed(stream.data(), stream.size(), [&](const FrameParser& p) {
+        seen.push_back({p.command(), p.data()[0], p.data_length(), p.checksum_valid()});
+    });
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_FALSE(seen[0].checksum_ok);      // corrupted frame is still reported
+    EXPECT_TRUE(seen[1].checksum_ok);
+    EXPECT_EQ(seen[1].first_data, 0x03);    // room temp recovered
+    EXPECT_TRUE(seen[2].checksum_ok);
+    EXPECT_EQ(seen[2].command, 0x7A);
+    EXPECT_EQ(parser.resync_count(), 1u);
+    EXPECT_EQ(parser.drop_count(), 0u);
+}
+
+TEST(FrameParserResync, BadChecksumWithoutStartByteIsDropped) {
+    const uint8_t frame[] = {0xFC, 0x7A, 0x01, 0x30, 0x01, 0x00, 0x55};
+    FrameParser parser;
+    parser.feed(frame, sizeof(frame), [](const FrameParser&) {});
+    EXPECT_EQ(parser.drop_count(), 1u);
+    EXPECT_EQ(parser.resync_count(), 0u);
+}
+
+TEST(FrameParserResync, SingleCorruptedByteCostsOnlyThatFrame) {
+    // Flip one byte at every position of a settings frame followed by a room temp frame:
+    // the room temp frame must always survive.
+    for (size_t pos = 0; pos < sizeof(BULK_SETTINGS); ++pos) {
+        for (uint8_t value : {uint8_t(0x00), uint8_t(0xFC), uint8_t(0xFF)}) {
+            auto stream = concat({{BULK_SETTINGS, sizeof(BULK_SETTINGS)}, {BULK_ROOMTEMP, sizeof(BULK_ROOMTEMP)},
+                                  {BULK_ACK, sizeof(BULK_ACK)}});
+            if (stream[pos] == value) continue;
+            stream[pos] = value;
+            FrameParser parser;
+            bool room_temp_ok = false;
+            parser.feed(stream.data(), stream.size(), [&](const FrameParser& p) {
+                if (p.checksum_valid() && p.command() == 0x62 && p.data()[0] == 0x03) room_temp_ok = true;
+            });
+            EXPECT_TRUE(room_temp_ok) << "corrupted byte " << pos << " -> 0x" << std::hex << int(value);
+        }
+    }
+}
+
+TEST(FrameParserResync, ByteWiseAndBulkResyncTheSameWay) {
+    // A cut settings frame (len 0x10) swallows a whole ACK, two bad headers and the start byte of a
+    // room temp frame. The checksum rescan completes the ACK with bytes still queued behind it:
+    // the byte-wise path must recover the same frames as the bulk path.
+    const uint8_t cut[] = {0xFC, 0x62, 0x01, 0x30, 0x10, 0x02, 0x00};
+    const uint8_t noise[] = {0xFC, 0x62, 0xFC, 0x7A, 0x01, 0x30, 0xFF};
+    auto stream = concat({{cut, sizeof(cut)}, {BULK_ACK, sizeof(BULK_ACK)}, {noise, sizeof(noise)},
+                          {BULK_ROOMTEMP, sizeof(BULK_ROOMTEMP)}, {BULK_SETTINGS, sizeof(BULK_SETTINGS)}});
+
+    FrameParser bulk;
+    std::vector<SeenFrame> bulk_seen;
+    bulk.feed(stream.data(), stream.size(), [&](const FrameParser& p) {
+        bulk_seen.push_back({p.command(), p.data()[0], p.data_length(), p.checksum_valid()});
+    });
+
+    FrameParser bytewise;
+    std::vector<SeenFrame> byte_seen;
+    for (uint8_t b : stream) {
+        bytewise.feed(b);
+        while (bytewise.frame_complete()) {
+            byte_seen.push_back({bytewise.command(), bytewise.data()[0], bytewise.data_length(),
+                                 bytewise.checksum_valid()});
+            bytewise.next();
+        }
+    }
+
+    ASSERT_EQ(bulk_seen.size(), 4u);
+    EXPECT_FALSE(bulk_seen[0].checksum_ok);
+    EXPECT_EQ(bulk_seen[1].command, 0x7A);
+    EXPECT_TRUE(bulk_seen[1].checksum_ok);
+    EXPECT_EQ(bulk_seen[2].first_data, 0x03);
+    EXPECT_TRUE(bulk_seen[2].checksum_ok);
+    EXPECT_EQ(bulk_seen[3].first_data, 0x02);
+    EXPECT_TRUE(bulk_seen[3].checksum_ok);
+    EXPECT_EQ(bulk.resync_count(), 2u);     // bad checksum, then FC 62 FC
+    EXPECT_EQ(bulk.drop_count(), 1u);       // FC 7A 01 30 FF: oversized, no start byte to recover
+    ASSERT_EQ(byte_seen.size(), bulk_seen.size());
+    for (size_t i = 0; i < bulk_seen.size(); ++i) {
+        EXPECT_EQ(byte_seen[i].command, bulk_seen[i].command) << "frame " << i;
+        EXPECT_EQ(byte_seen[i].first_data, bulk_seen[i].first_data) << "frame " << i;
+        EXPECT_EQ(byte_seen[i].length, bulk_seen[i].length) << "frame " << i;
+        EXPECT_EQ(byte_seen[i].checksum_ok, bulk_seen[i].checksum_ok) << "frame " << i;
+    }
+    EXPECT_EQ(bytewise.resync_count(), bulk.resync_count());
+    EXPECT_EQ(bytewise.drop_count(), bulk.drop_count());
+}
@@ -0,0 +1,116 @@
+/// test_frame_queue.cpp — Tests for FrameQueue (RX frame ring) and the FrameView handed to decoders.
+/// Deps: frame_queue.h, frame_parser.h, cn105_types.h
+#include <gtest/gtest.h>
+#include <vector>
+#include "frame_queue.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+// Real 0x62/0x02 settings response and 0x61 ACK (see test_real_frames.cpp)
+const uint8_t SETTINGS[22] = {
+    0xFC,0x62,0x01,0x30,0x10, 0x02,0x00,0x00,0x00,0x01,0x1C,0x00,0x00,0x00,0x00,0x03,0xA7,0x00,0x00,0x00,0x00, 0x94
+};
+const uint8_t ACK[22] = {
+    0xFC,0x61,0x01,0x30,0x10, 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, 0x5E
+};
+
+/// Feeds `frame` byte by byte and pushes it into `queue` once complete.
+template <size_t N>
+bool push_frame(FrameQueue<N>& queue, const uint8_t* frame, size_t len, uint32_t ts) {
+    FrameParser parser;
+    for (size_t i = 0; i < len; i++) parser.feed(frame[i]);
+    EXPECT_TRUE(parser.frame_complete());
+    return queue.push(parser, ts);
+}
+
+} // namespace
+
+TEST(FrameQueue, StartsEmpty) {
+    FrameQueue<4> q;
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.full());
+    EXPECT_EQ(q.size(), 0u);
+    EXPECT_EQ(q.capacity(), 4u);
+    q.pop();    // no-op on empty
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(FrameQueue, ViewExposesHeaderPayloadAndTimestamp) {
+    FrameQueue<4> q;
+    ASSERT_TRUE(push_frame(q, SETTINGS, sizeof(SETTINGS), 1234));
+    FrameView v = q.front();
+    EXPECT_EQ(v.command, 0x62);
+    EXPECT_EQ(v.length, 0x10);
+    EXPECT_EQ(v.timestamp_ms, 1234u);
+    EXPECT_TRUE(v.checksum_ok);
+    EXPECT_EQ(v.raw_length, sizeof(SETTINGS));
+    EXPECT_EQ(0, memcmp(v.raw, SETTINGS, sizeof(SETTINGS)));
+    EXPECT_EQ(v[0], 0x02);
+    EXPECT_EQ(v[5], 0x1C);
+    EXPECT_EQ(v.payload, v.raw + 5);
+}
+
+TEST(FrameQueue, SlotIsIndependentOfParser) {
+    // The parser buffer is reused for the next frame; the queued copy must not change
+    FrameQueue<4> q;
+    FrameParser parser;
+    for (uint8_t b : SETTINGS) parser.feed(b);
+    ASSERT_TRUE(q.push(parser, 0));
+    parser.reset();
+    for (uint8_t b : ACK) parser.feed(b);
+    FrameView v = q.front();
+    EXPECT_EQ(v.command, 0x62);
+    EXPECT_EQ(v[0], 0x02);
+}
+
+TEST(FrameQueue, FifoOrderAndWrapAround) {
+    FrameQueue<2> q;
+    std::vector<uint8_t> seen;
+    for (uint32_t i = 0; i < 5; i++) {
+        ASSERT_TRUE(push_frame(q, (i % 2) ? ACK : SETTINGS, 22, i));
+        FrameView v = q.front();
+        EXPECT_EQ(v.timestamp_ms, i);
+        seen.push_back(v.command);
+        q.pop();
+    }
+    EXPECT_EQ(seen, (std::vector<uint8_t>{0x62, 0x61, 0x62, 0x61, 0x62}));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(FrameQueue, OverflowDropsNewestAndCounts) {
+    FrameQueue<2> q;
+    EXPECT_TRUE(push_frame(q, SETTINGS, sizeof(SETTINGS), 1));
+    EXPECT_TRUE(push_frame(q, ACK, sizeof(ACK), 2));
+    EXPECT_TRUE(q.full());
+    EXPECT_FALSE(push_frame(q, SETTINGS, sizeof(SETTINGS), 3));
+    EXPECT_EQ(q.overflow_count(), 1u);
+    EXPECT_EQ(q.front().timestamp_ms, 1u);
+    q.pop();
+    EXPECT_EQ(q.front().timestamp_ms, 2u);
+}
+
+TEST(FrameQueue, BadChecksumIsCarriedInView) {
+    uint8_t bad[22];
+    memcpy(bad, SETTINGS, sizeof(bad));
+    bad[21] ^= 0xFF;
+    FrameQueue<4> q;
+    ASSERT_TRUE(push_frame(q, bad, sizeof(bad), 0));
+    EXPECT_FALSE(q.front().checksum_ok);
+}
+
+TEST(FrameQueue, BulkFeedQueuesEveryFrame) {
+    uint8_t stream[44];
+    memcpy(stream, SETTINGS, 22);
+    memcpy(stream + 22, ACK, 22);
+    FrameParser parser;
+    FrameQueue<4> q;
+    parser.feed(stream, sizeof(stream), [&](const FrameParser& p) { q.push(p, 7); });
+    ASSERT_EQ(q.size(), 2u);
+    EXPECT_EQ(q.front().command, 0x62);
+    q.pop();
+    EXPECT_EQ(q.front().command, 0x61);
+    q.clear();
+    EXPECT_TRUE(q.empty());
+}
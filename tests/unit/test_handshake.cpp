@@ -0,0 +1,147 @@
+/// test_handshake.cpp — Tests for HandshakeEngine (non-blocking CONNECT retries, backoff, installer probe).
+/// Deps: handshake.h
+#include <gtest/gtest.h>
+#include "handshake.h"
+
+using namespace esphome;
+using Action = HandshakeEngine::Action;
+
+namespace {
+
+/// Polls every ms from `now` until something other than NONE happens (or `max_ms` elapsed).
+Action poll_until_action(HandshakeEngine& hs, uint32_t& now, uint32_t max_ms) {
+    for (uint32_t end = now + max_ms; now <= end; now++) {
+        Action a = hs.poll(now);
+        if (a != Action::NONE) return a;
+    }
+    return Action::NONE;
+}
+
+} // namespace
+
+TEST(HandshakeEngine, IdleUntilStarted) {
+    HandshakeEngine hs;
+    EXPECT_FALSE(hs.in_progress());
+    EXPECT_EQ(hs.poll(0), Action::NONE);
+    EXPECT_EQ(hs.poll(100000), Action::NONE);
+}
+
+TEST(HandshakeEngine, BeginSendsOnFirstPoll) {
+    HandshakeEngine hs;
+    hs.begin(1000);
+    EXPECT_TRUE(hs.in_progress());
+    EXPECT_EQ(hs.poll(1000), Action::SEND_CONNECT);
+    EXPECT_EQ(hs.connect_command(), 0x5A);
+    hs.sent(1000);
+    EXPECT_TRUE(hs.awaiting_reply());
+    EXPECT_EQ(hs.poll(1000 + HandshakeConfig().reply_timeout_ms - 1), Action::NONE);
+    EXPECT_EQ(hs.poll(1000 + HandshakeConfig().reply_timeout_ms), Action::TIMED_OUT);
+    EXPECT_EQ(hs.attempts(), 1u);
+}
+
+TEST(HandshakeEngine, ReplyStopsRetries) {
+    HandshakeEngine hs;
+    hs.begin(0);
+    ASSERT_EQ(hs.poll(0), Action::SEND_CONNECT);
+    hs.sent(0);
+    hs.connected(120);
+    EXPECT_FALSE(hs.in_progress());
+    EXPECT_EQ(hs.last_connect_ms(), 120u);
+    EXPECT_EQ(hs.poll(60000), Action::NONE);
+}
+
+TEST(HandshakeEngine, BackoffDoublesUpToCap) {
+    HandshakeEngine hs;
+    const HandshakeConfig cfg;
+    EXPECT_EQ(hs.backoff_ms(0), cfg.backoff_min_ms);
+    EXPECT_EQ(hs.backoff_ms(1), cfg.backoff_min_ms * 2);
+    EXPECT_EQ(hs.backoff_ms(2), cfg.backoff_min_ms * 4);
+    EXPECT_EQ(hs.backoff_ms(10), cfg.backoff_max_ms);
+    EXPECT_EQ(hs.backoff_ms(1000), cfg.backoff_max_ms);
+}
+
+TEST(HandshakeEngine, RetryDelaysStayWithinJitterBounds) {
+    // Unit unplugged: every CONNECT times out, delays grow and stay in [d/2, d]
+    HandshakeEngine hs;
+    uint32_t now = 0;
+    hs.begin(now);
+    for (uint32_t attempt = 0; attempt < 8; attempt++) {
+        ASSERT_EQ(poll_until_action(hs, now, 20000), Action::SEND_CONNECT);
+        hs.sent(now);
+        ASSERT_EQ(poll_until_action(hs, now, 20000), Action::TIMED_OUT);
+        const uint32_t d = hs.backoff_ms(attempt + 1);
+        EXPECT_GE(hs.last_delay_ms(), d / 2) << "attempt " << attempt;
+        EXPECT_LE(hs.last_delay_ms(), d) << "attempt " << attempt;
+        EXPECT_EQ(hs.next_attempt_in(now), hs.last_delay_ms());
+    }
+    EXPECT_EQ(hs.nb_sent(), 8u);
+}
+
+TEST(HandshakeEngine, JitterDiffersBetweenSeeds) {
+    HandshakeEngine a(HandshakeConfig(), 1);
+    HandshakeEngine b(HandshakeConfig(), 2);
+    a.begin(0);
+    b.begin(0);
+    a.retry_later(0);
+    b.retry_later(0);
+    a.retry_later(0);
+    b.retry_later(0);
+    EXPECT_NE(a.last_delay_ms(), b.last_delay_ms());
+}
+
+TEST(HandshakeEngine, InstallerProbeFallsBackAtOnce) {
+    HandshakeEngine hs;
+    hs.set_installer_mode(true);
+    hs.begin(0);
+    ASSERT_EQ(hs.poll(0), Action::SEND_CONNECT);
+    EXPECT_EQ(hs.connect_command(), 0x5B);
+    hs.sent(0);
+    EXPECT_EQ(hs.poll(HandshakeConfig().installer_probe_ms - 1), Action::NONE);
+    EXPECT_EQ(hs.poll(HandshakeConfig().installer_probe_ms), Action::PROBE_FAILED);
+    EXPECT_TRUE(hs.installer_fallback_done());
+    EXPECT_EQ(hs.attempts(), 0u);                    // the probe does not count as a backoff step
+    EXPECT_EQ(hs.poll(HandshakeConfig().installer_probe_ms), Action::SEND_CONNECT);
+    EXPECT_EQ(hs.connect_command(), 0x5A);
+    hs.sent(HandshakeConfig().installer_probe_ms);
+    EXPECT_EQ(hs.poll(HandshakeConfig().installer_probe_ms * 2), Action::NONE);     // full reply timeout now
+}
+
+TEST(HandshakeEngine, InstallerKeptWhenAnswered) {
+    HandshakeEngine hs;
+    hs.set_installer_mode(true);
+    hs.begin(0);
+    ASSERT_EQ(hs.poll(0), Action::SEND_CONNECT);
+    hs.sent(0);
+    hs.connected(100);
+    hs.link_lost(5000);
+    uint32_t now = 5000;
+    ASSERT_EQ(poll_until_action(hs, now, 20000), Action::SEND_CONNECT);
+    EXPECT_EQ(hs.connect_command(), 0x5B);
+}
+
+TEST(HandshakeEngine, LinkLostIgnoredWhileInProgress) {
+    HandshakeEngine hs;
+    hs.begin(0);
+    ASSERT_EQ(hs.poll(0), Action::SEND_CONNECT);
+    hs.sent(0);
+    hs.link_lost(10);                               // writePacket() failing during the handshake
+    EXPECT_TRUE(hs.awaiting_reply());
+}
+
+TEST(HandshakeEngine, LinkLostRetriesAfterFirstStep) {
+    HandshakeEngine hs;
+    hs.link_lost(1000);
+    EXPECT_EQ(hs.poll(1000), Action::NONE);
+    EXPECT_GE(hs.next_attempt_in(1000), HandshakeConfig().backoff_min_ms / 2);
+    EXPECT_LE(hs.next_attempt_in(1000), HandshakeConfig().backoff_min_ms);
+}
+
+TEST(HandshakeEngine, DeadlinesSurviveMillisWrap) {
+    HandshakeEngine hs;
+    const uint32_t start = 0xFFFFFF00u;
+    hs.begin(start);
+    ASSERT_EQ(hs.poll(start), Action::SEND_CONNECT);
+    hs.sent(start);
+    EXPECT_EQ(hs.poll(start + 100), Action::NONE);      // wrapped, still before the deadline
+    EXPECT_EQ(hs.poll(start + HandshakeConfig().reply_timeout_ms), Action::TIMED_OUT);
+}
@@ -0,0 +1,183 @@
+/// test_loop_profiler.cpp — Tests for PhaseStats and LoopProfiler (per-phase loop() timings).
+/// Deps: loop_profiler.h, mocks/esphome.h (virtual micros() for CN105_PROFILE_PHASE)
+#include <gtest/gtest.h>
+#include <cstring>
+#include "esphome.h"
+#define USE_CN105_LOOP_PROFILER
+#include "loop_profiler.h"
+
+using namespace esphome;
+
+// ════════════════════════════════════════════════════════════════
+// PhaseStats
+// ════════════════════════════════════════════════════════════════
+
+TEST(PhaseStats, EmptyReportsZero) {
+    PhaseStats s;
+    EXPECT_EQ(s.count(), 0u);
+    EXPECT_EQ(s.min_us(), 0u);
+    EXPECT_EQ(s.mean_us(), 0u);
+    EXPECT_EQ(s.percentile(99), 0u);
+}
+
+TEST(PhaseStats, MinAvgMax) {
+    PhaseStats s;
+    s.record(40);
+    s.record(10);
+    s.record(100);
+    EXPECT_EQ(s.min_us(), 10u);
+    EXPECT_EQ(s.max_us(), 100u);
+    EXPECT_EQ(s.mean_us(), 50u);
+}
+
+TEST(PhaseStats, P99IgnoresRareOutlierBelowOnePercent) {
+    PhaseStats s;
+    for (int i = 0; i < 999; i++) s.record(100);    // ≤ 128 µs bucket
+    s.record(45000);                                 // one slow loop
+    EXPECT_EQ(s.percentile(99), 128u);
+    EXPECT_EQ(s.percentile(100), 45000u);
+    EXPECT_EQ(s.max_us(), 45000u);
+}
+
+TEST(PhaseStats, PercentileCappedByMax) {
+    PhaseStats s;
+    s.record(20);                                    // ≤ 32 µs bucket
+    EXPECT_EQ(s.percentile(99), 20u);
+    s.record(5000000);                               // overflow bucket
+    EXPECT_EQ(s.bucket(PhaseStats::BUCKETS - 1), 1u);
+    EXPECT_EQ(s.percentile(100), 5000000u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// LoopProfiler
+// ════════════════════════════════════════════════════════════════
+
+TEST(LoopProfiler, NestedPhasesRecordOwnTime) {
+    // decode 0..500 µs, with a publish 100..400 and a packet debug 150..250 inside the publish
+    LoopProfiler p;
+    p.loop_begin(0);
+    p.enter(LoopPhase::DECODE, 0);
+    p.enter(LoopPhase::PUBLISH, 100);
+    p.enter(LoopPhase::PACKET_DEBUG, 150);
+    p.leave(250);
+    p.leave(400);
+    p.leave(500);
+    p.loop_end(600);
+    EXPECT_EQ(p.depth(), 0u);
+    EXPECT_EQ(p.stats(LoopPhase::DECODE).max_us(), 200u);
+    EXPECT_EQ(p.stats(LoopPhase::PUBLISH).max_us(), 200u);
+    EXPECT_EQ(p.stats(LoopPhase::PACKET_DEBUG).max_us(), 100u);
+    EXPECT_EQ(p.stats(LoopPhase::LOOP).max_us(), 600u);
+}
+
+TEST(LoopProfiler, RepeatedPhaseGivesOneSamplePerEntry) {
+    LoopProfiler p;
+    for (uint32_t t = 0; t < 3; t++) {
+        p.enter(LoopPhase::DECODE, t * 1000);
+        p.leave(t * 1000 + 30 * (t + 1));
+    }
+    EXPECT_EQ(p.stats(LoopPhase::DECODE).count(), 3u);
+    EXPECT_EQ(p.stats(LoopPhase::DECODE).min_us(), 30u);
+    EXPECT_EQ(p.stats(LoopPhase::DECODE).max_us(), 90u);
+}
+
+TEST(LoopProfiler, TooDeepNestingChargesEnclosingPhase) {
+    LoopProfiler p;
+    for (uint8_t i = 0; i < LoopProfiler::MAX_DEPTH; i++) p.enter(LoopPhase::SCHEDULER, 0);
+    p.enter(LoopPhase::WRITE, 0);                   // beyond MAX_DEPTH: ignored
+    p.leave(50);
+    EXPECT_EQ(p.stats(LoopPhase::WRITE).count(), 0u);
+    EXPECT_EQ(p.depth(), LoopProfiler::MAX_DEPTH);
+    for (uint8_t i = 0; i < LoopProfiler::MAX_DEPTH; i++) p.leave(50);
+    EXPECT_EQ(p.depth(), 0u);
+    EXPECT_EQ(p.stats(LoopPhase::SCHEDULER).max_us(), 50u);
+}
+
+TEST(LoopProfiler, WindowReportsOnceThenResets) {
+    LoopProfiler p;
+    p.set_window_ms(1000);
+    EXPECT_FALSE(p.window_elapsed(5000));           // first call opens the window
+    p.loop_begin(0);
+    p.loop_end(70);
+    EXPECT_FALSE(p.window_elapsed(5999));
+    EXPECT_TRUE(p.window_elapsed(6000));
+    p.start_window(6000);
+    EXPECT_EQ(p.stats(LoopPhase::LOOP).count(), 0u);
+    EXPECT_FALSE(p.window_elapsed(6500));
+}
+
+TEST(LoopProfiler, SlowestPhaseSkipsLoopTotal) {
+    LoopProfiler p;
+    p.loop_begin(0);
+    p.enter(LoopPhase::UART_READ, 0);
+    p.leave(800);
+    p.enter(LoopPhase::PUBLISH, 800);
+    p.leave(35000);
+    p.loop_end(35000);
+    EXPECT_EQ(p.slowest_phase(), LoopPhase::PUBLISH);
+}
+
+TEST(LoopProfiler, FormatListsPhasesWithSamplesOnly) {
+    LoopProfiler p;
+    p.loop_begin(0);
+    p.enter(LoopPhase::UART_READ, 0);
+    p.leave(20);
+    p.loop_end(30);
+    char buf[256];
+    p.format(buf, sizeof(buf));
+    EXPECT_STREQ(buf, "loop 30/30/30/30 read 20/20/20/20");
+}
+
+TEST(LoopProfiler, FormatWithEveryPhaseFitsTextSensor) {
+    // Worst case short of a blocked loop: every phase between 1 µs and 99.999 ms
+    LoopProfiler p;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(LoopPhase::COUNT); i++) {
+        p.enter(static_cast<LoopPhase>(i), 0);
+        p.leave(99999);
+        p.enter(static_cast<LoopPhase>(i), 0);
+        p.leave(1);
+    }
+    char buf[256];
+    const size_t n = p.format(buf, sizeof(buf));
+    EXPECT_EQ(n, std::strlen(buf));
+    EXPECT_LT(n, 255u);
+    EXPECT_NE(std::strstr(buf, "pktdbg"), nullptr);  // last phase still present
+
+    char small[40];
+    p.format(small, sizeof(small));                  // entries that do not fit are dropped whole
+    EXPECT_STREQ(small, "loop 1/50000/99999/99999");
+}
+
+// ════════════════════════════════════════════════════════════════
+// CN105_PROFILE_PHASE (virtual micros())
+// ════════════════════════════════════════════════════════════════
+
+namespace {
+
+struct ProfiledComponent {
+    LoopProfiler loopProfiler_;
+
+    void write() {
+        CN105_PROFILE_PHASE(WRITE);
+        host_clock_us() += 250;
+    }
+    void decode() {
+        CN105_PROFILE_PHASE(DECODE);
+        host_clock_us() += 100;
+        this->write();
+    }
+};
+
+} // namespace
+
+TEST(LoopProfiler, ScopedMarkersUseMicros) {
+    ProfiledComponent c;
+    {
+        ScopedLoopTotal total(c.loopProfiler_, micros);
+        c.decode();
+        host_clock_us() += 50;
+    }
+    EXPECT_EQ(c.loopProfiler_.stats(LoopPhase::DECODE).max_us(), 100u);
+    EXPECT_EQ(c.loopProfiler_.stats(LoopPhase::WRITE).max_us(), 250u);
+    EXPECT_EQ(c.loopProfiler_.stats(LoopPhase::LOOP).max_us(), 400u);
+}
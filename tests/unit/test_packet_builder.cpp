@@ -0,0 +1,126 @@
+/// test_packet_builder.cpp — Non-regression tests for build_set_packet() against real SET frames.
+/// Deps: packet_builder.h, cn105_protocol.h, cn105_types.h
+#include <gtest/gtest.h>
+#include "packet_builder.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+void expect_packet(const uint8_t* actual, const uint8_t* expected21) {
+    for (int i = 0; i < 21; i++) {
+        EXPECT_EQ(actual[i], expected21[i]) << "byte " << i;
+    }
+    EXPECT_EQ(actual[21], checksum(expected21, 21));
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Real captured SET packets (same frames as test_real_frames.cpp)
+// ════════════════════════════════════════════════════════════════
+
+TEST(PacketBuilder, Heat_21_5_EncodingB) {
+    const uint8_t expected[] = {0xFC,0x41,0x01,0x30,0x10, 0x01,0x07,0x00,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xAB,0x00};
+    SetRequest req;
+    req.power = Power::ON;
+    req.mode = Mode::HEAT;
+    req.temperature = 21.5f;
+    req.temperature_encoding_b = true;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    expect_packet(pkt, expected);
+    EXPECT_EQ(pkt[21], 0xC9);
+}
+
+TEST(PacketBuilder, FanOnly_19_5_EncodingB) {
+    const uint8_t expected[] = {0xFC,0x41,0x01,0x30,0x10, 0x01,0x07,0x00,0x01,0x07,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xA7,0x00};
+    SetRequest req;
+    req.power = Power::ON;
+    req.mode = Mode::FAN;
+    req.temperature = 19.5f;
+    req.temperature_encoding_b = true;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    expect_packet(pkt, expected);
+}
+
+TEST(PacketBuilder, VaneUp) {
+    const uint8_t expected[] = {0xFC,0x41,0x01,0x30,0x10, 0x01,0x10,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    SetRequest req;
+    req.vane = Vane::POS_2;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    expect_packet(pkt, expected);
+    EXPECT_EQ(pkt[21], 0x6B);
+}
+
+TEST(PacketBuilder, FanMedium) {
+    const uint8_t expected[] = {0xFC,0x41,0x01,0x30,0x10, 0x01,0x08,0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    SetRequest req;
+    req.fan = Fan::SPEED_2;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    expect_packet(pkt, expected);
+    EXPECT_EQ(pkt[21], 0x72);
+}
+
+TEST(PacketBuilder, VaneSwingIsCaseInsensitive) {
+    SetRequest req;
+    req.vane = *VANE_TABLE.find(VANE_MAP, "swing");     // label from a select / YAML lambda
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    EXPECT_EQ(pkt[12], 0x07);
+    EXPECT_EQ(pkt[21], 0x66);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Field encoding
+// ════════════════════════════════════════════════════════════════
+
+TEST(PacketBuilder, EmptyRequestIsHeaderOnly) {
+    SetRequest req;
+    uint8_t pkt[PACKET_LEN];
+    memset(pkt, 0xEE, sizeof(pkt));
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    for (int i = 0; i < HEADER_LEN; i++) EXPECT_EQ(pkt[i], HEADER[i]);
+    for (int i = HEADER_LEN; i < 21; i++) EXPECT_EQ(pkt[i], 0x00);
+    EXPECT_EQ(pkt[21], checksum(pkt, 21));
+}
+
+TEST(PacketBuilder, TemperatureEncodingA) {
+    SetRequest req;
+    req.temperature = 22;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    EXPECT_EQ(pkt[10], 0x09);      // TEMP_MAP: 22 → 0x09
+    EXPECT_EQ(pkt[19], 0x00);
+    EXPECT_EQ(pkt[6], CONTROL_PACKET_1[2]);
+}
+
+TEST(PacketBuilder, WideVaneWithAdjustAndSplitHorizontal) {
+    SetRequest req;
+    req.wide_vane = WideVane::FAR_LEFT;
+    req.wide_vane_adj = true;
+    req.split_horizontal_vane = true;
+    uint8_t pkt[PACKET_LEN];
+    EXPECT_EQ(build_set_packet(pkt, req), 0);
+    EXPECT_EQ(pkt[7], CONTROL_PACKET_2[0]);
+    EXPECT_EQ(pkt[18], 0x81);
+    EXPECT_EQ(pkt[16], 0x01);
+}
+
+TEST(PacketBuilder, InvalidFieldsAreRejectedAndLeftOut) {
+    SetRequest req;
+    req.power = static_cast<Power>(7);
+    req.mode = Mode::HEAT;
+    req.temperature = 35;       // outside TEMP_MAP (16..31)
+    req.fan = static_cast<Fan>(9);
+    uint8_t pkt[PACKET_LEN];
+    uint8_t rejected = build_set_packet(pkt, req);
+    EXPECT_EQ(rejected, SET_FIELD_POWER | SET_FIELD_TEMPERATURE | SET_FIELD_FAN);
+    EXPECT_EQ(pkt[6], CONTROL_PACKET_1[1]);
+    EXPECT_EQ(pkt[8], 0x00);
+    EXPECT_EQ(pkt[9], 0x01);
+    EXPECT_EQ(pkt[11], 0x00);
+}
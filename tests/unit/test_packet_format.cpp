@@ -0,0 +1,116 @@
+/// test_packet_format.cpp — Tests for the allocation-free packet debug formatter against the former snprintf output.
+/// Deps: packet_format.h
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include "packet_format.h"
+
+using namespace cn105_protocol;
+
+namespace {
+
+/// Former hpPacketDebug() line (std::string + snprintf per byte), kept as the reference.
+std::string legacy_packet_debug(const uint8_t* packet, unsigned int length, const char* log_prefix) {
+    char byteBuf[4];
+    if (length < 5) {
+        std::string output;
+        for (unsigned int i = 0; i < length; i++) {
+            snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
+            output += byteBuf;
+        }
+        return "SHORT: " + output;
+    }
+    char fullLabel[20];
+    snprintf(fullLabel, sizeof(fullLabel), "%s%s", packet_type_label(packet, length), packet_sub_label(packet, length));
+    std::string headerStr, dataStr, csStr;
+    for (unsigned int i = 0; i < 5 && i < length; i++) {
+        snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
+        headerStr += byteBuf;
+    }
+    if (length > 6) {
+        for (unsigned int i = 5; i < length - 1; i++) {
+            snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
+            dataStr += byteBuf;
+        }
+    }
+    snprintf(byteBuf, sizeof(byteBuf), "%02X", packet[length - 1]);
+    csStr = byteBuf;
+    char line[256];
+    snprintf(line, sizeof(line), "%s|%s|->[%s](%s) <%s>", log_prefix, headerStr.c_str(), dataStr.c_str(), csStr.c_str(), fullLabel);
+    return line;
+}
+
+std::string format(const uint8_t* packet, size_t length, const char* prefix) {
+    char line[PACKET_DEBUG_LEN];
+    const size_t n = format_packet_debug(line, sizeof(line), packet, length, prefix);
+    EXPECT_EQ(n, strlen(line));
+    return line;
+}
+
+const uint8_t SETTINGS_REPLY[22] = {0xFC,0x62,0x01,0x30,0x10, 0x02,0x00,0x00,0x01,0x01,0x0A,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x59};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Packet lines
+// ════════════════════════════════════════════════════════════════
+
+TEST(PacketFormat, SettingsReply) {
+    EXPECT_EQ(format(SETTINGS_REPLY, 22, ""),
+        "|FC 62 01 30 10 |->[02 00 00 01 01 0A 00 00 00 00 00 00 00 00 00 00 ](59) <RESPONSE:Settings>");
+}
+
+TEST(PacketFormat, MatchesLegacyOutput) {
+    const uint8_t connect[8] = {0xFC,0x5A,0x01,0x30,0x02, 0xCA,0x01,0xA8};
+    const uint8_t unknown[6] = {0x00,0x11,0x22,0x33,0x44, 0x55};
+    const uint8_t shortFrame[3] = {0xFC,0x62,0x01};
+    EXPECT_EQ(format(SETTINGS_REPLY, 22, "READ"), legacy_packet_debug(SETTINGS_REPLY, 22, "READ"));
+    EXPECT_EQ(format(connect, 8, "CONN"), legacy_packet_debug(connect, 8, "CONN"));
+    EXPECT_EQ(format(unknown, 6, ""), legacy_packet_debug(unknown, 6, ""));
+    EXPECT_EQ(format(shortFrame, 3, "READ"), legacy_packet_debug(shortFrame, 3, "READ"));
+
+    uint8_t frame[22];
+    memcpy(frame, SETTINGS_REPLY, sizeof(frame));
+    for (int code = 0; code < 256; code++) {
+        frame[1] = static_cast<uint8_t>(code);
+        frame[5] = static_cast<uint8_t>(code);
+        EXPECT_EQ(format(frame, 22, "X"), legacy_packet_debug(frame, 22, "X")) << code;
+    }
+}
+
+TEST(PacketFormat, FiveByteFrameDoesNotReadPastTheEnd) {
+    const uint8_t header[5] = {0xFC,0x41,0x01,0x30,0x10};
+    EXPECT_EQ(format(header, 5, ""), "|FC 41 01 30 10 |->[](10) <SET>");
+}
+
+TEST(PacketFormat, TruncatesWithoutOverflow) {
+    char line[24];
+    memset(line, 0x7F, sizeof(line));
+    const size_t n = format_packet_debug(line, 20, SETTINGS_REPLY, 22, "READ");
+    EXPECT_EQ(n, 19u);
+    EXPECT_EQ(std::string(line), "READ|FC 62 01 30 10");
+    EXPECT_EQ(line[20], 0x7F);
+    EXPECT_EQ(format_packet_debug(line, 0, SETTINGS_REPLY, 22, "READ"), 0u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Functions payload
+// ════════════════════════════════════════════════════════════════
+
+TEST(PacketFormat, FunctionsMatchLegacyOutput) {
+    uint8_t payload[16] = {0x20};
+    for (int i = 1; i < 16; i++) payload[i] = static_cast<uint8_t>(i * 17);
+    std::string expected;
+    char buffer[16];
+    for (int i = 1; i < 16; i++) {
+        snprintf(buffer, sizeof(buffer), " %d:%d", ((payload[i] >> 2) & 0xff) + 100, payload[i] & 3);
+        expected += buffer;
+    }
+    char line[PACKET_DEBUG_LEN];
+    format_functions_debug(line, sizeof(line), payload, 16);
+    EXPECT_EQ(std::string(line), expected);
+
+    const uint8_t maxed[2] = {0x22, 0xFF};
+    format_functions_debug(line, sizeof(line), maxed, 2);
+    EXPECT_STREQ(line, " 163:3");
+}
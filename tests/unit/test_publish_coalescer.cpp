@@ -0,0 +1,92 @@
+/// test_publish_coalescer.cpp — Tests for Deadband and PublishCoalescer (end-of-cycle publishing).
+/// Deps: publish_coalescer.h
+#include <gtest/gtest.h>
+#include "publish_coalescer.h"
+
+using namespace esphome;
+
+// ════════════════════════════════════════════════════════════════
+// Deadband
+// ════════════════════════════════════════════════════════════════
+
+TEST(Deadband, DefaultPublishesAnyChange) {
+    Deadband d;
+    EXPECT_FALSE(d.exceeded(21.5f, 21.5f));
+    EXPECT_TRUE(d.exceeded(21.5f, 21.6f));
+}
+
+TEST(Deadband, AbsoluteThresholdIsExclusive) {
+    Deadband d{ 0.5f, 0.0f };
+    EXPECT_FALSE(d.exceeded(5.0f, 5.5f));           // OAT flipping by one half degree
+    EXPECT_FALSE(d.exceeded(5.0f, 4.5f));
+    EXPECT_TRUE(d.exceeded(5.0f, 6.0f));
+}
+
+TEST(Deadband, RelativeUsesLastValue) {
+    Deadband d{ 0.0f, 0.05f };
+    EXPECT_FALSE(d.exceeded(600.0f, 630.0f));       // 5 % of 600 W
+    EXPECT_TRUE(d.exceeded(600.0f, 631.0f));
+    EXPECT_TRUE(d.exceeded(0.0f, 1.0f));            // relative band is 0 around 0
+}
+
+TEST(Deadband, LargerOfBothApplies) {
+    Deadband d{ 10.0f, 0.05f };
+    EXPECT_FALSE(d.exceeded(100.0f, 109.0f));       // absolute wins at low power
+    EXPECT_FALSE(d.exceeded(1000.0f, 1049.0f));     // relative wins at high power
+    EXPECT_TRUE(d.exceeded(1000.0f, 1051.0f));
+}
+
+TEST(Deadband, NanTransitionsAlwaysPublish) {
+    Deadband d{ 100.0f, 0.0f };
+    EXPECT_TRUE(d.exceeded(NAN, 3.0f));
+    EXPECT_TRUE(d.exceeded(3.0f, NAN));
+    EXPECT_FALSE(d.exceeded(NAN, NAN));
+}
+
+// ════════════════════════════════════════════════════════════════
+// PublishCoalescer
+// ════════════════════════════════════════════════════════════════
+
+TEST(PublishCoalescer, MarksAreMergedUntilTaken) {
+    // 0x03 then 0x06 in the same cycle: one climate publish
+    PublishCoalescer c;
+    EXPECT_FALSE(c.pending());
+    c.mark(PublishField::CLIMATE);
+    c.mark(PublishField::INPUT_POWER);
+    c.mark(PublishField::CLIMATE);
+    EXPECT_TRUE(c.is_dirty(PublishField::CLIMATE));
+    const uint16_t dirty = c.take();
+    EXPECT_EQ(dirty, PublishCoalescer::bit(PublishField::CLIMATE) | PublishCoalescer::bit(PublishField::INPUT_POWER));
+    EXPECT_FALSE(c.pending());
+    EXPECT_EQ(c.take(), 0u);
+    EXPECT_EQ(c.flushes(), 1u);
+}
+
+TEST(PublishCoalescer, FirstValueAlwaysPublished) {
+    PublishCoalescer c;
+    c.set_deadband(PublishField::INPUT_POWER, 1000.0f, 0.0f);
+    EXPECT_TRUE(c.should_publish(PublishField::INPUT_POWER, 0.0f));
+}
+
+TEST(PublishCoalescer, DeadbandMeasuredFromLastPublishedValue) {
+    // Input power jittering by a few watts, then drifting: published once it left the band
+    PublishCoalescer c;
+    c.set_deadband(PublishField::INPUT_POWER, 5.0f, 0.0f);
+    c.published(PublishField::INPUT_POWER, 400.0f);
+    EXPECT_FALSE(c.should_publish(PublishField::INPUT_POWER, 403.0f));
+    EXPECT_FALSE(c.should_publish(PublishField::INPUT_POWER, 397.0f));
+    EXPECT_FALSE(c.should_publish(PublishField::INPUT_POWER, 405.0f));
+    EXPECT_TRUE(c.should_publish(PublishField::INPUT_POWER, 406.0f));
+    EXPECT_EQ(c.suppressed(), 3u);
+    EXPECT_EQ(c.publishes(PublishField::INPUT_POWER), 1u);
+}
+
+TEST(PublishCoalescer, DeadbandsArePerField) {
+    PublishCoalescer c;
+    c.set_deadband(PublishField::OUTSIDE_AIR_TEMPERATURE, 0.5f, 0.0f);
+    c.published(PublishField::OUTSIDE_AIR_TEMPERATURE, 4.0f);
+    c.published(PublishField::KWH, 4.0f);
+    EXPECT_FALSE(c.should_publish(PublishField::OUTSIDE_AIR_TEMPERATURE, 4.5f));
+    EXPECT_TRUE(c.should_publish(PublishField::KWH, 4.1f));
+    EXPECT_FLOAT_EQ(c.deadband(PublishField::KWH).absolute, 0.0f);
+}
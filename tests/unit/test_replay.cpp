@@ -0,0 +1,227 @@
+/// test_replay.cpp — Tests for the capture replay harness (log / dump readers, decoders, state trace).
+/// Deps: replay/replay.h, replay/capture_reader.h, frame_capture.h, esphome_stubs.h
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "esphome_stubs.h"
+#include "replay/replay.h"
+
+using namespace cn105_replay;
+using namespace cn105_protocol;
+
+namespace {
+
+std::vector<CaptureFrame> read_lines(CaptureReader& reader, const std::vector<std::string>& lines) {
+    std::vector<CaptureFrame> frames;
+    for (const auto& line : lines) {
+        reader.line(line.data(), line.size(), [&frames](const CaptureFrame& f) { frames.push_back(f); });
+    }
+    return frames;
+}
+
+struct Trace {
+    std::vector<std::string> lines;
+    void operator()(const char* text, size_t len) { lines.emplace_back(text, len); }
+};
+
+std::vector<std::string> replay(const std::vector<std::string>& log, ReplayOptions options = {}) {
+    Trace trace;
+    Replayer<Trace> replayer(trace, options);
+    CaptureReader reader;
+    for (const auto& frame : read_lines(reader, log)) replayer.frame(frame);
+    return trace.lines;
+}
+
+const char* SETTINGS_OFF_HEAT_19_5 =
+    "[23:59:58.520][D][READ:057]: |FC 62 01 30 10 |->[02 00 00 00 01 1C 00 00 00 00 03 A7 00 00 00 00 ](94) <RESPONSE:Settings>";
+const char* SETTINGS_ON_HEAT_21_5 =
+    "[00:00:01.120][D][READ:057]: |FC 62 01 30 10 |->[02 00 00 01 01 1A 00 00 00 00 03 AB 00 00 00 00 ](91) <RESPONSE:Settings>";
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// Packet debug lines
+// ════════════════════════════════════════════════════════════════
+
+TEST(ReplayReader, EsphomeLogLine) {
+    CaptureReader reader;
+    const auto frames = read_lines(reader, { SETTINGS_OFF_HEAT_19_5 });
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].ms, ((23u * 60 + 59) * 60 + 58) * 1000u + 520u);
+    EXPECT_EQ(frames[0].line, 1u);
+    EXPECT_EQ(frames[0].direction, Direction::RX);
+    ASSERT_EQ(frames[0].length, 22);
+    EXPECT_EQ(frames[0].bytes[0], 0xFC);
+    EXPECT_EQ(frames[0].bytes[5], 0x02);
+    EXPECT_EQ(frames[0].bytes[21], 0x94);
+}
+
+TEST(ReplayReader, OtherFormats) {
+    CaptureReader reader;
+    const auto frames = read_lines(reader, {
+        "\033[0;36m[D][WRITE:087]: |FC 5A 01 30 02 |->[CA 01 ](A8) <CONNECT>\033[0m\r\n",     // colours, no clock
+        "[14:04:58][D][READ:057]: |FC 7A 01 30 01 |->[00 ](54) <UNKNOWN>",                    // seconds only
+        "READ |FC 61 01 30 10 |->[00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ](5E) <GET>",
+        "FC 62 01 30 10 09 00 00 00 01 00 00 00 00 00 00 00 00 00 00 00 53",
+    });
+    ASSERT_EQ(frames.size(), 4u);
+    EXPECT_EQ(frames[0].ms, CaptureFrame::UNKNOWN_MS);
+    EXPECT_EQ(frames[0].direction, Direction::TX);
+    EXPECT_EQ(frames[0].length, 8);
+    EXPECT_EQ(frames[1].ms, ((14u * 60 + 4) * 60 + 58) * 1000u);
+    EXPECT_EQ(frames[1].direction, Direction::RX);
+    EXPECT_EQ(frames[2].bytes[1], 0x61);
+    EXPECT_EQ(frames[3].length, 22);
+    EXPECT_EQ(frames[3].bytes[9], 0x01);
+}
+
+TEST(ReplayReader, DuplicateTagsAndNoiseAreSkipped) {
+    CaptureReader reader;
+    const auto frames = read_lines(reader, {
+        "[23:59:58.011][D][CN105_CONN:026]: |FC 5A 01 30 02 |->[CA 01 ](A8) <CONNECT>",
+        "[00:00:00.101][D][WRITE_SETTINGS:328]: |FC 41 01 30 10 |->[01 07 00 01 01 00 00 00 00 00 00 00 00 00 AB 00 ](C9) <SET:Start>",
+        "[00:00:00.221][D][ACK:569]: |FC 61 01 30 10 |->[00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ](5E) <GET>",
+        "[23:59:59.500][I][CN105:412]: Cycle ended in 1490 ms",
+        "[D][READ:057]: SHORT: FC 62 ",
+        "",
+    });
+    EXPECT_TRUE(frames.empty());
+    EXPECT_EQ(reader.lines(), 6u);
+    EXPECT_EQ(reader.packet_lines(), 0u);
+}
+
+TEST(ReplayReader, MalformedHexIsCounted) {
+    CaptureReader reader;
+    const auto frames = read_lines(reader, {
+        "[D][READ:057]: |FC 62 01 30 1 |->[02 ](94) <RESPONSE>",     // single digit
+        "[D][READ:057]: |FC 62 01 |->[](94) <RESPONSE>",              // too short for a frame
+    });
+    EXPECT_TRUE(frames.empty());
+    EXPECT_EQ(reader.malformed(), 2u);
+}
+
+TEST(ReplayReader, ClockRollsOverMidnight) {
+    CaptureReader reader;
+    const auto frames = read_lines(reader, { SETTINGS_OFF_HEAT_19_5, SETTINGS_ON_HEAT_21_5 });
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[1].ms - frames[0].ms, 2600u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// FrameCapture dumps
+// ════════════════════════════════════════════════════════════════
+
+TEST(ReplayReader, FrameCaptureDumpInLog) {
+    const uint8_t request[22] = {0xFC,0x42,0x01,0x30,0x10, 0x02,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0x7B};
+    const uint8_t ack[22] = {0xFC,0x61,0x01,0x30,0x10, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0x5E};
+    esphome::FrameCapture capture;
+    capture.init(16);
+    for (uint32_t i = 0; i < 10; i++) {
+        capture.record(esphome::FrameDirection::TX, 1000 + i * 200, request, sizeof(request));
+        capture.record(esphome::FrameDirection::RX, 1100 + i * 200, ack, sizeof(ack));
+    }
+    std::vector<std::string> log = { "[10:00:00.000][W][CN105_CAPTURE:413]: BEGIN 16/16 frames (4 dropped), 462 bytes, base64:" };
+    capture.dump_base64(5000, [&log](const char* line) { log.push_back(std::string("[10:00:00.001][W][CN105_CAPTURE:415]: ") + line); });
+    log.push_back("[10:00:00.002][W][CN105_CAPTURE:416]: END");
+
+    CaptureReader reader;
+    const auto frames = read_lines(reader, log);
+    ASSERT_EQ(frames.size(), 16u);
+    EXPECT_EQ(reader.dump_frames(), 16u);
+    EXPECT_EQ(frames[0].ms, 1400u);                 // oldest frame still in the ring: device millis()
+    EXPECT_EQ(frames[0].direction, Direction::TX);
+    EXPECT_EQ(frames[1].direction, Direction::RX);
+    EXPECT_EQ(frames[15].ms, 2900u);
+    EXPECT_EQ(frames[15].line, log.size());
+    EXPECT_EQ(0, memcmp(frames[1].bytes, ack, sizeof(ack)));
+}
+
+TEST(ReplayReader, TruncatedBlobIsRejected) {
+    const uint8_t blob[] = {'C','N','C',1, 2,0, 0,0,0,0, 0,0,0,0, 10,0,0,0, 0x80, 6, 0xFC,0x61};
+    size_t frames = 0;
+    EXPECT_FALSE(parse_capture_blob(blob, sizeof(blob), [&frames](const CaptureFrame&) { frames++; }));
+    const uint8_t wrong_version[14] = {'C','N','C',9};
+    EXPECT_FALSE(parse_capture_blob(wrong_version, sizeof(wrong_version), [&frames](const CaptureFrame&) { frames++; }));
+    EXPECT_EQ(frames, 0u);
+}
+
+// ════════════════════════════════════════════════════════════════
+// Decoders
+// ════════════════════════════════════════════════════════════════
+
+TEST(ReplayDecoders, SettingsMatchRealFrames) {
+    const uint8_t fan2VaneUp[] = {0x02,0x00,0x00,0x01,0x01,0x1A,0x03,0x02,0x00,0x00,0x03,0xAB,0x00,0x00,0x00,0x00};
+    const heatpumpSettings s = decode_settings(fan2VaneUp, heatpumpSettings{});
+    EXPECT_EQ(s.power, Power::ON);
+    EXPECT_EQ(s.mode, Mode::HEAT);
+    EXPECT_FLOAT_EQ(s.temperature, 21.5f);
+    EXPECT_EQ(s.fan, Fan::SPEED_2);
+    EXPECT_EQ(s.vane, Vane::POS_2);
+    EXPECT_FALSE(s.iSee);
+}
+
+TEST(ReplayDecoders, UnknownByteKeepsPreviousValue) {
+    uint8_t data[16] = {0x02,0x00,0x00,0x7E,0x01,0x1A,0x00,0x00,0x00,0x00,0x00,0xAB};
+    heatpumpSettings previous{};
+    previous.power = Power::ON;
+    EXPECT_EQ(decode_settings(data, previous).power, Power::ON);
+}
+
+TEST(ReplayDecoders, RoomAndOperating) {
+    const uint8_t room[16] = {0x03,0x00,0x00,0x0D,0x00,0x00,0xAE,0x00,0x00,0x00,0x00,0x00,0x00,0x3C};
+    const heatpumpStatus r = decode_room_temperature(room, heatpumpStatus{});
+    EXPECT_FLOAT_EQ(r.roomTemperature, 23.0f);
+    EXPECT_TRUE(std::isnan(r.outsideAirTemperature));
+    EXPECT_FLOAT_EQ(r.runtimeHours, 1.0f);
+
+    const uint8_t running[16] = {0x06,0x00,0x00,0x1A,0x01,0x01,0x90,0x00,0x2A};
+    const heatpumpStatus o = decode_operating(running, r, false);
+    EXPECT_TRUE(o.operating);
+    EXPECT_FLOAT_EQ(o.compressorFrequency, 26.0f);
+    EXPECT_FLOAT_EQ(o.inputPower, 400.0f);
+    EXPECT_FLOAT_EQ(o.kWh, 4.2f);
+    EXPECT_FLOAT_EQ(o.roomTemperature, 23.0f);      // carried over, like the component
+}
+
+// ════════════════════════════════════════════════════════════════
+// State trace
+// ════════════════════════════════════════════════════════════════
+
+TEST(ReplayTrace, OneLinePerChange) {
+    const auto trace = replay({ SETTINGS_OFF_HEAT_19_5, SETTINGS_OFF_HEAT_19_5, SETTINGS_ON_HEAT_21_5 });
+    ASSERT_EQ(trace.size(), 2u);
+    EXPECT_EQ(trace[0],
+        "{\"t\":86398520,\"line\":1,\"dir\":\"rx\",\"kind\":\"settings\","
+        "\"changed\":[\"power\",\"mode\",\"temperature\",\"fan\",\"vane\",\"wide_vane\"],"
+        "\"power\":\"OFF\",\"mode\":\"HEAT\",\"temperature\":19.5,\"fan\":\"AUTO\",\"vane\":\"AUTO\",\"wide_vane\":\"|\",\"isee\":false}\n");
+    EXPECT_EQ(trace[1],
+        "{\"t\":86401120,\"line\":3,\"dir\":\"rx\",\"kind\":\"settings\",\"changed\":[\"power\",\"temperature\"],"
+        "\"power\":\"ON\",\"mode\":\"HEAT\",\"temperature\":21.5,\"fan\":\"AUTO\",\"vane\":\"AUTO\",\"wide_vane\":\"|\",\"isee\":false}\n");
+}
+
+TEST(ReplayTrace, AllFramesTracesUnchangedReplies) {
+    ReplayOptions options;
+    options.all_frames = true;
+    EXPECT_EQ(replay({ SETTINGS_OFF_HEAT_19_5, SETTINGS_OFF_HEAT_19_5 }, options).size(), 2u);
+}
+
+TEST(ReplayTrace, BadChecksumIsTracedAndIgnored) {
+    Trace trace;
+    Replayer<Trace> replayer(trace);
+    CaptureReader reader;
+    for (const auto& frame : read_lines(reader, {
+        "[D][READ:057]: |FC 62 01 30 10 |->[02 00 00 01 01 1A 00 00 00 00 03 AB 00 00 00 00 ](CB) <RESPONSE:Settings>" })) {
+        replayer.frame(frame);
+    }
+    ASSERT_EQ(trace.lines.size(), 1u);
+    EXPECT_EQ(trace.lines[0].find("{\"line\":1,\"dir\":\"rx\",\"kind\":\"bad_checksum\""), 0u);
+    EXPECT_EQ(replayer.rejected(), 1u);
+    EXPECT_EQ(replayer.settings().power, Power::UNSET);
+}
+
+TEST(ReplayTrace, WritesAreTraced) {
+    const auto trace = replay({
+        "[00:00:00.100][D][WRITE:087]: |FC 41 01 30 10 |->[01 07 00 01 01 00 00 00 00 00 00 00 00 00 AB 00 ](C9) <SET:Start>" });
+    ASSERT_EQ(trace.size(), 1u);
+    EXPECT_EQ(trace[0], "{\"t\":100,\"line\":1,\"dir\":\"tx\",\"kind\":\"set\",\"data\":\"0107000101000000000000000000AB00\"}\n");
+}
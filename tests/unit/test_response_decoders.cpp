@@ -0,0 +1,162 @@
+/// test_response_decoders.cpp — Pure 0x62 payload decoders against real captured replies and edge bytes.
+/// Deps: response_decoders.h, cn105_types.h
+///
+/// Payloads are the data[] part (data[0] = reply code) of the frames in test_real_frames.cpp.
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include "response_decoders.h"
+
+using namespace cn105_protocol;
+
+// ════════════════════════════════════════════════════════════════
+// 0x02 settings
+// ════════════════════════════════════════════════════════════════
+
+TEST(DecodeSettings, BootState_OFF_HEAT_19_5) {
+    const uint8_t data[] = {0x02,0x00,0x00,0x00,0x01,0x1C,0x00,0x00,0x00,0x00,0x03,0xA7,0x00,0x00,0x00,0x00};
+    const SettingsFrame f = decode_settings(data);
+    EXPECT_EQ(f.power, Power::OFF);
+    EXPECT_EQ(f.mode, Mode::HEAT);
+    EXPECT_FALSE(f.isee);
+    EXPECT_TRUE(f.temperature_encoding_b);
+    EXPECT_FLOAT_EQ(f.temperature, 19.5f);
+    EXPECT_EQ(f.fan, Fan::AUTO);
+    EXPECT_EQ(f.vane, Vane::AUTO);
+    EXPECT_TRUE(f.wide_vane_reported);
+    EXPECT_EQ(f.wide_vane, WideVane::CENTER);
+    EXPECT_FALSE(f.wide_vane_adjust);
+    EXPECT_EQ(f.airflow_control, AirflowControl::EVEN);
+}
+
+TEST(DecodeSettings, Fan2_VaneSwing) {
+    const uint8_t data[] = {0x02,0x00,0x00,0x01,0x01,0x1A,0x03,0x07,0x00,0x00,0x03,0xAB,0x00,0x00,0x00,0x00};
+    const SettingsFrame f = decode_settings(data);
+    EXPECT_EQ(f.power, Power::ON);
+    EXPECT_FLOAT_EQ(f.temperature, 21.5f);
+    EXPECT_EQ(f.fan, Fan::SPEED_2);
+    EXPECT_EQ(f.vane, Vane::SWING);
+}
+
+TEST(DecodeSettings, EncodingAFallback) {
+    // data[11] == 0: data[5] through TEMP_MAP (0x0A → 21 °C)
+    const uint8_t data[] = {0x02,0x00,0x00,0x01,0x01,0x0A,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    const SettingsFrame f = decode_settings(data);
+    EXPECT_FALSE(f.temperature_encoding_b);
+    EXPECT_FLOAT_EQ(f.temperature, 21.0f);
+    EXPECT_FALSE(f.wide_vane_reported);
+    EXPECT_EQ(f.wide_vane, WideVane::UNSET);
+}
+
+TEST(DecodeSettings, UnknownBytesAreUnset) {
+    const uint8_t data[] = {0x02,0x00,0x00,0x07,0x06,0x1F,0x04,0x06,0x00,0x00,0x0F,0x00,0x00,0x00,0x00,0x00};
+    const SettingsFrame f = decode_settings(data);
+    EXPECT_EQ(f.power, Power::UNSET);
+    EXPECT_EQ(f.mode, Mode::UNSET);
+    EXPECT_TRUE(std::isnan(f.temperature));
+    EXPECT_EQ(f.fan, Fan::UNSET);
+    EXPECT_EQ(f.vane, Vane::UNSET);
+    EXPECT_EQ(f.wide_vane, WideVane::UNSET);
+}
+
+TEST(DecodeSettings, ISeeAirflowAndHumidity) {
+    // Mode byte 0x09 = HEAT + i-See; data[10] 0x80 = adjust flag with airflow control in data[14]
+    const uint8_t data[] = {0x02,0x00,0x00,0x01,0x09,0x00,0x00,0x00,0x00,0x00,0x80,0xAB,0x37,0x00,0x02,0x00};
+    const SettingsFrame f = decode_settings(data);
+    EXPECT_TRUE(f.isee);
+    EXPECT_EQ(f.mode, Mode::HEAT);
+    EXPECT_TRUE(f.wide_vane_adjust);
+    EXPECT_EQ(f.airflow_control, AirflowControl::DIRECT);
+    EXPECT_EQ(f.target_humidity, 0x37);
+
+    // Same bytes without i-See: airflow reported as even
+    uint8_t no_isee[sizeof(data)];
+    memcpy(no_isee, data, sizeof(data));
+    no_isee[4] = 0x01;
+    EXPECT_EQ(decode_settings(no_isee).airflow_control, AirflowControl::EVEN);
+}
+
+// ════════════════════════════════════════════════════════════════
+// 0x03 room temperature / 0x06 status / 0x09 stage
+// ════════════════════════════════════════════════════════════════
+
+TEST(DecodeRoomTemperature, BothEncodings_23C) {
+    uint8_t data[] = {0x03,0x00,0x00,0x0D,0x00,0x00,0xAE,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    RoomTemperatureFrame f = decode_room_temperature(data);
+    EXPECT_TRUE(f.room_encoding_b);
+    EXPECT_FLOAT_EQ(f.room_temperature, 23.0f);
+    EXPECT_TRUE(std::isnan(f.outside_air_temperature));
+
+    data[6] = 0x00;
+    f = decode_room_temperature(data);
+    EXPECT_FALSE(f.room_encoding_b);
+    EXPECT_FLOAT_EQ(f.room_temperature, 23.0f);
+}
+
+TEST(DecodeRoomTemperature, OutsideAirAndRuntime) {
+    // data[5] 0x8A → 5 °C outside, data[11..13] = 0x000E10 minutes = 60 h
+    const uint8_t data[] = {0x03,0x00,0x00,0x0D,0x00,0x8A,0xAE,0x00,0x00,0x00,0x00,0x00,0x0E,0x10,0x00,0x00};
+    const RoomTemperatureFrame f = decode_room_temperature(data);
+    EXPECT_FLOAT_EQ(f.outside_air_temperature, 5.0f);
+    EXPECT_FLOAT_EQ(f.runtime_hours, 60.0f);
+}
+
+TEST(DecodeStatus, CompressorZeroWhenNotOperating) {
+    uint8_t data[] = {0x06,0x00,0x00,0x2A,0x00,0x01,0xF4,0x00,0x7B,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    StatusFrame f = decode_status(data);
+    EXPECT_FALSE(f.operating);
+    EXPECT_EQ(f.compressor_frequency, 0);
+    EXPECT_EQ(f.raw_input_power, 500);
+    EXPECT_EQ(f.raw_energy, 123);
+
+    data[4] = 0x01;
+    f = decode_status(data);
+    EXPECT_TRUE(f.operating);
+    EXPECT_EQ(f.compressor_frequency, 42);
+}
+
+TEST(DecodeStatus, Units) {
+    EXPECT_FLOAT_EQ(input_power_to_W(500, false), 500.0f);
+    EXPECT_NEAR(input_power_to_W(293, true), 999.8f, 0.1f);
+    EXPECT_FLOAT_EQ(energy_usage_to_kWh(123, false), 12.3f);
+    EXPECT_NEAR(energy_usage_to_kWh(3412, true), 1000.0f, 0.1f);
+}
+
+TEST(DecodeStage, RealPowerReplies) {
+    uint8_t data[] = {0x09,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    StageFrame f = decode_stage(data);
+    EXPECT_EQ(f.sub_mode, SubMode::NORMAL);
+    EXPECT_EQ(f.stage, Stage::STAGE_IDLE);
+    EXPECT_EQ(f.auto_sub_mode, AutoSubMode::AUTO_OFF);
+
+    data[4] = 0x01;
+    EXPECT_EQ(decode_stage(data).stage, Stage::STAGE_LOW);
+    data[4] = 0x7F;
+    EXPECT_EQ(decode_stage(data).stage, Stage::UNSET);
+}
+
+// ════════════════════════════════════════════════════════════════
+// 0x42 HVAC options / 0x04 error info
+// ════════════════════════════════════════════════════════════════
+
+TEST(DecodeHvacOptions, Flags) {
+    const uint8_t data[] = {0x42,0x01,0x00,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    const HvacOptionsFrame f = decode_hvac_options(data);
+    EXPECT_TRUE(f.air_purifier);
+    EXPECT_FALSE(f.night_mode);
+    EXPECT_TRUE(f.circulator);
+}
+
+TEST(DecodeErrorInfo, ReportingFlagIsNotAnError) {
+    uint8_t data[] = {0x04,0x00,0x00,0x00,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    ErrorInfoFrame f = decode_error_info(data);
+    EXPECT_TRUE(f.reporting_flag);
+    EXPECT_FALSE(f.has_error());
+
+    data[4] = 0x85;
+    data[5] = 0x02;
+    f = decode_error_info(data);
+    EXPECT_TRUE(f.has_error());
+    EXPECT_EQ(f.code, 0x05);
+    EXPECT_EQ(f.sub_code, 0x02);
+}
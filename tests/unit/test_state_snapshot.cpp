@@ -0,0 +1,120 @@
+/// test_state_snapshot.cpp — Tests for the field-level change masks and VersionedState.
+/// Deps: state_snapshot.h, cn105_types.h, esphome_stubs.h
+#include <gtest/gtest.h>
+#include "esphome_stubs.h"
+#include "state_snapshot.h"
+
+using namespace esphome;
+using namespace cn105_protocol;
+
+namespace {
+
+heatpumpSettings heatAt(float temperature) {
+    heatpumpSettings s{};
+    s.power = Power::ON;
+    s.mode = Mode::HEAT;
+    s.temperature = temperature;
+    s.fan = Fan::AUTO;
+    s.vane = Vane::AUTO;
+    s.wideVane = WideVane::CENTER;
+    return s;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════════
+// diff_settings
+// ════════════════════════════════════════════════════════════════
+
+TEST(StateSnapshot, IdenticalSettingsGiveEmptyMask) {
+    EXPECT_EQ(diff_settings(heatAt(21.0f), heatAt(21.0f)), 0);
+}
+
+TEST(StateSnapshot, OnlyTheMovedFieldIsSet) {
+    heatpumpSettings received = heatAt(22.5f);
+    EXPECT_EQ(diff_settings(heatAt(21.0f), received), field_bit(SettingsField::TEMPERATURE));
+
+    received = heatAt(21.0f);
+    received.vane = Vane::SWING;
+    received.fan = Fan::QUIET;
+    const FieldMask mask = diff_settings(heatAt(21.0f), received);
+    EXPECT_TRUE(has_field(mask, SettingsField::VANE));
+    EXPECT_TRUE(has_field(mask, SettingsField::FAN));
+    EXPECT_FALSE(has_field(mask, SettingsField::WIDE_VANE));
+    EXPECT_FALSE(has_field(mask, SettingsField::POWER));
+}
+
+TEST(StateSnapshot, FirstReplySetsEveryCarriedField) {
+    const FieldMask mask = diff_settings(heatpumpSettings{}, heatAt(21.0f));
+    EXPECT_EQ(mask, field_bit(SettingsField::POWER) | field_bit(SettingsField::MODE) |
+        field_bit(SettingsField::TEMPERATURE) | field_bit(SettingsField::FAN) |
+        field_bit(SettingsField::VANE) | field_bit(SettingsField::WIDE_VANE));
+}
+
+TEST(StateSnapshot, UnsetEntryIsNotAChange) {
+    heatpumpSettings received = heatAt(21.0f);
+    received.wideVane = WideVane::UNSET;        // wide vane not supported: not decoded
+    EXPECT_EQ(diff_settings(heatAt(21.0f), received), 0);
+}
+
+TEST(StateSnapshot, ISeeChangeIsItsOwnField) {
+    heatpumpSettings received = heatAt(21.0f);
+    received.iSee = true;
+    EXPECT_EQ(diff_settings(heatAt(21.0f), received), field_bit(SettingsField::ISEE));
+}
+
+// ════════════════════════════════════════════════════════════════
+// diff_status
+// ════════════════════════════════════════════════════════════════
+
+TEST(StateSnapshot, NaNToNaNIsNotAChange) {
+    heatpumpStatus current{};       // every reading NaN before the first replies
+    heatpumpStatus received{};
+    received.roomTemperature = 21.0f;
+    EXPECT_EQ(diff_status(current, received), field_bit(StatusField::ROOM_TEMPERATURE));
+    EXPECT_EQ(diff_status(received, received), 0);
+}
+
+TEST(StateSnapshot, StatusFieldsAreIndependent) {
+    heatpumpStatus current{};
+    current.roomTemperature = 21.0f;
+    current.compressorFrequency = 30;
+    current.inputPower = 400;
+    heatpumpStatus received = current;
+    received.inputPower = 420;
+    received.operating = true;
+    EXPECT_EQ(diff_status(current, received), field_bit(StatusField::INPUT_POWER) | field_bit(StatusField::OPERATING));
+
+    received = current;
+    received.outsideAirTemperature = 4.5f;
+    EXPECT_EQ(diff_status(current, received), field_bit(StatusField::OUTSIDE_AIR_TEMPERATURE));
+    received.outsideAirTemperature = NAN;   // sensor dropping out again
+    current.outsideAirTemperature = 4.5f;
+    EXPECT_EQ(diff_status(current, received), field_bit(StatusField::OUTSIDE_AIR_TEMPERATURE));
+}
+
+// ════════════════════════════════════════════════════════════════
+// VersionedState
+// ════════════════════════════════════════════════════════════════
+
+TEST(StateSnapshot, EmptyCommitKeepsTheVersion) {
+    VersionedState<SettingsField> state;
+    EXPECT_EQ(state.commit(0), 0);
+    EXPECT_EQ(state.version(), 0u);
+}
+
+TEST(StateSnapshot, CommitRecordsFieldVersions) {
+    VersionedState<SettingsField> state;
+    state.commit(field_bit(SettingsField::MODE) | field_bit(SettingsField::TEMPERATURE));
+    const uint32_t seen = state.version();
+    EXPECT_EQ(seen, 1u);
+
+    EXPECT_EQ(state.commit(field_bit(SettingsField::TEMPERATURE)), field_bit(SettingsField::TEMPERATURE));
+    EXPECT_EQ(state.version(), 2u);
+    EXPECT_EQ(state.last_changed(), field_bit(SettingsField::TEMPERATURE));
+    EXPECT_EQ(state.field_version(SettingsField::MODE), 1u);
+    EXPECT_EQ(state.field_version(SettingsField::TEMPERATURE), 2u);
+    EXPECT_TRUE(state.changed_since(SettingsField::TEMPERATURE, seen));
+    EXPECT_FALSE(state.changed_since(SettingsField::MODE, seen));
+    EXPECT_FALSE(state.changed_since(SettingsField::FAN, 0));
+}
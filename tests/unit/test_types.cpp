@@ -4,59 +4,61 @@
 #include "esphome_stubs.h"
 #include "cn105_types.h"
 
+using namespace cn105_protocol;
+
 // ========================================================
 // heatpumpSettings tests
 // ========================================================
 
-TEST(HeatpumpSettingsTest, ResetSettings_NullsAndDefaults) {
+TEST(HeatpumpSettingsTest, ResetSettings_UnsetAndDefaults) {
     heatpumpSettings s{};
-    s.power = "ON";
-    s.mode = "COOL";
+    s.power = Power::ON;
+    s.mode = Mode::COOL;
     s.temperature = 24.0f;
-    s.fan = "AUTO";
-    s.vane = "SWING";
-    s.wideVane = "|";
+    s.fan = Fan::AUTO;
+    s.vane = Vane::SWING;
+    s.wideVane = WideVane::CENTER;
 
     s.resetSettings();
 
-    EXPECT_EQ(s.power, nullptr);
-    EXPECT_EQ(s.mode, nullptr);
+    EXPECT_EQ(s.power, Power::UNSET);
+    EXPECT_EQ(s.mode, Mode::UNSET);
     EXPECT_FLOAT_EQ(s.temperature, -1.0f);
     EXPECT_FLOAT_EQ(s.dual_low_target, -100.0f);
     EXPECT_FLOAT_EQ(s.dual_high_target, -100.0f);
-    EXPECT_EQ(s.fan, nullptr);
-    EXPECT_EQ(s.vane, nullptr);
-    EXPECT_EQ(s.wideVane, nullptr);
+    EXPECT_EQ(s.fan, Fan::UNSET);
+    EXPECT_EQ(s.vane, Vane::UNSET);
+    EXPECT_EQ(s.wideVane, WideVane::UNSET);
 }
 
 TEST(HeatpumpSettingsTest, EqualityOperator_IdenticalSettings) {
     heatpumpSettings a{};
-    a.power = "ON";
-    a.mode = "HEAT";
+    a.power = Power::ON;
+    a.mode = Mode::HEAT;
     a.temperature = 22.0f;
-    a.fan = "AUTO";
-    a.vane = "AUTO";
-    a.wideVane = "|";
+    a.fan = Fan::AUTO;
+    a.vane = Vane::AUTO;
+    a.wideVane = WideVane::CENTER;
 
     heatpumpSettings b{};
-    b.power = "ON";
-    b.mode = "HEAT";
+    b.power = Power::ON;
+    b.mode = Mode::HEAT;
     b.temperature = 22.0f;
-    b.fan = "AUTO";
-    b.vane = "AUTO";
-    b.wideVane = "|";
+    b.fan = Fan::AUTO;
+    b.vane = Vane::AUTO;
+    b.wideVane = WideVane::CENTER;
 
     EXPECT_TRUE(a == b);
 }
 
 TEST(HeatpumpSettingsTest, EqualityOperator_DifferentTemp) {
     heatpumpSettings a{};
-    a.power = "ON";
-    a.mode = "HEAT";
+    a.power = Power::ON;
+    a.mode = Mode::HEAT;
     a.temperature = 22.0f;
-    a.fan = "AUTO";
-    a.vane = "AUTO";
-    a.wideVane = "|";
+    a.fan = Fan::AUTO;
+    a.vane = Vane::AUTO;
+    a.wideVane = WideVane::CENTER;
 
     heatpumpSettings b = a;
     b.temperature = 24.0f;
@@ -66,29 +68,27 @@ TEST(HeatpumpSettingsTest, EqualityOperator_DifferentTemp) {
 
 TEST(HeatpumpSettingsTest, EqualityOperator_DifferentMode) {
     heatpumpSettings a{};
-    a.power = "ON";
-    a.mode = "HEAT";
+    a.power = Power::ON;
+    a.mode = Mode::HEAT;
     a.temperature = 22.0f;
-    a.fan = "AUTO";
-    a.vane = "AUTO";
-    a.wideVane = "|";
+    a.fan = Fan::AUTO;
+    a.vane = Vane::AUTO;
+    a.wideVane = WideVane::CENTER;
 
     heatpumpSettings b = a;
-    b.mode = "COOL";
+    b.mode = Mode::COOL;
 
-    // operator== compares const char* pointers, not string content
-    // Since "HEAT" and "COOL" are different string literals, pointers differ
     EXPECT_FALSE(a == b);
 }
 
 TEST(HeatpumpSettingsTest, InequalityOperator_Works) {
     heatpumpSettings a{};
-    a.power = "ON";
-    a.mode = "HEAT";
+    a.power = Power::ON;
+    a.mode = Mode::HEAT;
     a.temperature = 22.0f;
-    a.fan = "AUTO";
-    a.vane = "AUTO";
-    a.wideVane = "|";
+    a.fan = Fan::AUTO;
+    a.vane = Vane::AUTO;
+    a.wideVane = WideVane::CENTER;
 
     heatpumpSettings b = a;
     b.temperature = 25.0f;
@@ -96,6 +96,20 @@ TEST(HeatpumpSettingsTest, InequalityOperator_Works) {
     EXPECT_TRUE(a != b);
 }
 
+TEST(HeatpumpSettingsTest, CompactLayout) {
+    static_assert(sizeof(heatpumpSettings) <= 24, "settings grew past one enum byte per field");
+    static_assert(sizeof(heatpumpRunStates) == 4, "run states grew");
+    heatpumpSettings s{};
+    EXPECT_FALSE(is_set(s.mode));
+    EXPECT_EQ(to_label(s.mode), nullptr);
+    s.mode = Mode::DRY;
+    EXPECT_TRUE(is_set(s.mode));
+    EXPECT_STREQ(to_label(s.mode), "DRY");
+    EXPECT_STREQ(to_label(WideVane::AIRFLOW_CONTROL), "AIRFLOW CONTROL");
+    EXPECT_STREQ(to_label(Stage::STAGE_DIFFUSE), "DIFFUSE");
+    EXPECT_EQ(to_label(static_cast<Fan>(9)), nullptr);
+}
+
 // ========================================================
 // wantedHeatpumpSettings tests
 // ========================================================
@@ -104,17 +118,36 @@ TEST(WantedHeatpumpSettingsTest, ResetSettings_IncludesFlags) {
     wantedHeatpumpSettings ws{};
     ws.hasChanged = true;
     ws.hasBeenSent = true;
-    ws.power = "ON";
+    ws.power = Power::ON;
     ws.temperature = 24.0f;
 
     ws.resetSettings();
 
     EXPECT_FALSE(ws.hasChanged);
     EXPECT_FALSE(ws.hasBeenSent);
-    EXPECT_EQ(ws.power, nullptr);
+    EXPECT_EQ(ws.power, Power::UNSET);
     EXPECT_FLOAT_EQ(ws.temperature, -1.0f);
 }
 
+TEST(HeatpumpSettingsTest, Confirms_OnlyChecksWrittenFields) {
+    heatpumpSettings written{};
+    written.mode = Mode::COOL;
+    written.temperature = 22.5f;
+
+    heatpumpSettings readback{};
+    readback.power = Power::ON;
+    readback.mode = Mode::COOL;
+    readback.temperature = 22.5f;
+    readback.fan = Fan::AUTO;
+    EXPECT_TRUE(readback.confirms(written));
+
+    readback.temperature = 22.0f;
+    EXPECT_FALSE(readback.confirms(written));
+    readback.temperature = 22.5f;
+    readback.mode = Mode::HEAT;
+    EXPECT_FALSE(readback.confirms(written));
+}
+
 // ========================================================
 // heatpumpStatus tests
 // ========================================================
@@ -176,14 +209,14 @@ TEST(HeatpumpRunStatesTest, ResetSettings) {
     rs.air_purifier = 1;
     rs.night_mode = 1;
     rs.circulator = 1;
-    rs.airflow_control = "DIRECT";
+    rs.airflow_control = AirflowControl::DIRECT;
 
     rs.resetSettings();
 
     EXPECT_EQ(rs.air_purifier, -1);
     EXPECT_EQ(rs.night_mode, -1);
     EXPECT_EQ(rs.circulator, -1);
-    EXPECT_EQ(rs.airflow_control, nullptr);
+    EXPECT_EQ(rs.airflow_control, AirflowControl::UNSET);
 }
 
 TEST(HeatpumpRunStatesTest, EqualityOperator) {
@@ -191,7 +224,7 @@ TEST(HeatpumpRunStatesTest, EqualityOperator) {
     a.air_purifier = 1;
     a.night_mode = 0;
     a.circulator = 1;
-    a.airflow_control = "EVEN";
+    a.airflow_control = AirflowControl::EVEN;
 
     heatpumpRunStates b = a;
 
@@ -210,3 +243,54 @@ TEST(WantedRunStatesTest, ResetSettings_IncludesFlags) {
     EXPECT_FALSE(wrs.hasBeenSent);
     EXPECT_EQ(wrs.air_purifier, -1);
 }
+
+// ════════════════════════════════════════════════════════════════
+// stateFreshness (warm reconnect)
+// ════════════════════════════════════════════════════════════════
+
+TEST(StateFreshnessTest, FirstConnectIsCold) {
+    stateFreshness f{};
+    EXPECT_FALSE(f.warmStart(1000, 300000));
+    EXPECT_EQ(f.pending, stateFreshness::ALL);
+}
+
+TEST(StateFreshnessTest, ValidOnceEveryPartRefreshed) {
+    stateFreshness f{};
+    f.warmStart(0, 300000);
+    EXPECT_FALSE(f.refreshed(stateFreshness::SETTINGS));
+    EXPECT_FALSE(f.refreshed(stateFreshness::SETTINGS));        // duplicate reply
+    EXPECT_FALSE(f.refreshed(stateFreshness::ROOM));
+    EXPECT_FALSE(f.valid);
+    EXPECT_TRUE(f.refreshed(stateFreshness::STATUS));
+    EXPECT_TRUE(f.valid);
+    EXPECT_FALSE(f.refreshed(stateFreshness::STATUS));          // later replies: nothing pending
+}
+
+TEST(StateFreshnessTest, ShortLossIsWarm) {
+    stateFreshness f{};
+    f.warmStart(0, 300000);
+    f.refreshed(stateFreshness::ALL);
+    f.linkLost(10000);
+    f.linkLost(12000);                                          // retries keep the first loss time
+    EXPECT_TRUE(f.stale);
+    EXPECT_EQ(f.staleForMs(15000), 5000u);
+    EXPECT_TRUE(f.warmStart(15000, 300000));
+    EXPECT_TRUE(f.stale);                                       // until the first replies are in
+    EXPECT_TRUE(f.refreshed(stateFreshness::ALL));
+    EXPECT_FALSE(f.stale);
+    EXPECT_EQ(f.staleForMs(20000), 0u);
+}
+
+TEST(StateFreshnessTest, LongLossOrZeroWindowIsCold) {
+    stateFreshness f{};
+    f.warmStart(0, 300000);
+    f.refreshed(stateFreshness::ALL);
+    f.linkLost(1000);
+    EXPECT_FALSE(f.warmStart(1000 + 300001, 300000));
+    EXPECT_FALSE(f.valid);
+
+    stateFreshness g{};
+    g.warmStart(0, 300000);
+    g.refreshed(stateFreshness::ALL);
+    EXPECT_FALSE(g.warmStart(10, 0));
+}